@@ -1,6 +1,11 @@
 #version 410
 
-uniform mat4 mvp;
+layout(std140) uniform Object {
+  mat4 model;
+  mat4 mvp;
+  vec3 color;
+  int bone_offset;
+};
 
 layout(location = 0) in vec4 vertex_position;
 layout(location = 2) in vec3 vertex_color;
@@ -0,0 +1,31 @@
+#version 410
+
+layout(triangles) in;
+layout(triangle_strip, max_vertices = 3) out;
+
+layout(std140) uniform Frame {
+  mat4 view;
+  mat4 projection;
+  mat4 view_projection;
+  vec3 sun_dir;
+  vec3 ambient;
+};
+
+out vec3 vertex;
+out vec3 normal;
+
+void main()
+{
+  vec3 a = gl_in[0].gl_Position.xyz - gl_in[1].gl_Position.xyz;
+  vec3 b = gl_in[2].gl_Position.xyz - gl_in[1].gl_Position.xyz;
+  vec3 n = normalize(cross(a, b));
+  gl_Position = view_projection * gl_in[0].gl_Position;
+  normal = n;
+  EmitVertex();
+  gl_Position = view_projection * gl_in[1].gl_Position;
+  normal = n;
+  EmitVertex();
+  gl_Position = view_projection * gl_in[2].gl_Position;
+  normal = n;
+  EmitVertex();
+}
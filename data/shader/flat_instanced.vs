@@ -0,0 +1,11 @@
+#version 410
+
+layout(location = 0) in vec3 vertex_position;
+// per instance, locations 4 - 7 (INSTANCE_ATTRIBUTE)
+layout(location = 4) in mat4 instance_model;
+
+void main(void)
+{
+  // world space, geometry shader projects the triangle
+  gl_Position = instance_model * vec4(vertex_position, 1);
+}
@@ -3,8 +3,12 @@
 layout(triangles) in;
 layout(triangle_strip, max_vertices = 3) out;
 
-uniform mat4 mvp;
-uniform mat4 model;
+layout(std140) uniform Object {
+  mat4 model;
+  mat4 mvp;
+  vec3 color;
+  int bone_offset;
+};
 
 out vec3 vertex;
 out vec3 normal;
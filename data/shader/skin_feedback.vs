@@ -0,0 +1,38 @@
+#version 410
+
+// skinning for the geometry cache, outputs are captured by transform feedback
+layout(location = 0) in vec3 vertex_position;
+layout(location = 1) in vec4 vertex_normal;
+layout(location = 8) in uvec4 bone_index;
+layout(location = 9) in vec4 bone_weight;
+
+layout(std140) uniform Object {
+  mat4 model;
+  mat4 mvp;
+  vec3 color;
+  int bone_offset;
+};
+
+uniform samplerBuffer bone_palette;
+
+out vec3 skinned_position;
+out vec3 skinned_normal;
+
+mat4 bone_matrix(uint bone)
+{
+  int i = (bone_offset + int(bone)) * 4;
+  return mat4(texelFetch(bone_palette, i), texelFetch(bone_palette, i + 1),
+              texelFetch(bone_palette, i + 2), texelFetch(bone_palette, i + 3));
+}
+
+void main(void)
+{
+  mat4 m = bone_matrix(bone_index.x) * bone_weight.x
+         + bone_matrix(bone_index.y) * bone_weight.y
+         + bone_matrix(bone_index.z) * bone_weight.z
+         + bone_matrix(bone_index.w) * bone_weight.w;
+
+  skinned_position = (m * vec4(vertex_position, 1)).xyz;
+  skinned_normal = normalize((m * vec4(vertex_normal.xyz, 0)).xyz);
+  gl_Position = vec4(skinned_position, 1);
+}
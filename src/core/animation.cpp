@@ -0,0 +1,287 @@
+#include "animation.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "log.h"
+
+namespace atom {
+
+namespace {
+
+const f32 QUANTIZE_SCALE = 32767;
+
+f32 rotation_error(const Quatf &a, const Quatf &b)
+{
+  f32 s = dot_product(a, b) < 0 ? -1 : 1;
+  return std::max(std::max(abs(a.w - s * b.w), abs(a.x - s * b.x)),
+                  std::max(abs(a.y - s * b.y), abs(a.z - s * b.z)));
+}
+
+/**
+ * Check that frames between keys @p a and @p b are reproduced by interpolation.
+ */
+bool segment_fits(const std::vector<Quatf> &frames, u32 a, u32 b, f32 tolerance)
+{
+  Quatf qa = dequantize_rotation(quantize_rotation(a, frames[a]));
+  Quatf qb = dequantize_rotation(quantize_rotation(b, frames[b]));
+
+  for (u32 i = a + 1; i < b; ++i) {
+    f32 t = static_cast<f32>(i - a) / (b - a);
+
+    if (rotation_error(nlerp(qa, qb, t), frames[i]) > tolerance) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+template<typename T>
+void append(std::vector<u8> &data, const T *values, u32 count)
+{
+  if (count > 0) {
+    const u8 *begin = reinterpret_cast<const u8 *>(values);
+    data.insert(data.end(), begin, begin + count * sizeof(T));
+  }
+}
+
+}
+
+AnimationClip::AnimationClip(const String &name, f32 fps, u32 frame_count,
+  const Slice<AnimationTrack> &tracks, const AnimationKey *keys)
+  : my_name(name)
+  , my_fps(fps)
+  , my_frame_count(frame_count)
+  , my_tracks(tracks)
+  , my_keys(keys)
+{
+
+}
+
+f32 AnimationClip::duration() const
+{
+  return my_frame_count > 1 ? (my_frame_count - 1) / my_fps : 0;
+}
+
+u32 AnimationClip::key_count() const
+{
+  u32 count = 0;
+
+  for (const AnimationTrack &track : my_tracks) {
+    count += track.key_count;
+  }
+
+  return count;
+}
+
+u32 AnimationClip::memory_size() const
+{
+  return sizeof(AnimationFileClip) + my_tracks.size() * sizeof(AnimationTrack)
+    + key_count() * sizeof(AnimationKey);
+}
+
+void AnimationClip::sample(f32 time, bool loop, f32 weight, Quatf *pose, u32 bone_count) const
+{
+  assert(pose != nullptr);
+  f32 last = my_frame_count > 1 ? my_frame_count - 1 : 0;
+  f32 frame = time * my_fps;
+
+  if (loop && last > 0) {
+    frame = std::fmod(frame, last);
+    frame = frame < 0 ? frame + last : frame;
+  } else {
+    frame = std::min(std::max(frame, 0.0f), last);
+  }
+
+  for (const AnimationTrack &track : my_tracks) {
+    if (track.bone >= bone_count || track.key_count == 0) {
+      continue;
+    }
+
+    const AnimationKey *begin = my_keys + track.first_key;
+    const AnimationKey *end = begin + track.key_count;
+    // the first key after sampled frame
+    const AnimationKey *next = std::upper_bound(begin, end, frame,
+      [](f32 f, const AnimationKey &key) { return f < key.frame; });
+    Quatf rotation;
+
+    if (next == begin) {
+      rotation = dequantize_rotation(*begin);
+    } else if (next == end) {
+      rotation = dequantize_rotation(*(end - 1));
+    } else {
+      const AnimationKey *prev = next - 1;
+      f32 t = (frame - prev->frame) / (next->frame - prev->frame);
+      rotation = nlerp(dequantize_rotation(*prev), dequantize_rotation(*next), t);
+    }
+
+    Quatf &dst = pose[track.bone];
+    dst = weight >= 1 ? rotation : nlerp(dst, rotation, weight);
+  }
+}
+
+AnimationKey quantize_rotation(u32 frame, const Quatf &rotation)
+{
+  assert(frame <= U16_MAX);
+  Quatf q = rotation.normalized();
+  // q and -q is the same rotation, keep w positive
+  f32 s = q.w < 0 ? -QUANTIZE_SCALE : QUANTIZE_SCALE;
+
+  AnimationKey key;
+  key.frame = frame;
+  key.rotation[0] = static_cast<i16>(std::lround(q.x * s));
+  key.rotation[1] = static_cast<i16>(std::lround(q.y * s));
+  key.rotation[2] = static_cast<i16>(std::lround(q.z * s));
+  return key;
+}
+
+Quatf dequantize_rotation(const AnimationKey &key)
+{
+  f32 x = key.rotation[0] / QUANTIZE_SCALE;
+  f32 y = key.rotation[1] / QUANTIZE_SCALE;
+  f32 z = key.rotation[2] / QUANTIZE_SCALE;
+  f32 w2 = 1 - x * x - y * y - z * z;
+  return Quatf(w2 > 0 ? std::sqrt(w2) : 0, x, y, z);
+}
+
+void compress_track(const std::vector<Quatf> &frames, f32 tolerance,
+  std::vector<AnimationKey> &keys)
+{
+  keys.clear();
+  u32 count = frames.size();
+
+  if (count == 0) {
+    return;
+  }
+
+  keys.push_back(quantize_rotation(0, frames[0]));
+  Quatf first = dequantize_rotation(keys[0]);
+  bool is_constant = true;
+
+  for (u32 i = 1; i < count && is_constant; ++i) {
+    is_constant = rotation_error(first, frames[i]) <= tolerance;
+  }
+
+  if (is_constant) {
+    return;
+  }
+
+  // greedy reduction, each key is extended as far as interpolation fits
+  u32 a = 0;
+
+  while (a + 1 < count) {
+    u32 b = a + 1;
+
+    while (b + 1 < count && segment_fits(frames, a, b + 1, tolerance)) {
+      ++b;
+    }
+
+    keys.push_back(quantize_rotation(b, frames[b]));
+    a = b;
+  }
+}
+
+bool compress_animations(const std::vector<RawAnimationClip> &clips, f32 tolerance,
+  std::vector<u8> &data)
+{
+  std::vector<AnimationFileClip> file_clips;
+  std::vector<AnimationTrack> tracks;
+  std::vector<AnimationKey> keys;
+  std::vector<AnimationKey> track_keys;
+
+  for (const RawAnimationClip &clip : clips) {
+    if (clip.name.size() >= ANIMATION_NAME_SIZE || clip.frame_count > U16_MAX + 1u ||
+        clip.fps <= 0) {
+      log_error("Can't compress animation \"%s\"", clip.name.c_str());
+      return false;
+    }
+
+    AnimationFileClip file_clip;
+    memset(&file_clip, 0, sizeof(file_clip));
+    strncpy(file_clip.name, clip.name.c_str(), ANIMATION_NAME_SIZE - 1);
+    file_clip.fps = clip.fps;
+    file_clip.frame_count = clip.frame_count;
+    file_clip.first_track = tracks.size();
+    file_clip.track_count = clip.tracks.size();
+
+    for (const RawAnimationTrack &raw : clip.tracks) {
+      if (raw.frames.size() != clip.frame_count) {
+        log_error("Animation \"%s\" has track with invalid frame count", clip.name.c_str());
+        return false;
+      }
+
+      compress_track(raw.frames, tolerance, track_keys);
+      tracks.push_back(AnimationTrack{raw.bone, static_cast<u32>(keys.size()),
+        static_cast<u32>(track_keys.size())});
+      keys.insert(keys.end(), track_keys.begin(), track_keys.end());
+    }
+
+    file_clips.push_back(file_clip);
+  }
+
+  AnimationFileHeader header;
+  memset(&header, 0, sizeof(header));
+  header.clip_count = file_clips.size();
+  header.track_count = tracks.size();
+  header.key_count = keys.size();
+
+  data.clear();
+  append(data, &header, 1);
+  append(data, file_clips.data(), file_clips.size());
+  append(data, tracks.data(), tracks.size());
+  append(data, keys.data(), keys.size());
+  return true;
+}
+
+bool parse_animations(const Slice<u8> &data, u32 bone_count, std::vector<AnimationClip> &clips)
+{
+  clips.clear();
+
+  if (data.size() < sizeof(AnimationFileHeader)) {
+    log_error("Animation data are too small");
+    return false;
+  }
+
+  const AnimationFileHeader *header = reinterpret_cast<const AnimationFileHeader *>(data.data());
+  u64 size = sizeof(AnimationFileHeader)
+    + u64(header->clip_count) * sizeof(AnimationFileClip)
+    + u64(header->track_count) * sizeof(AnimationTrack)
+    + u64(header->key_count) * sizeof(AnimationKey);
+
+  if (size != data.size()) {
+    log_error("Animation data are corrupted");
+    return false;
+  }
+
+  const AnimationFileClip *file_clips = reinterpret_cast<const AnimationFileClip *>(header + 1);
+  const AnimationTrack *tracks = reinterpret_cast<const AnimationTrack *>(file_clips + header->clip_count);
+  const AnimationKey *keys = reinterpret_cast<const AnimationKey *>(tracks + header->track_count);
+
+  for (u32 i = 0; i < header->track_count; ++i) {
+    const AnimationTrack &track = tracks[i];
+
+    if (track.bone >= bone_count ||
+        u64(track.first_key) + track.key_count > header->key_count) {
+      log_error("Animation data contain invalid track");
+      return false;
+    }
+  }
+
+  for (u32 i = 0; i < header->clip_count; ++i) {
+    const AnimationFileClip &clip = file_clips[i];
+
+    if (u64(clip.first_track) + clip.track_count > header->track_count || !(clip.fps > 0)) {
+      log_error("Animation data contain invalid clip");
+      clips.clear();
+      return false;
+    }
+
+    String name(clip.name, strnlen(clip.name, ANIMATION_NAME_SIZE));
+    clips.push_back(AnimationClip(name, clip.fps, clip.frame_count,
+      Slice<AnimationTrack>(tracks + clip.first_track, clip.track_count), keys));
+  }
+
+  return true;
+}
+
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vector>
+#include "foundation.h"
+
+namespace atom {
+
+/**
+ * Compressed animation clips, stored in the model stream MODEL_ANIMATION
+ * (same data in .m3b file and in memory, all values are little endian):
+ *   AnimationFileHeader
+ *   AnimationFileClip[clip_count]
+ *   AnimationTrack[track_count]
+ *   AnimationKey[key_count]
+ *
+ * Clips reference stream data directly (no copy).
+ */
+const u32 ANIMATION_NAME_SIZE = 32;
+
+struct AnimationFileHeader {
+  u32 clip_count;
+  u32 track_count;
+  u32 key_count;
+  u32 reserved;
+};
+
+struct AnimationFileClip {
+  char name[ANIMATION_NAME_SIZE];
+  f32  fps;
+  u32  frame_count;
+  u32  first_track;
+  u32  track_count;
+};
+
+/**
+ * Rotation keys of one bone, keys are sorted by frame.
+ */
+struct AnimationTrack {
+  u32 bone;             ///< bone index in the model skeleton
+  u32 first_key;
+  u32 key_count;
+};
+
+/**
+ * Rotation quantized to 16 bits per component, quaternion is stored with
+ * w >= 0, so w is reconstructed from x, y, z.
+ */
+struct AnimationKey {
+  u16 frame;
+  i16 rotation[3];
+};
+
+static_assert(sizeof(AnimationFileHeader) == 16, "Invalid AnimationFileHeader size");
+static_assert(sizeof(AnimationFileClip) == 48, "Invalid AnimationFileClip size");
+static_assert(sizeof(AnimationTrack) == 12, "Invalid AnimationTrack size");
+static_assert(sizeof(AnimationKey) == 8, "Invalid AnimationKey size");
+
+class AnimationClip {
+  String                my_name;
+  f32                   my_fps;
+  u32                   my_frame_count;
+  Slice<AnimationTrack> my_tracks;
+  const AnimationKey   *my_keys;
+
+public:
+  AnimationClip(const String &name, f32 fps, u32 frame_count,
+    const Slice<AnimationTrack> &tracks, const AnimationKey *keys);
+
+  const String& name() const
+  {
+    return my_name;
+  }
+
+  f32 fps() const
+  {
+    return my_fps;
+  }
+
+  u32 frame_count() const
+  {
+    return my_frame_count;
+  }
+
+  /**
+   * Length of the clip in seconds (last frame time).
+   */
+  f32 duration() const;
+
+  Slice<AnimationTrack> tracks() const
+  {
+    return my_tracks;
+  }
+
+  u32 key_count() const;
+
+  /**
+   * Size of the compressed clip data in bytes.
+   */
+  u32 memory_size() const;
+
+  /**
+   * Sample rotations at @p time and blend them into @p pose, bones without
+   * track are unchanged.
+   *
+   * @param weight blend weight, 1 replaces rotations in the pose
+   * @param pose rotation of each bone
+   */
+  void sample(f32 time, bool loop, f32 weight, Quatf *pose, u32 bone_count) const;
+};
+
+/**
+ * Uncompressed clip (from exporter), one rotation per frame.
+ */
+struct RawAnimationTrack {
+  u32                bone;
+  std::vector<Quatf> frames;
+};
+
+struct RawAnimationClip {
+  String                         name;
+  f32                            fps;
+  u32                            frame_count;
+  std::vector<RawAnimationTrack> tracks;
+};
+
+AnimationKey quantize_rotation(u32 frame, const Quatf &rotation);
+
+Quatf dequantize_rotation(const AnimationKey &key);
+
+/**
+ * Quantize rotations and remove keys which are reproduced by interpolation
+ * of the neighbour keys (error of each quaternion component <= tolerance).
+ * Constant track is reduced to the single key.
+ */
+void compress_track(const std::vector<Quatf> &frames, f32 tolerance,
+  std::vector<AnimationKey> &keys);
+
+/**
+ * Build MODEL_ANIMATION stream data from uncompressed clips.
+ */
+bool compress_animations(const std::vector<RawAnimationClip> &clips, f32 tolerance,
+  std::vector<u8> &data);
+
+/**
+ * Create clips referencing MODEL_ANIMATION stream data, @p data must outlive
+ * the clips.
+ */
+bool parse_animations(const Slice<u8> &data, u32 bone_count, std::vector<AnimationClip> &clips);
+
+}
@@ -0,0 +1,80 @@
+#include "animation_component.h"
+#include "model_component.h"
+#include "skeleton_component.h"
+#include "resources.h"
+#include "model.h"
+#include <algorithm>
+
+namespace atom {
+
+META_CLASS(AnimationComponent,
+)
+
+AnimationComponent::AnimationComponent()
+  : NullComponent(ComponentType::ANIMATION)
+  , my_model(this)
+  , my_skeleton(this)
+  , my_resolved(nullptr)
+{
+  META_INIT();
+}
+
+u32 AnimationComponent::add_layer(const String &clip, f32 weight, bool loop)
+{
+  my_layers.push_back(AnimationLayer{clip, 0, 1, weight, loop, U32_MAX});
+  my_resolved = nullptr;
+  return my_layers.size() - 1;
+}
+
+void AnimationComponent::set_layer_weight(u32 index, f32 weight)
+{
+  assert(index < my_layers.size());
+  my_layers[index].weight = std::min(std::max(weight, 0.0f), 1.0f);
+}
+
+void AnimationComponent::resolve_clips(const Model &model)
+{
+  for (AnimationLayer &layer : my_layers) {
+    layer.index = model.find_animation(layer.clip);
+  }
+
+  my_resolved = &model;
+}
+
+void AnimationComponent::update(f32 dt)
+{
+  SkeletonComponent *skeleton = my_skeleton.get_component();
+
+  if (my_model.is_null() || skeleton == nullptr) {
+    return;
+  }
+
+  ModelResourcePtr resource = my_model->get_model();
+
+  if (resource == nullptr) {
+    return;
+  }
+
+  const Model &model = resource->model();
+
+  if (&model != my_resolved) {
+    resolve_clips(model);
+  }
+
+  u32 bone_count = skeleton->bone_count();
+  my_pose.assign(bone_count, Quatf());
+
+  for (AnimationLayer &layer : my_layers) {
+    layer.time += dt * layer.speed;
+
+    if (layer.index != U32_MAX && layer.weight > 0) {
+      model.animations[layer.index].sample(layer.time, layer.loop, layer.weight,
+        my_pose.data(), bone_count);
+    }
+  }
+
+  skeleton->set_pose(my_pose.data(), bone_count);
+  skeleton->recalculate_skeleton();
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "component.h"
+
+namespace atom {
+
+/**
+ * Playback of one clip, layers are blended in order (layer overrides
+ * animated bones of previous layers by its weight).
+ */
+struct AnimationLayer {
+  String clip;      ///< clip name in the model
+  f32    time;      ///< playback time (s)
+  f32    speed;     ///< time scale, 0 pauses playback
+  f32    weight;    ///< <0, 1>, 0 disables the layer
+  bool   loop;
+  u32    index;     ///< clip index in the model, U32_MAX when unresolved
+};
+
+class AnimationComponent : public NullComponent {
+  Slot<ModelComponent>        my_model;
+  Slot<SkeletonComponent>     my_skeleton;
+  std::vector<AnimationLayer> my_layers;
+  std::vector<Quatf>          my_pose;
+  const Model                *my_resolved;   ///< model used for layer clip indices
+
+  /**
+   * Find clip indices of layers when model has changed (loaded/reloaded).
+   */
+  void resolve_clips(const Model &model);
+
+public:
+  AnimationComponent();
+
+  /**
+   * Add layer on top of the existing layers.
+   *
+   * @return layer index
+   */
+  u32 add_layer(const String &clip, f32 weight = 1, bool loop = true);
+
+  u32 layer_count() const
+  {
+    return my_layers.size();
+  }
+
+  AnimationLayer& layer(u32 index)
+  {
+    assert(index < my_layers.size());
+    return my_layers[index];
+  }
+
+  void set_layer_weight(u32 index, f32 weight);
+
+  /**
+   * Advance playback by @p dt, blend layers and update skeleton pose (bones
+   * without any animated track stay in the rest pose).
+   */
+  void update(f32 dt);
+
+  META_SUB_CLASS(NullComponent);
+};
+
+MAP_COMPONENT_TYPE(AnimationComponent, ANIMATION)
+
+}
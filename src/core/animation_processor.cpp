@@ -0,0 +1,41 @@
+#include "animation_processor.h"
+#include "animation_component.h"
+#include "world.h"
+#include "core.h"
+#include "constants.h"
+#include "job_system.h"
+
+namespace atom {
+
+AnimationProcessor::AnimationProcessor(World &world)
+  : NullProcessor(world)
+{
+
+}
+
+AnimationProcessor::~AnimationProcessor()
+{
+
+}
+
+void AnimationProcessor::poll()
+{
+  const ComponentRange<AnimationComponent> components = world().components<AnimationComponent>();
+  const f32 dt = 1.0f / FPS;
+
+  // each component writes only the pose of its own skeleton
+  core().job_system().parallel_for(components.size(), ANIMATION_JOB_CHUNK,
+    [&components, dt](u32 begin, u32 end)
+    {
+      for (u32 i = begin; i < end; ++i) {
+        components[i]->update(dt);
+      }
+    });
+}
+
+ProcessorAccess AnimationProcessor::access() const
+{
+  return ProcessorAccess{0, ProcessorData::SKELETONS};
+}
+
+}
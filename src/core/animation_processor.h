@@ -0,0 +1,21 @@
+#pragma once
+
+#include "processor.h"
+
+namespace atom {
+
+/**
+ * Evaluate animation layers of all AnimationComponents each tick, skeletons
+ * are independent, so they are evaluated in parallel.
+ */
+class AnimationProcessor : public NullProcessor {
+public:
+  explicit AnimationProcessor(World &world);
+  ~AnimationProcessor();
+
+  void poll() override;
+
+  ProcessorAccess access() const override;
+};
+
+}
@@ -0,0 +1,108 @@
+#include "audio_component.h"
+#include "audio_service.h"
+#include "core.h"
+#include "entity.h"
+#include "log.h"
+#include "resource_service.h"
+
+namespace atom {
+
+META_CLASS(AudioComponent,
+  FIELD(my_volume, "volume"),
+  FIELD(my_min_distance, "min_distance"),
+  FIELD(my_max_distance, "max_distance"),
+  FIELD(my_linear, "linear"),
+  FIELD(my_repeat, "repeat"),
+  FIELD(my_auto_play, "auto_play")
+)
+
+AudioComponent::AudioComponent()
+  : NullComponent(ComponentType::AUDIO)
+  , my_volume(1)
+  , my_min_distance(1)
+  , my_max_distance(100)
+  , my_linear(false)
+  , my_repeat(false)
+  , my_auto_play(true)
+  , my_track(AudioService::INVALID_ID)
+  , my_play_pending(false)
+  , my_has_position(false)
+{
+  META_INIT();
+}
+
+AudioComponent::~AudioComponent()
+{
+  // empty
+}
+
+void AudioComponent::activate()
+{
+  // decoded by the resource workers, played once it is ready
+  my_sound_resource = core().resource_service().get_sound_async(my_sound);
+
+  my_has_position = false;
+  my_play_pending = my_auto_play;
+}
+
+void AudioComponent::deactivate()
+{
+  stop();
+  my_sound_resource.reset();
+}
+
+AudioEmitter AudioComponent::emitter() const
+{
+  AudioEmitter emitter;
+  emitter.position = my_position;
+  emitter.velocity = my_velocity;
+  emitter.min_distance = my_min_distance;
+  emitter.max_distance = my_max_distance;
+  emitter.rolloff = my_linear ? AudioRolloff::LINEAR : AudioRolloff::INVERSE;
+  return emitter;
+}
+
+void AudioComponent::play()
+{
+  my_play_pending = true;
+}
+
+void AudioComponent::stop()
+{
+  my_play_pending = false;
+
+  if (my_track != AudioService::INVALID_ID) {
+    core().audio_service().stop(my_track);
+    my_track = AudioService::INVALID_ID;
+  }
+}
+
+void AudioComponent::update(AudioService &audio, f32 dt)
+{
+  const Mat4f &transform = entity().transform();
+  Vec3f position(transform(0, 3), transform(1, 3), transform(2, 3));
+  Vec3f velocity = my_has_position && dt > 0 ? (position - my_position) * (1 / dt) : Vec3f();
+  bool moved = !my_has_position || position != my_position || velocity != my_velocity;
+  my_position = position;
+  my_velocity = velocity;
+  my_has_position = true;
+
+  if (my_sound_resource != nullptr && my_sound_resource->state() == ResourceState::FAILED) {
+    log_error("Can't load sound \"%s\"", my_sound.c_str());
+    my_sound_resource.reset();
+  }
+
+  if (my_play_pending && my_sound_resource != nullptr && my_sound_resource->is_ready()) {
+    if (my_track != AudioService::INVALID_ID) {
+      audio.stop(my_track);
+    }
+
+    my_track = audio.play(my_sound_resource, emitter(), my_repeat);
+    my_play_pending = false;
+  } else if (moved && my_track != AudioService::INVALID_ID) {
+    // static sources don't fill the command queue
+    audio.set_emitter(my_track, emitter());
+  }
+}
+
+}
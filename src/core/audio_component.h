@@ -0,0 +1,94 @@
+#pragma once
+
+#include "component.h"
+#include "audio_spatial.h"
+
+namespace atom {
+
+/**
+ * Sound positioned at the entity. Position and velocity of the source are
+ * taken from the entity transform each tick (AudioProcessor), the mixer pans,
+ * attenuates and Doppler shifts the sound by the world camera.
+ */
+class AudioComponent : public NullComponent {
+  String           my_sound;
+  f32              my_volume;
+  f32              my_min_distance;
+  f32              my_max_distance;
+  bool             my_linear;        ///< linear rolloff instead of the inverse one
+  bool             my_repeat;
+  bool             my_auto_play;     ///< play after activation
+  SoundResourcePtr my_sound_resource;
+  u32              my_track;         ///< AudioService id, INVALID_ID if not playing
+  bool             my_play_pending;
+  bool             my_has_position;  ///< my_position is valid (velocity)
+  Vec3f            my_position;
+  Vec3f            my_velocity;
+
+  void activate() override;
+
+  void deactivate() override;
+
+  AudioEmitter emitter() const;
+
+public:
+  AudioComponent();
+  ~AudioComponent();
+
+  void set_sound(const String &sound)
+  {
+    my_sound = sound;
+  }
+
+  void set_volume(f32 volume)
+  {
+    my_volume = volume;
+  }
+
+  void set_distance(f32 min_distance, f32 max_distance)
+  {
+    my_min_distance = min_distance;
+    my_max_distance = max_distance;
+  }
+
+  void set_rolloff(AudioRolloff rolloff)
+  {
+    my_linear = rolloff == AudioRolloff::LINEAR;
+  }
+
+  void set_repeat(bool repeat)
+  {
+    my_repeat = repeat;
+  }
+
+  void set_auto_play(bool auto_play)
+  {
+    my_auto_play = auto_play;
+  }
+
+  /**
+   * Start the sound in the next update, playing one is restarted.
+   */
+  void play();
+
+  void stop();
+
+  /**
+   * Track id of the last playback (it may have ended already).
+   */
+  u32 track() const
+  {
+    return my_track;
+  }
+
+  /**
+   * Move the emitter to the entity, called by AudioProcessor.
+   */
+  void update(AudioService &audio, f32 dt);
+
+  META_SUB_CLASS(NullComponent);
+};
+
+MAP_COMPONENT_TYPE(AudioComponent, AUDIO)
+
+}
@@ -0,0 +1,422 @@
+#include "audio_mixer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "resources.h"
+#include "sound.h"
+#include "audio_stream.h"
+#include "constants.h"
+
+#if defined(ATOM_SSE)
+#include <emmintrin.h>
+#endif
+
+#if defined(ATOM_AVX2)
+#include <immintrin.h>
+#endif
+
+namespace atom {
+
+namespace {
+
+void accumulate_scalar(f32 *accumulator, const f32 *samples, u32 count, f32 left, f32 right)
+{
+  for (u32 i = 0; i < count; ++i) {
+    accumulator[i] += samples[i] * (i % 2 == 0 ? left : right);
+  }
+}
+
+void convert_scalar(i16 *output, const f32 *accumulator, u32 count)
+{
+  for (u32 i = 0; i < count; ++i) {
+    f32 v = std::min(std::max(accumulator[i], f32(I16_MIN)), f32(I16_MAX));
+    output[i] = static_cast<i16>(std::lrint(v));
+  }
+}
+
+#if defined(ATOM_SSE)
+
+void accumulate_sse(f32 *accumulator, const f32 *samples, u32 count, f32 left, f32 right)
+{
+  const __m128 v = _mm_setr_ps(left, right, left, right);
+  u32 i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    __m128 a = _mm_mul_ps(_mm_loadu_ps(samples + i), v);
+    __m128 b = _mm_mul_ps(_mm_loadu_ps(samples + i + 4), v);
+    _mm_storeu_ps(accumulator + i, _mm_add_ps(_mm_loadu_ps(accumulator + i), a));
+    _mm_storeu_ps(accumulator + i + 4, _mm_add_ps(_mm_loadu_ps(accumulator + i + 4), b));
+  }
+
+  accumulate_scalar(accumulator + i, samples + i, count - i, left, right);
+}
+
+void convert_sse(i16 *output, const f32 *accumulator, u32 count)
+{
+  // clamp before conversion, out of range floats convert to I32_MIN
+  const __m128 min = _mm_set1_ps(I16_MIN);
+  const __m128 max = _mm_set1_ps(I16_MAX);
+  u32 i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(accumulator + i), min), max);
+    __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(accumulator + i + 4), min), max);
+    __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), packed);
+  }
+
+  convert_scalar(output + i, accumulator + i, count - i);
+}
+
+#endif
+
+#if defined(ATOM_AVX2)
+
+ATOM_TARGET_AVX2
+void accumulate_avx2(f32 *accumulator, const f32 *samples, u32 count, f32 left, f32 right)
+{
+  const __m256 v = _mm256_setr_ps(left, right, left, right, left, right, left, right);
+  u32 i = 0;
+
+  for (; i + 16 <= count; i += 16) {
+    __m256 a = _mm256_fmadd_ps(_mm256_loadu_ps(samples + i), v, _mm256_loadu_ps(accumulator + i));
+    __m256 b = _mm256_fmadd_ps(_mm256_loadu_ps(samples + i + 8), v,
+      _mm256_loadu_ps(accumulator + i + 8));
+    _mm256_storeu_ps(accumulator + i, a);
+    _mm256_storeu_ps(accumulator + i + 8, b);
+  }
+
+  accumulate_scalar(accumulator + i, samples + i, count - i, left, right);
+}
+
+ATOM_TARGET_AVX2
+void convert_avx2(i16 *output, const f32 *accumulator, u32 count)
+{
+  const __m256 min = _mm256_set1_ps(I16_MIN);
+  const __m256 max = _mm256_set1_ps(I16_MAX);
+  u32 i = 0;
+
+  for (; i + 16 <= count; i += 16) {
+    __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(accumulator + i), min), max);
+    __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(accumulator + i + 8), min), max);
+    // pack works in 128bit lanes, restore the order of 64bit quarters
+    __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+    packed = _mm256_permute4x64_epi64(packed, 0xD8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i), packed);
+  }
+
+  convert_scalar(output + i, accumulator + i, count - i);
+}
+
+#endif
+
+}
+
+void mix_accumulate(f32 *accumulator, const f32 *samples, u32 count, f32 left, f32 right,
+  SimdLevel level)
+{
+  assert(has_simd(level) && "Unsupported SIMD level");
+
+  switch (level) {
+#if defined(ATOM_AVX2)
+    case SimdLevel::AVX2:
+      accumulate_avx2(accumulator, samples, count, left, right);
+      break;
+#endif
+#if defined(ATOM_SSE)
+    case SimdLevel::SSE:
+      accumulate_sse(accumulator, samples, count, left, right);
+      break;
+#endif
+    default:
+      accumulate_scalar(accumulator, samples, count, left, right);
+      break;
+  }
+}
+
+void mix_convert(i16 *output, const f32 *accumulator, u32 count, SimdLevel level)
+{
+  assert(has_simd(level) && "Unsupported SIMD level");
+
+  switch (level) {
+#if defined(ATOM_AVX2)
+    case SimdLevel::AVX2:
+      convert_avx2(output, accumulator, count);
+      break;
+#endif
+#if defined(ATOM_SSE)
+    case SimdLevel::SSE:
+      convert_sse(output, accumulator, count);
+      break;
+#endif
+    default:
+      convert_scalar(output, accumulator, count);
+      break;
+  }
+}
+
+AudioMixer::AudioMixer(SimdLevel level)
+  : my_commands(AUDIO_COMMAND_QUEUE_SIZE)
+  , my_released(AUDIO_COMMAND_QUEUE_SIZE)
+  , my_accumulator(AUDIO_SAMPLES * AUDIO_CHANNELS)
+  , my_stream_samples(my_accumulator.size())
+  , my_simd(level)
+{
+  // audio thread doesn't allocate
+  my_tracks.reserve(AUDIO_MAX_TRACKS);
+  my_voices.reserve(AUDIO_MAX_TRACKS);
+}
+
+bool AudioMixer::push(AudioCommand &&command)
+{
+  return my_commands.push(std::move(command));
+}
+
+void AudioMixer::collect()
+{
+  Track track;
+
+  while (my_released.pop(track)) {
+    track.sound.reset();
+    track.stream.reset();
+  }
+}
+
+void AudioMixer::release_track(u32 index)
+{
+  Track &track = my_tracks[index];
+  // full queue releases the sound here
+  my_released.push(std::move(track));
+  track = std::move(my_tracks.back());
+  my_tracks.pop_back();
+}
+
+void AudioMixer::process_commands()
+{
+  AudioCommand command;
+
+  while (my_commands.pop(command)) {
+    auto found = std::find_if(my_tracks.begin(), my_tracks.end(),
+      [&command](const Track &track) { return track.id == command.id; });
+
+    switch (command.type) {
+      case AudioCommandType::PLAY:
+        if (my_tracks.size() < AUDIO_MAX_TRACKS &&
+            (command.sound != nullptr || command.stream != nullptr)) {
+          Track track = Track();
+          track.id = command.id;
+          track.repeat = command.repeat && command.stream == nullptr;
+          track.volume = command.volume;
+          track.spatial = command.spatial;
+          track.emitter = command.emitter;
+
+          if (command.sound != nullptr) {
+            const Sound &sound = command.sound->sound();
+            track.samples = sound.samples();
+            track.count = sound.sample_count();
+          }
+
+          track.sound = std::move(command.sound);
+          track.stream = std::move(command.stream);
+          my_tracks.push_back(std::move(track));
+        } else {
+          Track track = Track();
+          track.sound = std::move(command.sound);
+          track.stream = std::move(command.stream);
+          my_released.push(std::move(track));
+        }
+        break;
+
+      case AudioCommandType::STOP:
+        if (found != my_tracks.end()) {
+          release_track(found - my_tracks.begin());
+        }
+        break;
+
+      case AudioCommandType::VOLUME:
+        if (found != my_tracks.end()) {
+          found->volume = command.volume;
+        }
+        break;
+
+      case AudioCommandType::EMITTER:
+        if (found != my_tracks.end()) {
+          found->spatial = true;
+          found->emitter = command.emitter;
+        }
+        break;
+
+      case AudioCommandType::LISTENER:
+        my_listener = command.listener;
+        break;
+
+      case AudioCommandType::CLEAR:
+        while (!my_tracks.empty()) {
+          release_track(my_tracks.size() - 1);
+        }
+        break;
+    }
+  }
+}
+
+void AudioMixer::select_voices()
+{
+  my_voices.clear();
+
+  for (u32 t = 0; t < my_tracks.size(); ++t) {
+    Track &track = my_tracks[t];
+    track.gain = track.spatial ? spatialize(my_listener, track.emitter, track.volume)
+                               : AudioGain{track.volume, track.volume, 1};
+    track.audible = false;
+
+    if (std::max(track.gain.left, track.gain.right) > AUDIO_AUDIBLE_GAIN) {
+      my_voices.push_back(t);
+    }
+  }
+
+  if (my_voices.size() > AUDIO_MAX_VOICES) {
+    auto louder = [this](u32 a, u32 b)
+    {
+      const AudioGain &ga = my_tracks[a].gain;
+      const AudioGain &gb = my_tracks[b].gain;
+      return std::max(ga.left, ga.right) > std::max(gb.left, gb.right);
+    };
+
+    std::nth_element(my_voices.begin(), my_voices.begin() + AUDIO_MAX_VOICES - 1,
+      my_voices.end(), louder);
+    my_voices.resize(AUDIO_MAX_VOICES);
+  }
+
+  for (u32 t : my_voices) {
+    my_tracks[t].audible = true;
+  }
+}
+
+bool AudioMixer::advance(Track &track, u32 frames)
+{
+  u32 track_frames = track.count / AUDIO_CHANNELS;
+  f64 cursor = track.position / AUDIO_CHANNELS + track.phase + f64(frames) * track.gain.pitch;
+
+  if (cursor >= track_frames) {
+    if (!track.repeat || track_frames == 0) {
+      return true;
+    }
+
+    cursor = std::fmod(cursor, f64(track_frames));
+  }
+
+  track.position = static_cast<u32>(cursor) * AUDIO_CHANNELS;
+  track.phase = cursor - std::floor(cursor);
+  return false;
+}
+
+bool AudioMixer::mix_resampled(Track &track, f32 *accumulator, u32 frames)
+{
+  u32 track_frames = track.count / AUDIO_CHANNELS;
+  f64 cursor = track.position / AUDIO_CHANNELS + track.phase;
+  const f32 *samples = track.samples;
+
+  for (u32 f = 0; f < frames; ++f) {
+    if (cursor >= track_frames) {
+      if (!track.repeat || track_frames == 0) {
+        return true;
+      }
+
+      cursor = std::fmod(cursor, f64(track_frames));
+    }
+
+    u32 i = static_cast<u32>(cursor);
+    f32 t = cursor - i;
+    // the last frame is held at the end of not repeated track
+    u32 j = i + 1 < track_frames ? i + 1 : (track.repeat ? 0 : i);
+    f32 left = samples[2 * i] + (samples[2 * j] - samples[2 * i]) * t;
+    f32 right = samples[2 * i + 1] + (samples[2 * j + 1] - samples[2 * i + 1]) * t;
+    accumulator[2 * f] += left * track.gain.left;
+    accumulator[2 * f + 1] += right * track.gain.right;
+    cursor += track.gain.pitch;
+  }
+
+  if (cursor >= track_frames) {
+    if (!track.repeat || track_frames == 0) {
+      return true;
+    }
+
+    cursor = std::fmod(cursor, f64(track_frames));
+  }
+
+  track.position = static_cast<u32>(cursor) * AUDIO_CHANNELS;
+  track.phase = cursor - std::floor(cursor);
+  return false;
+}
+
+bool AudioMixer::mix_track(Track &track, f32 *accumulator, u32 count)
+{
+  if (track.stream != nullptr) {
+    // late decoding is silent, the stream continues in the next buffer,
+    // virtual stream is read too, so it stays in sync
+    u32 n = track.stream->read(my_stream_samples.data(), count);
+
+    if (track.audible) {
+      mix_accumulate(accumulator, my_stream_samples.data(), n, track.gain.left,
+        track.gain.right, my_simd);
+    }
+
+    return track.stream->is_stream_finished();
+  }
+
+  if (!track.audible) {
+    return advance(track, count / AUDIO_CHANNELS);
+  }
+
+  if (track.gain.pitch != 1) {
+    return mix_resampled(track, accumulator, count / AUDIO_CHANNELS);
+  }
+
+  u32 done = 0;
+  track.phase = 0;
+
+  while (done < count && track.position < track.count) {
+    u32 n = std::min(track.count - track.position, count - done);
+    mix_accumulate(accumulator + done, track.samples + track.position, n, track.gain.left,
+      track.gain.right, my_simd);
+    done += n;
+    track.position += n;
+
+    if (track.position == track.count && track.repeat) {
+      track.position = 0;
+    }
+  }
+
+  return track.position >= track.count;
+}
+
+void AudioMixer::mix_chunk(i16 *output, u32 count)
+{
+  f32 *accumulator = my_accumulator.data();
+  std::fill(accumulator, accumulator + count, 0.0f);
+  select_voices();
+
+  for (u32 t = 0; t < my_tracks.size(); ) {
+    if (mix_track(my_tracks[t], accumulator, count)) {
+      release_track(t);
+    } else {
+      ++t;
+    }
+  }
+
+  mix_convert(output, accumulator, count, my_simd);
+}
+
+void AudioMixer::mix(i16 *output, u32 count)
+{
+  process_commands();
+
+  while (count > 0) {
+    u32 chunk = std::min<u32>(count, my_accumulator.size());
+    mix_chunk(output, chunk);
+    output += chunk;
+    count -= chunk;
+  }
+}
+
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <vector>
+#include "corefwd.h"
+#include "cpu.h"
+#include "audio_spatial.h"
+#include "spsc_queue.h"
+
+namespace atom {
+
+enum class AudioCommandType {
+  PLAY,
+  STOP,
+  VOLUME,
+  EMITTER,    ///< move the track source
+  LISTENER,
+  CLEAR
+};
+
+/**
+ * Request of the game thread, applied by the mixer before the next mixed buffer.
+ */
+struct AudioCommand {
+  AudioCommandType type;
+  u32              id;
+  f32              volume;
+  bool             repeat;
+  bool             spatial;   ///< PLAY with emitter
+  AudioEmitter     emitter;   ///< PLAY & EMITTER
+  AudioListener    listener;
+  SoundResourcePtr sound;   ///< PLAY of the sound
+  AudioStreamPtr   stream;  ///< PLAY of the stream (AudioDecoder fills it)
+
+  AudioCommand()
+    : type(AudioCommandType::CLEAR)
+    , id(0)
+    , volume(1)
+    , repeat(false)
+    , spatial(false)
+  {
+    // empty
+  }
+};
+
+/**
+ * Mixer of AudioService without an audio device. Track list is owned by the
+ * mixing (audio callback) thread, game thread changes it only by commands, so
+ * neither thread waits for the other. Ended tracks are returned to the game
+ * thread and their sounds and streams are released in collect(), audio thread
+ * doesn't free resources (unless the game thread stops collecting).
+ *
+ * Sounds and streams are already in the mixer format (stereo floats in 16bit
+ * range, AUDIO_FREQUENCY), they are accumulated without conversion and the
+ * sum is converted to i16 with saturation.
+ *
+ * Spatial tracks are panned, attenuated and pitch shifted (Doppler) by their
+ * emitter and the listener. Only AUDIO_MAX_VOICES loudest audible tracks are
+ * mixed, the other ones are virtual, only their playback position advances.
+ * Streams don't support pitch shift.
+ */
+class AudioMixer : NonCopyable {
+  struct Track {
+    u32              id;
+    bool             repeat;
+    f32              volume;
+    u32              position;  ///< next sample
+    const f32       *samples;   ///< interleaved stereo
+    u32              count;
+    SoundResourcePtr sound;
+    AudioStreamPtr   stream;    ///< replaces samples
+    f32              phase;     ///< fraction of the frame after position (pitch shift)
+    bool             spatial;
+    bool             audible;   ///< mixed in the current chunk
+    AudioEmitter     emitter;
+    AudioGain        gain;
+  };
+
+  SpscQueue<AudioCommand>     my_commands;    ///< game thread -> audio thread
+  SpscQueue<Track>            my_released;    ///< audio thread -> game thread
+  std::vector<Track>          my_tracks;      ///< audio thread only
+  std::vector<f32>            my_accumulator;
+  std::vector<f32>            my_stream_samples;  ///< samples read from a stream
+  std::vector<u32>            my_voices;      ///< audible tracks of the chunk
+  AudioListener               my_listener;
+  SimdLevel                   my_simd;
+
+  void process_commands();
+
+  /**
+   * Compute gains and select mixed tracks.
+   */
+  void select_voices();
+
+  void mix_chunk(i16 *output, u32 count);
+
+  /**
+   * @return track ended
+   */
+  bool mix_track(Track &track, f32 *accumulator, u32 count);
+
+  /**
+   * Mix with pitch shift (linear interpolation).
+   *
+   * @return track ended
+   */
+  bool mix_resampled(Track &track, f32 *accumulator, u32 frames);
+
+  /**
+   * Move the position of virtual track.
+   *
+   * @return track ended
+   */
+  bool advance(Track &track, u32 frames);
+
+  void release_track(u32 index);
+
+public:
+  explicit AudioMixer(SimdLevel level = simd_level());
+
+  /**
+   * Game thread only.
+   *
+   * @return false when the command queue is full, command is dropped
+   */
+  bool push(AudioCommand &&command);
+
+  /**
+   * Release sounds and streams of ended tracks, game thread only.
+   */
+  void collect();
+
+  /**
+   * Mix playing tracks to @p output, audio thread only.
+   *
+   * @param count sample count of all channels
+   */
+  void mix(i16 *output, u32 count);
+
+  /**
+   * Playing tracks, audio thread only.
+   */
+  u32 track_count() const
+  {
+    return my_tracks.size();
+  }
+
+  /**
+   * Tracks mixed in the last chunk, audio thread only.
+   */
+  u32 voice_count() const
+  {
+    return my_voices.size();
+  }
+};
+
+/**
+ * accumulator[i] += samples[i] * (i is even ? left : right), interleaved stereo
+ */
+void mix_accumulate(f32 *accumulator, const f32 *samples, u32 count, f32 left, f32 right,
+  SimdLevel level);
+
+/**
+ * accumulator[i] += samples[i] * volume
+ */
+inline void mix_accumulate(f32 *accumulator, const f32 *samples, u32 count, f32 volume,
+  SimdLevel level)
+{
+  mix_accumulate(accumulator, samples, count, volume, volume, level);
+}
+
+/**
+ * Round accumulated samples to i16, out of range values saturate.
+ */
+void mix_convert(i16 *output, const f32 *accumulator, u32 count, SimdLevel level);
+
+}
@@ -0,0 +1,53 @@
+#include "audio_processor.h"
+#include "audio_component.h"
+#include "audio_service.h"
+#include "core.h"
+#include "constants.h"
+#include "world.h"
+
+namespace atom {
+
+AudioProcessor::AudioProcessor(World &world)
+  : NullProcessor(world)
+  , my_has_listener(false)
+{
+
+}
+
+AudioProcessor::~AudioProcessor()
+{
+
+}
+
+void AudioProcessor::activate()
+{
+  my_has_listener = false;
+}
+
+void AudioProcessor::poll()
+{
+  const f32 dt = 1.0f / FPS;
+  AudioService &audio = core().audio_service();
+
+  // camera position is the translation of the inverted view matrix, x axis points right
+  Mat4f inverted_view = world().camera().view.inverted();
+  Vec3f position(inverted_view(0, 3), inverted_view(1, 3), inverted_view(2, 3));
+  AudioListener listener;
+  listener.position = position;
+  listener.right = Vec3f(inverted_view(0, 0), inverted_view(1, 0), inverted_view(2, 0));
+  listener.velocity = my_has_listener ? (position - my_listener.position) * (1 / dt) : Vec3f();
+
+  if (!my_has_listener || listener.position != my_listener.position ||
+      listener.right != my_listener.right || listener.velocity != my_listener.velocity) {
+    audio.set_listener(listener);
+  }
+
+  my_listener = listener;
+  my_has_listener = true;
+
+  for (AudioComponent *component : world().components<AudioComponent>()) {
+    component->update(audio, dt);
+  }
+}
+
+}
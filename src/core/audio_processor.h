@@ -0,0 +1,26 @@
+#pragma once
+
+#include "processor.h"
+#include "audio_spatial.h"
+
+namespace atom {
+
+/**
+ * Move the audio listener with the world camera and emitters of all
+ * AudioComponents with their entities. Commands of AudioService have a single
+ * producer, so it runs serially with the other processors.
+ */
+class AudioProcessor : public NullProcessor {
+  AudioListener my_listener;
+  bool          my_has_listener;   ///< my_listener is valid (velocity)
+
+public:
+  explicit AudioProcessor(World &world);
+  ~AudioProcessor();
+
+  void activate() override;
+
+  void poll() override;
+};
+
+}
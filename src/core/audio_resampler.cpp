@@ -0,0 +1,174 @@
+#include "audio_resampler.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "constants.h"
+
+namespace atom {
+
+namespace {
+
+f64 sinc(f64 x)
+{
+  return x == 0 ? 1 : std::sin(PI * x) / (PI * x);
+}
+
+f64 blackman(f64 u)
+{
+  return 0.42 - 0.5 * std::cos(2 * PI * u) + 0.08 * std::cos(4 * PI * u);
+}
+
+}
+
+AudioResampler::AudioResampler(u32 input_rate, u32 output_rate, ResampleQuality quality)
+  : my_step(f64(input_rate) / output_rate)
+  , my_before(0)
+  , my_after(0)
+{
+  assert(input_rate > 0 && output_rate > 0);
+
+  if (input_rate == output_rate) {
+    // passthrough
+  } else if (quality == ResampleQuality::LINEAR) {
+    my_after = 1;
+  } else {
+    my_before = RESAMPLE_TAPS / 2 - 1;
+    my_after = RESAMPLE_TAPS / 2;
+    f64 cutoff = std::min(1.0, f64(output_rate) / input_rate);
+    my_filter.resize((RESAMPLE_PHASES + 1) * RESAMPLE_TAPS);
+
+    for (u32 p = 0; p <= RESAMPLE_PHASES; ++p) {
+      f32 *row = &my_filter[p * RESAMPLE_TAPS];
+      f64 frac = f64(p) / RESAMPLE_PHASES;
+      f64 sum = 0;
+
+      for (u32 k = 0; k < RESAMPLE_TAPS; ++k) {
+        // distance of the tap from the interpolated position
+        f64 x = f64(k) - my_before - frac;
+        f64 h = cutoff * sinc(cutoff * x) * blackman((x + RESAMPLE_TAPS / 2) / RESAMPLE_TAPS);
+        row[k] = h;
+        sum += h;
+      }
+
+      // unit gain of DC, rows don't differ in loudness
+      for (u32 k = 0; k < RESAMPLE_TAPS; ++k) {
+        row[k] /= sum;
+      }
+    }
+  }
+
+  reset();
+}
+
+void AudioResampler::reset()
+{
+  // silence before the first frame
+  my_history.assign(my_before * AUDIO_CHANNELS, 0.0f);
+  my_position = my_before;
+  my_end = F64_MAX;
+}
+
+void AudioResampler::push(const f32 *input, u32 frames)
+{
+  assert(my_end == F64_MAX && "Push after flush");
+  my_history.insert(my_history.end(), input, input + frames * AUDIO_CHANNELS);
+}
+
+void AudioResampler::flush()
+{
+  my_end = my_history.size() / AUDIO_CHANNELS;
+  my_history.resize(my_history.size() + my_after * AUDIO_CHANNELS, 0.0f);
+}
+
+u32 AudioResampler::pull(f32 *output, u32 frames)
+{
+  const u32 available = my_history.size() / AUDIO_CHANNELS;
+  const f32 *history = my_history.data();
+  u32 done = 0;
+
+  while (done < frames && my_position < my_end) {
+    u32 i = static_cast<u32>(my_position);
+
+    if (i + my_after >= available) {
+      break;
+    }
+
+    f32 *out = output + done * AUDIO_CHANNELS;
+    f32 frac = my_position - i;
+
+    if (my_filter.empty()) {
+      // passthrough (frac is 0) or linear
+      const f32 *a = history + i * AUDIO_CHANNELS;
+      const f32 *b = history + (i + my_after) * AUDIO_CHANNELS;
+      out[0] = a[0] + (b[0] - a[0]) * frac;
+      out[1] = a[1] + (b[1] - a[1]) * frac;
+    } else {
+      u32 phase = static_cast<u32>(frac * RESAMPLE_PHASES + 0.5f);
+      const f32 *row = &my_filter[phase * RESAMPLE_TAPS];
+      const f32 *in = history + (i - my_before) * AUDIO_CHANNELS;
+      f32 left = 0;
+      f32 right = 0;
+
+      for (u32 k = 0; k < RESAMPLE_TAPS; ++k) {
+        left += in[2 * k] * row[k];
+        right += in[2 * k + 1] * row[k];
+      }
+
+      out[0] = left;
+      out[1] = right;
+    }
+
+    my_position += my_step;
+    ++done;
+  }
+
+  // drop frames which can't be used by the next output
+  u32 first = static_cast<u32>(my_position);
+  u32 drop = first > my_before ? std::min(first - my_before, available) : 0;
+
+  if (drop > 0) {
+    my_history.erase(my_history.begin(), my_history.begin() + drop * AUDIO_CHANNELS);
+    my_position -= drop;
+    my_end -= my_end == F64_MAX ? 0 : drop;
+  }
+
+  return done;
+}
+
+void audio_to_stereo(const i16 *input, u32 frames, u32 channels, f32 *output)
+{
+  assert(channels == 1 || channels == 2);
+
+  if (channels == 1) {
+    for (u32 i = 0; i < frames; ++i) {
+      output[2 * i] = input[i];
+      output[2 * i + 1] = input[i];
+    }
+  } else {
+    std::copy(input, input + 2 * frames, output);
+  }
+}
+
+std::vector<f32> convert_audio(const i16 *samples, u32 count, u32 channels, u32 sample_rate,
+  ResampleQuality quality)
+{
+  u32 frames = count / channels;
+  std::vector<f32> stereo(frames * AUDIO_CHANNELS);
+  audio_to_stereo(samples, frames, channels, stereo.data());
+
+  if (sample_rate == u32(AUDIO_FREQUENCY)) {
+    return stereo;
+  }
+
+  AudioResampler resampler(sample_rate, AUDIO_FREQUENCY, quality);
+  resampler.push(stereo.data(), frames);
+  resampler.flush();
+
+  // one more for rounding
+  std::vector<f32> result((u64(frames) * AUDIO_FREQUENCY / sample_rate + 1) * AUDIO_CHANNELS);
+  u32 converted = resampler.pull(result.data(), result.size() / AUDIO_CHANNELS);
+  result.resize(converted * AUDIO_CHANNELS);
+  return result;
+}
+
+}
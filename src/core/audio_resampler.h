@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include "foundation.h"
+
+namespace atom {
+
+const u32 RESAMPLE_TAPS = 16;     ///< length of the windowed sinc filter (frames)
+const u32 RESAMPLE_PHASES = 256;  ///< fractional positions of the polyphase filter table
+
+enum class ResampleQuality {
+  LINEAR,   ///< fast, high frequencies alias
+  SINC      ///< polyphase windowed sinc (Blackman window)
+};
+
+/**
+ * Streaming sample rate converter of interleaved stereo float frames. Input
+ * is pushed in arbitrary pieces, output is pulled when enough following
+ * input frames are known. Output frame n is the input interpolated at
+ * n * input_rate / output_rate, equal rates only copy frames.
+ *
+ * Downsampling filter cuts off at the output Nyquist frequency.
+ */
+class AudioResampler : NonCopyable {
+  f64              my_step;       ///< input frames per output frame
+  u32              my_before;     ///< input frames needed before the interpolated position
+  u32              my_after;      ///< and after it
+  std::vector<f32> my_filter;     ///< RESAMPLE_PHASES + 1 rows of RESAMPLE_TAPS coefficients
+  std::vector<f32> my_history;    ///< interleaved stereo input not needed yet
+  f64              my_position;   ///< next output frame in my_history
+  f64              my_end;        ///< end of the input in my_history (after flush)
+
+public:
+  AudioResampler(u32 input_rate, u32 output_rate, ResampleQuality quality);
+
+  /**
+   * Forget the input (seek), rates and quality are kept.
+   */
+  void reset();
+
+  void push(const f32 *input, u32 frames);
+
+  /**
+   * End of the input, the last frames can be pulled.
+   */
+  void flush();
+
+  /**
+   * @return frames written to @p output, less than @p frames when more input is needed
+   */
+  u32 pull(f32 *output, u32 frames);
+
+  bool is_passthrough() const
+  {
+    return my_step == 1;
+  }
+};
+
+/**
+ * Convert interleaved 16bit mono or stereo samples to stereo floats (16bit
+ * range), the mixer format.
+ *
+ * @param output 2 * frames floats
+ */
+void audio_to_stereo(const i16 *input, u32 frames, u32 channels, f32 *output);
+
+/**
+ * Convert the whole sound to the mixer format (stereo floats, AUDIO_FREQUENCY).
+ *
+ * @param count sample count of all channels
+ */
+std::vector<f32> convert_audio(const i16 *samples, u32 count, u32 channels, u32 sample_rate,
+  ResampleQuality quality);
+
+}
@@ -1,8 +1,8 @@
 #include "audio_service.h"
 #include <SDL/SDL.h>
-#include <algorithm>
 #include "resources.h"
 #include "sound.h"
+#include "config.h"
 #include "log.h"
 
 namespace atom {
@@ -13,7 +13,6 @@ AudioService::AudioService()
 {
   // SDL_Init bolo zavolane uz v coreovi
   SDL_AudioSpec desired;
-  SDL_AudioSpec obtained;
   desired.channels = AUDIO_CHANNELS;
   desired.format = AUDIO_S16;
   desired.freq = AUDIO_FREQUENCY;
@@ -22,85 +21,52 @@ AudioService::AudioService()
   desired.callback = AudioService::mix;
   desired.userdata = this;
 
-  if (SDL_OpenAudio(&desired, &obtained) != 0) {
+  // without obtained spec SDL converts the mixed buffer to the device format
+  if (SDL_OpenAudio(&desired, nullptr) != 0) {
     log_error("Can't initialize audio");
     return;
   }
 
-  if (obtained.freq != AUDIO_FREQUENCY || obtained.channels != AUDIO_CHANNELS) {
-    log_error("Your sound card doesn't support frequency 44100 stereo sound!");
-    return;
-  }
-
-  // init buffer
-  my_buffer.resize(obtained.size / AUDIO_SAMPLE_SIZE, 0);
-
   log_info("Audio initialized");
   SDL_PauseAudio(0);
 }
 
 AudioService::~AudioService()
 {
+  // callback uses the mixer
+  SDL_CloseAudio();
 }
 
 void AudioService::mix_audio(u8 *buffer, u32 len)
 {
-  assert(len == my_buffer.size() * AUDIO_SAMPLE_SIZE);
   log_debug(DEBUG_AUDIO, "Audio buffer size %i bytes", len);
+  my_mixer.mix(reinterpret_cast<i16 *>(buffer), len / AUDIO_SAMPLE_SIZE);
 
-  if (my_sounds.empty()) {
-    return;
-  }
-
-  memset(buffer, 0, len);
-
-  i16 *dst = reinterpret_cast<i16 *>(buffer);
-
-  u32 buffer_samples = my_buffer.size();
-  u32 buffer_size = buffer_samples * AUDIO_SAMPLE_SIZE;
-
-  std::lock_guard<std::mutex> lock(my_mutex);
-
-  for (AudioTrack &stream : my_sounds) {
-    if (stream.stopped) {
-      continue;
-    }
-
-    u32 bytes = stream.sound->sound().read_old(&my_buffer[0], stream.offset, buffer_size);
-    stream.offset += bytes;
-
-    while (stream.repeat && bytes < buffer_size) {
-      int ret = stream.sound->sound().read_old(&my_buffer[bytes / 2], 0, buffer_size - bytes);
-      bytes += ret;
-      stream.offset = ret;
-    }
-
-    int count = bytes / 2;
+//  mix_test_audio(buffer, len);
+}
 
-    for (int i = 0; i < count; ++i) {
-      i32 a = my_buffer[i];
-      i32 b = dst[i];
+u32 AudioService::send(AudioCommand &&command)
+{
+  u32 id = command.id;
 
-      if (a < 0 && b < 0) {
-        dst[i] = (a + b) - (a * b) / I16_MIN;
-      } else if (a > 0 && b > 0) {
-        dst[i] = (a + b) - (a * b) / I16_MAX;
-      } else {
-        dst[i] = a + b;
-      }
-    }
+  if (!my_mixer.push(std::move(command))) {
+    log_warning("Audio command queue is full");
+    return INVALID_ID;
   }
 
-  // remove ended streams
-
-//  mix_test_audio(buffer, len);
-
+  return id;
 }
 
 void AudioService::clear()
 {
-  std::lock_guard<std::mutex> lock(my_mutex);
-  my_sounds.clear();
+  AudioCommand command;
+  command.type = AudioCommandType::CLEAR;
+  send(std::move(command));
+}
+
+void AudioService::update()
+{
+  my_mixer.collect();
 }
 
 void AudioService::mix_test_audio(u8 *buffer, u32 len)
@@ -126,37 +92,89 @@ void AudioService::mix(void *service, u8 *buffer, int len)
   reinterpret_cast<AudioService *>(service)->mix_audio(buffer, len);
 }
 
-AudioService::AudioTrack* AudioService::find_track(u32 id)
+u32 AudioService::play(const SoundResourcePtr &sound, bool repeat)
 {
-  std::lock_guard<std::mutex> lock(my_mutex);
-  auto found = std::find_if(my_sounds.begin(), my_sounds.end(),
-    [id](const AudioTrack &stream) { return stream.id == id; });
-
-  return found != my_sounds.end() ? &(*found) : nullptr;
+  assert(sound != nullptr);
+  AudioCommand command;
+  command.type = AudioCommandType::PLAY;
+  command.id = my_next_id++;
+  command.repeat = repeat;
+  command.sound = sound;
+  return send(std::move(command));
 }
 
-u32 AudioService::play(const SoundResourcePtr &sound, bool repeat)
+u32 AudioService::play(const SoundResourcePtr &sound, const AudioEmitter &emitter, bool repeat)
 {
   assert(sound != nullptr);
-  AudioTrack stream;
-  stream.id = my_next_id++;
-  stream.repeat = repeat;
-  stream.stopped = false;
-  stream.offset = 0;
-  stream.sound = sound;
-  std::lock_guard<std::mutex> lock(my_mutex);
-  my_sounds.push_back(stream);
+  AudioCommand command;
+  command.type = AudioCommandType::PLAY;
+  command.id = my_next_id++;
+  command.repeat = repeat;
+  command.spatial = true;
+  command.emitter = emitter;
+  command.sound = sound;
+  return send(std::move(command));
+}
 
-  return stream.id;
+u32 AudioService::play(const MusicResourcePtr &music, bool repeat)
+{
+  assert(music != nullptr);
+  // each playback has its own decoder
+  uptr<Music> decoder = Music::create_from_file(music->music().filename().c_str());
+
+  if (decoder == nullptr) {
+    return INVALID_ID;
+  }
+
+  ResampleQuality quality = Config::instance().linear_resampling ? ResampleQuality::LINEAR
+                                                                 : ResampleQuality::SINC;
+  return play(std::make_shared<AudioStream>(std::move(decoder), repeat, quality));
+}
+
+u32 AudioService::play(const AudioStreamPtr &stream)
+{
+  assert(stream != nullptr);
+  my_decoder.add(stream);
+
+  AudioCommand command;
+  command.type = AudioCommandType::PLAY;
+  command.id = my_next_id++;
+  command.stream = stream;
+  return send(std::move(command));
 }
 
 void AudioService::stop(u32 id)
 {
-  std::lock_guard<std::mutex> lock(my_mutex);
-  auto start = std::remove_if(my_sounds.begin(), my_sounds.end(),
-    [id](AudioTrack &stream) { return stream.id == id; });
+  AudioCommand command;
+  command.type = AudioCommandType::STOP;
+  command.id = id;
+  send(std::move(command));
+}
+
+void AudioService::set_volume(u32 id, f32 volume)
+{
+  AudioCommand command;
+  command.type = AudioCommandType::VOLUME;
+  command.id = id;
+  command.volume = volume;
+  send(std::move(command));
+}
 
-  my_sounds.erase(start, my_sounds.end());
+void AudioService::set_emitter(u32 id, const AudioEmitter &emitter)
+{
+  AudioCommand command;
+  command.type = AudioCommandType::EMITTER;
+  command.id = id;
+  command.emitter = emitter;
+  send(std::move(command));
+}
+
+void AudioService::set_listener(const AudioListener &listener)
+{
+  AudioCommand command;
+  command.type = AudioCommandType::LISTENER;
+  command.listener = listener;
+  send(std::move(command));
 }
 
 }
@@ -1,9 +1,8 @@
 #pragma once
 
-#include <deque>
-#include <mutex>
 #include "music.h"
 #include "audio_stream.h"
+#include "audio_mixer.h"
 #include "foundation.h"
 #include "singleton.h"
 #include "core.h"
@@ -20,25 +19,60 @@ public:
   AudioService();
   ~AudioService();
 
+  /**
+   * Commands are delivered to the audio thread through a wait-free queue,
+   * methods never wait for the mixing.
+   *
+   * @return track id or INVALID_ID when the command queue is full
+   */
   u32 play(const SoundResourcePtr &sound, bool repeat = false);
 
+  /**
+   * Play the sound positioned in the world, see set_listener.
+   */
+  u32 play(const SoundResourcePtr &sound, const AudioEmitter &emitter, bool repeat = false);
+
+  /**
+   * Stream the music, it is decoded ahead of the playback on the decoder thread.
+   */
+  u32 play(const MusicResourcePtr &music, bool repeat = false);
+
+  /**
+   * Play the stream (e.g. with loop points), it can be seeked while playing.
+   */
+  u32 play(const AudioStreamPtr &stream);
+
   void stop(u32 id);
 
+  /**
+   * @param volume 1 is the original volume
+   */
+  void set_volume(u32 id, f32 volume);
+
+  /**
+   * Move the source of the track, it becomes spatial.
+   */
+  void set_emitter(u32 id, const AudioEmitter &emitter);
+
+  /**
+   * All spatial tracks are heard by this listener.
+   */
+  void set_listener(const AudioListener &listener);
+
   void clear(); // stop
 
+  /**
+   * Release sounds of ended tracks, call once per frame.
+   */
+  void update();
+
   // void pause();
 
 private:
-  struct AudioTrack {
-    u32              id;
-    bool             stopped;
-    bool             repeat;
-    u64              offset;
-    SoundResourcePtr sound;
-  };
-
-  // private definitions
-  typedef std::deque<AudioStream *> AudioStreamList;
+  /**
+   * @return track id or INVALID_ID
+   */
+  u32 send(AudioCommand &&command);
 
   void mix_audio(u8 *buffer, u32 len);
 
@@ -46,14 +80,11 @@ private:
 
   static void mix(void *service, u8 *buffer, int len);
 
-  AudioTrack* find_track(u32 id);
-
 private:
   u32                    my_next_id;
   u32                    my_counter;
-  std::deque<AudioTrack> my_sounds;
-  std::vector<i16>       my_buffer;  ///< sample buffer
-  std::mutex             my_mutex;
+  AudioMixer             my_mixer;
+  AudioDecoder           my_decoder;
 
 private:
   friend class Core;
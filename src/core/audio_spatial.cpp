@@ -0,0 +1,60 @@
+#include "audio_spatial.h"
+#include <algorithm>
+#include <cmath>
+
+namespace atom {
+
+f32 audio_attenuation(const AudioEmitter &emitter, f32 distance)
+{
+  f32 min_distance = std::max(emitter.min_distance, 0.001f);
+
+  if (distance >= emitter.max_distance) {
+    return 0;
+  }
+
+  if (distance <= min_distance) {
+    return 1;
+  }
+
+  switch (emitter.rolloff) {
+    case AudioRolloff::LINEAR:
+      return 1 - (distance - min_distance) / (emitter.max_distance - min_distance);
+
+    case AudioRolloff::INVERSE:
+    default:
+      return min_distance / distance;
+  }
+}
+
+AudioGain spatialize(const AudioListener &listener, const AudioEmitter &emitter, f32 volume)
+{
+  Vec3f offset = emitter.position - listener.position;
+  f32 distance = offset.length();
+  f32 gain = volume * audio_attenuation(emitter, distance);
+
+  if (distance < 1e-4f) {
+    // source in the head, both ears and no shift
+    f32 center = gain * std::sqrt(0.5f);
+    return AudioGain{center, center, 1};
+  }
+
+  Vec3f direction = offset * (1 / distance);
+  // pan -1 left, 1 right, sin/cos keeps the same power in all directions
+  f32 pan = std::min(std::max(dot3(direction, listener.right), -1.0f), 1.0f);
+  f32 angle = (pan + 1) * PI / 4;
+
+  // velocities towards each other raise the pitch
+  f32 listener_speed = dot3(listener.velocity, direction);
+  f32 emitter_speed = -dot3(emitter.velocity, direction);
+  f32 pitch = (SPEED_OF_SOUND + listener_speed) / std::max(SPEED_OF_SOUND - emitter_speed, 1.0f);
+  pitch = std::min(std::max(pitch, AUDIO_MIN_PITCH), AUDIO_MAX_PITCH);
+
+  // slow movement would send almost every spatial track to the scalar resampler
+  if (std::abs(pitch - 1) < AUDIO_PITCH_EPSILON) {
+    pitch = 1;
+  }
+
+  return AudioGain{gain * std::cos(angle), gain * std::sin(angle), pitch};
+}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "math.h"
+
+namespace atom {
+
+const f32 SPEED_OF_SOUND = 343.0f;    ///< units (meters) per second, Doppler shift
+const f32 AUDIO_MIN_PITCH = 0.5f;     ///< Doppler shift is clamped to <min, max>
+const f32 AUDIO_MAX_PITCH = 2.0f;
+const f32 AUDIO_PITCH_EPSILON = 0.005f;  ///< smaller shift (< 9 cents) is dropped, track is mixed without resampling
+
+enum class AudioRolloff {
+  INVERSE,    ///< min_distance / distance, like a point source
+  LINEAR      ///< linear fade from min_distance to max_distance
+};
+
+/**
+ * Sound source in world space. Sources farther than max_distance are
+ * inaudible (with both curves).
+ */
+struct AudioEmitter {
+  Vec3f        position;
+  Vec3f        velocity;       ///< units per second
+  f32          min_distance;   ///< full volume closer than this
+  f32          max_distance;
+  AudioRolloff rolloff;
+
+  AudioEmitter()
+    : min_distance(1)
+    , max_distance(100)
+    , rolloff(AudioRolloff::INVERSE)
+  {
+    // empty
+  }
+};
+
+/**
+ * Ears of the player, usually the world camera.
+ */
+struct AudioListener {
+  Vec3f position;
+  Vec3f right;      ///< unit vector to the right ear
+  Vec3f velocity;   ///< units per second
+
+  AudioListener()
+    : right(1, 0, 0)
+  {
+    // empty
+  }
+};
+
+/**
+ * Mixing parameters of one source.
+ */
+struct AudioGain {
+  f32 left;
+  f32 right;
+  f32 pitch;    ///< playback speed, 1 is the original one
+};
+
+/**
+ * Volume of the emitter at the distance, <0, 1>.
+ */
+f32 audio_attenuation(const AudioEmitter &emitter, f32 distance);
+
+/**
+ * Constant power panning by the direction to the emitter, distance
+ * attenuation and Doppler shift.
+ */
+AudioGain spatialize(const AudioListener &listener, const AudioEmitter &emitter, f32 volume);
+
+}
@@ -1,41 +1,257 @@
 #include "audio_stream.h"
-
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include "log.h"
 
 namespace atom {
 
-AudioStream::AudioStream()
+AudioStream::AudioStream(uptr<AudioBuffer> &&buffer, bool loop, ResampleQuality quality)
+  : my_buffer(std::move(buffer))
+  , my_channels(0)
+  , my_frames(0)
+  , my_loop_start(0)
+  , my_loop_end(0)
+  , my_loop(loop)
+  , my_blocks(AUDIO_BUFFER_COUNT)
+  , my_free(AUDIO_BUFFER_COUNT)
+  , my_filled(AUDIO_BUFFER_COUNT)
+  , my_seek_frame(0)
+  , my_generation(0)
+  , my_finished(false)
+  , my_decoded_generation(0)
+  , my_position(0)
+  , my_end(false)
+  , my_source_end(false)
+  , my_wrapped(false)
+  , my_resampler(std::max(my_buffer->get_sample_rate(), 1), AUDIO_FREQUENCY, quality)
+  , my_pcm(AUDIO_DECODE_FRAMES * AUDIO_CHANNELS)
+  , my_decoded(AUDIO_DECODE_FRAMES * AUDIO_CHANNELS)
+  , my_current(U32_MAX)
+  , my_offset(0)
 {
+  assert(my_buffer != nullptr);
+  my_channels = my_buffer->get_channel_count();
+
+  if (my_channels != 1 && my_channels != 2) {
+    log_error("Unsupported audio stream channel count %u", my_channels);
+    my_end = true;
+    my_finished = true;
+  } else {
+    my_frames = my_buffer->get_size() / (my_channels * AUDIO_SAMPLE_SIZE);
+  }
+
+  for (u32 i = 0; i < AUDIO_BUFFER_COUNT; ++i) {
+    my_blocks[i].samples.resize(AUDIO_BUFFER_SIZE);
+    my_blocks[i].count = 0;
+    my_blocks[i].generation = 0;
+    my_blocks[i].last = false;
+    u32 index = i;
+    my_free.push(std::move(index));
+  }
 }
 
-AudioStream::~AudioStream()
+void AudioStream::set_loop_points(u32 start, u32 end)
 {
+  my_loop_start = std::min(start, my_frames);
+  my_loop_end = end > 0 ? std::min(end, my_frames) : 0;
 }
 
-void AudioStream::reset()
+void AudioStream::seek(u32 frame)
 {
+  my_seek_frame.store(frame, std::memory_order_relaxed);
+  my_generation.fetch_add(1, std::memory_order_release);
 }
 
-void AudioStream::set_audio_buffer(AudioBuffer *buffer)
+u32 AudioStream::decode(u32 frame, u32 count)
 {
+  u32 frame_size = my_channels * AUDIO_SAMPLE_SIZE;
+  int bytes = my_buffer->read_old(my_pcm.data(), frame * frame_size, count * frame_size);
+  u32 frames = bytes > 0 ? bytes / frame_size : 0;
+  audio_to_stereo(my_pcm.data(), frames, my_channels, my_decoded.data());
+  return frames;
 }
 
-void AudioStream::play()
+bool AudioStream::decode_next()
 {
+  u32 end = my_loop && my_loop_end > my_loop_start ? my_loop_end : my_frames;
+  u32 wanted = my_position < end ? std::min(AUDIO_DECODE_FRAMES, end - my_position) : 0;
+  u32 decoded = wanted > 0 ? decode(my_position, wanted) : 0;
+  my_position += decoded;
+
+  if (decoded > 0) {
+    my_resampler.push(my_decoded.data(), decoded);
+    my_wrapped = false;
+  }
+
+  if (decoded == wanted && my_position < end) {
+    return true;
+  }
+
+  // end of the buffer, loop or decoding error
+  if (my_loop && !my_wrapped) {
+    my_position = my_loop_start;
+    my_wrapped = true;
+    return true;
+  }
+
+  return false;
 }
 
-void AudioStream::pause()
+bool AudioStream::update()
 {
+  u32 generation = my_generation.load(std::memory_order_acquire);
+
+  if (generation != my_decoded_generation) {
+    my_decoded_generation = generation;
+    my_position = std::min(my_seek_frame.load(std::memory_order_relaxed), my_frames);
+    my_end = false;
+    my_source_end = false;
+    my_wrapped = false;
+    my_resampler.reset();
+  }
+
+  u32 index;
+
+  if (my_end || !my_free.pop(index)) {
+    return false;
+  }
+
+  Block &block = my_blocks[index];
+  block.generation = generation;
+  block.last = false;
+
+  u32 capacity = block.samples.size() / AUDIO_CHANNELS;
+  u32 frames = 0;
+
+  while (true) {
+    frames += my_resampler.pull(&block.samples[frames * AUDIO_CHANNELS], capacity - frames);
+
+    if (frames == capacity) {
+      break;
+    }
+
+    if (my_source_end) {
+      block.last = true;
+      my_end = true;
+      break;
+    }
+
+    if (!decode_next()) {
+      my_resampler.flush();
+      my_source_end = true;
+    }
+  }
+
+  block.count = frames * AUDIO_CHANNELS;
+  my_filled.push(std::move(index));
+  return true;
 }
 
-bool AudioStream::is_stream_finished()
+u32 AudioStream::read(f32 *output, u32 count)
 {
-  return true;
+  u32 done = 0;
+
+  while (done < count) {
+    if (my_current == U32_MAX) {
+      u32 index;
+
+      if (!my_filled.pop(index)) {
+        break;
+      }
+
+      my_current = index;
+      my_offset = 0;
+    }
+
+    Block &block = my_blocks[my_current];
+    // seek may come during the read, blocks decoded after it are kept
+    u32 generation = my_generation.load(std::memory_order_acquire);
+    u32 n = 0;
+
+    // block of the old position is dropped
+    if (block.generation == generation) {
+      n = std::min(block.count - my_offset, count - done);
+      memcpy(output + done, &block.samples[my_offset], n * sizeof(f32));
+      done += n;
+      my_offset += n;
+    }
+
+    if (block.generation != generation || my_offset == block.count) {
+      if (block.generation == generation && block.last) {
+        my_finished.store(true, std::memory_order_release);
+      }
+
+      u32 index = my_current;
+      my_current = U32_MAX;
+      my_free.push(std::move(index));
+
+      if (is_stream_finished()) {
+        break;
+      }
+    }
+  }
+
+  return done;
 }
 
-bool AudioStream::update()
+AudioDecoder::AudioDecoder()
+  : my_quit(false)
 {
-  return true;
+  my_thread = std::thread(&AudioDecoder::run, this);
+}
+
+AudioDecoder::~AudioDecoder()
+{
+  {
+    std::lock_guard<std::mutex> lock(my_mutex);
+    my_quit = true;
+  }
+
+  my_wakeup.notify_one();
+  my_thread.join();
+}
+
+void AudioDecoder::add(const AudioStreamPtr &stream)
+{
+  assert(stream != nullptr);
+
+  {
+    std::lock_guard<std::mutex> lock(my_mutex);
+    my_added.push_back(stream);
+  }
+
+  my_wakeup.notify_one();
+}
+
+void AudioDecoder::run()
+{
+  while (!my_quit.load()) {
+    {
+      std::lock_guard<std::mutex> lock(my_mutex);
+      my_streams.insert(my_streams.end(), my_added.begin(), my_added.end());
+      my_added.clear();
+    }
+
+    // decoding doesn't block add
+    bool busy = false;
+
+    for (const AudioStreamPtr &stream : my_streams) {
+      busy = stream->update() || busy;
+    }
+
+    // streams released by the mixer and the game
+    my_streams.erase(std::remove_if(my_streams.begin(), my_streams.end(),
+      [](const AudioStreamPtr &stream) { return stream.use_count() == 1; }),
+      my_streams.end());
+
+    if (!busy) {
+      // added stream wakes the thread up immediately
+      std::unique_lock<std::mutex> lock(my_mutex);
+      my_wakeup.wait_for(lock, std::chrono::milliseconds(AUDIO_DECODE_PERIOD),
+        [this] { return my_quit.load() || !my_added.empty(); });
+    }
+  }
 }
 
 }
@@ -1,27 +1,158 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "constants.h"
+#include "corefwd.h"
 #include "audio_buffer.h"
+#include "audio_resampler.h"
+#include "spsc_queue.h"
 
 namespace atom {
 
-const int AUDIO_BUFFER_COUNT = 3; ///< pocet OpenAL buffrov, pouzite v AudioStream
-const int AUDIO_BUFFER_SIZE = 16384; ///< velkost OpenAL medzipamate, pouzite v AudioStream
+const u32 AUDIO_BUFFER_COUNT = 4;     ///< decoded blocks of AudioStream (power of two)
+const u32 AUDIO_BUFFER_SIZE = 16384;  ///< samples of one block (interleaved stereo)
+const u32 AUDIO_DECODE_PERIOD = 10;   ///< idle AudioDecoder checks streams after this time (ms)
+const u32 AUDIO_DECODE_FRAMES = 1024; ///< frames read from AudioBuffer at once
+
+/**
+ * Playback of AudioBuffer (Music) decoded ahead in small blocks. Decoder
+ * thread fills free blocks (update), mixer reads the filled ones (read).
+ * Blocks are exchanged through wait-free queues, so the mixer never waits
+ * for decoding. Only AUDIO_BUFFER_COUNT blocks are in memory, independent
+ * of the track length.
+ *
+ * Blocks are in the mixer format, mono buffers are decoded to stereo and
+ * other sample rates are resampled to AUDIO_FREQUENCY on the decoder thread.
+ * Frames (seek, loop points, frame_count) are frames of the buffer.
+ */
+class AudioStream : NonCopyable {
+  struct Block {
+    std::vector<f32> samples;     ///< interleaved stereo
+    u32              count;       ///< decoded samples
+    u32              generation;  ///< blocks of older seeks are skipped
+    bool             last;        ///< end of the stream
+  };
+
+  uptr<AudioBuffer>  my_buffer;       ///< decoder thread only
+  u32                my_channels;     ///< channels of my_buffer
+  u32                my_frames;       ///< length of my_buffer
+  u32                my_loop_start;
+  u32                my_loop_end;
+  bool               my_loop;
+  std::vector<Block> my_blocks;
+  SpscQueue<u32>     my_free;         ///< mixer -> decoder
+  SpscQueue<u32>     my_filled;       ///< decoder -> mixer
+  std::atomic<u32>   my_seek_frame;
+  std::atomic<u32>   my_generation;   ///< incremented by each seek
+  std::atomic<bool>  my_finished;
+
+  // decoder thread
+  u32                my_decoded_generation;
+  u32                my_position;     ///< next decoded frame
+  bool               my_end;          ///< last block was decoded
+  bool               my_source_end;   ///< whole buffer was decoded, resampler is flushed
+  bool               my_wrapped;      ///< nothing decoded since the loop start
+  AudioResampler     my_resampler;
+  std::vector<i16>   my_pcm;          ///< samples read from my_buffer
+  std::vector<f32>   my_decoded;      ///< my_pcm in the mixer format
+
+  // mixer thread
+  u32                my_current;      ///< read block, U32_MAX none
+  u32                my_offset;       ///< next sample in my_current
+
+  /**
+   * Read frames of the buffer to my_decoded.
+   *
+   * @return decoded frames
+   */
+  u32 decode(u32 frame, u32 count);
+
+  /**
+   * Push next frames of the buffer (with looping) to the resampler.
+   *
+   * @return false at the end of the buffer or on error
+   */
+  bool decode_next();
 
-class AudioStream {
 public:
-  // public methods
-  AudioStream();
-  ~AudioStream();
-
-  void reset();
-  void set_audio_buffer(AudioBuffer *buffer);
-  void play();
-  void pause();
-  bool is_stream_finished();
+  /**
+   * @param loop play again from the loop start after the loop end
+   */
+  AudioStream(uptr<AudioBuffer> &&buffer, bool loop,
+    ResampleQuality quality = ResampleQuality::SINC);
+
+  /**
+   * Loop between frames, call it before the stream is played.
+   *
+   * @param end 0 is the end of the buffer
+   */
+  void set_loop_points(u32 start, u32 end);
+
+  /**
+   * Continue from the frame, can be called from any thread. Decoded blocks
+   * of the old position are dropped. Finished stream isn't restarted.
+   */
+  void seek(u32 frame);
+
+  void reset()
+  {
+    seek(0);
+  }
+
+  /**
+   * Decode one free block, decoder thread only.
+   *
+   * @return false when there was nothing to decode
+   */
   bool update();
 
-private:
+  /**
+   * Copy decoded samples, mixer thread only.
+   *
+   * @param count stereo sample count (even)
+   * @return copied samples, less than @p count when decoding is late or the stream ended
+   */
+  u32 read(f32 *output, u32 count);
+
+  bool is_stream_finished() const
+  {
+    return my_finished.load(std::memory_order_acquire);
+  }
+
+  u32 frame_count() const
+  {
+    return my_frames;
+  }
+};
+
+/**
+ * Worker thread decoding played streams. Stream is dropped when nobody else
+ * references it.
+ */
+class AudioDecoder : NonCopyable {
+  std::vector<AudioStreamPtr> my_streams;   ///< decoder thread only
+  std::vector<AudioStreamPtr> my_added;     ///< waiting for the thread
+  std::mutex                  my_mutex;     ///< guards my_added
+  std::condition_variable     my_wakeup;    ///< new stream or quit
+  std::atomic<bool>           my_quit;
+  std::thread                 my_thread;
+
+  void run();
+
+public:
+  AudioDecoder();
+
+  ~AudioDecoder();
+
+  /**
+   * Wake up the thread to decode the stream, its playback starts with the
+   * first decoded block (the caller doesn't wait for decoding).
+   */
+  void add(const AudioStreamPtr &stream);
 };
 
 }
@@ -0,0 +1,31 @@
+#include "bone_palette.h"
+
+namespace atom {
+
+void BonePalette::clear()
+{
+  my_bones.clear();
+  my_offsets.clear();
+}
+
+i32 BonePalette::add(const void *owner, const Slice<Mat4f> &bones)
+{
+  auto found = my_offsets.find(owner);
+
+  if (found != my_offsets.end()) {
+    return found->second;
+  }
+
+  i32 offset = my_bones.size();
+  my_bones.insert(my_bones.end(), bones.begin(), bones.end());
+  my_offsets[owner] = offset;
+  return offset;
+}
+
+i32 BonePalette::find(const void *owner) const
+{
+  auto found = my_offsets.find(owner);
+  return found != my_offsets.end() ? found->second : -1;
+}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "foundation.h"
+
+namespace atom {
+
+/**
+ * Bone matrices of all skeletons drawn in one frame. Palette is uploaded once
+ * (VideoService::set_bone_palette) and skinning shaders index it with
+ * Uniforms::bone_offset instead of per draw bone uniforms.
+ */
+class BonePalette {
+  std::vector<Mat4f>                     my_bones;
+  std::unordered_map<const void *, i32>  my_offsets;   ///< first bone of each skeleton
+
+public:
+  void clear();
+
+  /**
+   * Append bones of the skeleton, skeleton drawn several times is stored once.
+   *
+   * @param owner skeleton identity
+   * @return offset of the first bone in the palette
+   */
+  i32 add(const void *owner, const Slice<Mat4f> &bones);
+
+  /**
+   * @return offset of the skeleton or -1 when it isn't in the palette
+   */
+  i32 find(const void *owner) const;
+
+  Slice<Mat4f> bones() const
+  {
+    return Slice<Mat4f>(my_bones.data(), my_bones.size());
+  }
+};
+
+}
@@ -0,0 +1,131 @@
+#include "bvh.h"
+#include "intersect.h"
+
+namespace atom {
+
+void Bvh::build(const Slice<BoundingBox> &boxes, u32 leaf_size)
+{
+  assert(leaf_size > 0);
+  clear();
+  my_leaf_size = leaf_size;
+
+  if (boxes.size() == 0) {
+    return;
+  }
+
+  std::vector<Vec3f> centers(boxes.size());
+  my_primitives.resize(boxes.size());
+
+  for (u32 i = 0; i < boxes.size(); ++i) {
+    centers[i] = boxes[i].center();
+    my_primitives[i] = i;
+  }
+
+  my_nodes.reserve(2 * boxes.size() / leaf_size + 1);
+  build_node(boxes, centers, 0, boxes.size());
+}
+
+u32 Bvh::build_node(const Slice<BoundingBox> &boxes,
+  std::vector<Vec3f> &centers, u32 begin, u32 end)
+{
+  u32 node_index = my_nodes.size();
+  my_nodes.push_back(BvhNode());
+
+  BoundingBox box;
+  BoundingBox center_box;
+
+  for (u32 i = begin; i < end; ++i) {
+    box.extend(boxes[my_primitives[i]]);
+    center_box.extend(centers[my_primitives[i]]);
+  }
+
+  my_nodes[node_index].box = box;
+
+  if (end - begin <= my_leaf_size) {
+    my_nodes[node_index].index = begin;
+    my_nodes[node_index].count = end - begin;
+    return node_index;
+  }
+
+  // split by median along the longest axis of centroid bounds
+  Vec3f extent(center_box.xmax - center_box.xmin,
+    center_box.ymax - center_box.ymin, center_box.zmax - center_box.zmin);
+  u32 axis = 0;
+
+  if (extent.y > extent.x) {
+    axis = 1;
+  }
+
+  if (extent.z > extent[axis]) {
+    axis = 2;
+  }
+
+  u32 middle = begin + (end - begin) / 2;
+  std::nth_element(my_primitives.begin() + begin, my_primitives.begin() + middle,
+    my_primitives.begin() + end,
+    [&centers, axis](u32 a, u32 b) { return centers[a][axis] < centers[b][axis]; });
+
+  build_node(boxes, centers, begin, middle);
+  u32 right = build_node(boxes, centers, middle, end);
+
+  my_nodes[node_index].index = right;
+  my_nodes[node_index].count = 0;
+  return node_index;
+}
+
+void Bvh::refit(const Slice<BoundingBox> &boxes)
+{
+  assert(boxes.size() == my_primitives.size());
+
+  // children are always stored after parent, reverse order is bottom-up
+  for (u32 i = my_nodes.size(); i > 0; --i) {
+    BvhNode &node = my_nodes[i - 1];
+    node.box = BoundingBox();
+
+    if (node.is_leaf()) {
+      for (u32 j = node.index; j < node.index + node.count; ++j) {
+        node.box.extend(boxes[my_primitives[j]]);
+      }
+    } else {
+      node.box.extend(my_nodes[i].box);
+      node.box.extend(my_nodes[node.index].box);
+    }
+  }
+}
+
+void Bvh::clear()
+{
+  my_nodes.clear();
+  my_primitives.clear();
+}
+
+void build_mesh_bvh(const Slice<Vec3f> &vertices, const Slice<u32> &indices, Bvh &bvh)
+{
+  u32 triangle_count = indices.size() / 3;
+  std::vector<BoundingBox> boxes(triangle_count);
+
+  for (u32 i = 0; i < triangle_count; ++i) {
+    boxes[i].extend(vertices[indices[3 * i]]);
+    boxes[i].extend(vertices[indices[3 * i + 1]]);
+    boxes[i].extend(vertices[indices[3 * i + 2]]);
+  }
+
+  bvh.build(Slice<BoundingBox>(boxes.data(), boxes.size()));
+}
+
+f32 intersect_mesh(const Ray &ray, const Bvh &bvh, const Slice<Vec3f> &vertices,
+  const Slice<u32> &indices, u32 &index)
+{
+  return bvh.intersect_ray(ray, [&](u32 triangle, f32 tnearest) -> f32 {
+    f32 t = intersect_triangle(ray, vertices[indices[3 * triangle]],
+      vertices[indices[3 * triangle + 1]], vertices[indices[3 * triangle + 2]]);
+
+    if (t >= 0 && t < tnearest) {
+      index = triangle;
+    }
+
+    return t;
+  });
+}
+
+}
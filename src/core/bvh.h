@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "math.h"
+
+namespace atom {
+
+/// default max number of primitives in leaf
+const u32 BVH_LEAF_SIZE = 4;
+
+/**
+ * Node of bounding volume hierarchy. Nodes are stored in depth-first order,
+ * left child of inner node directly follows its parent.
+ */
+struct BvhNode {
+  BoundingBox box;
+  u32         index;  ///< right child (inner node) or first primitive (leaf)
+  u32         count;  ///< number of primitives, 0 for inner node
+
+  bool is_leaf() const
+  {
+    return count > 0;
+  }
+};
+
+/**
+ * Bounding volume hierarchy over an array of bounding boxes (primitives).
+ *
+ * Hierarchy is built by median split along the longest axis. When primitives
+ * move but their count stays same, use refit instead of full rebuild.
+ */
+class Bvh {
+public:
+  /**
+   * Build hierarchy from bounding boxes, index of box is primitive id.
+   *
+   * @param leaf_size max number of primitives in leaf
+   */
+  void build(const Slice<BoundingBox> &boxes, u32 leaf_size = BVH_LEAF_SIZE);
+
+  /**
+   * Update node bounds without changing the topology.
+   *
+   * @param boxes same number of boxes (in same order) as used in build
+   */
+  void refit(const Slice<BoundingBox> &boxes);
+
+  void clear();
+
+  bool is_empty() const
+  {
+    return my_nodes.empty();
+  }
+
+  BoundingBox bounds() const
+  {
+    return my_nodes.empty() ? BoundingBox() : my_nodes[0].box;
+  }
+
+  u32 primitive_count() const
+  {
+    return my_primitives.size();
+  }
+
+  /**
+   * Nodes in depth-first order, root is the first one.
+   */
+  Slice<BvhNode> nodes() const
+  {
+    return Slice<BvhNode>(my_nodes.data(), my_nodes.size());
+  }
+
+  /**
+   * Primitive ids ordered by leaves, leaf covers range <index, index + count).
+   */
+  Slice<u32> primitives() const
+  {
+    return Slice<u32>(my_primitives.data(), my_primitives.size());
+  }
+
+  /**
+   * Find nearest intersection of ray and primitives.
+   *
+   * @param f functor f32 f(u32 primitive, f32 tnearest), should return
+   *          distance of intersection with primitive or negative value on miss
+   * @return distance of nearest intersection or negative value on miss
+   */
+  template<typename IntersectFunc>
+  f32 intersect_ray(const Ray &ray, IntersectFunc f, f32 tmax = F32_MAX) const;
+
+private:
+  u32 build_node(const Slice<BoundingBox> &boxes,
+    std::vector<Vec3f> &centers, u32 begin, u32 end);
+
+  static bool intersect_node(const Vec3f &origin, const Vec3f &inv_dir,
+    const BoundingBox &box, f32 tmax, f32 &tnear);
+
+  /**
+   * Intersect ray interval <t0, t1> with one slab of the box.
+   */
+  static void clip_slab(f32 lo, f32 hi, f32 origin, f32 inv_dir, f32 &t0, f32 &t1);
+
+private:
+  std::vector<BvhNode> my_nodes;
+  std::vector<u32>     my_primitives;
+  u32                  my_leaf_size;
+};
+
+/**
+ * Build hierarchy over mesh triangles, primitive id is triangle index.
+ */
+void build_mesh_bvh(const Slice<Vec3f> &vertices, const Slice<u32> &indices, Bvh &bvh);
+
+/**
+ * Calculate nearest intersection of ray and triangle mesh using hierarchy
+ * created by build_mesh_bvh.
+ */
+f32 intersect_mesh(const Ray &ray, const Bvh &bvh, const Slice<Vec3f> &vertices,
+  const Slice<u32> &indices, u32 &index);
+
+inline void Bvh::clip_slab(f32 lo, f32 hi, f32 origin, f32 inv_dir, f32 &t0, f32 &t1)
+{
+  // zero direction component, origin on the slab plane would give 0 * inf = NaN
+  if (std::isinf(inv_dir)) {
+    if (origin < lo || origin > hi) {
+      t0 = F32_MAX;
+      t1 = -F32_MAX;
+    }
+    return;
+  }
+
+  f32 ta = (lo - origin) * inv_dir;
+  f32 tb = (hi - origin) * inv_dir;
+  t0 = max(t0, min(ta, tb));
+  t1 = min(t1, max(ta, tb));
+}
+
+inline bool Bvh::intersect_node(const Vec3f &origin, const Vec3f &inv_dir,
+  const BoundingBox &box, f32 tmax, f32 &tnear)
+{
+  f32 t0 = -F32_MAX;
+  f32 t1 = F32_MAX;
+  clip_slab(box.xmin, box.xmax, origin.x, inv_dir.x, t0, t1);
+  clip_slab(box.ymin, box.ymax, origin.y, inv_dir.y, t0, t1);
+  clip_slab(box.zmin, box.zmax, origin.z, inv_dir.z, t0, t1);
+
+  tnear = t0;
+  // ray origin inside box is a hit too
+  return t1 >= max(t0, 0.0f) && t0 < tmax;
+}
+
+template<typename IntersectFunc>
+f32 Bvh::intersect_ray(const Ray &ray, IntersectFunc f, f32 tmax) const
+{
+  if (my_nodes.empty()) {
+    return -1;
+  }
+
+  const Vec3f inv_dir(1.0f / ray.dir.x, 1.0f / ray.dir.y, 1.0f / ray.dir.z);
+  f32 nearest = tmax;
+  bool hit = false;
+  f32 tnear;
+
+  if (!intersect_node(ray.origin, inv_dir, my_nodes[0].box, nearest, tnear)) {
+    return -1;
+  }
+
+  const u32 STACK_SIZE = 64;
+  u32 stack[STACK_SIZE];
+  u32 stack_size = 0;
+  u32 node_index = 0;
+
+  while (true) {
+    const BvhNode &node = my_nodes[node_index];
+
+    if (node.is_leaf()) {
+      for (u32 i = node.index; i < node.index + node.count; ++i) {
+        f32 t = f(my_primitives[i], nearest);
+
+        if (t >= 0 && t < nearest) {
+          nearest = t;
+          hit = true;
+        }
+      }
+    } else {
+      u32 left = node_index + 1;
+      u32 right = node.index;
+      f32 tleft, tright;
+      bool hit_left = intersect_node(ray.origin, inv_dir, my_nodes[left].box, nearest, tleft);
+      bool hit_right = intersect_node(ray.origin, inv_dir, my_nodes[right].box, nearest, tright);
+
+      if (hit_left && hit_right) {
+        // visit nearer child first, the other one later
+        if (tright < tleft) {
+          std::swap(left, right);
+        }
+        assert(stack_size < STACK_SIZE);
+        stack[stack_size++] = right;
+        node_index = left;
+        continue;
+      } else if (hit_left) {
+        node_index = left;
+        continue;
+      } else if (hit_right) {
+        node_index = right;
+        continue;
+      }
+    }
+
+    // pop next node, skip those which are farther than current hit
+    bool found = false;
+
+    while (stack_size > 0) {
+      node_index = stack[--stack_size];
+
+      if (intersect_node(ray.origin, inv_dir, my_nodes[node_index].box, nearest, tnear)) {
+        found = true;
+        break;
+      }
+    }
+
+    if (!found) {
+      break;
+    }
+  }
+
+  return hit ? nearest : -1;
+}
+
+}
@@ -1,5 +1,8 @@
 #include "collider_component.h"
 #include "bt_utils.h"
+#include "model_component.h"
+#include "model.h"
+#include "constants.h"
 
 namespace atom {
 
@@ -85,4 +88,56 @@ void BoxColliderComponent::set_size(const Vec3f &size)
   set_collision_shape(uptr<btCollisionShape>(new btBoxShape(to_bt_vector3(my_size / 2.0f))));
 }
 
+
+
+//
+// Static mesh collider
+//
+
+MeshColliderComponent::MeshColliderComponent()
+  : my_model(this)
+{
+  // empty
+}
+
+MeshColliderComponent::~MeshColliderComponent()
+{
+  // shape references my_triangles
+  set_collision_shape(nullptr);
+}
+
+void MeshColliderComponent::activate()
+{
+  ModelResourcePtr resource = my_model->get_model();
+
+  if (resource == nullptr) {
+    log_error("%s: model isn't loaded", ATOM_FUNC_NAME);
+    return;
+  }
+
+  const Model &model = resource->model();
+  Slice<f32> vertices = model.find_stream<f32>(MODEL_VERTEX);
+  Slice<u32> indices = model.find_stream<u32>(MODEL_INDEX);
+
+  if (vertices.size() == 0 || indices.size() < 3) {
+    log_error("%s: model doesn't have vertices or indices", ATOM_FUNC_NAME);
+    return;
+  }
+
+  // triangles aren't copied, bullet uses the model data directly
+  btIndexedMesh part;
+  part.m_numTriangles = indices.size() / 3;
+  part.m_triangleIndexBase = reinterpret_cast<const unsigned char *>(indices.data());
+  part.m_triangleIndexStride = 3 * sizeof(u32);
+  part.m_numVertices = vertices.size() / 3;
+  part.m_vertexBase = reinterpret_cast<const unsigned char *>(vertices.data());
+  part.m_vertexStride = 3 * sizeof(f32);
+
+  set_collision_shape(nullptr);
+  my_resource = resource;
+  my_triangles.reset(new btTriangleIndexVertexArray());
+  my_triangles->addIndexedMesh(part, PHY_INTEGER);
+  set_collision_shape(uptr<btCollisionShape>(new btBvhTriangleMeshShape(my_triangles.get(), true)));
+}
+
 }
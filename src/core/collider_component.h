@@ -4,6 +4,7 @@
 #include "component.h"
 
 class btCollisionShape;
+class btTriangleIndexVertexArray;
 
 namespace atom {
 
@@ -62,10 +63,19 @@ public:
 
 
 /**
- * Static mesh collider.
+ * Static mesh collider, triangles of the model (ModelComponent) which has to
+ * be loaded when the component is activated.
  */
 class MeshColliderComponent : public ColliderComponent {
+  Slot<ModelComponent>             my_model;
+  ModelResourcePtr                 my_resource;   ///< keeps triangle data alive
+  uptr<btTriangleIndexVertexArray> my_triangles;
 
+  void activate() override;
+
+public:
+  MeshColliderComponent();
+  ~MeshColliderComponent();
 };
 
 MAP_COMPONENT_TYPE(ColliderComponent, COLLIDER)
@@ -13,6 +13,7 @@ META_CLASS(Component,
 Component::Component(ComponentType type)
   : my_type(type)
   , my_entity(nullptr)
+  , my_storage(nullptr)
 {
   META_INIT();
 }
@@ -25,19 +26,34 @@ Component::~Component()
 void Component::attach(Entity &entity)
 {
   my_entity = &entity;
+  my_handle = entity.world().register_component(this);
+}
+
+void Component::start()
+{
   // first activate slots
   for (GenericSlot *slot : my_slots) {
-    slot->activate(entity);
+    slot->activate(entity());
   }
   init();
   // then activate entity
   activate();
 }
 
-void Component::detach()
+void Component::stop()
 {
   deactivate();
   terminate();
+}
+
+void Component::detach()
+{
+  for (GenericSlot *slot : my_slots) {
+    slot->deactivate();
+  }
+
+  world().unregister_component(this);
+  my_handle = ComponentHandle();
   my_entity = nullptr;
 }
 
@@ -67,6 +83,11 @@ ComponentType Component::type() const
   return my_type;
 }
 
+ComponentHandle Component::handle() const
+{
+  return my_handle;
+}
+
 const String& Component::name() const
 {
   return my_name;
@@ -83,19 +104,34 @@ void Component::register_slot(GenericSlot *slot)
   my_slots.push_back(slot);
 }
 
+void destroy_component(Component *component)
+{
+  assert(component != nullptr && component->my_storage != nullptr);
+  ComponentStorage *storage = component->my_storage;
+  component->~Component();
+  storage->deallocate(component);
+}
+
 void GenericSlot::activate(Entity &entity)
 {
-  my_component = entity.find_component(my_type, my_name);
+  Component *component = entity.find_component(my_type, my_name);
+  my_handle = component != nullptr ? component->handle() : ComponentHandle();
+}
+
+void GenericSlot::deactivate()
+{
+  my_handle = ComponentHandle();
 }
 
 Component* GenericSlot::get() const
 {
-  return my_component;
+  return my_handle.is_null() ? nullptr
+    : my_parent->world().component_pool(my_type).get(my_handle);
 }
 
 bool GenericSlot::is_null() const
 {
-  return my_component == nullptr;
+  return get() == nullptr;
 }
 
 }
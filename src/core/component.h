@@ -3,6 +3,8 @@
 #include <cassert>
 #include <vector>
 #include "foundation.h"
+#include "component_pool.h"
+#include "component_storage.h"
 
 namespace atom {
 
@@ -17,18 +19,26 @@ enum class ComponentType : u32 {
   SCRIPT,
   RIGID_BODY,
   SKELETON,
-  COLLIDER
+  COLLIDER,
+  ANIMATION,
+  TERRAIN,
+  AUDIO
 };
 
+const u32 COMPONENT_TYPE_COUNT = static_cast<u32>(ComponentType::AUDIO) + 1;
+
 typedef std::vector<GenericSlot *> SlotArray;
 
 TYPE_OF(ComponentType, COMPONENT_TYPE)
 
 /**
- *
+ * Components are created by Entity::add_component in the ComponentStorage of
+ * their class (contiguous per type), the entity owns them.
  *
  * Component contains these important methods
  *  - attach
+ *  - start
+ *  - stop
  *  - detach
  *  - duplicate
  *
@@ -50,10 +60,15 @@ TYPE_OF(ComponentType, COMPONENT_TYPE)
  *  - access to parent entity (entity is valid between calls activate/deactivate)
  */
 class Component : NonCopyable {
-  ComponentType my_type;
-  Entity       *my_entity;
-  String        my_name;
-  SlotArray     my_slots;
+  friend class Entity;
+  friend void destroy_component(Component *component);
+
+  ComponentType     my_type;
+  Entity           *my_entity;
+  String            my_name;
+  SlotArray         my_slots;
+  ComponentHandle   my_handle;   ///< handle to the World component pool (valid while attached)
+  ComponentStorage *my_storage;  ///< memory of the component (set by Entity::add_component)
 
   virtual void init() = 0;
 
@@ -71,7 +86,24 @@ public:
 
   virtual ~Component();
 
+  /**
+   * Add component to the World pool of its type. All components of the
+   * entity are attached before they are started, so slots can resolve
+   * handles of any of them.
+   */
   void attach(Entity &entity);
+
+  /**
+   * Resolve slots, init and activate the component.
+   */
+  void start();
+
+  /**
+   * Deactivate and terminate the component, slots of other components are
+   * valid until they are detached.
+   */
+  void stop();
+
   void detach();
 
   // volat len po welcome a pred goodbye
@@ -85,6 +117,8 @@ public:
 
   ComponentType type() const;
 
+  ComponentHandle handle() const;
+
   const String& name() const;
 
   void set_name(const String &name);
@@ -140,18 +174,28 @@ ComponentType component_type_of();
   { return ComponentType::mapped; }
 
 
+/**
+ * Destroy component created by Entity::add_component and return its memory
+ * to the storage.
+ */
+void destroy_component(Component *component);
+
 /**
  * See @ref Slot class
+ *
+ * Slot keeps handle of the component from the World pool, so it doesn't
+ * dangle when the referenced component is detached.
  */
 class GenericSlot : NonCopyable {
-  Component    *my_component;
-  ComponentType my_type;
-  String        my_name;  ///< component name
+  Component      *my_parent;
+  ComponentHandle my_handle;
+  ComponentType   my_type;
+  String          my_name;  ///< component name
 
 public:
   explicit GenericSlot(Component *parent, ComponentType type,
     const String &name = String())
-    : my_component(nullptr)
+    : my_parent(parent)
     , my_type(type)
     , my_name(name)
   {
@@ -161,13 +205,19 @@ public:
 
   void activate(Entity &entity);
 
+  void deactivate();
+
+  /**
+   * @return component or nullptr when the slot is empty or the component
+   *         was detached
+   */
   Component* get() const;
 
   bool is_null() const;
 
   operator bool() const
   {
-    return my_component != nullptr;
+    return !is_null();
   }
 };
 
@@ -0,0 +1,86 @@
+#include "component_pool.h"
+#include "log.h"
+
+namespace atom {
+
+ComponentPool::ComponentPool()
+  : my_revision(0)
+{
+}
+
+ComponentHandle ComponentPool::add(Component *component)
+{
+  assert(component != nullptr);
+
+  u32 slot;
+
+  if (my_free.empty()) {
+    slot = my_slots.size();
+    my_slots.push_back(SlotEntry{U32_MAX, 0});
+  } else {
+    slot = my_free.back();
+    my_free.pop_back();
+  }
+
+  my_slots[slot].dense = my_components.size();
+  my_components.push_back(component);
+  my_slot_index.push_back(slot);
+  ++my_revision;
+
+  return ComponentHandle(slot, my_slots[slot].generation);
+}
+
+void ComponentPool::remove(ComponentHandle handle)
+{
+  if (get(handle) == nullptr) {
+    log_warning("Removing invalid component handle");
+    return;
+  }
+
+  SlotEntry &entry = my_slots[handle.index];
+  u32 last = my_components.size() - 1;
+
+  // move the last component to the freed place
+  if (entry.dense != last) {
+    my_components[entry.dense] = my_components[last];
+    my_slot_index[entry.dense] = my_slot_index[last];
+    my_slots[my_slot_index[entry.dense]].dense = entry.dense;
+  }
+
+  my_components.pop_back();
+  my_slot_index.pop_back();
+
+  entry.dense = U32_MAX;
+  ++entry.generation;
+  my_free.push_back(handle.index);
+  ++my_revision;
+}
+
+Component* ComponentPool::get(ComponentHandle handle) const
+{
+  if (handle.index >= my_slots.size()) {
+    return nullptr;
+  }
+
+  const SlotEntry &entry = my_slots[handle.index];
+  return entry.generation == handle.generation && entry.dense != U32_MAX
+    ? my_components[entry.dense] : nullptr;
+}
+
+void ComponentPool::clear()
+{
+  // invalidate all handles
+  for (u32 i = 0; i < my_slots.size(); ++i) {
+    if (my_slots[i].dense != U32_MAX) {
+      my_slots[i].dense = U32_MAX;
+      ++my_slots[i].generation;
+      my_free.push_back(i);
+    }
+  }
+
+  my_components.clear();
+  my_slot_index.clear();
+  ++my_revision;
+}
+
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <vector>
+#include "foundation.h"
+
+namespace atom {
+
+/**
+ * Stable reference to the component stored in ComponentPool. Handle of removed
+ * component is invalid even when its slot is reused (generation differs).
+ */
+struct ComponentHandle {
+  u32 index;
+  u32 generation;
+
+  ComponentHandle()
+    : index(U32_MAX)
+    , generation(0)
+  {}
+
+  ComponentHandle(u32 i, u32 g)
+    : index(i)
+    , generation(g)
+  {}
+
+  bool is_null() const
+  {
+    return index == U32_MAX;
+  }
+};
+
+/**
+ * Typed view of packed component array, see ComponentPool::view.
+ */
+template<typename T>
+class ComponentRange {
+public:
+  class iterator {
+  public:
+    explicit iterator(Component *const *ptr)
+      : my_ptr(ptr)
+    {}
+
+    T* operator*() const
+    { return static_cast<T *>(*my_ptr); }
+
+    iterator& operator++()
+    { ++my_ptr; return *this; }
+
+    bool operator!=(const iterator &other) const
+    { return my_ptr != other.my_ptr; }
+
+  private:
+    Component *const *my_ptr;
+  };
+
+  ComponentRange(Component *const *data, u32 size)
+    : my_data(data)
+    , my_size(size)
+  {}
+
+  iterator begin() const
+  { return iterator(my_data); }
+
+  iterator end() const
+  { return iterator(my_data + my_size); }
+
+  T* operator[](u32 i) const
+  {
+    assert(i < my_size);
+    return static_cast<T *>(my_data[i]);
+  }
+
+  u32 size() const
+  { return my_size; }
+
+  bool is_empty() const
+  { return my_size == 0; }
+
+private:
+  Component *const *my_data;
+  u32               my_size;
+};
+
+/**
+ * Pool of attached components of the same type. Components live by value in
+ * the ComponentStorage of their class, the pool packs pointers to them
+ * (processors iterate it without gaps, one type may have several classes),
+ * removal moves the last component to the freed place. Sparse slot table
+ * maps handles to the packed array, so handles stay valid while other
+ * components are removed.
+ */
+class ComponentPool : NonCopyable {
+public:
+  ComponentPool();
+
+  ComponentHandle add(Component *component);
+
+  void remove(ComponentHandle handle);
+
+  /**
+   * @return component or nullptr when the handle is not valid
+   */
+  Component* get(ComponentHandle handle) const;
+
+  u32 size() const
+  {
+    return my_components.size();
+  }
+
+  /**
+   * Incremented on each add/remove, processors can detect changes in the
+   * component set (e.g. to rebuild acceleration structures).
+   */
+  u32 revision() const
+  {
+    return my_revision;
+  }
+
+  template<typename T>
+  ComponentRange<T> view() const
+  {
+    return ComponentRange<T>(my_components.data(), my_components.size());
+  }
+
+  void clear();
+
+private:
+  struct SlotEntry {
+    u32 dense;        ///< index to my_components, U32_MAX for free slot
+    u32 generation;
+  };
+
+  std::vector<Component *> my_components;  ///< packed components (in ComponentStorage)
+  std::vector<u32>         my_slot_index;  ///< packed index -> slot
+  std::vector<SlotEntry>   my_slots;
+  std::vector<u32>         my_free;        ///< free slots
+  u32                      my_revision;
+};
+
+}
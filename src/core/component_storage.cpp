@@ -0,0 +1,54 @@
+#include "component_storage.h"
+#include <cassert>
+#include <cstddef>
+
+namespace atom {
+
+ComponentStorage::ComponentStorage(u32 element_size, u32 alignment)
+  : my_element_size((element_size + alignment - 1) & ~(alignment - 1))
+  , my_used(COMPONENT_STORAGE_BLOCK)
+  , my_size(0)
+{
+  assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  // blocks are allocated by new[], it guarantees only the fundamental alignment
+  assert(alignment <= alignof(std::max_align_t));
+}
+
+ComponentStorage::~ComponentStorage()
+{
+  assert(my_size == 0 && "Components outlive their storage");
+
+  for (u8 *block : my_blocks) {
+    delete [] block;
+  }
+}
+
+void* ComponentStorage::allocate()
+{
+  std::lock_guard<std::mutex> lock(my_mutex);
+  ++my_size;
+
+  if (!my_free.empty()) {
+    void *element = my_free.back();
+    my_free.pop_back();
+    return element;
+  }
+
+  if (my_used == COMPONENT_STORAGE_BLOCK) {
+    my_blocks.push_back(new u8[my_element_size * COMPONENT_STORAGE_BLOCK]);
+    my_used = 0;
+  }
+
+  return my_blocks.back() + my_element_size * my_used++;
+}
+
+void ComponentStorage::deallocate(void *element)
+{
+  assert(element != nullptr);
+  std::lock_guard<std::mutex> lock(my_mutex);
+  assert(my_size > 0);
+  --my_size;
+  my_free.push_back(element);
+}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include "foundation.h"
+
+namespace atom {
+
+const u32 COMPONENT_STORAGE_BLOCK = 256;  ///< components in one block of ComponentStorage
+
+/**
+ * Memory of components of one class. Components are stored by value in
+ * blocks of COMPONENT_STORAGE_BLOCK objects, so components of the same type
+ * are contiguous in memory instead of scattered across the heap. Blocks
+ * never move (components are referenced by slots and processors), places of
+ * destroyed components are reused.
+ */
+class ComponentStorage : NonCopyable {
+public:
+  ComponentStorage(u32 element_size, u32 alignment);
+
+  ~ComponentStorage();
+
+  /**
+   * @return uninitialized memory for one component (thread safe)
+   */
+  void* allocate();
+
+  void deallocate(void *element);
+
+  /**
+   * @return number of allocated components
+   */
+  u32 size() const
+  {
+    return my_size;
+  }
+
+  u32 element_size() const
+  {
+    return my_element_size;
+  }
+
+private:
+  std::mutex           my_mutex;
+  std::vector<u8 *>    my_blocks;
+  std::vector<void *>  my_free;          ///< places of destroyed components
+  u32                  my_element_size;  ///< aligned size of the component
+  u32                  my_used;          ///< used places of the last block
+  u32                  my_size;
+};
+
+/**
+ * Storage shared by all components of class T (all worlds). It is never
+ * destroyed, entities held by static objects may release components at exit.
+ */
+template<typename T>
+ComponentStorage& component_storage()
+{
+  static ComponentStorage *storage = new ComponentStorage(sizeof(T), alignof(T));
+  return *storage;
+}
+
+}
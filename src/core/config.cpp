@@ -42,7 +42,13 @@ META_CLASS(Config,
   FIELD(debug_audio, "debug_audio"),
   FIELD(debug_input, "debug_input"),
   FIELD(debug_resources, "debug_resources"),
-  FIELD(debug_counters, "debug_counters")
+  FIELD(debug_counters, "debug_counters"),
+  FIELD(resource_cache_size, "resource_cache_size"),
+  FIELD(resource_grace_period, "resource_grace_period"),
+  FIELD(deterministic, "deterministic"),
+  FIELD(terrain_tile_cache, "terrain_tile_cache"),
+  FIELD(linear_resampling, "linear_resampling"),
+  FIELD(gpu_skinning, "gpu_skinning")
 )
 
 void Config::set_screen_resolution(u32 width, u32 height)
@@ -59,6 +65,12 @@ Config::Config()
   , debug_input(false)
   , debug_resources(false)
   , debug_counters(false)
+  , resource_cache_size(DEFAULT_RESOURCE_CACHE_SIZE)
+  , resource_grace_period(DEFAULT_RESOURCE_GRACE_PERIOD)
+  , deterministic(false)
+  , terrain_tile_cache(DEFAULT_TERRAIN_TILE_CACHE)
+  , linear_resampling(false)
+  , gpu_skinning(true)
   , screen_width(1024)
   , screen_height(768)
   , screen_bpp(32)
@@ -81,6 +81,12 @@ public:
   bool debug_input;
   bool debug_resources;
   bool debug_counters;
+  int  resource_cache_size;    ///< memory budget for unused resources (MiB)
+  int  resource_grace_period;  ///< time for which unused resource is kept (ms)
+  bool deterministic;          ///< execute world jobs serially (bit-identical replays)
+  int  terrain_tile_cache;     ///< loaded terrain tiles of each TerrainComponent
+  bool linear_resampling;      ///< fast linear sample rate conversion instead of windowed sinc
+  bool gpu_skinning;           ///< skin geometry caches by transform feedback instead of on CPU
 
 private:
   int screen_width;
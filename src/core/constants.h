@@ -12,14 +12,38 @@ const int DEFAULT_SCREEN_HEIGHT = 540;
 const int DEFAULT_SCREEN_BITS_PER_PIXEL = 32;
 const float DEFAULT_SCREEN_ASPECT_RATIO = DEFAULT_SCREEN_WIDTH / (float) DEFAULT_SCREEN_HEIGHT;
 const int FPS = 30;
+const i64 RESOURCE_ASYNC_BUDGET = 2000;  ///< time for finishing async loads per frame (us)
+const i64 RESOURCE_GC_BUDGET = 500;      ///< time for incremental garbage collection per frame (us)
+const int DEFAULT_RESOURCE_CACHE_SIZE = 64;       ///< unused resource budget (MiB)
+const int DEFAULT_RESOURCE_GRACE_PERIOD = 10000;  ///< unused resource lifetime (ms)
+const u32 GEOMETRY_JOB_CHUNK = 8;  ///< dynamic geometry components processed by one job
+const u32 ANIMATION_JOB_CHUNK = 16;  ///< animated skeletons evaluated by one job
+const f32 ANIMATION_KEY_TOLERANCE = 0.001f;  ///< max quaternion component error of removed keys
+const u32 INSTANCING_MIN_COUNT = 4;  ///< smaller groups of the same mesh are drawn one by one
+const u32 CULLING_LEAF_SIZE = 32;  ///< objects in MeshTree leaf, tested by one SIMD loop
+const u32 OCCLUSION_WIDTH = 256;   ///< resolution of the software occlusion buffer
+const u32 OCCLUSION_HEIGHT = 128;
+const u32 OCCLUSION_VISIBLE_FRAMES = 4;  ///< visible object isn't tested again for this many frames
+const f32 LOD_PIXEL_ERROR = 1.0f;  ///< max screen space error of the selected level of detail
+const f32 LOD_HYSTERESIS = 0.7f;   ///< coarser level needs error below LOD_PIXEL_ERROR * this
+const f32 LOD_REDUCTION = 0.5f;    ///< triangle count of the next generated level of detail
+const u32 STREAM_BUFFER_SIZE = 4 << 20;  ///< per frame region of the VideoService stream buffer (bytes)
+const int DEFAULT_TERRAIN_TILE_CACHE = 64;  ///< loaded terrain tiles (resident and released ones)
+const f32 TERRAIN_UNLOAD_MARGIN = 0.5f;     ///< tiles are kept this many tile sizes beyond the radius
 const String DEFAULT_SHADER_DIR("data/shader");
 
 const int AUDIO_FREQUENCY = 44100;
 const u32 AUDIO_SAMPLES = 2048;  ///< desired buffer size (in samples)
 const u32 AUDIO_CHANNELS = 2;    ///< stereo
 const u32 AUDIO_SAMPLE_SIZE = 2;  ///< sample size is 2bytes (i16)
+const u32 AUDIO_COMMAND_QUEUE_SIZE = 256;  ///< play/stop/volume commands sent in one frame
+const u32 AUDIO_MAX_TRACKS = 64;  ///< simultaneously played tracks
+const u32 AUDIO_MAX_VOICES = 16;  ///< loudest tracks which are mixed, the other ones are virtual
+const f32 AUDIO_AUDIBLE_GAIN = 0.001f;  ///< quieter tracks are virtual (-60 dB)
 
 const f32 ACCELERATION = 9.81; // acceleration constant
+const u32 PHYSICS_STEP_RATE = 60;  ///< fixed physics steps per second
+const u32 PHYSICS_MAX_STEPS = 10;  ///< steps of one frame, slower frames slow the simulation down
 
 const char DATA_DIR[] = "data";
 const char IMAGE_RESOURCE_DIR[] = "data/image"; ///< adresar s obrazkami
@@ -33,6 +57,7 @@ const char MATERIAL_DIR[] = "data/material";
 const char LEVEL_FILE_EXT[] = "lev";
 const char MATERIAL_EXT[] = "mat";
 const char MESH_EXT[] = "m3d";
+const char MESH_BINARY_EXT[] = "m3b";  ///< binary (memory mappable) mesh
 
 const int PATH_SIZE = 256;
 
@@ -64,7 +89,7 @@ const char RESOURCE_BITMAP_FONT_TAG[] = "bitmap_font";
 const char RESOURCE_SOUND_TAG[] = "sound";
 const char RESOURCE_MUSIC_TAG[] = "music";
 
-const int REQ_VERTEX_ATTRIBUTES = 4;
+const int REQ_VERTEX_ATTRIBUTES = 16;  ///< MAX_ATTRIBUTES (OpenGL 4.1 minimum)
 
 // model standard data streams
 const char MODEL_VERTEX[] = "vertices";
@@ -72,5 +97,8 @@ const char MODEL_NORMAL[] = "normals";
 const char MODEL_INDEX[] = "indices";
 const char MODEL_BONE_INDEX[] = "bone_index";
 const char MODEL_BONE_WEIGHT[] = "bone_weight";
+const char MODEL_ANIMATION[] = "animations";  ///< compressed clips, see animation.h
+const char MODEL_LOD[] = "lods";                 ///< LodLevel of each coarser level (u32 stream)
+const char MODEL_LOD_INDEX[] = "lod_indices";    ///< indices of all coarser levels
 
 }
@@ -11,6 +11,7 @@
 #include "resource_service.h"
 #include "game_entry.h"
 #include "config.h"
+#include "job_system.h"
 
 namespace atom {
 
@@ -160,11 +161,15 @@ void Core::init_services()
 
   // Inicializacia AudioService
   my_services.audio.reset(new AudioService());
+
+  my_services.jobs.reset(new JobSystem(0, Config::instance().deterministic));
+  log_info("Job system with %u workers", my_services.jobs->worker_count());
 }
 
 void Core::quit_services()
 {
   // remove order is important
+  my_services.jobs.reset();
   my_services.resource.reset();
   my_services.input.reset();
   my_services.video.reset();
@@ -25,6 +25,7 @@ enum class InitMode {
  *   DrawService
  *   AudioService
  *   ResourceService
+ *   JobSystem
  */
 class Core : private NonCopyable {
 public:
@@ -66,6 +67,12 @@ public:
     return *my_services.resource;
   }
 
+  JobSystem& job_system() const
+  {
+    assert(my_services.jobs != nullptr);
+    return *my_services.jobs;
+  }
+
   void update();
 
   bool load_game_lib(const char *name);
@@ -79,6 +86,7 @@ private:
     uptr<VideoService>    video;
     uptr<AudioService>    audio;
     uptr<ResourceService> resource;
+    uptr<JobSystem>       jobs;
   };
 
   /**
@@ -15,8 +15,15 @@ class Image;
 class Sprite;
 class Texture;
 class VideoBuffer;
+class StreamBuffer;
+struct StreamRange;
+class VertexArray;
+class BonePalette;
+class SkinningFeedback;
 class TextureSampler;
 class Mesh;
+class Bvh;
+class MappedFile;
 class Model;
 class Shader;
 class Technique;
@@ -26,6 +33,7 @@ class BitmapFont;
 class Uniforms;
 class Material;
 struct RenderContext;
+struct LodLevel;
 class MeshTree;
 class MeshTreeNode;
 struct PixelRGB;
@@ -38,6 +46,7 @@ class AudioService;
 class AudioBuffer;
 class Sound;
 class Music;
+class AudioStream;
 
 // system
 struct MetaClass;
@@ -45,6 +54,9 @@ struct MetaObject;
 struct GameEntry;
 class Core;
 class ResourceService;
+class ResourceIndex;
+class ThreadPool;
+class JobSystem;
 class Config;
 class SDL;
 class LZOProcessor;
@@ -63,6 +75,7 @@ class SoundResource;
 class MusicResource;
 
 struct Bone;
+class AnimationClip;
 
 // loaders
 struct ResourceLoaders;
@@ -85,6 +98,7 @@ typedef sptr<MaterialResource> MaterialResourcePtr;
 typedef sptr<BitmapFontResource> BitmapFontResourcePtr;
 typedef sptr<SoundResource> SoundResourcePtr;
 typedef sptr<MusicResource> MusicResourcePtr;
+typedef sptr<AudioStream> AudioStreamPtr;
 
 // world
 class World;
@@ -110,10 +124,15 @@ class MeshComponent;
 class RenderComponent;
 class ScriptComponent;
 class GeometryComponent;
+struct GeometryCache;
 class SkeletonComponent;
 class PlaneColliderComponent;
 class BoxColliderComponent;
 class RigidBodyComponent;
+class AnimationComponent;
+class TerrainComponent;
+class MeshColliderComponent;
+class AudioComponent;
 class GenericSlot;
 
 // component utils
@@ -125,6 +144,9 @@ class PhysicsProcessor;
 class ScriptProcessor;
 class GeometryProcessor;
 class DebugProcessor;
+class AnimationProcessor;
+class TerrainProcessor;
+class AudioProcessor;
 
 // math
 class TransformationStack;
@@ -0,0 +1,46 @@
+#include "cpu.h"
+
+namespace atom {
+
+namespace {
+
+SimdLevel detect_simd_level()
+{
+#if defined(ATOM_AVX2)
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::AVX2;
+  }
+
+  return SimdLevel::SSE;
+#elif defined(ATOM_SSE)
+  return SimdLevel::SSE;
+#else
+  return SimdLevel::SCALAR;
+#endif
+}
+
+}
+
+SimdLevel simd_level()
+{
+  static const SimdLevel level = detect_simd_level();
+  return level;
+}
+
+const char* simd_level_name(SimdLevel level)
+{
+  switch (level) {
+    case SimdLevel::SCALAR:
+      return "scalar";
+    case SimdLevel::SSE:
+      return "sse";
+    case SimdLevel::AVX2:
+      return "avx2";
+  }
+
+  return "unknown";
+}
+
+}
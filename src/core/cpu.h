@@ -0,0 +1,39 @@
+#pragma once
+
+#include "platform.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+  #define ATOM_SSE 1
+#endif
+
+#if defined(ATOM_SSE) && (defined(__GNUC__) || defined(__clang__))
+  #define ATOM_AVX2 1
+  /// compile function with AVX2 & FMA instructions (call it only when simd_level() >= AVX2)
+  #define ATOM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+namespace atom {
+
+/**
+ * Instruction sets used by vectorized kernels, ordered from the slowest.
+ */
+enum class SimdLevel {
+  SCALAR,
+  SSE,
+  AVX2
+};
+
+/**
+ * Best instruction set supported by the CPU and the compiler, detected at
+ * runtime.
+ */
+SimdLevel simd_level();
+
+inline bool has_simd(SimdLevel level)
+{
+  return static_cast<int>(level) <= static_cast<int>(simd_level());
+}
+
+const char* simd_level_name(SimdLevel level);
+
+}
@@ -9,6 +9,7 @@
 #include "geometry_component.h"
 #include "render_context.h"
 #include "model.h"
+#include "stream_buffer.h"
 
 namespace atom {
 
@@ -93,6 +94,11 @@ void DebugProcessor::poll()
   }
 }
 
+ProcessorAccess DebugProcessor::access() const
+{
+  return ProcessorAccess{ProcessorData::PHYSICS, ProcessorData::DEBUG};
+}
+
 void DebugProcessor::draw()
 {
   if (my_debug_categories & DebugCategory::PHYSICS) {
@@ -277,19 +283,20 @@ void DebugProcessor::draw_all()
   if (!my_line_points.empty()) {
     Mesh mesh;
     VideoService &vs = core().video_service();
-    uptr<VideoBuffer> vertex_buffer(new VideoBuffer(vs, VideoBufferUsage::STATIC_DRAW));
-    uptr<VideoBuffer> color_buffer(new VideoBuffer(vs, VideoBufferUsage::STATIC_DRAW));
-    vertex_buffer->set_bytes(my_line_points.data(), my_line_points.size() * sizeof(Vec3f));
-    color_buffer->set_bytes(my_line_colors.data(), my_line_colors.size() * sizeof(Vec3f));
-    mesh.vertex = std::move(vertex_buffer);
-    mesh.color = std::move(color_buffer);
+    StreamBuffer &stream = vs.stream_buffer();
+    mesh.stream_vertex = stream.write(to_slice(my_line_points));
+    mesh.stream_color = stream.write(to_slice(my_line_colors));
+
+    if (mesh.stream_vertex.buffer == nullptr || mesh.stream_color.buffer == nullptr) {
+      return;
+    }
 
     Uniforms &u = vs.get_uniforms();
     u.color = Vec3f(1, 1, 1);
     u.transformations.model = Mat4f();
     u.model = Mat4f();
     u.mvp = u.transformations.model_view_projection();
-    RenderContext context = { u, vs };
+    RenderContext context = { u, vs, nullptr, 0, nullptr };
 
     my_debug_material->material().draw_mesh(context, mesh);
   }
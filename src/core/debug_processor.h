@@ -32,6 +32,8 @@ public:
 
   void poll() override;
 
+  ProcessorAccess access() const override;
+
   void draw();
 
   void set_debug(u32 category, bool enable);
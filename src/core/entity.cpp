@@ -3,6 +3,8 @@
 #include "mesh.h"
 #include "uniforms.h"
 #include "component.h"
+#include "world.h"
+#include "geometry_processor.h"
 
 namespace atom {
 
@@ -16,6 +18,7 @@ Entity::Entity(World &world, Core &core)
   : my_world(world)
   , my_core(core)
   , my_bounding_box(-1, 1, -1, 1, -1, 1)
+  , my_component_mask(0)
 {
   META_INIT();
   init();
@@ -23,26 +26,47 @@ Entity::Entity(World &world, Core &core)
 
 Entity::~Entity()
 {
+  for (Component *component : my_components) {
+    destroy_component(component);
+  }
 }
 
 void Entity::activate()
 {
-  for (const uptr<Component> &component : my_components) {
+  // slots resolve handles, so all components have to be in the pools first
+  for (Component *component : my_components) {
     component->attach(*this);
   }
+
+  for (Component *component : my_components) {
+    component->start();
+  }
 }
 
 void Entity::deactivate()
 {
-  for (const uptr<Component> &component : my_components) {
+  for (Component *component : my_components) {
+    component->stop();
+  }
+
+  for (Component *component : my_components) {
     component->detach();
   }
 }
 
-void Entity::add_component(uptr<Component> component)
+void Entity::add_component(Component *component)
 {
   assert(component != nullptr);
-  my_components.push_back(std::move(component));
+  assert(my_components.size() < 256 && "Too many components");
+
+  ComponentType type = component->type();
+
+  if (!has_component(type)) {
+    my_component_mask |= 1u << static_cast<u32>(type);
+    my_component_index[static_cast<u32>(type)] = my_components.size();
+  }
+
+  my_components.push_back(component);
 }
 
 const String& Entity::id() const
@@ -64,6 +88,7 @@ void Entity::set_transform(const Mat4f &transform)
 {
   my_transform = transform;
   update_aabb();
+  my_world.processors().geometry.on_transform_changed(*this);
 }
 
 const BoundingBox& Entity::bounding_box() const
@@ -105,32 +130,39 @@ Core& Entity::core() const
 Component* Entity::find_component(const String &name)
 {
   auto found = std::find_if(my_components.begin(), my_components.end(),
-    [name](const uptr<Component> &component) { return component->name() == name; });
-  return found != my_components.end() ? found->get() : nullptr;
+    [name](const Component *component) { return component->name() == name; });
+  return found != my_components.end() ? *found : nullptr;
 }
 
 Component* Entity::find_component(ComponentType type)
 {
-  auto found = std::find_if(my_components.begin(), my_components.end(),
-    [type](const uptr<Component> &component) { return component->type() == type; });
-  return found != my_components.end() ? found->get() : nullptr;
+  return has_component(type)
+    ? my_components[my_component_index[static_cast<u32>(type)]] : nullptr;
 }
 
 Component* Entity::find_component(ComponentType type, const String &name)
 {
+  if (!has_component(type)) {
+    return nullptr;
+  }
+
+  if (name.empty()) {
+    return find_component(type);
+  }
+
   auto found = std::find_if(my_components.begin(), my_components.end(),
-    [type, &name](const uptr<Component> &component)
-    { return component->type() == type && (name.empty() ? true : component->name() == name); });
-  return found != my_components.end() ? found->get() : nullptr;
+    [type, &name](const Component *component)
+    { return component->type() == type && component->name() == name; });
+  return found != my_components.end() ? *found : nullptr;
 }
 
 std::vector<Component *> Entity::find_components(ComponentType type)
 {
   std::vector<Component *> components;
 
-  for (const uptr<Component> &component : my_components) {
+  for (Component *component : my_components) {
     if (component->type() == type) {
-      components.push_back(component.get());
+      components.push_back(component);
     }
   }
 
@@ -146,25 +178,7 @@ void Entity::init(const Vec3f &position, f32 rotation)
 
 void Entity::update_aabb()
 {
-  my_aabb = BoundingBox();
-  const BoundingBox &box = my_bounding_box;
-  Vec3f xmin_ymin_zmin = Vec3f(box.xmin, box.ymin, box.zmin);
-  Vec3f xmax_ymin_zmin = Vec3f(box.xmax, box.ymin, box.zmin);
-  Vec3f xmin_ymax_zmin = Vec3f(box.xmin, box.ymax, box.zmin);
-  Vec3f xmax_ymax_zmin = Vec3f(box.xmax, box.ymax, box.zmin);
-  Vec3f xmin_ymin_zmax = Vec3f(box.xmin, box.ymin, box.zmax);
-  Vec3f xmax_ymin_zmax = Vec3f(box.xmax, box.ymin, box.zmax);
-  Vec3f xmin_ymax_zmax = Vec3f(box.xmin, box.ymax, box.zmax);
-  Vec3f xmax_ymax_zmax = Vec3f(box.xmax, box.ymax, box.zmax);
-
-  my_aabb.extend(transform_point(my_transform, xmin_ymin_zmin));
-  my_aabb.extend(transform_point(my_transform, xmax_ymin_zmin));
-  my_aabb.extend(transform_point(my_transform, xmin_ymax_zmin));
-  my_aabb.extend(transform_point(my_transform, xmax_ymax_zmin));
-  my_aabb.extend(transform_point(my_transform, xmin_ymin_zmax));
-  my_aabb.extend(transform_point(my_transform, xmax_ymin_zmax));
-  my_aabb.extend(transform_point(my_transform, xmin_ymax_zmax));
-  my_aabb.extend(transform_point(my_transform, xmax_ymax_zmax));
+  my_aabb = transform_bounding_box(my_transform, my_bounding_box);
 }
 
 }
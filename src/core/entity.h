@@ -1,5 +1,6 @@
 #pragma once
 
+#include <new>
 #include <vector>
 #include "foundation.h"
 #include "transformations.h"
@@ -38,7 +39,7 @@ class Entity : NonCopyable {
     TERMINATED
   };
 
-  typedef std::vector<uptr<Component>> ComponentArray;
+  typedef std::vector<Component *> ComponentArray;  ///< owned, see destroy_component
 
   // members
   World         &my_world;
@@ -50,6 +51,8 @@ class Entity : NonCopyable {
   String         my_id;
   String         my_class;
   ComponentArray my_components;
+  u32            my_component_mask;                        ///< bit per ComponentType
+  u8             my_component_index[COMPONENT_TYPE_COUNT];  ///< first component of each type
 public:
   Entity(World &world, Core &core);
 
@@ -65,7 +68,21 @@ public:
    */
   void deactivate();
 
-  void add_component(uptr<Component> component);
+  /**
+   * Create component of class T in its ComponentStorage, entity owns it.
+   */
+  template<typename T>
+  T* add_component()
+  {
+    ComponentStorage &storage = component_storage<T>();
+    void *memory = storage.allocate();
+    T *component = new (memory) T();
+    // storage memory is released through the Component pointer
+    assert(static_cast<Component *>(component) == memory);
+    component->my_storage = &storage;
+    add_component(component);
+    return component;
+  }
 
   const String& id() const;
 
@@ -92,8 +109,16 @@ public:
 
   Component* find_component(const String &name);
 
+  /**
+   * O(1) lookup of the first component of given type.
+   */
   Component* find_component(ComponentType type);
 
+  bool has_component(ComponentType type) const
+  {
+    return (my_component_mask & (1u << static_cast<u32>(type))) != 0;
+  }
+
   Component* find_component(ComponentType type, const String &name);
 
   template<typename T>
@@ -118,9 +143,9 @@ public:
     std::vector<T *> components;
     const ComponentType type = component_type_of<T>();
 
-    for (const uptr<Component> &component : my_components) {
+    for (Component *component : my_components) {
       if (component->type() == type) {
-        components.push_back(static_cast<T *>(component.get()));
+        components.push_back(static_cast<T *>(component));
       }
     }
 
@@ -130,6 +155,8 @@ public:
   META_ROOT_CLASS;
 
 private:
+  void add_component(Component *component);
+
   void init(const Vec3f &position = Vec3f(0, 0, 0), f32 rotation = 0);
 
   void update_aabb();
@@ -0,0 +1,31 @@
+#include "fixed_timestep.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace atom {
+
+FixedTimestep::FixedTimestep(f64 step, u32 max_steps)
+  : my_step(step)
+  , my_accumulator(0)
+  , my_max_steps(max_steps)
+{
+  assert(step > 0);
+}
+
+u32 FixedTimestep::advance(f64 elapsed)
+{
+  my_accumulator += std::max(elapsed, 0.0);
+  f64 steps = std::floor(my_accumulator / my_step);
+
+  if (steps > my_max_steps) {
+    // spiral of death, the rest of the frame isn't simulated
+    my_accumulator = 0;
+    return my_max_steps;
+  }
+
+  my_accumulator = std::max(my_accumulator - steps * my_step, 0.0);
+  return static_cast<u32>(steps);
+}
+
+}
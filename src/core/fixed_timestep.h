@@ -0,0 +1,47 @@
+#pragma once
+
+#include "platform.h"
+
+namespace atom {
+
+/**
+ * Accumulator of the elapsed time for a simulation with a fixed step. The
+ * time left after the last whole step is kept for the next frame and gives
+ * the interpolation factor between the last two simulated states.
+ */
+class FixedTimestep {
+  f64 my_step;
+  f64 my_accumulator;   ///< time not simulated yet, <0, step)
+  u32 my_max_steps;
+
+public:
+  /**
+   * @param max_steps steps of one frame, longer frames slow the simulation down
+   */
+  FixedTimestep(f64 step, u32 max_steps);
+
+  /**
+   * @return steps covering the elapsed time
+   */
+  u32 advance(f64 elapsed);
+
+  /**
+   * Position of the frame between the last two steps, <0, 1).
+   */
+  f32 alpha() const
+  {
+    return my_accumulator / my_step;
+  }
+
+  f64 step() const
+  {
+    return my_step;
+  }
+
+  void reset()
+  {
+    my_accumulator = 0;
+  }
+};
+
+}
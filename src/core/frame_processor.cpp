@@ -36,7 +36,7 @@ void FrameProcessor::run(const FramePtr &frame)
 
   while (my_current_frame != nullptr) {
 //    my_current_frame->performance_counters().clear();
-//    auto last = std::chrono::high_resolution_clock::now();
+    std::chrono::steady_clock::time_point frame_start = std::chrono::steady_clock::now();
     std::chrono::microseconds frame_time(1000000 / FPS);
 
 //    my_core.input_service().set_event_func(bind(&Frame::process_event, this, _1));
@@ -54,6 +54,9 @@ void FrameProcessor::run(const FramePtr &frame)
       break;
     }
 
+    // stream buffer data are written in update and used in draw
+    my_core.video_service().begin_frame();
+
     counters.start("Input processing");
     my_current_frame->input();
     counters.stop("Input processing");
@@ -66,15 +69,27 @@ void FrameProcessor::run(const FramePtr &frame)
     my_current_frame->draw();
     counters.stop("Frame rendering");
 
+    VideoService &vs = my_core.video_service();
+    counters.set_value("Draws", vs.stats().draws);
+    counters.set_value("Instances", vs.stats().instances);
+    counters.set_value("Program switches", vs.stats().program_switches);
+    counters.set_value("Buffer binds", vs.stats().buffer_binds);
+    counters.set_value("Texture binds", vs.stats().texture_binds);
+    counters.set_value("Uniform updates", vs.stats().uniform_updates);
+    counters.set_value("Visible objects", vs.stats().visible);
+    counters.set_value("Culled objects", vs.stats().culled);
+    counters.set_value("Occluded objects", vs.stats().occluded);
+    vs.reset_stats();
+
 //    info("Drawing counter");
     // render counters
     draw_counters(counters.to_string());
     // clear counters and start a new measurement
     counters.clear();
+    vs.end_frame();
 
-//    my_counters.start("Poll");
-//    my_core.audio_service().update();
-//    my_counters.stop("Poll");
+    // sounds of ended tracks are released on the game thread
+    my_core.audio_service().update();
 
     counters.start("Resource system");
     my_core.resource_service().poll();
@@ -86,13 +101,8 @@ void FrameProcessor::run(const FramePtr &frame)
       log_warning("Missing frame buffer update callback");
     }
 
-//    auto now = high_resolution_clock::now();
-//    auto duration = duration_cast<std::chrono::microseconds>(now - last);
-//    if (duration < frame_time) {
-//      sleep_for(frame_time - duration);
-//    }
-
-//    last = now;
+    // frame pacing, late frames don't wait (physics follows the real time)
+    std::this_thread::sleep_until(frame_start + frame_time);
 
 //    if (my_post_frame_callback) {
 //      if (my_post_frame_callback() == true)
@@ -105,8 +115,6 @@ void FrameProcessor::run(const FramePtr &frame)
       if (my_current_frame != nullptr)
         my_current_frame->set_running_state(true);
     }
-
-    my_core.resource_service().garbage_collect();
   }
 }
 
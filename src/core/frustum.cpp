@@ -0,0 +1,221 @@
+#include "frustum.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(ATOM_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(ATOM_AVX2)
+#include <immintrin.h>
+#endif
+
+namespace atom {
+
+/// boxes processed by the widest kernel, arrays are padded by this count
+const u32 CULL_BATCH = 8;
+
+Frustum extract_frustum(const Mat4f &view_projection)
+{
+  const Mat4f &m = view_projection;
+  Frustum frustum;
+
+  // clip space -w <= x, y, z <= w, each plane is row 3 +- row 0, 1, 2
+  for (u32 i = 0; i < 6; ++i) {
+    u32 row = i / 2;
+    f32 sign = i % 2 == 0 ? 1.0f : -1.0f;
+    Vec4f plane(m(3, 0) + sign * m(row, 0), m(3, 1) + sign * m(row, 1),
+                m(3, 2) + sign * m(row, 2), m(3, 3) + sign * m(row, 3));
+    f32 length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+    frustum.planes[i] = length > 0 ? plane * (1 / length) : plane;
+  }
+
+  return frustum;
+}
+
+Containment classify_box(const Frustum &frustum, const BoundingBox &box)
+{
+  Vec3f center = box.center();
+  Vec3f extent(box.xmax - box.xmin, box.ymax - box.ymin, box.zmax - box.zmin);
+  extent = extent * 0.5f;
+  Containment result = Containment::INSIDE;
+
+  for (const Vec4f &plane : frustum.planes) {
+    f32 distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+    f32 radius = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y
+      + std::abs(plane.z) * extent.z;
+
+    if (distance + radius < 0) {
+      return Containment::OUTSIDE;
+    }
+
+    if (distance - radius < 0) {
+      result = Containment::INTERSECT;
+    }
+  }
+
+  return result;
+}
+
+void BoxArray::resize(u32 size)
+{
+  my_size = size;
+  my_stride = (size + CULL_BATCH - 1) / CULL_BATCH * CULL_BATCH + CULL_BATCH;
+  // padding is filled by zeros, so kernels don't read uninitialized memory
+  my_data.assign(6 * my_stride, 0);
+}
+
+void BoxArray::set(u32 index, const BoundingBox &box)
+{
+  assert(index < my_size);
+  Vec3f center = box.center();
+  my_data[index] = center.x;
+  my_data[my_stride + index] = center.y;
+  my_data[2 * my_stride + index] = center.z;
+  my_data[3 * my_stride + index] = (box.xmax - box.xmin) * 0.5f;
+  my_data[4 * my_stride + index] = (box.ymax - box.ymin) * 0.5f;
+  my_data[5 * my_stride + index] = (box.zmax - box.zmin) * 0.5f;
+}
+
+namespace {
+
+u32 cull_scalar(const Frustum &frustum, const BoxArray &boxes, u32 begin, u32 end, u32 *visible)
+{
+  const f32 *cx = boxes.center(0), *cy = boxes.center(1), *cz = boxes.center(2);
+  const f32 *ex = boxes.extent(0), *ey = boxes.extent(1), *ez = boxes.extent(2);
+  u32 count = 0;
+
+  for (u32 i = begin; i < end; ++i) {
+    bool outside = false;
+
+    for (const Vec4f &p : frustum.planes) {
+      f32 distance = p.x * cx[i] + p.y * cy[i] + p.z * cz[i] + p.w;
+      f32 radius = std::abs(p.x) * ex[i] + std::abs(p.y) * ey[i] + std::abs(p.z) * ez[i];
+      outside |= distance + radius < 0;
+    }
+
+    visible[count] = i;
+    count += outside ? 0 : 1;
+  }
+
+  return count;
+}
+
+/**
+ * Append lanes of the batch starting at @p first which are not in @p outside
+ * mask (bit per lane), without branches.
+ */
+inline u32 append_visible(u32 outside, u32 first, u32 lanes, u32 *visible, u32 count)
+{
+  for (u32 j = 0; j < lanes; ++j) {
+    visible[count] = first + j;
+    count += ((outside >> j) & 1) ^ 1;
+  }
+
+  return count;
+}
+
+#if defined(ATOM_SSE)
+
+u32 cull_sse(const Frustum &frustum, const BoxArray &boxes, u32 begin, u32 end, u32 *visible)
+{
+  const f32 *c[3] = { boxes.center(0), boxes.center(1), boxes.center(2) };
+  const f32 *e[3] = { boxes.extent(0), boxes.extent(1), boxes.extent(2) };
+  const __m128 zero = _mm_setzero_ps();
+  u32 count = 0;
+
+  for (u32 i = begin; i < end; i += 4) {
+    __m128 cx = _mm_loadu_ps(c[0] + i), cy = _mm_loadu_ps(c[1] + i), cz = _mm_loadu_ps(c[2] + i);
+    __m128 ex = _mm_loadu_ps(e[0] + i), ey = _mm_loadu_ps(e[1] + i), ez = _mm_loadu_ps(e[2] + i);
+    __m128 outside = zero;
+
+    for (const Vec4f &p : frustum.planes) {
+      __m128 distance = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(p.x)), _mm_mul_ps(cy, _mm_set1_ps(p.y))),
+        _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(p.z)), _mm_set1_ps(p.w)));
+      __m128 radius = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(std::abs(p.x))),
+                   _mm_mul_ps(ey, _mm_set1_ps(std::abs(p.y)))),
+        _mm_mul_ps(ez, _mm_set1_ps(std::abs(p.z))));
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+    }
+
+    count = append_visible(_mm_movemask_ps(outside), i, std::min(4u, end - i), visible, count);
+  }
+
+  return count;
+}
+
+#endif
+
+#if defined(ATOM_AVX2)
+
+ATOM_TARGET_AVX2
+u32 cull_avx2(const Frustum &frustum, const BoxArray &boxes, u32 begin, u32 end, u32 *visible)
+{
+  const f32 *c[3] = { boxes.center(0), boxes.center(1), boxes.center(2) };
+  const f32 *e[3] = { boxes.extent(0), boxes.extent(1), boxes.extent(2) };
+  const __m256 zero = _mm256_setzero_ps();
+  u32 count = 0;
+
+  for (u32 i = begin; i < end; i += 8) {
+    __m256 cx = _mm256_loadu_ps(c[0] + i);
+    __m256 cy = _mm256_loadu_ps(c[1] + i);
+    __m256 cz = _mm256_loadu_ps(c[2] + i);
+    __m256 ex = _mm256_loadu_ps(e[0] + i);
+    __m256 ey = _mm256_loadu_ps(e[1] + i);
+    __m256 ez = _mm256_loadu_ps(e[2] + i);
+    __m256 outside = zero;
+
+    for (const Vec4f &p : frustum.planes) {
+      __m256 distance = _mm256_fmadd_ps(cx, _mm256_set1_ps(p.x),
+        _mm256_fmadd_ps(cy, _mm256_set1_ps(p.y),
+          _mm256_fmadd_ps(cz, _mm256_set1_ps(p.z), _mm256_set1_ps(p.w))));
+      __m256 radius = _mm256_fmadd_ps(ex, _mm256_set1_ps(std::abs(p.x)),
+        _mm256_fmadd_ps(ey, _mm256_set1_ps(std::abs(p.y)),
+          _mm256_mul_ps(ez, _mm256_set1_ps(std::abs(p.z)))));
+      outside = _mm256_or_ps(outside,
+        _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_LT_OQ));
+    }
+
+    count = append_visible(_mm256_movemask_ps(outside), i, std::min(8u, end - i), visible, count);
+  }
+
+  return count;
+}
+
+#endif
+
+}
+
+u32 cull_boxes(const Frustum &frustum, const BoxArray &boxes, u32 begin, u32 end,
+  u32 *visible)
+{
+  return cull_boxes(frustum, boxes, begin, end, visible, simd_level());
+}
+
+u32 cull_boxes(const Frustum &frustum, const BoxArray &boxes, u32 begin, u32 end,
+  u32 *visible, SimdLevel level)
+{
+  assert(end <= boxes.size());
+  assert(has_simd(level) && "Unsupported SIMD level");
+
+  if (begin >= end) {
+    return 0;
+  }
+
+  switch (level) {
+#if defined(ATOM_AVX2)
+    case SimdLevel::AVX2:
+      return cull_avx2(frustum, boxes, begin, end, visible);
+#endif
+#if defined(ATOM_SSE)
+    case SimdLevel::SSE:
+      return cull_sse(frustum, boxes, begin, end, visible);
+#endif
+    default:
+      return cull_scalar(frustum, boxes, begin, end, visible);
+  }
+}
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+#include "math.h"
+#include "cpu.h"
+
+namespace atom {
+
+enum class Containment {
+  OUTSIDE,
+  INTERSECT,
+  INSIDE
+};
+
+/**
+ * View frustum as 6 planes (left, right, bottom, top, near, far). Plane is
+ * stored as (n, d) with normal pointing inside, point p is inside the plane
+ * when dot(n, p) + d >= 0.
+ */
+struct Frustum {
+  Vec4f planes[6];
+};
+
+/**
+ * Extract normalized frustum planes from projection * view matrix (OpenGL
+ * clip space), planes are in world space.
+ */
+Frustum extract_frustum(const Mat4f &view_projection);
+
+/**
+ * Classify box against the frustum (conservative, box near frustum corner
+ * may be reported as intersecting).
+ */
+Containment classify_box(const Frustum &frustum, const BoundingBox &box);
+
+/**
+ * Bounding boxes in SoA layout (center & half extent of each axis), so the
+ * culling kernel tests several boxes with one instruction. Arrays are padded,
+ * kernels can read whole SIMD batch after the last box.
+ */
+class BoxArray {
+  std::vector<f32> my_data;
+  u32              my_size;
+  u32              my_stride;   ///< padded size of one array
+
+public:
+  BoxArray()
+    : my_size(0)
+    , my_stride(0)
+  {
+    // empty
+  }
+
+  void resize(u32 size);
+
+  void set(u32 index, const BoundingBox &box);
+
+  u32 size() const
+  {
+    return my_size;
+  }
+
+  const f32* center(u32 axis) const
+  {
+    return &my_data[axis * my_stride];
+  }
+
+  const f32* extent(u32 axis) const
+  {
+    return &my_data[(3 + axis) * my_stride];
+  }
+};
+
+/**
+ * Test boxes <begin, end) against the frustum, uses the best SIMD kernel for
+ * the current CPU (4 boxes per instruction with SSE, 8 with AVX2).
+ *
+ * @param[out] visible indices of boxes intersecting the frustum, array must
+ *             have space for end - begin indices
+ * @return number of visible boxes
+ */
+u32 cull_boxes(const Frustum &frustum, const BoxArray &boxes, u32 begin, u32 end,
+  u32 *visible);
+
+/**
+ * Culling with explicit kernel, @p level must be supported by the CPU.
+ */
+u32 cull_boxes(const Frustum &frustum, const BoxArray &boxes, u32 begin, u32 end,
+  u32 *visible, SimdLevel level);
+
+}
@@ -8,22 +8,14 @@ namespace atom {
 
 META_CLASS(GeometryComponent,
   FIELD(my_is_dynamic, "dynamic"),
+  FIELD(my_skin_normals, "skin_normals"),
   FIELD(my_categories, "categories")
 )
 
-void GeometryComponent::init()
-{
-  processors().geometry.register_component(this);
-}
-
-void GeometryComponent::terminate()
-{
-  processors().geometry.unregister_component(this);
-}
-
 GeometryComponent::GeometryComponent()
   : NullComponent(ComponentType::GEOMETRY)
   , my_is_dynamic(false)
+  , my_skin_normals(false)
   , my_categories(U32_MAX)
   , my_model(this)
   , my_skeleton(this)
@@ -46,6 +38,16 @@ const Model* GeometryComponent::model() const
   return resource != nullptr ? &resource->model() : nullptr;
 }
 
+bool GeometryComponent::is_model_loading() const
+{
+  if (my_model.is_null()) {
+    return false;
+  }
+
+  ModelResourcePtr resource = my_model->get_model_handle();
+  return resource != nullptr && resource->state() == ResourceState::LOADING;
+}
+
 const SkeletonComponent* GeometryComponent::skeleton() const
 {
   return my_skeleton.get_component();
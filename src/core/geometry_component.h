@@ -6,18 +6,17 @@ namespace atom {
 
 struct GeometryCache {
   std::vector<Vec3f> vertices;
+  std::vector<Vec3f> normals;   ///< empty when normals are not skinned
 };
 
 class GeometryComponent : public NullComponent {
   bool                    my_is_dynamic;
+  bool                    my_skin_normals;
   u32                     my_categories;
   Slot<ModelComponent>    my_model;
   Slot<SkeletonComponent> my_skeleton;
   GeometryCache           my_cache;
 
-  void init() override;
-  void terminate() override;
-
 public:
   GeometryComponent();
 
@@ -31,6 +30,19 @@ public:
     return my_is_dynamic;
   }
 
+  /**
+   * Skin also model normals of dynamic geometry (GeometryCache::normals).
+   */
+  void set_skin_normals(bool skin)
+  {
+    my_skin_normals = skin;
+  }
+
+  bool skin_normals() const
+  {
+    return my_skin_normals;
+  }
+
   u32 categories() const
   {
     return my_categories;
@@ -38,8 +50,16 @@ public:
 
   void set_categories(u32 mask);
 
+  /**
+   * @return model or nullptr when there is no model or it is still loading
+   */
   const Model* model() const;
 
+  /**
+   * @return true while the model resource is still loading
+   */
+  bool is_model_loading() const;
+
   const SkeletonComponent* skeleton() const;
 
   GeometryCache& geometry_cache()
@@ -6,16 +6,99 @@
 #include "intersect.h"
 #include "model.h"
 #include "utils.h"
+#include "world.h"
+#include "core.h"
+#include "constants.h"
+#include "config.h"
+#include "job_system.h"
+#include "skinning.h"
 
 namespace atom {
 
+static const Model* find_model(GeometryComponent &component)
+{
+  Component *found = component.entity().find_component<ModelComponent>();
+
+  if (found == nullptr) {
+    return nullptr;
+  }
+
+  ModelResourcePtr model_resource = static_cast<ModelComponent *>(found)->get_model();
+  return model_resource != nullptr ? &model_resource->model() : nullptr;
+}
+
 void GeometryProcessor::regenerate_mesh(GeometryComponent &component)
 {
-//  component.
+  if (!component.is_dynamic()) {
+    return;
+  }
+
+  const Model *model = component.model();
+  // skip components without geometry model data, asynchronous load is not an error
+  if (model == nullptr) {
+    if (!component.is_model_loading()) {
+      log_error("Dynamic GeometryComponent without model");
+    }
+    return;
+  }
+  // skip components without skeleton data
+  const SkeletonComponent *skeleton = component.skeleton();
+  if (skeleton == nullptr) {
+    log_error("Dynamic GeometryComponent without skeleton");
+    return;
+  }
+
+
+  Slice<f32> vertices = model->find_stream<f32>(MODEL_VERTEX);
+  Slice<u32> indices = model->find_stream<u32>(MODEL_INDEX);
+  Slice<u32> bone_index = model->find_stream<u32>(MODEL_BONE_INDEX);
+  Slice<f32> bone_weight = model->find_stream<f32>(MODEL_BONE_WEIGHT);
+
+  if (vertices.is_empty() || indices.is_empty() ||
+      bone_index.is_empty() || bone_weight.is_empty()) {
+    log_error("Dynamic GeometryComponent with invalid model");
+    return;
+  }
+
+  Slice<f32> normals = component.skin_normals()
+    ? model->find_stream<f32>(MODEL_NORMAL) : Slice<f32>();
+  u32 count = vertices.raw_size() / sizeof(Vec3f);
+
+  if (bone_index.size() < count || bone_weight.raw_size() < count * sizeof(Vec4f) ||
+      (!normals.is_empty() && normals.raw_size() < count * sizeof(Vec3f))) {
+    log_error("Dynamic GeometryComponent with invalid model");
+    return;
+  }
+
+  const Slice<Mat4f> transformations = skeleton->get_transforms();
+
+  // bone indices are validated against the model bones by the loader
+  if (transformations.size() < model->bones.size()) {
+    return;
+  }
+
+  SkinningInput input;
+  input.positions = reinterpret_cast<const Vec3f *>(vertices.data());
+  input.normals = normals.is_empty() ? nullptr : reinterpret_cast<const Vec3f *>(normals.data());
+  input.bone_indices = bone_index.data();
+  input.bone_weights = reinterpret_cast<const Vec4f *>(bone_weight.data());
+  input.count = count;
+  input.bones = transformations.data();
+  input.bone_count = transformations.size();
+
+  GeometryCache &cache = component.geometry_cache();
+  cache.vertices.resize(count);
+  cache.normals.resize(input.normals != nullptr ? count : 0);
+
+  skin_vertices(input, cache.vertices.data(),
+    cache.normals.empty() ? nullptr : cache.normals.data());
 }
 
 GeometryProcessor::GeometryProcessor(World &world)
   : NullProcessor(world)
+  , my_revision(0)
+  , my_needs_refit(false)
+  , my_gpu_skinning(Config::instance().gpu_skinning)
 {
 
 }
@@ -27,149 +110,171 @@ GeometryProcessor::~GeometryProcessor()
 
 void GeometryProcessor::poll()
 {
-  for (GeometryComponent *component : my_components) {
-    // regenerate mesh
-    if (component->is_dynamic()) {
-      const Model *model = component->model();
-      // skip components without geometry model data
-      if (model == nullptr) {
-        log_error("Dynamic GeometryComponent without model");
-        continue;
-      }
-      // skip components without skeleton data
-      const SkeletonComponent *skeleton = component->skeleton();
-      if (skeleton == nullptr) {
-        log_error("Dynamic GeometryComponent without skeleton");
-        continue;
-      }
-
+  if (my_gpu_skinning) {
+    return;
+  }
 
-      Slice<f32> vertices = model->find_stream<f32>(MODEL_VERTEX);
-      Slice<u32> indices = model->find_stream<u32>(MODEL_INDEX);
-      Slice<u32> bone_index = model->find_stream<u32>(MODEL_BONE_INDEX);
-      Slice<f32> bone_weight = model->find_stream<f32>(MODEL_BONE_WEIGHT);
+  const ComponentRange<GeometryComponent> components = world().components<GeometryComponent>();
 
-      if (vertices.is_empty() || indices.is_empty() ||
-          bone_index.is_empty() || bone_weight.is_empty()) {
-        log_error("Dynamic GeometryComponent with invalid model");
-        continue;
+  // each component writes only its own geometry cache
+  core().job_system().parallel_for(components.size(), GEOMETRY_JOB_CHUNK,
+    [this, &components](u32 begin, u32 end)
+    {
+      for (u32 i = begin; i < end; ++i) {
+        regenerate_mesh(*components[i]);
       }
+    });
+}
 
-      GeometryCache &cache = component->geometry_cache();
-      cache.vertices.clear();
-
-      const Vec3f *src_vertices =
-        reinterpret_cast<const Vec3f *>(vertices.data());
-      const u32 *src_bone_index =
-        reinterpret_cast<const u32 *>(bone_index.data());
-      const Vec4f *src_bone_weight =
-        reinterpret_cast<const Vec4f *>(bone_weight.data());
-
-      const Slice<Mat4f> transformations = skeleton->get_transforms();
-
-      u32 count = vertices.raw_size() / sizeof(Vec3f);
-
-      for (u32 i = 0; i < count; ++i) {
-        u32 bi = src_bone_index[i];
-        Vec4f weights = src_bone_weight[i];
-        Vec3f v(0, 0, 0);
-
-        for (u32 j = 0; j < 4; ++j, bi >>= 8) {
-          u32 index = bi & 0xFF;
-          f32 w = weights[j];
-          v += transform_point(transformations[index], src_vertices[i]) * w;
-        }
-        cache.vertices.push_back(v);
-      }
-    }
-  }
+ProcessorAccess GeometryProcessor::access() const
+{
+  return ProcessorAccess{ProcessorData::SKELETONS, ProcessorData::GEOMETRY};
 }
 
 bool GeometryProcessor::intersect_ray(const Ray &ray, u32 categories,
-  RayGeometryResult &result)
+  RayGeometryResult &result, f32 lod_distance)
 {
-  f32 tnearest = F32_MAX;
+  update_bvh();
+
+  const ComponentRange<GeometryComponent> components = world().components<GeometryComponent>();
   u32 inearest = U32_MAX;
-  Vec3f intersection;
+  u32 lod_nearest = 0;
   Vec3f normal;
   GeometryComponent *nearest = nullptr;
 
-  for (GeometryComponent *component : my_components) {
+  f32 tnearest = my_bvh.intersect_ray(ray, [&](u32 primitive, f32 tmax) -> f32 {
+    GeometryComponent *component = components[primitive];
+
     if ((component->categories() & categories) == 0) {
-      continue;
+      return -1;
     }
 
-    Entity &entity = component->entity();
-    Component *found = entity.find_component<ModelComponent>();
+    const Model *model = find_model(*component);
     // entity doesn't have model, skip it
-    if (found == nullptr) {
-      continue;
+    if (model == nullptr) {
+      return -1;
     }
 
-    ModelComponent *model_component = static_cast<ModelComponent *>(found);
-    ModelResourcePtr model_resource = model_component->get_model();
-
-    if (model_resource == nullptr) {
-      continue;
-    }
-
-    const Model &model = model_resource->model();
-
-    const DataStream *vertices = model.find_array(MODEL_VERTEX, Type::F32);
-    const DataStream *indices = model.find_array(MODEL_INDEX, Type::U32);
+    const DataStream *vertices = model->find_array(MODEL_VERTEX, Type::F32);
+    const DataStream *indices = model->find_array(MODEL_INDEX, Type::U32);
 
     if (vertices == nullptr || indices == nullptr) {
-      continue;
+      return -1;
     }
 
     const Slice<Vec3f> v(reinterpret_cast<const Vec3f *>(vertices->data.data()),
       vertices->data.size() / sizeof(Vec3f));
-    const Slice<u32> i(reinterpret_cast<const u32 *>(indices->data.data()),
+    Slice<u32> i(reinterpret_cast<const u32 *>(indices->data.data()),
       indices->data.size() / sizeof(u32));
+    Slice<LodLevel> lods = model->lods();
+    u32 lod = 0;
+
+    // far check doesn't need exact surface, use the coarsest level
+    if (lods.size() > 0 && intersect_bounding_box(ray, my_boxes[primitive]) > lod_distance) {
+      Slice<u32> lod_indices = model->find_stream<u32>(MODEL_LOD_INDEX);
+      const LodLevel &coarsest = lods[lods.size() - 1];
 
-    Mat4f transform = entity.transform();
-    Mat4f inverted = transform.inverted();
+      if (coarsest.first + coarsest.count <= lod_indices.size()) {
+        i = Slice<u32>(lod_indices.data() + coarsest.first, coarsest.count);
+        lod = lods.size();
+      }
+    }
+
+    // transformation is affine, so t is same in local and world space
+    Mat4f inverted = component->entity().transform().inverted();
     Ray r(transform_point(inverted, ray.origin),
           transform_vec(inverted, ray.dir));
 
     u32 index;
-    f32 t = intersect_mesh(r, v, i, index);
+    // model hierarchy is built over the full mesh
+    f32 t = model->bvh.is_empty() || lod > 0 ? intersect_mesh(r, v, i, index)
+                                             : intersect_mesh(r, model->bvh, v, i, index);
 
-    if (t > 0 && t < tnearest) {
+    if (t > 0 && t < tmax) {
       inearest = index;
-      tnearest = t;
+      lod_nearest = lod;
       nearest = component;
-      intersection = transform_point(transform, r.origin) + transform_vec(transform, r.dir) * t;
 
       Vec3f v0 = v[i[index * 3    ]];
       Vec3f v1 = v[i[index * 3 + 1]];
       Vec3f v2 = v[i[index * 3 + 2]];
       normal = cross3(v1 - v0, v2 - v0).normalized();
-
+      return t;
     }
-  }
+
+    return -1;
+  });
 
   if (nearest != nullptr) {
-    result.hit = intersection;
+    result.hit = ray.origin + ray.dir * tnearest;
     result.component = nearest;
     result.triangle = inearest;
     result.normal = normal;
     result.t = tnearest;
+    result.lod = lod_nearest;
   }
 
   return nearest != nullptr;
 }
 
-void GeometryProcessor::register_component(GeometryComponent *component)
+void GeometryProcessor::on_transform_changed(Entity &entity)
+{
+  if (entity.has_component(ComponentType::GEOMETRY)) {
+    my_needs_refit = true;
+  }
+}
+
+void GeometryProcessor::update_bvh()
 {
-  assert(component != nullptr);
-  my_components.push_back(component);
+  const ComponentPool &pool = world().component_pool(ComponentType::GEOMETRY);
+  // component was added/removed (packed order has changed)
+  bool needs_rebuild = pool.revision() != my_revision;
+
+  if (!needs_rebuild && !my_needs_refit && !has_new_bounds()) {
+    return;
+  }
+
+  const ComponentRange<GeometryComponent> components = pool.view<GeometryComponent>();
+  my_boxes.resize(components.size());
+  my_unbounded.clear();
+
+  for (u32 i = 0; i < components.size(); ++i) {
+    GeometryComponent *component = components[i];
+    Entity &entity = component->entity();
+    const Model *model = find_model(*component);
+    // entity bounding box doesn't have to enclose model geometry, prefer model bounds
+    my_boxes[i] = model != nullptr && !model->bvh.is_empty()
+      ? transform_bounding_box(entity.transform(), model->bvh.bounds())
+      : entity.aabb();
+    // model is still loading, refit once it is ready
+    if (model == nullptr && component->is_model_loading()) {
+      my_unbounded.push_back(i);
+    }
+  }
+
+  Slice<BoundingBox> boxes(my_boxes.data(), my_boxes.size());
+
+  if (needs_rebuild) {
+    my_bvh.build(boxes);
+  } else {
+    my_bvh.refit(boxes);
+  }
+
+  my_revision = pool.revision();
+  my_needs_refit = false;
 }
 
-void GeometryProcessor::unregister_component(GeometryComponent *component)
+bool GeometryProcessor::has_new_bounds() const
 {
-  assert(component != nullptr);
-  utils::erase_remove(my_components, component);
+  const ComponentRange<GeometryComponent> components = world().components<GeometryComponent>();
+
+  for (u32 i : my_unbounded) {
+    if (!components[i]->is_model_loading()) {
+      return true;
+    }
+  }
+
+  return false;
 }
 
 }
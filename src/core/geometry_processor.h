@@ -2,35 +2,77 @@
 
 #include <vector>
 #include "processor.h"
+#include "bvh.h"
 
 namespace atom {
 
-typedef std::vector<GeometryComponent *> GeometryComponentArray;
-
 struct RayGeometryResult {
   GeometryComponent *component;
   Vec3f              hit;       ///< intersection
   f32                t;
-  u32                triangle;  ///< triangle index
+  u32                triangle;  ///< triangle index in the intersected level of detail
   Vec3f              normal;    ///< triangle normal
+  u32                lod;       ///< 0 full mesh, otherwise index to Model::lods() + 1
 };
 
 class GeometryProcessor : public NullProcessor {
-  GeometryComponentArray my_components;
+  std::vector<BoundingBox> my_boxes;          ///< world space box of each component
+  std::vector<u32>         my_unbounded;      ///< components boxed without model bounds
+  Bvh                      my_bvh;            ///< hierarchy over my_boxes
+  u32                      my_revision;       ///< component pool revision used by my_bvh
+  bool                     my_needs_refit;    ///< some component has moved
+  bool                     my_gpu_skinning;   ///< caches are filled by RenderProcessor
   
   void regenerate_mesh(GeometryComponent &component);
+
+  /**
+   * Rebuild/refit world hierarchy when components changed since last query.
+   */
+  void update_bvh();
+
+  /**
+   * @return true when a model of some component from my_unbounded has loaded
+   */
+  bool has_new_bounds() const;
   
 public:
   explicit GeometryProcessor(World &world);
   ~GeometryProcessor();
   
   void poll() override;
+
+  ProcessorAccess access() const override;
   
-  bool intersect_ray(const Ray &ray, u32 categories, RayGeometryResult &result);
-  
-  void register_component(GeometryComponent *component);
+  /**
+   * Nearest intersection of the ray and component geometry.
+   *
+   * @param lod_distance components farther than this (ray parameter t) are
+   *                     tested against their coarsest level of detail
+   */
+  bool intersect_ray(const Ray &ray, u32 categories, RayGeometryResult &result,
+    f32 lod_distance = F32_MAX);
   
-  void unregister_component(GeometryComponent *component);
+  /**
+   * Notification from Entity::set_transform, world hierarchy will be refitted
+   * before next ray query.
+   */
+  void on_transform_changed(Entity &entity);
+
+  /**
+   * Skin dynamic geometry caches on GPU (SkinningFeedback in RenderProcessor),
+   * poll doesn't skin on CPU then. Caches lag SKINNING_FEEDBACK_FRAMES frames
+   * behind the skeleton. Enabled by Config::gpu_skinning, RenderProcessor
+   * falls back to CPU skinning when the feedback shader doesn't link.
+   */
+  void set_gpu_skinning(bool enable)
+  {
+    my_gpu_skinning = enable;
+  }
+
+  bool gpu_skinning() const
+  {
+    return my_gpu_skinning;
+  }
 };
 
 }
@@ -0,0 +1,167 @@
+#include "job_system.h"
+#include <algorithm>
+#include <cassert>
+
+namespace atom {
+
+namespace {
+
+// queue of the current thread (workers only)
+thread_local const JobSystem *tl_owner = nullptr;
+thread_local u32              tl_queue = 0;
+
+}
+
+JobSystem::JobSystem(u32 count, bool deterministic)
+  : my_queued(0)
+  , my_quit(false)
+{
+  if (deterministic) {
+    count = 0;
+  } else if (count == 0) {
+    u32 hardware = std::thread::hardware_concurrency();
+    count = hardware > 1 ? hardware - 1 : 0;
+  }
+
+  for (u32 i = 0; i <= count; ++i) {
+    my_queues.push_back(uptr<Queue>(new Queue()));
+  }
+
+  for (u32 i = 0; i < count; ++i) {
+    my_workers.push_back(std::thread(&JobSystem::run_worker, this, i + 1));
+  }
+}
+
+JobSystem::~JobSystem()
+{
+  {
+    std::lock_guard<std::mutex> lock(my_sleep_mutex);
+    my_quit = true;
+  }
+
+  my_wake.notify_all();
+
+  for (std::thread &worker : my_workers) {
+    worker.join();
+  }
+}
+
+void JobSystem::run(const Job &job, JobCounter &counter)
+{
+  if (is_deterministic()) {
+    job();
+    return;
+  }
+
+  counter.my_pending.fetch_add(1, std::memory_order_relaxed);
+
+  Queue &queue = *my_queues[queue_index()];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(Task{job, &counter});
+  }
+
+  my_queued.fetch_add(1, std::memory_order_release);
+  // sleeping worker checks my_queued under this lock, no wakeup is lost
+  { std::lock_guard<std::mutex> lock(my_sleep_mutex); }
+  my_wake.notify_one();
+}
+
+void JobSystem::wait(JobCounter &counter)
+{
+  u32 index = queue_index();
+
+  while (!counter.is_done()) {
+    if (!execute_one(index)) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void JobSystem::parallel_for(u32 count, u32 chunk_size,
+  const std::function<void(u32, u32)> &f)
+{
+  assert(chunk_size > 0);
+
+  if (count <= chunk_size || is_deterministic()) {
+    if (count > 0) {
+      f(0, count);
+    }
+    return;
+  }
+
+  JobCounter counter;
+  // the first chunk is processed by the calling thread
+  for (u32 begin = chunk_size; begin < count; begin += chunk_size) {
+    u32 end = std::min(begin + chunk_size, count);
+    run([&f, begin, end] { f(begin, end); }, counter);
+  }
+
+  f(0, chunk_size);
+  wait(counter);
+}
+
+void JobSystem::run_worker(u32 index)
+{
+  tl_owner = this;
+  tl_queue = index;
+
+  while (true) {
+    if (execute_one(index)) {
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(my_sleep_mutex);
+    my_wake.wait(lock, [this] { return my_quit || my_queued.load(std::memory_order_acquire) > 0; });
+
+    if (my_quit) {
+      break;
+    }
+  }
+}
+
+bool JobSystem::execute_one(u32 index)
+{
+  Task task;
+  bool found = false;
+
+  // the newest job from own queue
+  {
+    Queue &queue = *my_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      found = true;
+    }
+  }
+
+  // steal the oldest job from other queues
+  for (u32 i = 1; i < my_queues.size() && !found; ++i) {
+    Queue &queue = *my_queues[(index + i) % my_queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      found = true;
+    }
+  }
+
+  if (!found) {
+    return false;
+  }
+
+  my_queued.fetch_sub(1, std::memory_order_relaxed);
+  task.job();
+  task.counter->my_pending.fetch_sub(1, std::memory_order_release);
+  return true;
+}
+
+u32 JobSystem::queue_index() const
+{
+  return tl_owner == this ? tl_queue : 0;
+}
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "noncopyable.h"
+#include "platform.h"
+#include "ptr.h"
+#include "thread_pool.h"
+
+namespace atom {
+
+/**
+ * Number of unfinished jobs, see JobSystem::run and JobSystem::wait.
+ */
+class JobCounter : private NonCopyable {
+public:
+  JobCounter()
+    : my_pending(0)
+  {}
+
+  bool is_done() const
+  {
+    return my_pending.load(std::memory_order_acquire) == 0;
+  }
+
+private:
+  friend class JobSystem;
+
+  std::atomic<u32> my_pending;
+};
+
+/**
+ * Work-stealing job system for short CPU jobs (frame work). Each worker has
+ * its own queue, it takes the newest job from its queue and steals the oldest
+ * jobs from the other queues when its queue is empty. Thread waiting for
+ * a counter executes jobs too, so jobs can wait for nested jobs.
+ *
+ * In deterministic mode there are no workers and jobs are executed
+ * immediately on the calling thread in submission order (replays).
+ */
+class JobSystem : private NonCopyable {
+public:
+  /**
+   * @param count number of worker threads, 0 means number of hardware threads
+   *              minus one (the main thread)
+   * @param deterministic execute all jobs serially on the calling thread
+   */
+  explicit JobSystem(u32 count = 0, bool deterministic = false);
+  ~JobSystem();
+
+  /**
+   * Queue the job, @p counter is decremented when the job is finished.
+   */
+  void run(const Job &job, JobCounter &counter);
+
+  /**
+   * Execute jobs until all jobs of the @p counter are finished.
+   */
+  void wait(JobCounter &counter);
+
+  /**
+   * Split range [0, count) to chunks of @p chunk_size and process them in
+   * parallel, returns when all chunks are finished. Chunks must not write
+   * to shared data.
+   */
+  void parallel_for(u32 count, u32 chunk_size, const std::function<void(u32, u32)> &f);
+
+  bool is_deterministic() const
+  {
+    return my_workers.empty();
+  }
+
+  u32 worker_count() const
+  {
+    return my_workers.size();
+  }
+
+private:
+  struct Task {
+    Job         job;
+    JobCounter *counter;
+  };
+
+  struct Queue {
+    std::mutex       mutex;
+    std::deque<Task> tasks;
+  };
+
+  void run_worker(u32 index);
+
+  /**
+   * Execute one job from the queue @p index or steal one from other queues.
+   *
+   * @return false when there is no job
+   */
+  bool execute_one(u32 index);
+
+  u32 queue_index() const;
+
+private:
+  std::vector<uptr<Queue>> my_queues;   ///< 0 is shared by non worker threads
+  std::vector<std::thread> my_workers;
+  std::atomic<u32>         my_queued;   ///< number of jobs in all queues
+  std::mutex               my_sleep_mutex;
+  std::condition_variable  my_wake;
+  bool                     my_quit;
+};
+
+}
@@ -6,6 +6,7 @@
 #include "sound.h"
 #include "music.h"
 #include "resource_service.h"
+#include "config.h"
 #include <rapidjson/filestream.h>
 
 namespace atom {
@@ -337,11 +338,68 @@ void MeshLoader::reload_resource(ResourceService &rs, Resource &resource)
   }
 }
 
+/**
+ * Append indices of coarser levels of detail after MODEL_INDEX, so all levels
+ * share one index buffer and fill Mesh::lods with their ranges.
+ */
+static Slice<u32> mesh_surface_with_lods(const Model &model, Mesh &mesh,
+  std::vector<u32> &storage)
+{
+  Slice<u32> indices = model.find_stream<u32>(MODEL_INDEX);
+  Slice<u32> lod_indices = model.find_stream<u32>(MODEL_LOD_INDEX);
+  Slice<LodLevel> lods = model.lods();
+
+  if (indices.is_empty() || lod_indices.is_empty() || lods.size() == 0) {
+    return indices;
+  }
+
+  for (const LodLevel &lod : lods) {
+    if (lod.first + lod.count > lod_indices.size()) {
+      log_error("Model has invalid level of detail, using only the full mesh");
+      return indices;
+    }
+  }
+
+  storage.reserve(indices.size() + lod_indices.size());
+  storage.assign(indices.begin(), indices.end());
+  storage.insert(storage.end(), lod_indices.begin(), lod_indices.end());
+  mesh.index_count = indices.size();
+  mesh.lods.push_back(LodLevel{0, indices.size(), 0});
+
+  for (const LodLevel &lod : lods) {
+    mesh.lods.push_back(LodLevel{indices.size() + lod.first, lod.count, lod.error});
+  }
+
+  return Slice<u32>(storage.data(), storage.size());
+}
+
 void MeshLoader::load_mesh_from_model(ResourceService &rs, const Model &model, Mesh &mesh)
 {
+  VideoService &vs = rs.video_service();
+  std::vector<u32> surface_data;
+  Slice<u32> surface = mesh_surface_with_lods(model, mesh, surface_data);
+  VertexLayout layout;
+  std::vector<u8> data;
+
+  Slice<f32> positions = model.find_stream<f32>(MODEL_VERTEX);
+
+  for (u32 i = 0; i + 2 < positions.size(); i += 3) {
+    mesh.bounds.extend(Vec3f(positions[i], positions[i + 1], positions[i + 2]));
+  }
+
+  // indexed meshes use one interleaved buffer with compact formats
+  if (!surface.is_empty() && interleave_model_vertices(model, layout, data)) {
+    mesh.vertices.reset(new VideoBuffer(vs, VideoBufferUsage::STATIC_DRAW));
+    mesh.vertices->set_bytes(data.data(), data.size());
+    mesh.surface.reset(new VideoBuffer(vs, VideoBufferUsage::STATIC_DRAW));
+    mesh.surface->set_data(surface);
+    mesh.vertex_array.reset(new VertexArray(vs, *mesh.vertices, layout, mesh.surface.get()));
+    return;
+  }
+
   Slice<f32> vertices = model.find_stream<f32>(MODEL_VERTEX);
   Slice<f32> normals = model.find_stream<f32>(MODEL_NORMAL);
-  Slice<u32> indices = model.find_stream<u32>(MODEL_INDEX);
+  Slice<u32> indices = surface;
   Slice<u32> bone_index = model.find_stream<u32>(MODEL_BONE_INDEX);
   Slice<f32> bone_weight = model.find_stream<f32>(MODEL_BONE_WEIGHT);
 
@@ -416,7 +474,8 @@ void BitmapFontLoader::reload_resource(ResourceService &rs, Resource &resource)
 ResourcePtr SoundLoader::create_resource(ResourceService &rs, const String &name)
 {
   String filename = sound_filename(name);
-  auto sound = Sound::create_from_file(filename.c_str());
+  auto sound = Sound::create_from_file(filename.c_str(), Config::instance().linear_resampling ?
+    ResampleQuality::LINEAR : ResampleQuality::SINC);
   SoundResourcePtr resource = std::make_shared<SoundResource>();
   resource->set_name(String("sound:") + name);
   resource->depend_on_file(filename);
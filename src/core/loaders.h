@@ -117,7 +117,6 @@ public:
 
   void reload_resource(ResourceService &rs, Resource &resource) override;
 
-private:
   static void load_mesh_from_model(ResourceService &rs, const Model &model, Mesh &mesh);
 };
 
@@ -147,8 +146,7 @@ public:
 
   void reload_resource(ResourceService &rs, Resource &resource) override;
 
-private:
-  String sound_filename(const String &name);
+  static String sound_filename(const String &name);
 };
 
 //-----------------------------------------------------------------------------
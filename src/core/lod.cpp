@@ -0,0 +1,32 @@
+#include "lod.h"
+#include "constants.h"
+
+namespace atom {
+
+u32 select_lod(const Slice<LodLevel> &lods, f32 pixels_per_unit, u32 current)
+{
+  if (lods.size() == 0) {
+    return 0;
+  }
+
+  u32 lod = current < lods.size() ? current : lods.size() - 1;
+
+  // current level is too coarse
+  while (lod > 0 && lods[lod].error * pixels_per_unit > LOD_PIXEL_ERROR) {
+    --lod;
+  }
+
+  if (lod != current) {
+    return lod;
+  }
+
+  // switch to coarser level only with some margin
+  while (lod + 1 < lods.size() &&
+         lods[lod + 1].error * pixels_per_unit < LOD_PIXEL_ERROR * LOD_HYSTERESIS) {
+    ++lod;
+  }
+
+  return lod;
+}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "foundation.h"
+
+namespace atom {
+
+/**
+ * Level of detail of indexed mesh, all levels share vertices of the mesh and
+ * differ only in indices.
+ */
+struct LodLevel {
+  u32 first;    ///< first index of the level
+  u32 count;    ///< index count
+  f32 error;    ///< max geometric error in model units (0 for the full mesh)
+};
+
+static_assert(sizeof(LodLevel) == 3 * sizeof(u32), "LodLevel is stored in u32 model stream");
+
+/**
+ * Select level of detail by the error projected to the screen. Coarser level
+ * is used when its error is smaller than LOD_PIXEL_ERROR * LOD_HYSTERESIS
+ * pixels, finer one when the error of current level exceeds LOD_PIXEL_ERROR,
+ * so the level doesn't switch back and forth near the threshold.
+ *
+ * @param lods levels ordered from the finest
+ * @param pixels_per_unit screen size of one model unit at the object distance
+ * @param current level used in the previous frame
+ */
+u32 select_lod(const Slice<LodLevel> &lods, f32 pixels_per_unit, u32 current);
+
+}
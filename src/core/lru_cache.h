@@ -35,6 +35,9 @@ public:
     T* operator->()
     { return &(operator*()); }
 
+    const Key& key() const
+    { return my_base_iterator->first; }
+
     const T* operator->() const
     { return &(operator*()); }
 
@@ -128,6 +131,44 @@ public:
   iterator end()
   { return IteratorWrapper(my_dict.end()); }
 
+  bool empty() const
+  { return my_dict.empty(); }
+
+  /**
+   * Najmenej pouzivany (najstarsi) prvok, end() pre prazdnu cache.
+   */
+  iterator oldest()
+  { return IteratorWrapper(my_tail); }
+
+  /**
+   * Odstranenie prvku.
+   *
+   * @return true ak bol prvok v cache
+   */
+  bool erase(const Key &key)
+  {
+    typename Dictionary::iterator item = my_dict.find(key);
+
+    if (item == my_dict.end())
+      return false;
+
+    typename Dictionary::iterator prev = item->second.prev;
+    typename Dictionary::iterator next = item->second.next;
+
+    if (prev != my_dict.end())
+      prev->second.next = next;
+    else
+      my_head = next;
+
+    if (next != my_dict.end())
+      next->second.prev = prev;
+    else
+      my_tail = prev;
+
+    my_dict.erase(item);
+    return true;
+  }
+
 private:  // private structs
   /**
    * Priprava pred vlozenim noveho prvku (zmazanie jedneho prvku ak je cache plna).
@@ -0,0 +1,111 @@
+#include "mapped_file.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+#include "log.h"
+
+namespace atom {
+
+MappedFile::MappedFile()
+  : my_data(nullptr)
+  , my_size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+#ifdef __linux__
+
+bool MappedFile::open(const String &filename)
+{
+  close();
+
+  int fd = ::open(filename.c_str(), O_RDONLY);
+
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info;
+
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+
+  void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // mapping stays valid after the descriptor is closed
+  ::close(fd);
+
+  if (data == MAP_FAILED) {
+    log_error("Can't map file \"%s\"", filename.c_str());
+    return false;
+  }
+
+  my_data = static_cast<const u8 *>(data);
+  my_size = info.st_size;
+  return true;
+}
+
+void MappedFile::close()
+{
+  if (my_data != nullptr) {
+    munmap(const_cast<u8 *>(my_data), my_size);
+  }
+
+  my_data = nullptr;
+  my_size = 0;
+}
+
+#else
+
+bool MappedFile::open(const String &filename)
+{
+  close();
+
+  std::ifstream input(filename.c_str(), std::ios::binary | std::ios::ate);
+
+  if (!input.is_open()) {
+    return false;
+  }
+
+  std::streamsize size = input.tellg();
+
+  if (size <= 0) {
+    return false;
+  }
+
+  my_buffer.resize(size);
+  input.seekg(0);
+  input.read(reinterpret_cast<char *>(&my_buffer[0]), size);
+
+  if (!input) {
+    my_buffer.clear();
+    return false;
+  }
+
+  my_data = my_buffer.data();
+  my_size = size;
+  return true;
+}
+
+void MappedFile::close()
+{
+  my_buffer.clear();
+  my_data = nullptr;
+  my_size = 0;
+}
+
+#endif
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include "noncopyable.h"
+#include "platform.h"
+#include "string.h"
+
+namespace atom {
+
+/**
+ * Read-only view of the whole file content. On linux the file is mapped into
+ * memory (mmap), on other platforms the content is read into a buffer.
+ * Data pointer is valid as long as the MappedFile instance exists.
+ */
+class MappedFile : private NonCopyable {
+public:
+  MappedFile();
+  ~MappedFile();
+
+  bool open(const String &filename);
+
+  void close();
+
+  bool is_open() const
+  {
+    return my_data != nullptr;
+  }
+
+  const u8* data() const
+  {
+    return my_data;
+  }
+
+  u32 size() const
+  {
+    return my_size;
+  }
+
+private:
+  const u8       *my_data;
+  u32             my_size;
+#ifndef __linux__
+  std::vector<u8> my_buffer;
+#endif
+};
+
+}
@@ -2,11 +2,14 @@
 
 #include <vector>
 #include "math.h"
+#include "slice.h"
 
 namespace atom {
 
 typedef std::vector<Mat4f> Mat4fArray;
+/// matrix array uniform, references memory of its owner (no copy)
+typedef Slice<Mat4f> Mat4fSlice;
 
-TYPE_OF(Mat4fArray, MAT4F_ARRAY)
+TYPE_OF(Mat4fSlice, MAT4F_ARRAY)
 
 }
@@ -27,7 +27,8 @@ META_CLASS(SimpleMaterial,
   FIELD(my_draw_type, "draw_type"),
   FIELD(my_fill_mode, "fill_mode"),
   FIELD(my_depth_test, "depth_test"),
-  FIELD(my_technique, "shader")
+  FIELD(my_technique, "shader"),
+  FIELD(my_instanced_technique, "instanced_shader")
 )
 
 uptr<atom::SimpleMaterial::Material> SimpleMaterial::create(ResourceService &rs)
@@ -52,39 +53,62 @@ SimpleMaterial::~SimpleMaterial()
 
 void SimpleMaterial::draw_mesh(const RenderContext &context, const Mesh &mesh)
 {
-  if (my_technique == nullptr) {
+  bool instanced = context.instance_count > 0;
+  const TechniqueResourcePtr &technique = instanced ? my_instanced_technique : my_technique;
+
+  if (technique == nullptr) {
     log_warning("%s: no shader", ATOM_FUNC_NAME);
     return;
   }
 
   DrawCommand command;
 
-  if (my_flags & DrawFlags::VERTEX) {
-    if (mesh.vertex == nullptr) {
+  if (mesh.vertex_array != nullptr) {
+    const VertexLayout &layout = mesh.vertex_array->layout();
+
+    if (((my_flags & DrawFlags::VERTEX) && layout.find(POSITION_ATTRIBUTE) == nullptr) ||
+        ((my_flags & DrawFlags::NORMAL) && layout.find(NORMAL_ATTRIBUTE) == nullptr) ||
+        ((my_flags & DrawFlags::COLOR) && layout.find(COLOR_ATTRIBUTE) == nullptr)) {
+      log_warning("%s: mesh layout is missing vertex data", ATOM_FUNC_NAME);
+      return;
+    }
+
+    command.vertex_array = mesh.vertex_array.get();
+  } else if (my_flags & DrawFlags::VERTEX) {
+    if (mesh.vertex != nullptr) {
+      command.attributes[POSITION_ATTRIBUTE] = mesh.vertex.get();
+    } else if (mesh.stream_vertex.buffer != nullptr) {
+      command.attributes[POSITION_ATTRIBUTE] = mesh.stream_vertex.buffer;
+      command.offsets[POSITION_ATTRIBUTE] = mesh.stream_vertex.offset;
+      command.vertex_count = mesh.stream_vertex.size / sizeof(Vec3f);
+    } else {
       log_warning("%s: mesh missing vertex data", ATOM_FUNC_NAME);
       return;
     }
 
-    command.attributes[0] = mesh.vertex.get();
-    command.types[0] = Type::VEC3F;
+    command.types[POSITION_ATTRIBUTE] = Type::VEC3F;
   }
 
-  if (my_flags & DrawFlags::NORMAL) {
+  if ((my_flags & DrawFlags::NORMAL) && command.vertex_array == nullptr) {
     if (mesh.normal == nullptr) {
       log_warning("%s: mesh missing normal data", ATOM_FUNC_NAME);
       return;
     }
-    command.attributes[1] = mesh.normal.get();
-    command.types[1] = Type::VEC3F;
+    command.attributes[NORMAL_ATTRIBUTE] = mesh.normal.get();
+    command.types[NORMAL_ATTRIBUTE] = Type::VEC3F;
   }
 
-  if (my_flags & DrawFlags::COLOR) {
-    if (mesh.color == nullptr) {
+  if ((my_flags & DrawFlags::COLOR) && command.vertex_array == nullptr) {
+    if (mesh.color != nullptr) {
+      command.attributes[COLOR_ATTRIBUTE] = mesh.color.get();
+    } else if (mesh.stream_color.buffer != nullptr) {
+      command.attributes[COLOR_ATTRIBUTE] = mesh.stream_color.buffer;
+      command.offsets[COLOR_ATTRIBUTE] = mesh.stream_color.offset;
+    } else {
       log_warning("%s: mesh missing color data", ATOM_FUNC_NAME);
       return;
     }
-    command.attributes[2] = mesh.color.get();
-    command.types[2] = Type::VEC3F;
+    command.types[COLOR_ATTRIBUTE] = Type::VEC3F;
   }
 
   if (my_flags & DrawFlags::INDEX) {
@@ -95,14 +119,44 @@ void SimpleMaterial::draw_mesh(const RenderContext &context, const Mesh &mesh)
     command.indices = mesh.surface.get();
   }
 
+  if (instanced) {
+    if (context.instances == nullptr || command.indices == nullptr) {
+      log_warning("%s: instanced draw needs instance and index data", ATOM_FUNC_NAME);
+      return;
+    }
+
+    command.attributes[INSTANCE_ATTRIBUTE] = context.instances;
+    command.types[INSTANCE_ATTRIBUTE] = Type::MAT4F;
+    command.instance_count = context.instance_count;
+  }
+
+  if (context.lod != nullptr) {
+    command.first_index = context.lod->first;
+    command.index_count = context.lod->count;
+  } else {
+    // surface contains coarser levels after the full mesh
+    command.index_count = mesh.index_count;
+  }
+
   command.draw = my_draw_type;
   command.face = my_draw_face;
   command.fill_mode = my_fill_mode;
   command.depth_test = my_depth_test;
-  command.program = &my_technique->program();
+  command.program = &technique->program();
   context.video_processor.draw(command);
 }
 
+const Technique* SimpleMaterial::technique() const
+{
+  return my_technique != nullptr ? &my_technique->program() : nullptr;
+}
+
+bool SimpleMaterial::supports_instancing() const
+{
+  return my_instanced_technique != nullptr && (my_flags & DrawFlags::INDEX) &&
+    my_draw_type == DrawType::TRIANGLES;
+}
+
 
 //
 // DebugMaterial (wireframe)
@@ -247,7 +301,15 @@ void FlatSkinMaterial::draw_mesh(const RenderContext &context, const Mesh &mesh)
 {
   assert(my_shader != nullptr);
 
-  if (mesh.vertex == nullptr || mesh.normal == nullptr || mesh.surface == nullptr) {
+  if (mesh.vertex_array != nullptr) {
+    const VertexLayout &layout = mesh.vertex_array->layout();
+
+    if (layout.find(BONE_INDEX_ATTRIBUTE) == nullptr || layout.find(BONE_WEIGHT_ATTRIBUTE) == nullptr ||
+        mesh.surface == nullptr) {
+      log_warning("%s: mesh layout is missing bone or surface data", ATOM_FUNC_NAME);
+      return;
+    }
+  } else if (mesh.vertex == nullptr || mesh.normal == nullptr || mesh.surface == nullptr) {
     log_warning("%s: mesh is missing vertex, normal or surface data", ATOM_FUNC_NAME);
     return;
   } else if (mesh.bone_weight == nullptr || mesh.bone_index == nullptr) {
@@ -263,16 +325,35 @@ void FlatSkinMaterial::draw_mesh(const RenderContext &context, const Mesh &mesh)
 
   DrawCommand command;
   command.draw = DrawType::TRIANGLES;
-  command.attributes[0] = mesh.vertex.get();
-  command.types[0] = Type::VEC3F;
-  command.attributes[1] = mesh.bone_index.get();
-  command.types[1] = Type::VEC4U8;
-  command.attributes[2] = mesh.bone_weight.get();
-  command.types[2] = Type::VEC4F;
+  command.vertex_array = mesh.vertex_array.get();
+
+  if (command.vertex_array == nullptr) {
+    command.attributes[POSITION_ATTRIBUTE] = mesh.vertex.get();
+    command.types[POSITION_ATTRIBUTE] = Type::VEC3F;
+    command.attributes[BONE_INDEX_ATTRIBUTE] = mesh.bone_index.get();
+    command.types[BONE_INDEX_ATTRIBUTE] = Type::VEC4U8;
+    command.attributes[BONE_WEIGHT_ATTRIBUTE] = mesh.bone_weight.get();
+    command.types[BONE_WEIGHT_ATTRIBUTE] = Type::VEC4F;
+  }
+
   command.indices = mesh.surface.get();
+
+  if (context.lod != nullptr) {
+    command.first_index = context.lod->first;
+    command.index_count = context.lod->count;
+  } else {
+    // surface contains coarser levels after the full mesh
+    command.index_count = mesh.index_count;
+  }
+
   command.program = &my_shader->program();
   vs.draw(command);
 }
 
+const Technique* FlatSkinMaterial::technique() const
+{
+  return my_shader != nullptr ? &my_shader->program() : nullptr;
+}
+
 
 }
@@ -27,6 +27,22 @@ public:
 
   virtual void draw_mesh(const RenderContext &context, const Mesh &mesh) = 0;
 
+  /**
+   * Program used by draw_mesh (render queue sort key), nullptr when unknown.
+   */
+  virtual const Technique* technique() const
+  {
+    return nullptr;
+  }
+
+  /**
+   * Material can draw RenderContext::instances with one draw call.
+   */
+  virtual bool supports_instancing() const
+  {
+    return false;
+  }
+
   DrawFace face() const
   {
     return my_face;
@@ -45,6 +61,7 @@ class SimpleMaterial : public Material {
   FillMode             my_fill_mode;
   bool                 my_depth_test;
   TechniqueResourcePtr my_technique;
+  TechniqueResourcePtr my_instanced_technique;  ///< optional, model matrix as vertex attribute
 
 public:
   enum DrawFlags {
@@ -61,6 +78,10 @@ public:
 
   void draw_mesh(const RenderContext &context, const Mesh &mesh) override;
 
+  const Technique* technique() const override;
+
+  bool supports_instancing() const override;
+
   META_SUB_CLASS(Material);
 };
 
@@ -156,6 +177,8 @@ public:
 
   void draw_mesh(const RenderContext &context, const Mesh &mesh) override;
 
+  const Technique* technique() const override;
+
   TechniqueResourcePtr my_shader;
   Vec3f                my_color;
 
@@ -14,6 +14,11 @@ Vec4f plane_from_vertices(
 
 void BoundingBox::extend(const Vec3f &v)
 {
+  if (is_null()) {
+    *this = BoundingBox(v.x, v.x, v.y, v.y, v.z, v.z);
+    return;
+  }
+
   xmin = min(v.x, xmin);
   xmax = max(v.x, xmax);
   ymin = min(v.y, ymin);
@@ -22,4 +27,37 @@ void BoundingBox::extend(const Vec3f &v)
   zmax = max(v.z, zmax);
 }
 
+void BoundingBox::extend(const BoundingBox &box)
+{
+  if (box.is_null()) {
+    return;
+  }
+
+  if (is_null()) {
+    *this = box;
+    return;
+  }
+
+  xmin = min(box.xmin, xmin);
+  xmax = max(box.xmax, xmax);
+  ymin = min(box.ymin, ymin);
+  ymax = max(box.ymax, ymax);
+  zmin = min(box.zmin, zmin);
+  zmax = max(box.zmax, zmax);
+}
+
+BoundingBox transform_bounding_box(const Mat4f &m, const BoundingBox &box)
+{
+  BoundingBox result;
+  result.extend(transform_point(m, Vec3f(box.xmin, box.ymin, box.zmin)));
+  result.extend(transform_point(m, Vec3f(box.xmax, box.ymin, box.zmin)));
+  result.extend(transform_point(m, Vec3f(box.xmin, box.ymax, box.zmin)));
+  result.extend(transform_point(m, Vec3f(box.xmax, box.ymax, box.zmin)));
+  result.extend(transform_point(m, Vec3f(box.xmin, box.ymin, box.zmax)));
+  result.extend(transform_point(m, Vec3f(box.xmax, box.ymin, box.zmax)));
+  result.extend(transform_point(m, Vec3f(box.xmin, box.ymax, box.zmax)));
+  result.extend(transform_point(m, Vec3f(box.xmax, box.ymax, box.zmax)));
+  return result;
+}
+
 }
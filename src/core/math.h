@@ -169,6 +169,23 @@ Quat<T> slerp(const Quat<T> &a, const Quat<T> &b, T t)
     a.z * ta + b.z * tb);
 }
 
+/**
+ * Normalized linear interpolation along the shorter arc, cheaper than slerp
+ * (angular velocity isn't constant, usable for close rotations).
+ */
+template<typename T>
+Quat<T> nlerp(const Quat<T> &a, const Quat<T> &b, T t)
+{
+  T tb = dot_product(a, b) < 0 ? -t : t;
+  T ta = 1 - t;
+
+  return Quat<T>(
+    a.w * ta + b.w * tb,
+    a.x * ta + b.x * tb,
+    a.y * ta + b.y * tb,
+    a.z * ta + b.z * tb).normalized();
+}
+
 /**
  * @note: this is branchless sign function
  *
@@ -238,7 +255,19 @@ struct BoundingBox {
     return xmin > xmax;
   }
 
+  Vec3f center() const
+  {
+    return Vec3f(xmin + xmax, ymin + ymax, zmin + zmax) * 0.5f;
+  }
+
   void extend(const Vec3f &v);
+
+  void extend(const BoundingBox &box);
 };
 
+/**
+ * Calculate axis aligned box that encloses the @p box transformed by @p m.
+ */
+BoundingBox transform_bounding_box(const Mat4f &m, const BoundingBox &box);
+
 }
@@ -2,6 +2,9 @@
 
 #include "foundation.h"
 #include "video_buffer.h"
+#include "vertex_array.h"
+#include "stream_buffer.h"
+#include "lod.h"
 
 namespace atom {
 
@@ -12,8 +15,20 @@ public:     // public methods
   uptr<VideoBuffer> color;       ///< mesh vertex colors
   uptr<VideoBuffer> uv;
   uptr<VideoBuffer> surface;      ///< triangle indices (u32)
+  u32               index_count;  ///< indices of the full mesh (surface contains lods after it), 0 whole surface
   uptr<VideoBuffer> bone_weight;  ///< per vertex bone weights (Vec4f)
   uptr<VideoBuffer> bone_index;   ///< per vertex bone indices (Vec4u8)
+  uptr<VideoBuffer> vertices;     ///< interleaved vertex data (vertex_array layout)
+  uptr<VertexArray> vertex_array; ///< vertices & surface, replaces separate buffers when set
+  BoundingBox       bounds;       ///< model space bounds, null when unknown (not culled)
+  std::vector<LodLevel> lods;     ///< levels of detail in surface from the finest, empty for single level
+  StreamRange       stream_vertex; ///< vertices written this frame (VideoService::stream_buffer), used without vertex
+  StreamRange       stream_color;  ///< colors written this frame, used without color
+
+  Mesh()
+    : index_count(0)
+  {
+  }
 };
 
 }
@@ -12,13 +12,16 @@ META_CLASS(MeshComponent,
 void MeshComponent::activate()
 {
   if (my_mode == MeshComponentMode::AUTO) {
-    if (my_model->get_model() == nullptr) {
+    ModelResourcePtr model = my_model->get_model_handle();
+
+    if (model == nullptr) {
       log_error("%s: no model", ATOM_FUNC_NAME);
       return;
     }
 
-    StringArray tokens = split_resource_name(my_model->get_model()->name());
-    my_mesh = core().resource_service().get_mesh(tokens[1]);
+    // mesh is uploaded after the model is loaded, see mesh()
+    StringArray tokens = split_resource_name(model->name());
+    my_mesh = core().resource_service().get_mesh_async(tokens[1]);
   }
 }
 
@@ -42,7 +45,7 @@ MeshComponent::~MeshComponent()
 
 MeshResourcePtr MeshComponent::mesh() const
 {
-  return my_mesh;
+  return my_mesh != nullptr && my_mesh->is_ready() ? my_mesh : nullptr;
 }
 
 void MeshComponent::set_mesh(MeshResourcePtr mesh)
@@ -25,6 +25,9 @@ public:
   MeshComponent();
   ~MeshComponent();
 
+  /**
+   * @return nullptr while the mesh is loading
+   */
   MeshResourcePtr mesh() const;
 
   void set_mesh(MeshResourcePtr mesh);
@@ -0,0 +1,329 @@
+#include "mesh_simplify.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+#include "lod.h"
+#include "model.h"
+#include "constants.h"
+#include "log.h"
+
+namespace atom {
+
+namespace {
+
+/**
+ * Symmetric 4x4 matrix, sum of squared distances to planes.
+ */
+struct Quadric {
+  f64 a[10];    // a00 a01 a02 a03 a11 a12 a13 a22 a23 a33
+  f64 planes;   // number of added planes
+
+  Quadric()
+    : planes(0)
+  {
+    std::fill(a, a + 10, 0.0);
+  }
+
+  void add_plane(f64 x, f64 y, f64 z, f64 d)
+  {
+    a[0] += x * x; a[1] += x * y; a[2] += x * z; a[3] += x * d;
+    a[4] += y * y; a[5] += y * z; a[6] += y * d;
+    a[7] += z * z; a[8] += z * d;
+    a[9] += d * d;
+    planes += 1;
+  }
+
+  void add(const Quadric &q)
+  {
+    for (u32 i = 0; i < 10; ++i) {
+      a[i] += q.a[i];
+    }
+
+    planes += q.planes;
+  }
+
+  f64 evaluate(const Vec3f &v) const
+  {
+    f64 x = v.x, y = v.y, z = v.z;
+    return a[0] * x * x + 2 * a[1] * x * y + 2 * a[2] * x * z + 2 * a[3] * x
+         + a[4] * y * y + 2 * a[5] * y * z + 2 * a[6] * y
+         + a[7] * z * z + 2 * a[8] * z
+         + a[9];
+  }
+};
+
+struct Collapse {
+  f64 cost;
+  f64 error;    // mean squared distance to merged planes
+  u32 from;
+  u32 to;
+  u32 from_version;
+  u32 to_version;
+
+  bool operator<(const Collapse &other) const
+  {
+    // std::priority_queue returns the largest element
+    return cost > other.cost;
+  }
+};
+
+u64 edge_key(u32 a, u32 b)
+{
+  return a < b ? (u64(a) << 32) | b : (u64(b) << 32) | a;
+}
+
+class Simplifier {
+  Slice<Vec3f>                    my_vertices;
+  std::vector<u32>                my_indices;
+  std::vector<u8>                 my_alive;         ///< triangle wasn't removed
+  std::vector<std::vector<u32>>   my_triangles;     ///< triangles of each vertex
+  std::vector<Quadric>            my_quadrics;
+  std::vector<u8>                 my_locked;
+  std::vector<u32>                my_version;       ///< changed on each collapse of vertex
+  std::priority_queue<Collapse>   my_queue;
+  u32                             my_alive_count;
+
+  Vec3f triangle_normal(u32 t, u32 from, u32 to) const
+  {
+    Vec3f v[3];
+
+    for (u32 i = 0; i < 3; ++i) {
+      u32 index = my_indices[t * 3 + i];
+      v[i] = my_vertices[index == from ? to : index];
+    }
+
+    return cross3(v[1] - v[0], v[2] - v[0]);
+  }
+
+  void push(u32 from, u32 to)
+  {
+    if (my_locked[from]) {
+      return;
+    }
+
+    Quadric q = my_quadrics[from];
+    q.add(my_quadrics[to]);
+    f64 cost = std::max(q.evaluate(my_vertices[to]), 0.0);
+    my_queue.push(Collapse{cost, q.planes > 0 ? cost / q.planes : 0, from, to,
+      my_version[from], my_version[to]});
+  }
+
+  /**
+   * Collapse doesn't flip any triangle which stays.
+   */
+  bool is_valid(u32 from, u32 to) const
+  {
+    for (u32 t : my_triangles[from]) {
+      if (!my_alive[t]) {
+        continue;
+      }
+
+      const u32 *tri = &my_indices[t * 3];
+
+      if (tri[0] == to || tri[1] == to || tri[2] == to) {
+        continue;
+      }
+
+      Vec3f before = triangle_normal(t, from, from);
+      Vec3f after = triangle_normal(t, from, to);
+
+      if (dot3(before, after) <= 0) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  void collapse(u32 from, u32 to)
+  {
+    for (u32 t : my_triangles[from]) {
+      if (!my_alive[t]) {
+        continue;
+      }
+
+      u32 *tri = &my_indices[t * 3];
+
+      if (tri[0] == to || tri[1] == to || tri[2] == to) {
+        my_alive[t] = 0;
+        --my_alive_count;
+        continue;
+      }
+
+      for (u32 i = 0; i < 3; ++i) {
+        if (tri[i] == from) {
+          tri[i] = to;
+        }
+      }
+
+      my_triangles[to].push_back(t);
+    }
+
+    my_triangles[from].clear();
+    my_quadrics[to].add(my_quadrics[from]);
+    ++my_version[from];
+    ++my_version[to];
+    // from is never used again
+    my_locked[from] = 1;
+
+    for (u32 t : my_triangles[to]) {
+      if (!my_alive[t]) {
+        continue;
+      }
+
+      for (u32 i = 0; i < 3; ++i) {
+        u32 other = my_indices[t * 3 + i];
+
+        if (other != to) {
+          push(other, to);
+          push(to, other);
+        }
+      }
+    }
+  }
+
+public:
+  Simplifier(const Slice<Vec3f> &vertices, const Slice<u32> &indices)
+    : my_vertices(vertices)
+    , my_indices(indices.begin(), indices.end())
+    , my_alive(indices.size() / 3, 1)
+    , my_triangles(vertices.size())
+    , my_quadrics(vertices.size())
+    , my_locked(vertices.size(), 0)
+    , my_version(vertices.size(), 0)
+    , my_alive_count(indices.size() / 3)
+  {
+    std::unordered_map<u64, u32> edges;
+
+    for (u32 t = 0; t < my_alive.size(); ++t) {
+      const u32 *tri = &my_indices[t * 3];
+      Vec3f n = cross3(my_vertices[tri[1]] - my_vertices[tri[0]],
+        my_vertices[tri[2]] - my_vertices[tri[0]]);
+      f32 length = n.length();
+
+      if (length > 0) {
+        n = n * (1 / length);
+      }
+
+      Quadric plane;
+      plane.add_plane(n.x, n.y, n.z, -dot3(n, my_vertices[tri[0]]));
+
+      for (u32 i = 0; i < 3; ++i) {
+        my_triangles[tri[i]].push_back(t);
+        my_quadrics[tri[i]].add(plane);
+        ++edges[edge_key(tri[i], tri[(i + 1) % 3])];
+      }
+    }
+
+    // border & non-manifold edges keep their vertices
+    for (const auto &edge : edges) {
+      if (edge.second != 2) {
+        my_locked[edge.first >> 32] = 1;
+        my_locked[edge.first & 0xFFFFFFFF] = 1;
+      }
+    }
+
+    for (const auto &edge : edges) {
+      u32 a = edge.first >> 32;
+      u32 b = edge.first & 0xFFFFFFFF;
+      push(a, b);
+      push(b, a);
+    }
+  }
+
+  f32 run(u32 target_count, std::vector<u32> &result)
+  {
+    f64 max_error = 0;
+
+    while (my_alive_count * 3 > target_count && !my_queue.empty()) {
+      Collapse c = my_queue.top();
+      my_queue.pop();
+
+      if (c.from_version != my_version[c.from] || c.to_version != my_version[c.to] ||
+          my_locked[c.from] || !is_valid(c.from, c.to)) {
+        continue;
+      }
+
+      collapse(c.from, c.to);
+      max_error = std::max(max_error, c.error);
+    }
+
+    result.clear();
+
+    for (u32 t = 0; t < my_alive.size(); ++t) {
+      if (my_alive[t]) {
+        result.insert(result.end(), &my_indices[t * 3], &my_indices[t * 3] + 3);
+      }
+    }
+
+    return std::sqrt(max_error);
+  }
+};
+
+}
+
+f32 simplify_mesh(const Slice<Vec3f> &vertices, const Slice<u32> &indices, u32 target_count,
+  std::vector<u32> &result)
+{
+  for (u32 index : indices) {
+    if (index >= vertices.size()) {
+      log_error("Mesh index %u is out of range", index);
+      result.assign(indices.begin(), indices.end());
+      return 0;
+    }
+  }
+
+  Simplifier simplifier(vertices, indices);
+  return simplifier.run(target_count, result);
+}
+
+u32 generate_model_lods(Model &model, u32 max_levels)
+{
+  Slice<f32> vertex_data = model.find_stream<f32>(MODEL_VERTEX);
+  Slice<u32> indices = model.find_stream<u32>(MODEL_INDEX);
+
+  if (vertex_data.is_empty() || indices.is_empty()) {
+    log_error("Model without vertices or indices, can't generate LOD");
+    return 0;
+  }
+
+  Slice<Vec3f> vertices(reinterpret_cast<const Vec3f *>(vertex_data.data()),
+    vertex_data.size() / 3);
+  std::vector<LodLevel> lods;
+  std::vector<u32> lod_indices;
+  std::vector<u32> previous(indices.begin(), indices.end());
+  std::vector<u32> simplified;
+
+  for (u32 level = 0; level < max_levels; ++level) {
+    u32 target = static_cast<u32>(previous.size() / 3 * LOD_REDUCTION) * 3;
+    f32 error = simplify_mesh(vertices, Slice<u32>(indices.data(), indices.size()), target,
+      simplified);
+
+    // mesh can't be simplified more (locked borders)
+    if (simplified.size() == 0 || simplified.size() > previous.size() * 0.9f) {
+      break;
+    }
+
+    // error of coarser level is never smaller than error of the finer one
+    f32 last_error = lods.empty() ? 0 : lods.back().error;
+    lods.push_back(LodLevel{static_cast<u32>(lod_indices.size()),
+      static_cast<u32>(simplified.size()), std::max(error, last_error)});
+    lod_indices.insert(lod_indices.end(), simplified.begin(), simplified.end());
+    previous.swap(simplified);
+  }
+
+  if (lods.empty()) {
+    return 0;
+  }
+
+  const u8 *lod_data = reinterpret_cast<const u8 *>(lods.data());
+  const u8 *index_data = reinterpret_cast<const u8 *>(lod_indices.data());
+  model.add_array(MODEL_LOD, Type::U32,
+    std::vector<u8>(lod_data, lod_data + lods.size() * sizeof(LodLevel)));
+  model.add_array(MODEL_LOD_INDEX, Type::U32,
+    std::vector<u8>(index_data, index_data + lod_indices.size() * sizeof(u32)));
+  return lods.size();
+}
+
+}
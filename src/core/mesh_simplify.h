@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include "corefwd.h"
+#include "math.h"
+
+namespace atom {
+
+/**
+ * Simplify indexed triangle mesh by edge collapses ordered by quadric error
+ * (Garland & Heckbert). Vertex is always collapsed to the other edge vertex,
+ * so the result references the original vertices and only indices change.
+ * Vertices on open borders and seams (edge not shared by two triangles) are
+ * locked, collapses flipping a triangle are rejected.
+ *
+ * @param target_count requested index count, result may be larger when the
+ *                     mesh can't be simplified more
+ * @param[out] result indices of the simplified mesh
+ * @return max error of performed collapses in model units, error of one
+ *         collapse is RMS distance of the kept vertex to the merged planes
+ */
+f32 simplify_mesh(const Slice<Vec3f> &vertices, const Slice<u32> &indices, u32 target_count,
+  std::vector<u32> &result);
+
+/**
+ * Generate up to @p max_levels coarser levels of detail from MODEL_VERTEX and
+ * MODEL_INDEX streams, each with LOD_REDUCTION of the previous triangles.
+ * Levels are stored in MODEL_LOD and MODEL_LOD_INDEX streams.
+ *
+ * @return number of generated levels
+ */
+u32 generate_model_lods(Model &model, u32 max_levels);
+
+}
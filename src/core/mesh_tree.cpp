@@ -1,21 +1,97 @@
 #include "mesh_tree.h"
-#include <algorithm>
+#include "constants.h"
 
 namespace atom {
 
-void MeshTree::add_node(const sptr<MeshTreeNode> &node)
+void MeshTree::set_boxes(const Slice<BoundingBox> &boxes)
 {
-  my_nodes.push_back(node);
+  Slice<u32> primitives = my_bvh.primitives();
+  my_boxes.resize(primitives.size());
+
+  for (u32 i = 0; i < primitives.size(); ++i) {
+    my_boxes.set(i, boxes[primitives[i]]);
+  }
+}
+
+void MeshTree::build(const Slice<BoundingBox> &boxes)
+{
+  my_bvh.build(boxes, CULLING_LEAF_SIZE);
+  set_boxes(boxes);
+}
+
+void MeshTree::refit(const Slice<BoundingBox> &boxes)
+{
+  my_bvh.refit(boxes);
+  set_boxes(boxes);
+}
+
+void MeshTree::clear()
+{
+  my_bvh.clear();
+  my_boxes.resize(0);
 }
 
-void MeshTree::remove_node(const sptr<MeshTreeNode> &node)
+void MeshTree::cull(const Frustum &frustum, std::vector<u32> &visible) const
 {
-  my_nodes.erase(std::remove(my_nodes.begin(), my_nodes.end(), node), my_nodes.end());
+  cull(frustum, visible, simd_level());
 }
 
-const std::vector<sptr<MeshTreeNode> > MeshTree::all_nodes() const
+void MeshTree::cull(const Frustum &frustum, std::vector<u32> &visible, SimdLevel level) const
 {
-  return my_nodes;
+  Slice<BvhNode> nodes = my_bvh.nodes();
+  Slice<u32> primitives = my_bvh.primitives();
+
+  if (nodes.size() == 0) {
+    return;
+  }
+
+  const u32 STACK_SIZE = 64;
+  // node index, the highest bit is set when the node is fully inside
+  const u32 INSIDE = 0x80000000u;
+  u32 stack[STACK_SIZE];
+  u32 stack_size = 0;
+  stack[stack_size++] = 0;
+
+  while (stack_size > 0) {
+    u32 entry = stack[--stack_size];
+    const BvhNode &node = nodes[entry & ~INSIDE];
+    bool inside = (entry & INSIDE) != 0;
+
+    if (!inside) {
+      Containment containment = classify_box(frustum, node.box);
+
+      if (containment == Containment::OUTSIDE) {
+        continue;
+      }
+
+      inside = containment == Containment::INSIDE;
+    }
+
+    if (node.is_leaf()) {
+      u32 first = visible.size();
+      visible.resize(first + node.count);
+
+      if (inside) {
+        for (u32 i = 0; i < node.count; ++i) {
+          visible[first + i] = primitives[node.index + i];
+        }
+      } else {
+        u32 count = cull_boxes(frustum, my_boxes, node.index, node.index + node.count,
+          &visible[first], level);
+        // box positions -> object ids
+        for (u32 i = first; i < first + count; ++i) {
+          visible[i] = primitives[visible[i]];
+        }
+
+        visible.resize(first + count);
+      }
+    } else {
+      assert(stack_size + 2 <= STACK_SIZE);
+      u32 flag = inside ? INSIDE : 0;
+      stack[stack_size++] = node.index | flag;
+      stack[stack_size++] = ((entry & ~INSIDE) + 1) | flag;
+    }
+  }
 }
 
 }
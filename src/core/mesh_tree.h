@@ -1,48 +1,50 @@
 #pragma once
 
-#include "mesh_tree_node.h"
+#include <vector>
+#include "bvh.h"
+#include "frustum.h"
 
 namespace atom {
 
+/**
+ * Hierarchy of world space boxes of rendered objects for the view frustum
+ * culling. Nodes are classified against the frustum top-down, subtrees fully
+ * inside are accepted without tests and boxes of intersected leaves are
+ * tested in SIMD batches (cull_boxes).
+ */
 class MeshTree {
-public:
-  void add_node(const sptr<MeshTreeNode> &node);
-
-  void remove_node(const sptr<MeshTreeNode> &node);
+  Bvh      my_bvh;
+  BoxArray my_boxes;      ///< boxes in the order of Bvh::primitives
 
-  const std::vector<sptr<MeshTreeNode>> all_nodes() const;
-
-private:
-  std::vector<sptr<MeshTreeNode>> my_nodes;
-};
+  void set_boxes(const Slice<BoundingBox> &boxes);
 
-class SceneNode : private NonCopyable {
 public:
-  virtual void draw() = 0;
-
-  int layer() const;
-
-private:
-  int my_layer;
-};
-
-inline bool operator<(const SceneNode &a, const SceneNode &b)
-{
-  return a.layer() < b.layer();
-}
-
-inline bool operator<(const sptr<SceneNode> &a, const sptr<SceneNode> &b)
-{
-  return operator<(*a, *b);
-}
-
-class SceneTree {
-public:
-  void add_node(const sptr<SceneNode> &node);
-
-private:
-  std::vector<sptr<SceneNode>> my_nodes;
-
+  /**
+   * Build hierarchy, index of box is object id.
+   */
+  void build(const Slice<BoundingBox> &boxes);
+
+  /**
+   * Update boxes of moved objects, hierarchy topology stays same.
+   *
+   * @param boxes same number of boxes (in same order) as used in build
+   */
+  void refit(const Slice<BoundingBox> &boxes);
+
+  void clear();
+
+  u32 size() const
+  {
+    return my_boxes.size();
+  }
+
+  /**
+   * Append ids of objects intersecting the frustum to @p visible (ordered by
+   * hierarchy, not by id).
+   */
+  void cull(const Frustum &frustum, std::vector<u32> &visible) const;
+
+  void cull(const Frustum &frustum, std::vector<u32> &visible, SimdLevel level) const;
 };
 
 }
@@ -40,6 +40,7 @@ enum class Type : u32 {
   SHADER,
   TEXTURE,
   SAMPLER_2D,
+  SAMPLER_BUFFER,
   DRAW_FACE,
   DRAW_TYPE,
   FILL_MODE,
@@ -1,15 +1,37 @@
 #include "model.h"
 #include <algorithm>
 #include "log.h"
+#include "constants.h"
+#include "mapped_file.h"
 
 namespace atom {
 
+Model::Model()
+{
+}
+
+Model::~Model()
+{
+}
+
 bool Model::add_array(const String &name, Type type, std::vector<u8> &&data)
 {
   uptr<DataStream> array(new DataStream());
   array->name = name;
   array->type = type;
-  array->data = std::move(data);
+  array->storage = std::move(data);
+  array->data = Slice<u8>(array->storage.data(), array->storage.size());
+
+  my_arrays.push_back(std::move(array));
+  return true;
+}
+
+bool Model::add_array(const String &name, Type type, const Slice<u8> &data)
+{
+  uptr<DataStream> array(new DataStream());
+  array->name = name;
+  array->type = type;
+  array->data = data;
 
   my_arrays.push_back(std::move(array));
   return true;
@@ -26,5 +48,70 @@ const DataStream* Model::find_array(const String &name, Type type) const
   return found != my_arrays.end() ? found->get() : nullptr;
 }
 
+void Model::set_mapped_file(uptr<MappedFile> file)
+{
+  my_file = std::move(file);
+}
+
+void Model::build_bvh()
+{
+  Slice<f32> vertices = find_stream<f32>(MODEL_VERTEX);
+  Slice<u32> indices = find_stream<u32>(MODEL_INDEX);
+
+  if (vertices.is_empty() || indices.is_empty()) {
+    bvh.clear();
+    return;
+  }
+
+  build_mesh_bvh(Slice<Vec3f>(reinterpret_cast<const Vec3f *>(vertices.data()),
+    vertices.size() / 3), indices, bvh);
+}
+
+bool Model::build_animations()
+{
+  Slice<u32> data = find_stream<u32>(MODEL_ANIMATION);
+
+  if (data.is_empty()) {
+    animations.clear();
+    return true;
+  }
+
+  return parse_animations(Slice<u8>(reinterpret_cast<const u8 *>(data.data()), data.raw_size()),
+    bones.size(), animations);
+}
+
+bool Model::has_valid_bone_indices() const
+{
+  Slice<u32> indices = find_stream<u32>(MODEL_BONE_INDEX);
+  const u32 count = bones.size();
+
+  for (u32 packed : indices) {
+    for (u32 j = 0; j < 4; ++j, packed >>= 8) {
+      if ((packed & 0xFF) >= count) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+u32 Model::find_animation(const String &name) const
+{
+  for (u32 i = 0; i < animations.size(); ++i) {
+    if (animations[i].name() == name) {
+      return i;
+    }
+  }
+
+  return U32_MAX;
+}
+
+Slice<LodLevel> Model::lods() const
+{
+  Slice<u32> data = find_stream<u32>(MODEL_LOD);
+  return Slice<LodLevel>(reinterpret_cast<const LodLevel *>(data.data()),
+    data.size() * sizeof(u32) / sizeof(LodLevel));
+}
 
 }
@@ -2,6 +2,9 @@
 
 #include "foundation.h"
 #include "stdvec.h"
+#include "bvh.h"
+#include "animation.h"
+#include "lod.h"
 
 namespace atom {
 
@@ -20,25 +23,75 @@ struct DataBone {
 struct DataStream {
   String          name;
   Type            type;
-  std::vector<u8> data;
+  Slice<u8>       data;     ///< points to storage or into mapped model file
+  std::vector<u8> storage;  ///< owned data, empty for mapped streams
 };
 
+typedef std::vector<uptr<DataStream>> DataStreamArray;
+
 class Model {
-  std::vector<uptr<DataStream>> my_arrays;
+  DataStreamArray  my_arrays;
+  uptr<MappedFile> my_file;   ///< keeps mapped stream data alive
 
 public:
   std::vector<DataBone> bones;
+  Bvh                   bvh;    ///< hierarchy over MODEL_VERTEX/MODEL_INDEX triangles
+  std::vector<AnimationClip> animations;  ///< clips referencing MODEL_ANIMATION stream
+
+  Model();
+  ~Model();
 
   bool add_array(const String &name, Type type, std::vector<u8> &&data);
+
+  /**
+   * Add stream without copying data, @p data must outlive the model
+   * (usually it points into the mapped file, see set_mapped_file).
+   */
+  bool add_array(const String &name, Type type, const Slice<u8> &data);
+
   const DataStream* find_array(const String &name, Type type) const;
 
+  const DataStreamArray& arrays() const
+  {
+    return my_arrays;
+  }
+
+  void set_mapped_file(uptr<MappedFile> file);
+
+  /**
+   * Build ray intersection hierarchy from vertex & index streams.
+   */
+  void build_bvh();
+
+  /**
+   * Create animation clips from MODEL_ANIMATION stream.
+   */
+  bool build_animations();
+
+  /**
+   * Each packed bone index of MODEL_BONE_INDEX (4 x 8 bits per vertex)
+   * references existing bone, skinning kernels don't check the indices.
+   */
+  bool has_valid_bone_indices() const;
+
+  /**
+   * @return clip index or U32_MAX when the model doesn't contain clip
+   */
+  u32 find_animation(const String &name) const;
+
+  /**
+   * Coarser levels of detail (MODEL_LOD), LodLevel::first is the offset in
+   * MODEL_LOD_INDEX stream. Full mesh (MODEL_INDEX) isn't included.
+   */
+  Slice<LodLevel> lods() const;
+
   template<typename T>
   Slice<T> find_stream(const String &name) const
   {
     const DataStream *stream = find_array(name, type_of<T>());
 
     if (stream != nullptr && stream->type == type_of<T>()) {
-      return Slice<T>(reinterpret_cast<const T *>(&stream->data[0]),
+      return Slice<T>(reinterpret_cast<const T *>(stream->data.data()),
         stream->data.size() / sizeof(T));
     }
     // return empty slice when stream not found or invalid data type
@@ -34,6 +34,11 @@ void ModelComponent::set_model(const ModelResourcePtr &model)
 }
 
 ModelResourcePtr ModelComponent::get_model() const
+{
+  return my_model != nullptr && my_model->is_ready() ? my_model : nullptr;
+}
+
+ModelResourcePtr ModelComponent::get_model_handle() const
 {
   return my_model;
 }
@@ -17,8 +17,17 @@ public:
 
   void set_model(const ModelResourcePtr& model);
 
+  /**
+   * Model data, nullptr while the model is loading (doesn't block, can be
+   * called from job threads). Users resolve the model once it is ready.
+   */
   ModelResourcePtr get_model() const;
 
+  /**
+   * Model resource even when it is still loading (name, state).
+   */
+  ModelResourcePtr get_model_handle() const;
+
   META_SUB_CLASS(NullComponent);
 };
 
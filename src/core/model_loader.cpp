@@ -1,6 +1,10 @@
 #include "model_loader.h"
 #include "utils.h"
 #include "json_utils.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstring>
+#include <sys/stat.h>
 #include <rapidjson/filestream.h>
 
 namespace atom {
@@ -44,8 +48,8 @@ bool load_model_element_array_from_json(const rapidjson::Value &node,
         if (utils::read_array(data, buffer) && !buffer.empty()) {
           u32 raw_size = buffer.size() * sizeof(i32);
           array.type = Type::I32;
-          array.data.resize(raw_size);
-          memcpy(&array.data[0], buffer.data(), raw_size);
+          array.storage.resize(raw_size);
+          memcpy(&array.storage[0], buffer.data(), raw_size);
           return true;
         }
       }
@@ -57,8 +61,8 @@ bool load_model_element_array_from_json(const rapidjson::Value &node,
         if (utils::read_array(data, buffer) && !buffer.empty()) {
           u32 raw_size = buffer.size() * sizeof(u32);
           array.type = Type::U32;
-          array.data.resize(raw_size);
-          memcpy(&array.data[0], buffer.data(), raw_size);
+          array.storage.resize(raw_size);
+          memcpy(&array.storage[0], buffer.data(), raw_size);
           return true;
         }
       }
@@ -70,8 +74,8 @@ bool load_model_element_array_from_json(const rapidjson::Value &node,
         if (utils::read_array(data, buffer) && !buffer.empty()) {
           u32 raw_size = buffer.size() * sizeof(f32);
           array.type = Type::F32;
-          array.data.resize(raw_size);
-          memcpy(&array.data[0], buffer.data(), raw_size);
+          array.storage.resize(raw_size);
+          memcpy(&array.storage[0], buffer.data(), raw_size);
           return true;
         }
       }
@@ -107,7 +111,7 @@ bool load_model_arrays_from_json(const rapidjson::Value &arrays_node, Model &mod
       log_warning("Error while loading array \"%s\"", i->name.GetString());
       return false;
     }
-    model.add_array(i->name.GetString(), array.type, std::move(array.data));
+    model.add_array(i->name.GetString(), array.type, std::move(array.storage));
   }
 
   return true;
@@ -189,6 +193,76 @@ bool load_model_skeleton_from_json(const rapidjson::Value &json_skeleton, Model
   return true;
 }
 
+/**
+ * Animations are exported uncompressed (rotation of each animated bone in
+ * each frame), they are compressed to MODEL_ANIMATION stream.
+ */
+bool load_model_animations_from_json(const rapidjson::Value &json_animations, Model &model)
+{
+  if (!json_animations.IsObject()) {
+    log_warning("Animations node is invalid");
+    return false;
+  }
+
+  std::vector<RawAnimationClip> clips;
+
+  for (auto i = json_animations.MemberBegin(); i != json_animations.MemberEnd(); ++i) {
+    const rapidjson::Value &value = i->value;
+    const rapidjson::Value &json_fps = value["fps"];
+    const rapidjson::Value &json_frames = value["frames"];
+    const rapidjson::Value &json_tracks = value["tracks"];
+
+    if (!json_fps.IsNumber() || !json_frames.IsInt() || !json_tracks.IsObject()) {
+      log_warning("Invalid animation \"%s\"", i->name.GetString());
+      return false;
+    }
+
+    RawAnimationClip clip;
+    clip.name = i->name.GetString();
+    clip.fps = json_fps.GetDouble();
+    clip.frame_count = json_frames.GetInt();
+
+    for (auto j = json_tracks.MemberBegin(); j != json_tracks.MemberEnd(); ++j) {
+      String bone_name = j->name.GetString();
+      auto bone = std::find_if(model.bones.begin(), model.bones.end(),
+        [&bone_name](const DataBone &b) { return b.name == bone_name; });
+
+      if (bone == model.bones.end()) {
+        log_warning("Animation \"%s\" contains unknown bone \"%s\"", clip.name.c_str(),
+          bone_name.c_str());
+        continue;
+      }
+
+      std::vector<f32> values;
+
+      if (!utils::read_array(j->value, values) || values.size() != clip.frame_count * 4) {
+        log_warning("Invalid track \"%s\" of animation \"%s\"", bone_name.c_str(),
+          clip.name.c_str());
+        return false;
+      }
+
+      RawAnimationTrack track;
+      track.bone = bone - model.bones.begin();
+
+      for (u32 k = 0; k < values.size(); k += 4) {
+        track.frames.push_back(Quatf(values[k], values[k + 1], values[k + 2], values[k + 3]));
+      }
+
+      clip.tracks.push_back(std::move(track));
+    }
+
+    clips.push_back(std::move(clip));
+  }
+
+  std::vector<u8> data;
+
+  if (!compress_animations(clips, ANIMATION_KEY_TOLERANCE, data)) {
+    return false;
+  }
+
+  return model.add_array(MODEL_ANIMATION, Type::U32, std::move(data));
+}
+
 bool load_model_from_json(const rapidjson::Value &mesh_node, Model &model)
 {
   if (!mesh_node.IsObject()) {
@@ -202,11 +276,15 @@ bool load_model_from_json(const rapidjson::Value &mesh_node, Model &model)
     !load_model_skeleton_from_json(mesh_node["skeleton"], model)) {
     return false;
   }
+  if (mesh_node.HasMember("animations") &&
+    !load_model_animations_from_json(mesh_node["animations"], model)) {
+    return false;
+  }
 
   return true;
 }
 
-bool load_model(const String &filename, Model &model)
+bool load_model_json(const String &filename, Model &model)
 {
   FILE *file = fopen(filename.c_str(), "r");
 
@@ -226,6 +304,255 @@ bool load_model(const String &filename, Model &model)
   return load_model_from_json(doc["mesh"], model);
 }
 
+//-----------------------------------------------------------------------------
+//
+// Binary model format
+//
+//-----------------------------------------------------------------------------
+
+static const char* model_file_type_name(Type type)
+{
+  switch (type) {
+    case Type::I32:
+      return "i32";
+    case Type::U32:
+      return "u32";
+    case Type::F32:
+      return "f32";
+    default:
+      return nullptr;
+  }
+}
+
+static String model_file_string(const char *str)
+{
+  return String(str, strnlen(str, MODEL_FILE_NAME_SIZE));
+}
+
+static void copy_vec3f(const f32 *src, Vec3f &dst)
+{
+  dst = Vec3f(src[0], src[1], src[2]);
+}
+
+static void copy_vec3f(const Vec3f &src, f32 *dst)
+{
+  dst[0] = src.x;
+  dst[1] = src.y;
+  dst[2] = src.z;
+}
+
+static u32 align_offset(u32 offset)
+{
+  return (offset + MODEL_FILE_ALIGNMENT - 1) & ~(MODEL_FILE_ALIGNMENT - 1);
+}
+
+bool load_model_binary(const String &filename, Model &model)
+{
+  uptr<MappedFile> file(new MappedFile());
+
+  if (!file->open(filename)) {
+    return false;
+  }
+
+  const u8 *data = file->data();
+  u32 size = file->size();
+
+  if (size < sizeof(ModelFileHeader)) {
+    log_error("Model file \"%s\" is too small", filename.c_str());
+    return false;
+  }
+
+  const ModelFileHeader *header = reinterpret_cast<const ModelFileHeader *>(data);
+
+  if (memcmp(header->magic, MODEL_FILE_MAGIC, sizeof(MODEL_FILE_MAGIC)) != 0) {
+    log_error("Model file \"%s\" has invalid magic", filename.c_str());
+    return false;
+  }
+
+  if (header->version != MODEL_FILE_VERSION) {
+    log_error("Model file \"%s\" has unsupported version %u (expected %u)",
+      filename.c_str(), header->version, MODEL_FILE_VERSION);
+    return false;
+  }
+
+  if (header->file_size != size ||
+      header->stream_table % 4 != 0 || header->bone_table % 4 != 0 ||
+      header->stream_table + u64(header->stream_count) * sizeof(ModelFileStream) > size ||
+      header->bone_table + u64(header->bone_count) * sizeof(ModelFileBone) > size) {
+    log_error("Model file \"%s\" is corrupted", filename.c_str());
+    return false;
+  }
+
+  const ModelFileStream *streams =
+    reinterpret_cast<const ModelFileStream *>(data + header->stream_table);
+  std::vector<Type> types(header->stream_count);
+
+  // validate whole stream table first, model must not reference unmapped file
+  for (u32 i = 0; i < header->stream_count; ++i) {
+    const ModelFileStream &stream = streams[i];
+    types[i] = str_to_type(String(stream.type, strnlen(stream.type, sizeof(stream.type))));
+
+    if (model_file_type_name(types[i]) == nullptr) {
+      log_error("Model file \"%s\" contains stream with unsupported type",
+        filename.c_str());
+      return false;
+    }
+
+    if (stream.offset % MODEL_FILE_ALIGNMENT != 0 ||
+        u64(stream.offset) + stream.size > size) {
+      log_error("Model file \"%s\" contains invalid stream", filename.c_str());
+      return false;
+    }
+  }
+
+  for (u32 i = 0; i < header->stream_count; ++i) {
+    const ModelFileStream &stream = streams[i];
+    model.add_array(model_file_string(stream.name), types[i],
+      Slice<u8>(data + stream.offset, stream.size));
+  }
+
+  const ModelFileBone *bones =
+    reinterpret_cast<const ModelFileBone *>(data + header->bone_table);
+  model.bones.resize(header->bone_count);
+
+  for (u32 i = 0; i < header->bone_count; ++i) {
+    const ModelFileBone &src = bones[i];
+    DataBone &bone = model.bones[i];
+    bone.name = model_file_string(src.name);
+    bone.parent = src.parent;
+    copy_vec3f(src.head, bone.head);
+    copy_vec3f(src.tail, bone.tail);
+    copy_vec3f(src.local_head, bone.local_head);
+    copy_vec3f(src.local_tail, bone.local_tail);
+    copy_vec3f(src.x, bone.x);
+    copy_vec3f(src.y, bone.y);
+    copy_vec3f(src.z, bone.z);
+  }
+
+  model.set_mapped_file(std::move(file));
+  return true;
+}
+
+bool save_model_binary(const String &filename, const Model &model)
+{
+  const DataStreamArray &arrays = model.arrays();
+
+  ModelFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, MODEL_FILE_MAGIC, sizeof(MODEL_FILE_MAGIC));
+  header.version = MODEL_FILE_VERSION;
+  header.stream_count = arrays.size();
+  header.bone_count = model.bones.size();
+  header.stream_table = sizeof(ModelFileHeader);
+  header.bone_table = header.stream_table + header.stream_count * sizeof(ModelFileStream);
+
+  std::vector<ModelFileStream> streams(arrays.size());
+  u32 offset = align_offset(header.bone_table + header.bone_count * sizeof(ModelFileBone));
+
+  for (u32 i = 0; i < arrays.size(); ++i) {
+    const DataStream &array = *arrays[i];
+    const char *type = model_file_type_name(array.type);
+
+    if (type == nullptr || array.name.size() >= MODEL_FILE_NAME_SIZE) {
+      log_error("Can't save stream \"%s\" to binary model", array.name.c_str());
+      return false;
+    }
+
+    ModelFileStream &stream = streams[i];
+    memset(&stream, 0, sizeof(stream));
+    strncpy(stream.name, array.name.c_str(), MODEL_FILE_NAME_SIZE - 1);
+    strncpy(stream.type, type, sizeof(stream.type) - 1);
+    stream.offset = offset;
+    stream.size = array.data.size();
+    offset = align_offset(offset + stream.size);
+  }
+
+  std::vector<ModelFileBone> bones(model.bones.size());
+
+  for (u32 i = 0; i < model.bones.size(); ++i) {
+    const DataBone &src = model.bones[i];
+    ModelFileBone &bone = bones[i];
+    memset(&bone, 0, sizeof(bone));
+
+    if (src.name.size() >= MODEL_FILE_NAME_SIZE) {
+      log_error("Bone name \"%s\" is too long", src.name.c_str());
+      return false;
+    }
+
+    strncpy(bone.name, src.name.c_str(), MODEL_FILE_NAME_SIZE - 1);
+    bone.parent = src.parent;
+    copy_vec3f(src.head, bone.head);
+    copy_vec3f(src.tail, bone.tail);
+    copy_vec3f(src.local_head, bone.local_head);
+    copy_vec3f(src.local_tail, bone.local_tail);
+    copy_vec3f(src.x, bone.x);
+    copy_vec3f(src.y, bone.y);
+    copy_vec3f(src.z, bone.z);
+  }
+
+  header.file_size = offset;
+
+  // build whole file in memory, streams are aligned by zero padding
+  std::vector<u8> output(offset, 0);
+  memcpy(&output[0], &header, sizeof(header));
+
+  if (!streams.empty()) {
+    memcpy(&output[header.stream_table], streams.data(),
+      streams.size() * sizeof(ModelFileStream));
+  }
+
+  if (!bones.empty()) {
+    memcpy(&output[header.bone_table], bones.data(), bones.size() * sizeof(ModelFileBone));
+  }
+
+  for (u32 i = 0; i < arrays.size(); ++i) {
+    if (streams[i].size > 0) {
+      memcpy(&output[streams[i].offset], arrays[i]->data.data(), streams[i].size);
+    }
+  }
+
+  FILE *file = fopen(filename.c_str(), "wb");
+
+  if (file == nullptr) {
+    log_error("Can't open \"%s\" for writing", filename.c_str());
+    return false;
+  }
+
+  bool ok = fwrite(output.data(), 1, output.size(), file) == output.size();
+  fclose(file);
+
+  if (!ok) {
+    log_error("Can't write model \"%s\"", filename.c_str());
+  }
+
+  return ok;
+}
+
+bool load_model(const String &filename, Model &model)
+{
+  String binary_ext = String(".") + MESH_BINARY_EXT;
+  bool is_binary = filename.size() > binary_ext.size() &&
+    filename.compare(filename.size() - binary_ext.size(), binary_ext.size(), binary_ext) == 0;
+
+  if (!(is_binary ? load_model_binary(filename, model) : load_model_json(filename, model))) {
+    return false;
+  }
+
+  if (!model.has_valid_bone_indices()) {
+    log_error("Model \"%s\" references missing bones", filename.c_str());
+    return false;
+  }
+
+  model.build_bvh();
+
+  if (!model.build_animations()) {
+    log_error("Model \"%s\" contains invalid animations", filename.c_str());
+    return false;
+  }
+
+  return true;
+}
+
 ResourcePtr ModelLoader::create_resource(ResourceService &rs, const String &name)
 {
   String filename = get_model_filename(name);
@@ -236,13 +563,20 @@ ResourcePtr ModelLoader::create_resource(ResourceService &rs, const String &name
   }
 
   sptr<ModelResource> resource = std::make_shared<ModelResource>();
-  resource->set_name(String(RESOURCE_MODEL_TAG) + ":" + name);
-  resource->depend_on_file(filename);
-  resource->set_loader(this);
+  init_resource(*resource, name);
   resource->set_data(std::move(model));
   return resource;
 }
 
+void ModelLoader::init_resource(Resource &resource, const String &name)
+{
+  resource.set_name(make_resource_name(RESOURCE_MODEL_TAG, name));
+  // binary model can be (re)exported or removed, watch both files
+  resource.depend_on_file(String(MESH_RESOURCE_DIR) + "/" + name + "." + MESH_BINARY_EXT);
+  resource.depend_on_file(String(MESH_RESOURCE_DIR) + "/" + name + "." + MESH_EXT);
+  resource.set_loader(this);
+}
+
 void ModelLoader::reload_resource(ResourceService &rs, Resource &resource)
 {
   StringArray tokens = split_resource_name(resource.name());
@@ -256,9 +590,35 @@ void ModelLoader::reload_resource(ResourceService &rs, Resource &resource)
   }
 }
 
+static bool get_modification_time(const String &filename, time_t &time)
+{
+  struct stat info;
+
+  if (stat(filename.c_str(), &info) != 0) {
+    return false;
+  }
+
+  time = info.st_mtime;
+  return true;
+}
+
 String ModelLoader::get_model_filename(const String &name)
 {
-  return String(MESH_RESOURCE_DIR) + "/" + name + "." + MESH_EXT;
+  String binary = String(MESH_RESOURCE_DIR) + "/" + name + "." + MESH_BINARY_EXT;
+  String json = String(MESH_RESOURCE_DIR) + "/" + name + "." + MESH_EXT;
+  time_t binary_time;
+  time_t json_time;
+
+  if (!get_modification_time(binary, binary_time)) {
+    return json;
+  }
+
+  // stale binary model (json was edited after the export)
+  if (get_modification_time(json, json_time) && json_time > binary_time) {
+    return json;
+  }
+
+  return binary;
 }
 
 uptr<Model> load_model(const String &filename)
@@ -266,7 +626,7 @@ uptr<Model> load_model(const String &filename)
   uptr<Model> mesh(new Model());
 
   if (load_model(filename, *mesh)) {
-    return std::move(mesh);
+    return mesh;
   }
 
   return nullptr;
@@ -10,17 +10,94 @@ namespace atom {
 //
 //-----------------------------------------------------------------------------
 
+/**
+ * Binary model file (.m3b) layout, all values are little endian:
+ *   ModelFileHeader
+ *   ModelFileStream[stream_count]  at header.stream_table
+ *   ModelFileBone[bone_count]      at header.bone_table
+ *   stream data, each stream starts at MODEL_FILE_ALIGNMENT boundary
+ *
+ * Stream data are used directly from the mapped file (no copy).
+ */
+const char MODEL_FILE_MAGIC[4] = { 'M', '3', 'D', 'B' };
+const u32 MODEL_FILE_VERSION = 1;
+const u32 MODEL_FILE_ALIGNMENT = 16;
+const u32 MODEL_FILE_NAME_SIZE = 32;
+
+struct ModelFileHeader {
+  char magic[4];
+  u32  version;
+  u32  stream_count;
+  u32  bone_count;
+  u32  stream_table;    ///< offset of stream table
+  u32  bone_table;      ///< offset of bone table
+  u32  file_size;
+  u32  reserved;
+};
+
+struct ModelFileStream {
+  char name[MODEL_FILE_NAME_SIZE];
+  char type[8];         ///< type name, same as in .m3d ("f32", "u32", "i32")
+  u32  offset;          ///< offset of data from the file start
+  u32  size;            ///< data size in bytes
+};
+
+struct ModelFileBone {
+  char name[MODEL_FILE_NAME_SIZE];
+  i32  parent;          ///< -1 for root bone
+  f32  head[3];
+  f32  tail[3];
+  f32  local_head[3];
+  f32  local_tail[3];
+  f32  x[3];
+  f32  y[3];
+  f32  z[3];
+  u32  reserved[2];
+};
+
+static_assert(sizeof(ModelFileHeader) == 32, "Invalid ModelFileHeader size");
+static_assert(sizeof(ModelFileStream) == 48, "Invalid ModelFileStream size");
+static_assert(sizeof(ModelFileBone) == 128, "Invalid ModelFileBone size");
+
+/**
+ * Load model from JSON (.m3d) or binary (.m3b) file, format is selected
+ * by the file extension.
+ */
 bool load_model(const String &filename, Model &model);
 
 uptr<Model> load_model(const String &filename);
 
+/**
+ * Load model from JSON (.m3d) file.
+ */
+bool load_model_json(const String &filename, Model &model);
+
+/**
+ * Map binary model file (.m3b) into memory, model streams point directly
+ * into the mapped file.
+ */
+bool load_model_binary(const String &filename, Model &model);
+
+/**
+ * Save model to binary file (.m3b).
+ */
+bool save_model_binary(const String &filename, const Model &model);
+
 class ModelLoader : public Loader {
 public:
   ResourcePtr create_resource(ResourceService &rs, const String &name) override;
 
   void reload_resource(ResourceService &rs, Resource &resource) override;
 
-private:
+  /**
+   * Set name, loader and file dependencies of the model resource (shared by
+   * synchronous and asynchronous loading).
+   */
+  void init_resource(Resource &resource, const String &name);
+
+  /**
+   * Prefer binary model file when it exists and is not older than the json model.
+   */
   static String get_model_filename(const String &name);
 
 };
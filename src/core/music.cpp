@@ -1,7 +1,6 @@
 #include "music.h"
 
 #include <string.h>
-#include <fstream>
 #include "log.h"
 #include "ptr.h"
 #include "utils.h"
@@ -21,28 +20,15 @@ size_t Music::read_func(void *ptr, size_t size, size_t nmemb, void *datasource)
   assert(ptr != nullptr);
 
   Music *music = reinterpret_cast<Music *>(datasource);
-
-  if (music->my_data_position >= music->my_data_size)
-    return 0;
-
-  int start = music->my_data_position;
-  int end = min(music->my_data_size, (int)(start + size * nmemb));
-  int bytes_total = end - start;
-
-  memcpy(ptr, (u8 *)&music->my_data[0] + start, bytes_total);
-
-  music->my_data_position += bytes_total;
-
-  return bytes_total;
+  return fread(ptr, size, nmemb, music->my_file);
 }
 
 int Music::seek_func(void *datasource, ogg_int64_t offset, int whence)
 {
   assert(datasource != nullptr);
+  Music *music = reinterpret_cast<Music *>(datasource);
 
-  not_implemented();
-
-  return -1;
+  return fseek(music->my_file, offset, whence);
 }
 
 long Music::tell_func(void *datasource)
@@ -50,7 +36,7 @@ long Music::tell_func(void *datasource)
   assert(datasource != nullptr);
   Music *music = (Music *)datasource;
 
-  return music->my_data_position;
+  return ftell(music->my_file);
 }
 
 uptr<Music> Music::create_from_file(
@@ -61,32 +47,16 @@ uptr<Music> Music::create_from_file(
   if (filename == nullptr)
     return nullptr;
 
-  std::ifstream input(filename, std::ios_base::in | std::ios_base::binary);
+  uptr<Music> music(new Music());
+  music->my_file = fopen(filename, "rb");
 
-  if (!input.is_open()) {
+  if (music->my_file == nullptr) {
     error("Can't open file \"%s\"\n", filename);
     return nullptr;
   }
 
-  /// @todo unique_ptr
-  long length = get_file_size(input);
-  uptr<u8[]> data(new u8[length]);
-
-  input.read((char *)&data[0], length);
-
-  if (input.fail()) {
-    error("Error while reading from file \"%s\"", filename);
-    return nullptr;
-  }
-
-  if (input.peek() != EOF)
-    log_warning("Invalid file size, reading less bytes than actual file size");
-
-  input.close();
-
-  uptr<Music> music(new Music());
-  music->my_data      = std::move(data);
-  music->my_data_size = length;
+  setvbuf(music->my_file, nullptr, _IOFBF, MUSIC_READ_BUFFER_SIZE);
+  music->my_filename = filename;
 
   int status = ov_open_callbacks(music.get(), &music->my_vorbis_file, nullptr, 0, our_callbacks);
 
@@ -95,7 +65,11 @@ uptr<Music> Music::create_from_file(
     return nullptr;
   }
 
-  /// @todo zavolat a zistit status ov_seekable
+  music->my_is_open = true;
+
+  if (!ov_seekable(&music->my_vorbis_file)) {
+    log_warning("Music \"%s\" isn't seekable", filename);
+  }
 
   if (music->my_vorbis_file.vi->channels > 2) {
     error("Only 1-2 channel music is supported!!!");
@@ -110,28 +84,37 @@ uptr<Music> Music::create_from_file(
   return music;
 }
 
-Music::Music() : my_position(0), my_data_position(0), my_data_size(0),
-                             my_samples_size(0), my_data(nullptr)
+Music::Music() : my_is_open(false), my_position(0), my_samples_size(0), my_file(nullptr)
 {
 }
 
 Music::~Music()
 {
-  ov_clear(&my_vorbis_file);
+  if (my_is_open) {
+    ov_clear(&my_vorbis_file);
+  }
+
+  if (my_file != nullptr) {
+    fclose(my_file);
+  }
 }
 
 int Music::read_old(void *buffer, int start, int size)
 {
   assert(buffer != nullptr);
   assert(start >= -1);
+  assert(size > 0);
 
-  if (start != -1 && start != my_position + 1) {
-    // seek to desired position
-    not_implemented();
-  }
+  if (start != AudioBuffer::CURRENT_POSITION && start != my_position) {
+    int frame_size = get_channel_count() * 2;
 
-  assert(buffer != nullptr);
-  assert(size > 0);
+    if (ov_pcm_seek(&my_vorbis_file, start / frame_size) != 0) {
+      log_error("Can't seek music \"%s\"", my_filename.c_str());
+      return 0;
+    }
+
+    my_position = start;
+  }
 
   int section;
   int bytes_read = 0;
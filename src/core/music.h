@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdio>
 #include <vorbis/vorbisfile.h>
 #include "foundation.h"
 #include "constants.h"
@@ -7,19 +8,31 @@
 
 namespace atom {
 
-const int MUSIC_BUFFER_SIZE = 116384; ///< velkost OpenAL medzipamate v Music
-const int MUSIC_BUFFER_COUNT = 3; ///< pocet OpenAL buffrov v Music
+const int MUSIC_READ_BUFFER_SIZE = 16384; ///< buffered reads of the compressed file
 
+/**
+ * Vorbis file decoded on demand. Compressed data are read from the file in
+ * buffered chunks, neither compressed nor decoded data are kept in memory.
+ * Music isn't thread safe, AudioStream decodes it on the decoder thread.
+ */
 class Music : public AudioBuffer {
 public:
     static uptr<Music> create_from_file(
       const char *filename);
 
+    /**
+     * @param start byte offset in decoded data, AudioBuffer::CURRENT_POSITION continues
+     */
     int read_old(void *buffer, int start, int size);
     int get_sample_rate();
     int get_channel_count();
     int get_size();
 
+    const String& filename() const
+    {
+      return my_filename;
+    }
+
     ~Music();
 
 private:
@@ -34,11 +47,11 @@ private:
 
 private:
     OggVorbis_File my_vorbis_file;
-    int   my_position;      ///< position in uncompressed samples
-    int   my_data_position; ///< position in compresed data
-    int   my_data_size;     ///< velkost komprimovanych (zdrojovych) dat v bytoch
+    bool  my_is_open;       ///< my_vorbis_file is initialized
+    int   my_position;      ///< position in decoded data (bytes)
     int   my_samples_size;  ///< velkost dekodovanych dat v bytoch
-    uptr<u8[]> my_data;  ///< complressed samples
+    FILE *my_file;          ///< compressed data
+    String my_filename;
 };
 
 }
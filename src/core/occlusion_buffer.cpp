@@ -0,0 +1,257 @@
+#include "occlusion_buffer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace atom {
+
+namespace {
+
+/// clip space w of the vertex closer than this is treated as crossing the near plane
+const f32 MIN_CLIP_W = 1e-5f;
+
+inline bool is_behind_near(const Vec4f &v)
+{
+  return v.w < MIN_CLIP_W || v.z < -v.w;
+}
+
+inline f32 edge(f32 ax, f32 ay, f32 bx, f32 by, f32 px, f32 py)
+{
+  return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+/// corners of the box, bit 0 selects x, bit 1 y and bit 2 z
+Vec3f box_corner(const BoundingBox &box, u32 i)
+{
+  return Vec3f(i & 1 ? box.xmax : box.xmin, i & 2 ? box.ymax : box.ymin,
+    i & 4 ? box.zmax : box.zmin);
+}
+
+}
+
+OcclusionBuffer::OcclusionBuffer(u32 width, u32 height)
+  : my_occluders(0)
+{
+  assert(width > 0 && height > 0);
+
+  // pyramid down to one texel
+  while (true) {
+    my_levels.push_back(Level{width, height, std::vector<f32>(width * height, 1.0f)});
+
+    if (width == 1 && height == 1) {
+      break;
+    }
+
+    width = (width + 1) / 2;
+    height = (height + 1) / 2;
+  }
+}
+
+void OcclusionBuffer::begin(const Mat4f &view_projection)
+{
+  my_view_projection = view_projection;
+  my_occluders = 0;
+
+  for (Level &level : my_levels) {
+    std::fill(level.depth.begin(), level.depth.end(), 1.0f);
+  }
+}
+
+void OcclusionBuffer::add_triangle(const Vec3f &a, const Vec3f &b, const Vec3f &c)
+{
+  Vec4f ca = my_view_projection * Vec4f(a, 1);
+  Vec4f cb = my_view_projection * Vec4f(b, 1);
+  Vec4f cc = my_view_projection * Vec4f(c, 1);
+
+  if (is_behind_near(ca) || is_behind_near(cb) || is_behind_near(cc)) {
+    return;
+  }
+
+  rasterize(ca, cb, cc);
+}
+
+void OcclusionBuffer::add_mesh(const Mat4f &transform, const Slice<f32> &positions,
+  const Slice<u32> &indices)
+{
+  const u32 vertex_count = positions.size() / 3;
+  const Mat4f mvp = my_view_projection * transform;
+  my_clip.resize(vertex_count);
+
+  for (u32 i = 0; i < vertex_count; ++i) {
+    my_clip[i] = mvp * Vec4f(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2], 1);
+  }
+
+  for (u32 i = 0; i + 2 < indices.size(); i += 3) {
+    u32 a = indices[i], b = indices[i + 1], c = indices[i + 2];
+
+    if (a >= vertex_count || b >= vertex_count || c >= vertex_count ||
+        is_behind_near(my_clip[a]) || is_behind_near(my_clip[b]) || is_behind_near(my_clip[c])) {
+      continue;
+    }
+
+    rasterize(my_clip[a], my_clip[b], my_clip[c]);
+  }
+}
+
+void OcclusionBuffer::add_box(const Mat4f &transform, const BoundingBox &box)
+{
+  if (box.is_null()) {
+    return;
+  }
+
+  // two triangles of each face, corner indices as in box_corner
+  static const u8 FACES[6][4] = {
+    { 0, 2, 6, 4 }, { 1, 5, 7, 3 },   // -x, +x
+    { 0, 4, 5, 1 }, { 2, 3, 7, 6 },   // -y, +y
+    { 0, 1, 3, 2 }, { 4, 6, 7, 5 }    // -z, +z
+  };
+
+  Vec4f corners[8];
+
+  for (u32 i = 0; i < 8; ++i) {
+    corners[i] = my_view_projection * (transform * Vec4f(box_corner(box, i), 1));
+
+    if (is_behind_near(corners[i])) {
+      return;
+    }
+  }
+
+  for (const u8 *face : FACES) {
+    rasterize(corners[face[0]], corners[face[1]], corners[face[2]]);
+    rasterize(corners[face[0]], corners[face[2]], corners[face[3]]);
+  }
+}
+
+void OcclusionBuffer::rasterize(const Vec4f &a, const Vec4f &b, const Vec4f &c)
+{
+  Level &level = my_levels[0];
+  f32 width = level.width;
+  f32 height = level.height;
+
+  // window coordinates and depth in <0, 1>
+  f32 ax = (a.x / a.w * 0.5f + 0.5f) * width, ay = (a.y / a.w * 0.5f + 0.5f) * height;
+  f32 bx = (b.x / b.w * 0.5f + 0.5f) * width, by = (b.y / b.w * 0.5f + 0.5f) * height;
+  f32 cx = (c.x / c.w * 0.5f + 0.5f) * width, cy = (c.y / c.w * 0.5f + 0.5f) * height;
+  f32 az = a.z / a.w * 0.5f + 0.5f;
+  f32 bz = b.z / b.w * 0.5f + 0.5f;
+  f32 cz = c.z / c.w * 0.5f + 0.5f;
+
+  f32 area = edge(ax, ay, bx, by, cx, cy);
+
+  if (area == 0) {
+    return;
+  }
+
+  // both windings are rasterized, farther faces don't change the result
+  f32 sign = area > 0 ? 1.0f : -1.0f;
+  area *= sign;
+
+  i32 x0 = std::max(static_cast<i32>(std::floor(std::min(std::min(ax, bx), cx))), 0);
+  i32 x1 = std::min(static_cast<i32>(std::ceil(std::max(std::max(ax, bx), cx))), i32(width) - 1);
+  i32 y0 = std::max(static_cast<i32>(std::floor(std::min(std::min(ay, by), cy))), 0);
+  i32 y1 = std::min(static_cast<i32>(std::ceil(std::max(std::max(ay, by), cy))), i32(height) - 1);
+
+  ++my_occluders;
+
+  for (i32 y = y0; y <= y1; ++y) {
+    f32 py = y + 0.5f;
+    f32 *row = &level.depth[y * level.width];
+
+    for (i32 x = x0; x <= x1; ++x) {
+      f32 px = x + 0.5f;
+      f32 w0 = sign * edge(bx, by, cx, cy, px, py);
+      f32 w1 = sign * edge(cx, cy, ax, ay, px, py);
+      f32 w2 = sign * edge(ax, ay, bx, by, px, py);
+
+      if (w0 < 0 || w1 < 0 || w2 < 0) {
+        continue;
+      }
+
+      f32 z = (w0 * az + w1 * bz + w2 * cz) / area;
+      row[x] = std::min(row[x], std::max(z, 0.0f));
+    }
+  }
+}
+
+void OcclusionBuffer::finish()
+{
+  for (u32 i = 1; i < my_levels.size(); ++i) {
+    const Level &src = my_levels[i - 1];
+    Level &dst = my_levels[i];
+
+    for (u32 y = 0; y < dst.height; ++y) {
+      u32 sy0 = 2 * y;
+      u32 sy1 = std::min(2 * y + 1, src.height - 1);
+
+      for (u32 x = 0; x < dst.width; ++x) {
+        u32 sx0 = 2 * x;
+        u32 sx1 = std::min(2 * x + 1, src.width - 1);
+        dst.depth[y * dst.width + x] = std::max(
+          std::max(src.depth[sy0 * src.width + sx0], src.depth[sy0 * src.width + sx1]),
+          std::max(src.depth[sy1 * src.width + sx0], src.depth[sy1 * src.width + sx1]));
+      }
+    }
+  }
+}
+
+f32 OcclusionBuffer::max_depth(u32 level, i32 x0, i32 y0, i32 x1, i32 y1) const
+{
+  const Level &l = my_levels[level];
+  f32 result = 0;
+
+  for (i32 y = y0; y <= y1; ++y) {
+    for (i32 x = x0; x <= x1; ++x) {
+      result = std::max(result, l.depth[y * l.width + x]);
+    }
+  }
+
+  return result;
+}
+
+bool OcclusionBuffer::is_visible(const BoundingBox &box) const
+{
+  if (my_occluders == 0) {
+    return true;
+  }
+
+  const Level &base = my_levels[0];
+  f32 xmin = F32_MAX, xmax = -F32_MAX, ymin = F32_MAX, ymax = -F32_MAX;
+  f32 zmin = F32_MAX;
+
+  for (u32 i = 0; i < 8; ++i) {
+    Vec4f c = my_view_projection * Vec4f(box_corner(box, i), 1);
+
+    if (is_behind_near(c)) {
+      return true;
+    }
+
+    f32 x = (c.x / c.w * 0.5f + 0.5f) * base.width;
+    f32 y = (c.y / c.w * 0.5f + 0.5f) * base.height;
+    xmin = std::min(xmin, x);
+    xmax = std::max(xmax, x);
+    ymin = std::min(ymin, y);
+    ymax = std::max(ymax, y);
+    zmin = std::min(zmin, c.z / c.w * 0.5f + 0.5f);
+  }
+
+  // off screen
+  if (xmax < 0 || ymax < 0 || xmin >= base.width || ymin >= base.height) {
+    return false;
+  }
+
+  i32 x0 = std::max(static_cast<i32>(xmin), 0);
+  i32 y0 = std::max(static_cast<i32>(ymin), 0);
+  i32 x1 = std::min(static_cast<i32>(xmax), i32(base.width) - 1);
+  i32 y1 = std::min(static_cast<i32>(ymax), i32(base.height) - 1);
+
+  // the finest level where the box covers at most 2x2 texels
+  u32 level = 0;
+
+  while (level + 1 < my_levels.size() && ((x1 >> level) - (x0 >> level) > 1 ||
+         (y1 >> level) - (y0 >> level) > 1)) {
+    ++level;
+  }
+
+  return zmin <= max_depth(level, x0 >> level, y0 >> level, x1 >> level, y1 >> level);
+}
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+#include "math.h"
+#include "slice.h"
+
+namespace atom {
+
+/**
+ * Software occlusion culling. Occluders are rasterized on CPU into a small
+ * depth buffer, hierarchical-Z pyramid (farthest depth of each 2x2 block) is
+ * built from it and boxes are tested against the pyramid level where the box
+ * covers at most few texels. Works without GPU readback, so results are
+ * available in the same frame and the same way on every driver.
+ *
+ * Depth is NDC z mapped to <0, 1>, 1 is the far plane.
+ */
+class OcclusionBuffer {
+  struct Level {
+    u32              width;
+    u32              height;
+    std::vector<f32> depth;
+  };
+
+  std::vector<Level> my_levels;         ///< 0 is the rasterized depth buffer
+  Mat4f              my_view_projection;
+  u32                my_occluders;      ///< triangles rasterized since begin
+  std::vector<Vec4f> my_clip;           ///< add_mesh vertices in clip space
+
+  void rasterize(const Vec4f &a, const Vec4f &b, const Vec4f &c);
+
+  f32 max_depth(u32 level, i32 x0, i32 y0, i32 x1, i32 y1) const;
+
+public:
+  OcclusionBuffer(u32 width, u32 height);
+
+  /**
+   * Clear the depth buffer, occluders and tested boxes use @p view_projection.
+   */
+  void begin(const Mat4f &view_projection);
+
+  /**
+   * Rasterize world space triangle, triangles crossing the near plane are
+   * skipped (occluders don't have to be complete).
+   */
+  void add_triangle(const Vec3f &a, const Vec3f &b, const Vec3f &c);
+
+  /**
+   * Rasterize indexed triangles (model streams), vertices are transformed
+   * by @p transform once. Triangles crossing the near plane are skipped.
+   *
+   * @param positions x, y, z of each vertex
+   * @param indices three indices of each triangle
+   */
+  void add_mesh(const Mat4f &transform, const Slice<f32> &positions, const Slice<u32> &indices);
+
+  /**
+   * Rasterize solid box @p box transformed by @p transform (12 triangles).
+   * Box must lie inside the occluder geometry.
+   */
+  void add_box(const Mat4f &transform, const BoundingBox &box);
+
+  /**
+   * Build hierarchical-Z pyramid, call it after the last occluder.
+   */
+  void finish();
+
+  bool has_occluders() const
+  {
+    return my_occluders > 0;
+  }
+
+  /**
+   * Conservative visibility of world space box, box crossing the near plane
+   * is always visible.
+   */
+  bool is_visible(const BoundingBox &box) const;
+
+  u32 width() const
+  {
+    return my_levels[0].width;
+  }
+
+  u32 height() const
+  {
+    return my_levels[0].height;
+  }
+
+  u32 level_count() const
+  {
+    return my_levels.size();
+  }
+
+  /**
+   * Depth of the texel, y = 0 is the bottom row.
+   */
+  f32 depth(u32 level, u32 x, u32 y) const
+  {
+    const Level &l = my_levels[level];
+    return l.depth[y * l.width + x];
+  }
+};
+
+}
@@ -44,6 +44,7 @@ void PerformanceCounters::clear()
 //  assert(my_running_counters.empty());
   log_debug(DEBUG_COUNTERS, "Clearing counters");
   my_counters.clear();
+  my_values.clear();
 }
 
 PerformanceCounters::CounterInfo PerformanceCounters::get_counter(
@@ -57,6 +58,29 @@ PerformanceCounters::CounterInfo PerformanceCounters::get_counter(
   return *i;
 }
 
+void PerformanceCounters::set_value(const String &counter_name, u64 value)
+{
+  for (auto &counter : my_values) {
+    if (counter.first == counter_name) {
+      counter.second = value;
+      return;
+    }
+  }
+
+  my_values.push_back(std::make_pair(counter_name, value));
+}
+
+u64 PerformanceCounters::get_value(const String &counter_name) const
+{
+  for (const auto &counter : my_values) {
+    if (counter.first == counter_name) {
+      return counter.second;
+    }
+  }
+
+  return 0;
+}
+
 String PerformanceCounters::to_string() const
 {
 //  String results;
@@ -75,6 +99,10 @@ String PerformanceCounters::to_string() const
       print_and_process_counter(i, 0, output);
   }
 
+  for (const auto &counter : my_values) {
+    output << counter.first << ": " << counter.second << "\n";
+  }
+
   return output.str();
 }
 
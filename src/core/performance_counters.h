@@ -1,9 +1,11 @@
 #pragma once
 
 #include <chrono>
+#include <utility>
 #include <vector>
 
 #include "string.h"
+#include "platform.h"
 
 namespace atom {
 
@@ -44,6 +46,20 @@ public:
   CounterInfo get_counter(
     const String &counter_name) const;
 
+  /**
+   * Set value counter (number of draws, state changes, ...), values are
+   * printed after timers and cleared by clear().
+   */
+  void set_value(
+    const String &counter_name,
+    u64 value);
+
+  /**
+   * @return value counter or 0 when the counter doesn't exist
+   */
+  u64 get_value(
+    const String &counter_name) const;
+
 //  CounterArray::const_iterator begin() const
 //  { return my_counters.begin(); }
 
@@ -61,6 +77,7 @@ private:  // private methods
 private:
   CounterArray     my_counters;
   std::vector<int> my_running_counters; ///< zasobnik aktualne beziacich casovacov
+  std::vector<std::pair<String, u64>> my_values;
 };
 
 }
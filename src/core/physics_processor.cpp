@@ -7,6 +7,7 @@
 #include "rigid_body_component.h"
 #include "bt_utils.h"
 #include "constants.h"
+#include "config.h"
 
 namespace atom {
 
@@ -25,6 +26,15 @@ PhysicsProcessor::PhysicsProcessor(World &world)
   , my_solver(new btSequentialImpulseConstraintSolver())
   , my_world(new btDiscreteDynamicsWorld(my_dispatcher.get(),
       my_broadphase.get(), my_solver.get(), my_configuration.get()))
+  , my_requested(0)
+  , my_done(0)
+  , my_previous(0)
+  , my_current(1)
+  , my_back(2)
+  , my_quit(false)
+  , my_timestep(1.0 / PHYSICS_STEP_RATE, PHYSICS_MAX_STEPS)
+  , my_alpha(0)
+  , my_has_time(false)
 {
   my_world->setGravity(btVector3(0, 0, -ACCELERATION));
 
@@ -33,13 +43,85 @@ PhysicsProcessor::PhysicsProcessor(World &world)
 
 PhysicsProcessor::~PhysicsProcessor()
 {
-
+  stop();
 }
 
 void PhysicsProcessor::activate()
 {
   assert(my_is_running == false);
   my_is_running = true;
+  my_quit = false;
+  my_has_time = false;
+  my_timestep.reset();
+  my_thread = std::thread(&PhysicsProcessor::run, this);
+}
+
+void PhysicsProcessor::deactivate()
+{
+  stop();
+  my_is_running = false;
+}
+
+void PhysicsProcessor::stop()
+{
+  if (!my_thread.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(my_mutex);
+    my_quit = true;
+  }
+
+  my_condition.notify_all();
+  my_thread.join();
+  // not simulated steps are dropped
+  my_requested = my_done;
+}
+
+void PhysicsProcessor::run()
+{
+  std::unique_lock<std::mutex> lock(my_mutex);
+
+  while (true) {
+    my_condition.wait(lock, [this]() { return my_quit || my_done < my_requested; });
+
+    if (my_quit) {
+      break;
+    }
+
+    for (RigidBodyComponent *body : my_bodies) {
+      body->apply_kinematic_target();
+    }
+
+    // bodies are changed only when the thread is idle
+    lock.unlock();
+    // one step of exactly fixed length
+    my_world->stepSimulation(my_timestep.step(), 0);
+
+    for (RigidBodyComponent *body : my_bodies) {
+      body->store_state(my_back);
+    }
+
+    lock.lock();
+    u32 previous = my_previous;
+    my_previous = my_current;
+    my_current = my_back;
+    my_back = previous;
+    ++my_done;
+    my_condition.notify_all();
+  }
+}
+
+void PhysicsProcessor::wait_idle(std::unique_lock<std::mutex> &lock) const
+{
+  my_condition.wait(lock, [this]() { return my_done == my_requested; });
+}
+
+void PhysicsProcessor::sync() const
+{
+  std::unique_lock<std::mutex> lock(my_mutex);
+  wait_idle(lock);
 }
 
 void PhysicsProcessor::poll()
@@ -48,22 +130,59 @@ void PhysicsProcessor::poll()
     return;
   }
 
-  // perform simulation step
-  my_world->stepSimulation(1.0f / FPS, 10);
+  bool deterministic = Config::instance().deterministic;
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  f64 elapsed = 1.0 / FPS;
+
+  if (my_has_time && !deterministic) {
+    elapsed = std::chrono::duration_cast<std::chrono::duration<f64>>(now - my_last_poll).count();
+  }
+
+  my_last_poll = now;
+  my_has_time = true;
+
+  std::unique_lock<std::mutex> lock(my_mutex);
+
+  if (deterministic) {
+    wait_idle(lock);
+  }
+
+  // states of the steps requested by the previous poll, the latest one when
+  // the physics thread is late
+  f32 alpha = my_done == my_requested ? my_alpha : 1.0f;
+
+  for (RigidBodyComponent *body : my_bodies) {
+    body->update_entity(my_previous, my_current, alpha);
+  }
+
+  my_requested += my_timestep.advance(elapsed);
+  my_alpha = my_timestep.alpha();
+  lock.unlock();
+  my_condition.notify_all();
+}
+
+ProcessorAccess PhysicsProcessor::access() const
+{
+  // motion states update entity transforms, Entity::set_transform marks
+  // the geometry hierarchy for refit
+  const u32 data = ProcessorData::PHYSICS | ProcessorData::TRANSFORMS;
+  return ProcessorAccess{data, data | ProcessorData::GEOMETRY};
 }
 
 void PhysicsProcessor::register_rigid_body(RigidBodyComponent *rigid_body)
 {
   assert(rigid_body != nullptr);
+  std::unique_lock<std::mutex> lock(my_mutex);
+  wait_idle(lock);
   my_bodies.push_back(rigid_body);
-
-  btRigidBody *bt_rigid_body = rigid_body->get_rigid_body();
-
-  my_world->addRigidBody(bt_rigid_body);
+  my_world->addRigidBody(rigid_body->get_rigid_body());
+  rigid_body->reset_states();
 }
 
 void PhysicsProcessor::unregister_rigid_body(RigidBodyComponent *rigid_body)
 {
+  std::unique_lock<std::mutex> lock(my_mutex);
+  wait_idle(lock);
   my_bodies.erase(std::remove(my_bodies.begin(), my_bodies.end(),
      rigid_body), my_bodies.end());
   my_world->removeRigidBody(rigid_body->get_rigid_body());
@@ -71,7 +190,14 @@ void PhysicsProcessor::unregister_rigid_body(RigidBodyComponent *rigid_body)
 
 btDiscreteDynamicsWorld& PhysicsProcessor::bt_world() const
 {
+  sync();
   return *my_world;
 }
 
+u64 PhysicsProcessor::step_count() const
+{
+  std::lock_guard<std::mutex> lock(my_mutex);
+  return my_done;
+}
+
 }
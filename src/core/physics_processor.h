@@ -1,8 +1,13 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include "foundation.h"
 #include "processor.h"
+#include "fixed_timestep.h"
 
 namespace atom {
 
@@ -15,6 +20,18 @@ class MeshColliderComponent;
 // PhysicsProcessor
 //
 
+/**
+ * Physics simulated with a fixed step (PHYSICS_STEP_RATE) on its own thread.
+ * Each poll requests the steps covering the frame time and publishes the
+ * states of the steps requested by the previous poll, so the simulation runs
+ * in parallel with the rest of the frame. Dynamic bodies are interpolated
+ * between the last two stepped states.
+ *
+ * Bullet world and bodies may be accessed only after sync() (bt_world does
+ * it), the main thread waits only for these synchronized accesses.
+ * In deterministic mode the frame time is 1 / FPS and poll waits for the
+ * previous steps, so entities get the same transforms in each run.
+ */
 class PhysicsProcessor : public NullProcessor {
   bool                                  my_is_running;
   uptr<btDefaultCollisionConfiguration> my_configuration;
@@ -24,6 +41,32 @@ class PhysicsProcessor : public NullProcessor {
   uptr<btDiscreteDynamicsWorld>         my_world;
   std::vector<RigidBodyComponent *>     my_bodies;
 
+  // guarded by my_mutex
+  mutable std::mutex                    my_mutex;
+  mutable std::condition_variable       my_condition;
+  u64                                   my_requested;   ///< steps requested by the main thread
+  u64                                   my_done;        ///< steps finished by the physics thread
+  u32                                   my_previous;    ///< state buffers of RigidBodyComponent
+  u32                                   my_current;
+  u32                                   my_back;        ///< written by the physics thread
+  bool                                  my_quit;
+
+  // main thread
+  std::thread                           my_thread;
+  FixedTimestep                         my_timestep;
+  f32                                   my_alpha;       ///< interpolation of the requested steps
+  bool                                  my_has_time;
+  std::chrono::steady_clock::time_point my_last_poll;
+
+  void run();
+
+  void stop();
+
+  /**
+   * Wait for the physics thread, caller holds the lock.
+   */
+  void wait_idle(std::unique_lock<std::mutex> &lock) const;
+
 public:
   PhysicsProcessor(World &world);
   ~PhysicsProcessor();
@@ -32,12 +75,29 @@ public:
 
   void activate() override;
 
+  void deactivate() override;
+
   void poll() override;
 
+  ProcessorAccess access() const override;
+
   void register_rigid_body(RigidBodyComponent *rigid_body);
   void unregister_rigid_body(RigidBodyComponent *rigid_body);
 
+  /**
+   * Wait until the requested steps are simulated.
+   */
+  void sync() const;
+
+  /**
+   * Synchronized access to the bullet world (debug draw, queries).
+   */
   btDiscreteDynamicsWorld& bt_world() const;
+
+  /**
+   * Fixed steps simulated since activation.
+   */
+  u64 step_count() const;
 };
 
 }
@@ -40,6 +40,7 @@ static_assert(sizeof(f64) == 8, "Incorrect size of f64");
 
 const i8   I8_MAX = 127;
 const i16 I16_MAX = 32767;
+const u16 U16_MAX = 0xFFFF;
 const i32 I32_MAX = 2147483647;
 const u32 U32_MAX = 0xFFFFFFFF;
 const i64 I64_MAX = 9223372036854775807L;
@@ -1,4 +1,5 @@
 #include "processor.h"
+#include <algorithm>
 #include "core.h"
 #include "world.h"
 
@@ -26,4 +27,30 @@ World& Processor::world() const
   return my_world;
 }
 
+ProcessorAccess Processor::access() const
+{
+  return ProcessorAccess{ProcessorData::ALL, ProcessorData::ALL};
+}
+
+u32 schedule_processors(const std::vector<ProcessorAccess> &access, std::vector<u32> &levels)
+{
+  u32 count = 0;
+  levels.assign(access.size(), 0);
+
+  for (u32 i = 0; i < access.size(); ++i) {
+    for (u32 j = 0; j < i; ++j) {
+      bool conflict = (access[i].writes & (access[j].reads | access[j].writes)) != 0
+        || (access[i].reads & access[j].writes) != 0;
+
+      if (conflict) {
+        levels[i] = std::max(levels[i], levels[j] + 1);
+      }
+    }
+
+    count = std::max(count, levels[i] + 1);
+  }
+
+  return count;
+}
+
 }
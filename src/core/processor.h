@@ -1,9 +1,41 @@
 #pragma once
 
+#include <vector>
 #include "foundation.h"
 
 namespace atom {
 
+/**
+ * World data read/written by Processor::poll, processors which don't access
+ * same data are polled in parallel.
+ */
+namespace ProcessorData {
+  enum : u32 {
+    TRANSFORMS = 1,   ///< entity transforms
+    PHYSICS    = 2,   ///< physics world, rigid bodies
+    SKELETONS  = 4,   ///< skeleton bone transforms
+    GEOMETRY   = 8,   ///< geometry cache
+    DEBUG      = 16,  ///< debug draw lines
+    ALL        = 0xFFFFFFFF
+  };
+}
+
+struct ProcessorAccess {
+  u32 reads;
+  u32 writes;
+};
+
+/**
+ * Assign each processor to the level, processor is polled after all
+ * preceding processors that write data it accesses (or access data it
+ * writes). Processors in the same level are independent.
+ *
+ * @param access processors in the poll order
+ * @param[out] levels level of each processor
+ * @return number of levels
+ */
+u32 schedule_processors(const std::vector<ProcessorAccess> &access, std::vector<u32> &levels);
+
 /// @todo replace start method with init/terminate & activate/deactivate
 class Processor : NonCopyable {
   World &my_world;
@@ -29,6 +61,11 @@ public:
    * Update/process processor state.
    */
   virtual void poll() = 0;
+
+  /**
+   * Data accessed by poll(), default is everything (no parallel execution).
+   */
+  virtual ProcessorAccess access() const;
 };
 
 class NullProcessor : public Processor {
@@ -9,24 +9,16 @@
 namespace atom {
 
 META_CLASS(RenderComponent,
-  FIELD(my_is_enabled, "enabled")
+  FIELD(my_is_enabled, "enabled"),
+  FIELD(my_is_occluder, "occluder")
 )
 
-void RenderComponent::activate()
-{
-  processors().video.register_component(this);
-}
-
-void RenderComponent::deactivate()
-{
-  processors().video.unregister_component(this);
-}
-
 RenderComponent::RenderComponent()
   : NullComponent(ComponentType::RENDER)
   , my_material(this, "")
   , my_mesh(this, "")
   , my_is_enabled(true)
+  , my_is_occluder(false)
 {
   META_INIT();
 }
@@ -9,10 +9,7 @@ class RenderComponent : public NullComponent {
   Slot<MaterialComponent> my_material;
   Slot<MeshComponent>     my_mesh;
   bool                    my_is_enabled;
-
-  void activate() override;
-
-  void deactivate() override;
+  bool                    my_is_occluder;  ///< model triangles hide objects behind it
 
 public:
   RenderComponent();
@@ -31,6 +28,20 @@ public:
     my_is_enabled = enabled;
   }
 
+  /**
+   * Model triangles (ModelComponent) are rasterized as occluder on CPU, use
+   * it for large low poly meshes (walls, buildings, rocks).
+   */
+  bool is_occluder() const
+  {
+    return my_is_occluder;
+  }
+
+  void set_occluder(bool occluder)
+  {
+    my_is_occluder = occluder;
+  }
+
   META_SUB_CLASS(NullComponent);
 };
 
@@ -5,9 +5,12 @@
 namespace atom {
 
 struct RenderContext {
-  Uniforms     &uniforms;
-  VideoService &video_processor;
+  Uniforms          &uniforms;
+  VideoService      &video_processor;
 //  DrawService  &draw_processor;
+  VideoBuffer       *instances;       ///< model matrices (Mat4f) of instanced draw
+  u32                instance_count;  ///< 0 draw single mesh with Uniforms::model
+  const LodLevel    *lod;             ///< drawn level of detail, nullptr whole surface
 };
 
 }
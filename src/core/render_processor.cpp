@@ -3,17 +3,30 @@
 #include <algorithm>
 #include "resource_service.h"
 #include "render_component.h"
+#include "mesh.h"
 #include "skeleton_component.h"
+#include "model_component.h"
+#include "model.h"
+#include "geometry_component.h"
+#include "geometry_processor.h"
+#include "skinning_feedback.h"
 #include "render_context.h"
 #include "uniforms.h"
+#include "video_buffer.h"
 #include "camera.h"
 #include "world.h"
+#include "constants.h"
 
 namespace atom {
 
 RenderProcessor::RenderProcessor(World &world)
   : NullProcessor(world)
   , my_gbuffer(world.core().video_service())
+  , my_revision(0)
+  , my_occlusion(OCCLUSION_WIDTH, OCCLUSION_HEIGHT)
+  , my_occlusion_culling(true)
+  , my_frame(0)
+  , my_height(0)
 {
 }
 
@@ -25,6 +38,7 @@ RenderProcessor::~RenderProcessor()
 void RenderProcessor::set_resolution(int width, int height)
 {
   my_gbuffer.set_resolution(width, height);
+  my_height = height;
 }
 
 MeshTree* RenderProcessor::mesh_tree()
@@ -40,64 +54,342 @@ void RenderProcessor::render(const Camera &camera)
   VideoService &vs = core().video_service();
 
   Uniforms &u = vs.get_uniforms();
-  RenderContext context = { u, vs };
+  RenderContext context = { u, vs, nullptr, 0, nullptr };
 
   u.transformations.view = camera.view;
   u.transformations.projection = camera.projection;
+  u.view_projection = camera.projection * camera.view;
 
   vs.set_blending(BlendOperation::SRC_ALPHA, BlendOperation::ONE_MINUS_SRC_ALPHA);
 
-  for (RenderComponent *component : my_components) {
+  my_draws.clear();
+  my_queue.clear();
+  my_ids.clear();
+  my_palette.clear();
+
+  const ComponentRange<RenderComponent> components = world().components<RenderComponent>();
+  cull(extract_frustum(u.view_projection));
+  u32 culled = components.size() - my_visible.size();
+  u32 occluded = my_occlusion_culling ? occlusion_cull(u.view_projection) : 0;
+  vs.add_culling_stats(my_visible.size(), culled, occluded);
+
+  for (u32 index : my_visible) {
+    RenderComponent *component = components[index];
+
     if (!component->is_enabled()) {
       continue;
     }
 
-    Entity &entity = component->entity();
-
     const MaterialResourcePtr &material = component->material();
     const MeshResourcePtr &mesh = component->mesh();
 
-    if (material == nullptr || mesh == nullptr) {
-      log_warning("RenderComponent without mesh or material");
+    // mesh isn't loaded yet
+    if (mesh == nullptr) {
+      continue;
+    }
+
+    if (material == nullptr) {
+      log_warning("RenderComponent without material");
       continue;
     }
 
-    u.transformations.model = entity.transform();
-    u.model = u.transformations.model;
-    u.mvp = u.transformations.model_view_projection();
+    Material &m = material->material();
+    const Mat4f &transform = component->entity().transform();
+    Vec3f position(transform(0, 3), transform(1, 3), transform(2, 3));
+    // camera looks in -z direction
+    f32 depth = -transform_point(camera.view, position).z;
+
+    const SkeletonComponent *skeleton = component->entity().find_component<SkeletonComponent>();
+    i32 bone_offset = skeleton != nullptr
+      ? my_palette.add(skeleton, skeleton->get_transforms()) : -1;
+
+    const LodLevel *lod = select_mesh_lod(index, mesh->mesh(), transform, camera.projection, depth);
+    // each level has own id, so only draws of the same level are instanced together
+    const void *mesh_id = lod != nullptr ? static_cast<const void *>(lod) : &mesh->mesh();
+
+    my_queue.add(render_key(frame_id(m.technique()), frame_id(&m), frame_id(mesh_id), depth),
+      my_draws.size());
+    my_draws.push_back(DrawItem{component, &m, &mesh->mesh(), bone_offset, lod});
+  }
+
+  GeometryProcessor &geometry = world().processors().geometry;
+
+  if (geometry.gpu_skinning()) {
+    skin_geometry();
+  } else {
+    vs.set_bone_palette(my_palette.bones());
+  }
+
+  // draws sharing program, material and mesh are submitted together, so
+  // VideoService skips redundant binds, larger groups are drawn as instances
+  my_queue.sort();
+
+  Slice<RenderPacket> packets = my_queue.packets();
+  u32 batch = 0;
+
+  for (u32 i = 0; i < packets.size(); ) {
+    const DrawItem &draw = my_draws[packets[i].index];
+    u32 count = state_run(packets, i);
 
-    SkeletonComponent *skeleton = entity.find_component<SkeletonComponent>();
+    vs.set_draw_face(draw.material->face());
 
-    if (skeleton != nullptr) {
-      int i = 0;
-      for (const Mat4f &t: skeleton->get_transforms()) {
-        u.bones[i++] = t;
+    if (count >= INSTANCING_MIN_COUNT && draw.material->supports_instancing()) {
+      draw_instances(context, packets, i, count, batch++);
+    } else {
+      for (u32 j = i; j < i + count; ++j) {
+        draw_single(context, my_draws[packets[j].index]);
       }
     }
 
-    vs.set_draw_face(material->material().face());
-    material->material().draw_mesh(context, mesh->mesh());
+    i += count;
   }
 
   //  my_pc.stop("Rendering");
 }
 
-GBuffer& RenderProcessor::get_gbuffer()
+void RenderProcessor::draw_single(RenderContext &context, const DrawItem &draw)
 {
-  return my_gbuffer;
+  Uniforms &u = context.uniforms;
+  Entity &entity = draw.component->entity();
+
+  u.transformations.model = entity.transform();
+  u.model = u.transformations.model;
+  u.mvp = u.transformations.model_view_projection();
+
+  // skinning shaders read bones from the frame palette
+  u.bone_offset = draw.bone_offset;
+
+  context.lod = draw.lod;
+  draw.material->draw_mesh(context, *draw.mesh);
+  context.lod = nullptr;
+}
+
+void RenderProcessor::draw_instances(RenderContext &context, const Slice<RenderPacket> &packets,
+  u32 first, u32 count, u32 batch)
+{
+  my_instances.clear();
+
+  for (u32 i = first; i < first + count; ++i) {
+    my_instances.push_back(my_draws[packets[i].index].component->entity().transform());
+  }
+
+  // separate buffer for each draw, so the upload doesn't wait for the previous draw
+  if (batch == my_instance_buffers.size()) {
+    my_instance_buffers.emplace_back(new VideoBuffer(context.video_processor,
+      VideoBufferUsage::DYNAMIC_DRAW));
+  }
+
+  VideoBuffer &buffer = *my_instance_buffers[batch];
+  buffer.set_data(Slice<Mat4f>(my_instances.data(), my_instances.size()));
+
+  const DrawItem &draw = my_draws[packets[first].index];
+  context.uniforms.bone_offset = -1;
+  context.instances = &buffer;
+  context.instance_count = count;
+  context.lod = draw.lod;
+  draw.material->draw_mesh(context, *draw.mesh);
+  context.instances = nullptr;
+  context.instance_count = 0;
+  context.lod = nullptr;
+}
+
+const LodLevel* RenderProcessor::select_mesh_lod(u32 index, const Mesh &mesh,
+  const Mat4f &transform, const Mat4f &projection, f32 depth)
+{
+  if (mesh.lods.size() < 2 || my_height == 0) {
+    return nullptr;
+  }
+
+  // largest scale of the model axes
+  f32 scale = 0;
+
+  for (u32 i = 0; i < 3; ++i) {
+    Vec3f axis(transform(0, i), transform(1, i), transform(2, i));
+    scale = std::max(scale, axis.length());
+  }
+
+  // object crossing the near plane has infinite screen size
+  f32 pixels_per_unit = depth > 0
+    ? projection(1, 1) * 0.5f * my_height * scale / depth : F32_MAX;
+  Slice<LodLevel> lods(mesh.lods.data(), mesh.lods.size());
+  u32 level = select_lod(lods, pixels_per_unit, my_lods[index]);
+  my_lods[index] = level;
+  return &mesh.lods[level];
+}
+
+void RenderProcessor::skin_geometry()
+{
+  VideoService &vs = core().video_service();
+
+  if (my_skinning == nullptr) {
+    my_skinning.reset(new SkinningFeedback(vs));
+  }
+
+  if (!my_skinning->is_valid()) {
+    // fallback to CPU skinning in GeometryProcessor
+    world().processors().geometry.set_gpu_skinning(false);
+    vs.set_bone_palette(my_palette.bones());
+    return;
+  }
+
+  struct Skinned {
+    GeometryComponent *component;
+    const Model       *model;
+    i32                bone_offset;
+  };
+
+  std::vector<Skinned> skinned;
+
+  // all skeletons have to be in the palette before it's uploaded
+  for (GeometryComponent *component : world().components<GeometryComponent>()) {
+    const Model *model = component->model();
+    const SkeletonComponent *skeleton = component->skeleton();
+
+    if (!component->is_dynamic() || model == nullptr || skeleton == nullptr) {
+      continue;
+    }
+
+    skinned.push_back(Skinned{component, model,
+      my_palette.add(skeleton, skeleton->get_transforms())});
+  }
+
+  vs.set_bone_palette(my_palette.bones());
+  my_skinning->begin_frame();
+
+  for (const Skinned &s : skinned) {
+    my_skinning->skin(s.component, *s.model, s.bone_offset, s.component->skin_normals(),
+      s.component->geometry_cache());
+  }
+
+  my_skinning->end_frame();
+}
+
+void RenderProcessor::update_mesh_tree()
+{
+  const ComponentPool &pool = world().component_pool(ComponentType::RENDER);
+  const ComponentRange<RenderComponent> components = pool.view<RenderComponent>();
+  // component was added/removed (packed order has changed)
+  bool needs_rebuild = pool.revision() != my_revision || my_mesh_tree.size() != components.size();
+
+  my_boxes.resize(components.size());
+  my_bounded.resize(components.size());
+  my_lods.resize(components.size());
+  my_unbounded.clear();
+
+  for (u32 i = 0; i < components.size(); ++i) {
+    const MeshResourcePtr &mesh = components[i]->mesh();
+    Entity &entity = components[i]->entity();
+    // entity box may enclose animated mesh, use both
+    BoundingBox box = entity.aabb();
+    bool bounded = mesh != nullptr && !mesh->mesh().bounds.is_null();
+
+    if (bounded) {
+      box.extend(transform_bounding_box(entity.transform(), mesh->mesh().bounds));
+    } else {
+      my_unbounded.push_back(i);
+    }
+
+    my_boxes[i] = box;
+    my_bounded[i] = bounded;
+  }
+
+  Slice<BoundingBox> boxes(my_boxes.data(), my_boxes.size());
+
+  if (needs_rebuild) {
+    my_mesh_tree.build(boxes);
+    // components have new indices
+    my_visible_frame.assign(components.size(), 0);
+    my_lods.assign(components.size(), 0);
+  } else {
+    my_mesh_tree.refit(boxes);
+  }
+
+  my_revision = pool.revision();
+}
+
+void RenderProcessor::cull(const Frustum &frustum)
+{
+  update_mesh_tree();
+
+  my_visible.clear();
+  my_mesh_tree.cull(frustum, my_visible);
+  // mesh without bounds (not loaded yet, generated) is always drawn
+  my_visible.erase(std::remove_if(my_visible.begin(), my_visible.end(),
+    [this](u32 index) { return my_bounded[index] == 0; }), my_visible.end());
+  my_visible.insert(my_visible.end(), my_unbounded.begin(), my_unbounded.end());
+}
+
+u32 RenderProcessor::occlusion_cull(const Mat4f &view_projection)
+{
+  const ComponentRange<RenderComponent> components = world().components<RenderComponent>();
+  ++my_frame;
+
+  my_occlusion.begin(view_projection);
+
+  for (u32 index : my_visible) {
+    RenderComponent *component = components[index];
+
+    if (!component->is_occluder() || !component->is_enabled()) {
+      continue;
+    }
+
+    // triangles of the model, the mesh bounds would hide objects seen through gaps
+    const ModelComponent *model = component->entity().find_component<ModelComponent>();
+    ModelResourcePtr resource = model != nullptr ? model->get_model() : nullptr;
+
+    if (resource != nullptr) {
+      const Model &data = resource->model();
+      my_occlusion.add_mesh(component->entity().transform(), data.find_stream<f32>(MODEL_VERTEX),
+        data.find_stream<u32>(MODEL_INDEX));
+    }
+  }
+
+  if (!my_occlusion.has_occluders()) {
+    return 0;
+  }
+
+  my_occlusion.finish();
+
+  u32 count = my_visible.size();
+
+  // visible components keep the result for few frames, so only hidden ones
+  // are tested each frame and objects near the occluder edge don't flicker
+  my_visible.erase(std::remove_if(my_visible.begin(), my_visible.end(),
+    [this, &components](u32 index) {
+      u32 last = my_visible_frame[index];
+
+      if (!my_bounded[index] || components[index]->is_occluder() ||
+          (last != 0 && my_frame - last < OCCLUSION_VISIBLE_FRAMES)) {
+        return false;
+      }
+
+      if (my_occlusion.is_visible(my_boxes[index])) {
+        my_visible_frame[index] = my_frame;
+        return false;
+      }
+
+      return true;
+    }), my_visible.end());
+
+  return count - my_visible.size();
 }
 
-void RenderProcessor::register_component(RenderComponent *component)
+u32 RenderProcessor::frame_id(const void *object)
 {
-  assert(component != nullptr);
-  my_components.push_back(component);
+  auto found = my_ids.find(object);
+
+  if (found != my_ids.end()) {
+    return found->second;
+  }
+
+  u32 id = my_ids.size();
+  my_ids[object] = id;
+  return id;
 }
 
-void RenderProcessor::unregister_component(RenderComponent *component)
+GBuffer& RenderProcessor::get_gbuffer()
 {
-  assert(component != nullptr);
-  my_components.erase(std::remove(my_components.begin(), my_components.end(),
-     component), my_components.end());
+  return my_gbuffer;
 }
 
 }
@@ -1,17 +1,91 @@
 #pragma once
 
+#include <unordered_map>
 #include "processor.h"
 #include "mesh_tree.h"
 #include "gbuffer.h"
+#include "render_queue.h"
+#include "bone_palette.h"
+#include "occlusion_buffer.h"
 
 namespace atom {
 
-typedef std::vector<RenderComponent *> RenderComponentArray;
-
 class RenderProcessor : public NullProcessor {
-  GBuffer              my_gbuffer;
-  MeshTree             my_mesh_tree;
-  RenderComponentArray my_components;
+  struct DrawItem {
+    RenderComponent *component;
+    Material        *material;
+    const Mesh      *mesh;
+    i32              bone_offset;   ///< first bone in my_palette (-1 without skeleton)
+    const LodLevel  *lod;           ///< nullptr draws the whole mesh
+  };
+
+  GBuffer               my_gbuffer;
+  MeshTree              my_mesh_tree; ///< world boxes of RenderComponents (pool order)
+  std::vector<BoundingBox> my_boxes;
+  std::vector<u8>       my_bounded;   ///< component has known bounds and is culled
+  std::vector<u32>      my_unbounded; ///< components drawn without culling
+  std::vector<u32>      my_visible;   ///< components of the current frame
+  u32                   my_revision;  ///< component pool revision used by my_mesh_tree
+  OcclusionBuffer       my_occlusion;
+  bool                  my_occlusion_culling;
+  std::vector<u32>      my_visible_frame;  ///< last frame the component passed occlusion test (0 never)
+  u32                   my_frame;
+  std::vector<u8>       my_lods;      ///< level of detail of the component in the last frame
+  u32                   my_height;    ///< viewport height in pixels
+  RenderQueue           my_queue;
+  std::vector<DrawItem> my_draws;     ///< draws of the current frame (RenderPacket::index)
+  std::unordered_map<const void *, u32> my_ids;  ///< sort key ids of techniques, materials, meshes
+  std::vector<Mat4f>    my_instances; ///< model matrices of the current instanced draw
+  std::vector<uptr<VideoBuffer>> my_instance_buffers;  ///< one per instanced draw in the frame
+  BonePalette           my_palette;   ///< bones of all skeletons used in the frame
+  uptr<SkinningFeedback> my_skinning; ///< created when GeometryProcessor::gpu_skinning is enabled
+
+  /**
+   * Dense id of the object for the sort key (valid during one frame).
+   */
+  u32 frame_id(const void *object);
+
+  /**
+   * Update boxes of all components and rebuild/refit my_mesh_tree.
+   */
+  void update_mesh_tree();
+
+  /**
+   * Fill my_visible by components intersecting the frustum.
+   */
+  void cull(const Frustum &frustum);
+
+  /**
+   * Rasterize occluders from my_visible and remove hidden components.
+   *
+   * @return number of removed components
+   */
+  u32 occlusion_cull(const Mat4f &view_projection);
+
+  /**
+   * Select level of detail of the mesh by its projected error, keeps the
+   * level of previous frame near the threshold.
+   *
+   * @param index component index in the pool
+   * @param depth view space distance of the component
+   */
+  const LodLevel* select_mesh_lod(u32 index, const Mesh &mesh, const Mat4f &transform,
+    const Mat4f &projection, f32 depth);
+
+  /**
+   * Skin dynamic geometry caches with the uploaded palette (GPU skinning).
+   */
+  void skin_geometry();
+
+  void draw_single(RenderContext &context, const DrawItem &draw);
+
+  /**
+   * Draw @p count sorted packets sharing material and mesh with one draw call.
+   *
+   * @param batch index of the instanced draw in the frame (instance buffer)
+   */
+  void draw_instances(RenderContext &context, const Slice<RenderPacket> &packets, u32 first,
+    u32 count, u32 batch);
 
 public:
   explicit RenderProcessor(World &world);
@@ -19,6 +93,15 @@ public:
 
   void set_resolution(int width, int height);
 
+  /**
+   * Hide components behind occluders (RenderComponent::is_occluder), enabled
+   * by default.
+   */
+  void set_occlusion_culling(bool enable)
+  {
+    my_occlusion_culling = enable;
+  }
+
   MeshTree* mesh_tree();
 
   MeshTree* gui_tree();
@@ -26,9 +109,6 @@ public:
   void render(const Camera &camera);
 
   GBuffer& get_gbuffer();
-
-  void register_component(RenderComponent *component);
-  void unregister_component(RenderComponent *component);
 };
 
 }
@@ -0,0 +1,81 @@
+#include "render_queue.h"
+#include <algorithm>
+#include <cstring>
+
+namespace atom {
+
+u64 render_key(u32 technique, u32 material, u32 mesh, f32 depth)
+{
+  // monotonic mapping of <0, inf) to <0, 1)
+  f32 d = depth > 0 ? depth / (depth + 1) : 0;
+  u64 quantized = std::min(static_cast<u32>(d * 65536), 0xFFFFu);
+
+  return (u64(technique & 0xFFFF) << 48) | (u64(material & 0xFFFF) << 32) |
+         (u64(mesh & 0xFFFF) << 16) | quantized;
+}
+
+u32 state_run(const Slice<RenderPacket> &packets, u32 first)
+{
+  assert(first < packets.size());
+  u64 state = packets[first].key >> 16;
+  u32 last = first + 1;
+
+  while (last < packets.size() && (packets[last].key >> 16) == state) {
+    ++last;
+  }
+
+  return last - first;
+}
+
+void radix_sort(RenderPacket *packets, RenderPacket *buffer, u32 count)
+{
+  const u32 DIGITS = sizeof(u64);
+  u32 histogram[DIGITS][256];
+  memset(histogram, 0, sizeof(histogram));
+
+  // histograms of all digits in one pass
+  for (u32 i = 0; i < count; ++i) {
+    u64 key = packets[i].key;
+
+    for (u32 d = 0; d < DIGITS; ++d) {
+      ++histogram[d][(key >> (d * 8)) & 0xFF];
+    }
+  }
+
+  RenderPacket *src = packets;
+  RenderPacket *dst = buffer;
+
+  for (u32 d = 0; d < DIGITS; ++d) {
+    u32 *h = histogram[d];
+    // all keys have the same digit, nothing to do
+    if (count == 0 || h[(src[0].key >> (d * 8)) & 0xFF] == count) {
+      continue;
+    }
+
+    u32 offset = 0;
+
+    for (u32 b = 0; b < 256; ++b) {
+      u32 n = h[b];
+      h[b] = offset;
+      offset += n;
+    }
+
+    for (u32 i = 0; i < count; ++i) {
+      dst[h[(src[i].key >> (d * 8)) & 0xFF]++] = src[i];
+    }
+
+    std::swap(src, dst);
+  }
+
+  if (src != packets) {
+    memcpy(packets, src, count * sizeof(RenderPacket));
+  }
+}
+
+void RenderQueue::sort()
+{
+  my_buffer.resize(my_packets.size());
+  radix_sort(my_packets.data(), my_buffer.data(), my_packets.size());
+}
+
+}
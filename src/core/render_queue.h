@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include "foundation.h"
+
+namespace atom {
+
+/**
+ * Draw request, draws are submitted in the key order.
+ */
+struct RenderPacket {
+  u64 key;
+  u32 index;    ///< index of the draw data (owned by the caller)
+};
+
+/**
+ * Sort key, draws with the same technique, material and mesh are grouped,
+ * inside the group they are ordered front to back.
+ *
+ *   | technique 16b | material 16b | mesh 16b | depth 16b |
+ *
+ * @param depth view space distance, values < 0 are clamped to 0
+ */
+u64 render_key(u32 technique, u32 material, u32 mesh, f32 depth);
+
+/**
+ * Number of sorted packets starting at @p first which share technique,
+ * material and mesh (differ only in depth), such run can be drawn instanced.
+ */
+u32 state_run(const Slice<RenderPacket> &packets, u32 first);
+
+/**
+ * LSD radix sort by RenderPacket::key (8 bit digits), stable.
+ *
+ * @param buffer temporary storage for @p count packets
+ */
+void radix_sort(RenderPacket *packets, RenderPacket *buffer, u32 count);
+
+class RenderQueue {
+  std::vector<RenderPacket> my_packets;
+  std::vector<RenderPacket> my_buffer;    ///< radix sort storage
+
+public:
+  void clear()
+  {
+    my_packets.clear();
+  }
+
+  void add(u64 key, u32 index)
+  {
+    my_packets.push_back(RenderPacket{key, index});
+  }
+
+  void sort();
+
+  Slice<RenderPacket> packets() const
+  {
+    return Slice<RenderPacket>(my_packets.data(), my_packets.size());
+  }
+};
+
+}
@@ -0,0 +1,201 @@
+#include "resource_index.h"
+#include <algorithm>
+#include <limits>
+#include "constants.h"
+#include "utils.h"
+
+namespace atom {
+
+ResourceIndex::ResourceIndex()
+  : my_released(std::numeric_limits<int>::max())
+  , my_released_size(0)
+  , my_memory_budget(u64(DEFAULT_RESOURCE_CACHE_SIZE) << 20)
+  , my_grace_period(i64(DEFAULT_RESOURCE_GRACE_PERIOD) * 1000)
+  , my_cursor(0)
+{
+}
+
+void ResourceIndex::set_cache_limits(u64 memory_budget, i64 grace_period)
+{
+  my_memory_budget = memory_budget;
+  my_grace_period = grace_period;
+}
+
+ResourcePtr ResourceIndex::find(const String &name)
+{
+  auto found = my_names.find(name);
+
+  if (found == my_names.end()) {
+    return nullptr;
+  }
+
+  release_from_cache(name);
+  return my_resources[found->second];
+}
+
+void ResourceIndex::add(const ResourcePtr &resource)
+{
+  assert(resource != nullptr);
+  assert(my_names.find(resource->name()) == my_names.end() && "This resource already exists");
+
+  my_names[resource->name()] = my_resources.size();
+  my_resources.push_back(resource);
+  update_sources(*resource);
+}
+
+void ResourceIndex::update_sources(const Resource &resource)
+{
+  for (const String &source : resource.sources()) {
+    StringArray &dependents = my_dependents[source];
+
+    if (std::find(dependents.begin(), dependents.end(), resource.name()) == dependents.end()) {
+      dependents.push_back(resource.name());
+    }
+  }
+}
+
+const StringArray& ResourceIndex::dependents(const String &source) const
+{
+  static const StringArray empty;
+  auto found = my_dependents.find(source);
+  return found != my_dependents.end() ? found->second : empty;
+}
+
+void ResourceIndex::garbage_collect(StringArray &removed)
+{
+  auto last = std::remove_if(my_resources.begin(), my_resources.end(),
+    [&removed](const ResourcePtr &resource) -> bool
+    {
+      if (resource.use_count() == 1) {
+        removed.push_back(resource->name());
+        return true;
+      }
+      return false;
+    });
+
+  if (last != my_resources.end()) {
+    my_resources.erase(last, my_resources.end());
+    rebuild();
+  }
+
+  // remaining resources are referenced
+  my_released.clear();
+  my_released_size = 0;
+}
+
+void ResourceIndex::collect(i64 now, i64 budget, StringArray &removed)
+{
+  const i64 deadline = micro_time() + budget;
+  const u32 count = my_resources.size();
+
+  // find unused resources, continue where the previous call stopped
+  for (u32 i = 0; i < count; ++i) {
+    if (my_cursor >= my_resources.size()) {
+      my_cursor = 0;
+    }
+
+    const ResourcePtr &resource = my_resources[my_cursor++];
+    auto released = my_released.find(resource->name());
+    bool unused = resource.use_count() == 1 && resource->is_ready();
+
+    if (unused && released == my_released.end()) {
+      u32 size = resource->memory_size();
+      my_released.insert(resource->name(), ReleasedResource{now, size});
+      my_released_size += size;
+    } else if (!unused && released != my_released.end()) {
+      release_from_cache(resource->name());
+    }
+
+    if ((i & 31) == 31 && micro_time() >= deadline) {
+      break;
+    }
+  }
+
+  // evict the oldest resources
+  while (!my_released.empty()) {
+    auto oldest = my_released.oldest();
+
+    if (my_released_size <= my_memory_budget && now - oldest->time < my_grace_period) {
+      break;
+    }
+
+    String name = oldest.key();
+    u32 index = my_names[name];
+    release_from_cache(name);
+
+    // resource was referenced again since it was released (e.g. by other resource)
+    if (my_resources[index].use_count() > 1) {
+      continue;
+    }
+
+    removed.push_back(name);
+    remove_at(index);
+
+    // at least one resource is evicted, the rest waits for the next call
+    if (micro_time() >= deadline) {
+      break;
+    }
+  }
+}
+
+ResourceArray ResourceIndex::release()
+{
+  ResourceArray resources;
+  resources.swap(my_resources);
+  my_names.clear();
+  my_dependents.clear();
+  my_released.clear();
+  my_released_size = 0;
+  my_cursor = 0;
+  return resources;
+}
+
+void ResourceIndex::rebuild()
+{
+  my_names.clear();
+  my_dependents.clear();
+
+  for (u32 i = 0; i < my_resources.size(); ++i) {
+    my_names[my_resources[i]->name()] = i;
+    update_sources(*my_resources[i]);
+  }
+}
+
+void ResourceIndex::remove_at(u32 index)
+{
+  assert(index < my_resources.size());
+  ResourcePtr resource = my_resources[index];
+
+  for (const String &source : resource->sources()) {
+    auto found = my_dependents.find(source);
+
+    if (found != my_dependents.end()) {
+      utils::erase_remove(found->second, resource->name());
+
+      if (found->second.empty()) {
+        my_dependents.erase(found);
+      }
+    }
+  }
+
+  my_names.erase(resource->name());
+
+  if (index + 1 != my_resources.size()) {
+    my_resources[index] = my_resources.back();
+    my_names[my_resources[index]->name()] = index;
+  }
+
+  my_resources.pop_back();
+}
+
+void ResourceIndex::release_from_cache(const String &name)
+{
+  auto released = my_released.find(name);
+
+  if (released != my_released.end()) {
+    my_released_size -= released->size;
+    my_released.erase(name);
+  }
+}
+
+}
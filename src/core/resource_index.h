@@ -0,0 +1,129 @@
+#pragma once
+
+#include <unordered_map>
+#include "lru_cache.h"
+#include "resources.h"
+
+namespace atom {
+
+typedef std::vector<ResourcePtr> ResourceArray;
+
+/**
+ * Resource container with hash lookup by resource name and reverse dependency
+ * graph (source -> resources depending on it). Source is file ("file:...")
+ * or another resource name, see Resource::sources().
+ *
+ * Unused resources are not removed immediately, they are kept in the LRU
+ * cache until the grace period expires or the memory budget is exceeded
+ * (see collect).
+ */
+class ResourceIndex {
+public:
+  ResourceIndex();
+
+  /**
+   * Set limits for the incremental garbage collection.
+   *
+   * @param memory_budget max size of unused resources (bytes)
+   * @param grace_period time for which unused resource is kept (microseconds)
+   */
+  void set_cache_limits(u64 memory_budget, i64 grace_period);
+
+  /**
+   * Find resource, found resource is no longer considered as unused.
+   *
+   * @return resource or nullptr when resource doesn't exist
+   */
+  ResourcePtr find(const String &name);
+
+  /**
+   * Add resource and its sources to the dependency graph.
+   */
+  void add(const ResourcePtr &resource);
+
+  /**
+   * Add new sources of the resource to the dependency graph (resource may get
+   * new dependencies while reloading).
+   */
+  void update_sources(const Resource &resource);
+
+  /**
+   * @return names of resources that depend directly on @p source, indirect
+   *         dependents have to be looked up with the returned names
+   */
+  const StringArray& dependents(const String &source) const;
+
+  /**
+   * Remove resources that are not referenced from outside of the index.
+   *
+   * @param[out] removed names of removed resources
+   */
+  void garbage_collect(StringArray &removed);
+
+  /**
+   * Incremental garbage collection, run it every frame. Unreferenced
+   * resources are moved to the LRU cache and the oldest ones are removed
+   * when they are unused longer than the grace period or the cache exceeds
+   * the memory budget.
+   *
+   * @param now current time (microseconds)
+   * @param budget max time spent by scanning and evicting the resources
+   *               (microseconds), remaining work continues in the next call
+   * @param[out] removed names of removed resources
+   */
+  void collect(i64 now, i64 budget, StringArray &removed);
+
+  /**
+   * @return memory used by unused resources in the cache (bytes)
+   */
+  u64 released_size() const
+  {
+    return my_released_size;
+  }
+
+  const ResourceArray& resources() const
+  {
+    return my_resources;
+  }
+
+  u32 size() const
+  {
+    return my_resources.size();
+  }
+
+  /**
+   * Remove all resources from the index and return them.
+   */
+  ResourceArray release();
+
+private:
+  void rebuild();
+
+  /**
+   * Remove resource in O(1), the last resource is moved to its place.
+   */
+  void remove_at(u32 index);
+
+  void release_from_cache(const String &name);
+
+private:
+  struct ReleasedResource {
+    i64 time;   ///< time when resource was found unused
+    u32 size;   ///< Resource::memory_size
+  };
+
+  typedef std::unordered_map<String, u32> NameMap;
+  typedef std::unordered_map<String, StringArray> DependencyMap;
+  typedef LRUCache<String, ReleasedResource> ReleasedCache;
+
+  ResourceArray my_resources;
+  NameMap       my_names;       ///< resource name -> index to my_resources
+  DependencyMap my_dependents;  ///< source -> dependent resource names
+  ReleasedCache my_released;    ///< unused resources, the oldest is evicted first
+  u64           my_released_size;
+  u64           my_memory_budget;
+  i64           my_grace_period;
+  u32           my_cursor;      ///< next resource checked by collect
+};
+
+}
@@ -11,9 +11,34 @@
 #include "model_loader.h"
 #include "loaders.h"
 #include "config.h"
+#include "thread_pool.h"
+#include "image.h"
+#include "model.h"
+#include "utils.h"
 
 namespace atom {
 
+/**
+ * Asynchronous load request. The decode step runs on a worker thread, the
+ * finish step (GL upload, set_data) on the main thread after the dependency
+ * is ready.
+ */
+struct AsyncRequest {
+  ResourcePtr           resource;
+  ResourcePtr           dependency;   ///< must be ready before finish, may be nullptr
+  std::function<bool()> decode;       ///< worker thread, may be empty
+  std::function<bool()> finish;       ///< main thread
+  i32                   priority;     ///< guarded by ResourceService::my_async_mutex
+  bool                  decoded;      ///< guarded by ResourceService::my_async_mutex
+  bool                  success;      ///< result of decode step
+
+  AsyncRequest()
+    : priority(0)
+    , decoded(false)
+    , success(false)
+  {}
+};
+
 struct ResourceLoaders {
   ImageLoader      image;
   TextureLoader    texture;
@@ -38,7 +63,8 @@ sptr<T> find_or_load_resource(ResourceService &rs, const String &name, const Str
   ResourcePtr found = rs.find_resource(resource_name);
 
   if (found != nullptr) {
-    return std::static_pointer_cast<T>(found);
+    // resource may be still loading asynchronously
+    return rs.wait_for(found) ? std::static_pointer_cast<T>(found) : nullptr;
   }
 
   ResourcePtr resource = loader.create_resource(rs, name);
@@ -66,6 +92,10 @@ ResourceService::ResourceService(Core &core)
 {
   init_loaders();
 
+  const Config &config = Config::instance();
+  my_resources.set_cache_limits(u64(std::max(config.resource_cache_size, 0)) << 20,
+    i64(config.resource_grace_period) * 1000);
+
   // watch data directory
   my_file_watch.watch_dir(MESH_RESOURCE_DIR);
   my_file_watch.watch_dir(IMAGE_RESOURCE_DIR);
@@ -77,7 +107,17 @@ ResourceService::~ResourceService()
 {
   log_debug(DEBUG_RESOURCES, "Releaseing all resources");
 
-  ResourceArray resources = std::move(my_resources);
+  // drop pending requests, queued jobs find nothing to decode and only the
+  // running jobs are finished
+  {
+    std::lock_guard<std::mutex> lock(my_async_mutex);
+    my_pending.clear();
+  }
+
+  my_workers.reset();
+  my_requests.clear();
+
+  ResourceArray resources = my_resources.release();
   ResourceArray used;
 
   bool cycle = false;
@@ -134,6 +174,7 @@ void ResourceService::quit_loaders()
 
 void ResourceService::poll()
 {
+  poll_async(RESOURCE_ASYNC_BUDGET);
   my_file_watch.poll();
   StringArray change_list;
 
@@ -142,27 +183,27 @@ void ResourceService::poll()
 
   if (!change_list.empty())
     refresh(*this, change_list);
+
+  StringArray removed;
+  my_resources.collect(micro_time(), RESOURCE_GC_BUDGET, removed);
+
+  for (const String &name : removed)
+    log_debug(DEBUG_RESOURCES, "Unloading the resource \"%s\"", name.c_str());
 }
 
 void ResourceService::garbage_collect()
 {
-  auto i = my_resources.begin();
+  StringArray removed;
+  my_resources.garbage_collect(removed);
 
-  while (i != my_resources.end()) {
-    const ResourcePtr &resource = *i;
-    if (resource.use_count() == 1) {
-      log_debug(DEBUG_RESOURCES, "Unloading the resource \"%s\"", resource->name().c_str());
-      i = my_resources.erase(i);
-    } else {
-      ++i;
-    }
-  }
+  for (const String &name : removed)
+    log_debug(DEBUG_RESOURCES, "Unloading the resource \"%s\"", name.c_str());
 }
 
 void ResourceService::print()
 {
   log_info("Managing these (unified) resources");
-  for (const ResourcePtr &resource : my_resources)
+  for (const ResourcePtr &resource : my_resources.resources())
     log_info("%s (%i)", resource->name().c_str(), resource.use_count() - 1);
 }
 
@@ -214,47 +255,51 @@ MusicResourcePtr ResourceService::get_music(const String &name)
 ResourcePtr ResourceService::find_resource(const String &resource_name)
 {
   assert(!resource_name.empty());
-
-  auto found = std::find_if(my_resources.begin(), my_resources.end(),
-    [&resource_name](const ResourcePtr &resource) -> bool
-    { return resource->name() == resource_name; });
-
-  return found != my_resources.end() ? *found : nullptr;
+  return my_resources.find(resource_name);
 }
 
 void ResourceService::add_resource(const ResourcePtr &resource)
 {
   assert(resource != nullptr);
   assert(!resource->name().empty());
-  assert(find_resource(resource->name()) == nullptr && "This resource already exists");
-  my_resources.push_back(resource);
+  my_resources.add(resource);
 }
 
 void ResourceService::refresh(ResourceService &rs, const StringArray &change_list)
 {
+  if (change_list.empty()) {
+    log_warning("Refresh called but there are no changes");
+    return;
+  }
+
   StringArray changes(change_list);
 
   do {
     StringArray next_changes;
-    // pouzi kopiu, pretoze zoznam zdrojov sa moze pri updatovani zmenit (zvacsit)
-    std::vector<ResourcePtr> resources(rs.my_resources);
 
     std::sort(changes.begin(), changes.end());
-    std::unique(changes.begin(), changes.end());
+    changes.erase(std::unique(changes.begin(), changes.end()), changes.end());
 
     for (const String &change : changes) {
-      for (const ResourcePtr &resource : resources) {
-        const auto &sources = resource->sources();
-        if (find(sources.begin(), sources.end(), change) != sources.end()) {
-          Loader *loader = resource->loader();
-
-          if (loader != nullptr) {
-            log_debug(DEBUG_RESOURCES, "Reloading the \"%s\" resource", resource->name().c_str());
-            loader->reload_resource(rs, *resource);
-            next_changes.push_back(resource->name());
-          } else {
-            log_debug(DEBUG_RESOURCES, "There is no loader for \"%s\"", resource->name().c_str());
-          }
+      // copy, dependents can change while reloading
+      StringArray dependents = rs.my_resources.dependents(change);
+
+      for (const String &name : dependents) {
+        ResourcePtr resource = rs.my_resources.find(name);
+        // asynchronous load is in progress and will use the new file version
+        if (!resource->is_ready()) {
+          continue;
+        }
+
+        Loader *loader = resource->loader();
+
+        if (loader != nullptr) {
+          log_debug(DEBUG_RESOURCES, "Reloading the \"%s\" resource", resource->name().c_str());
+          loader->reload_resource(rs, *resource);
+          rs.my_resources.update_sources(*resource);
+          next_changes.push_back(resource->name());
+        } else {
+          log_debug(DEBUG_RESOURCES, "There is no loader for \"%s\"", resource->name().c_str());
         }
       }
     }
@@ -262,11 +307,6 @@ void ResourceService::refresh(ResourceService &rs, const StringArray &change_lis
     changes = next_changes;
   }
   while (!changes.empty());
-
-  if (change_list.empty()) {
-    log_warning("Refresh called but there are no changes");
-    return;
-  }
 }
 
 void ResourceService::refresh(ResourceService &rs, const String &resource_name)
@@ -276,4 +316,331 @@ void ResourceService::refresh(ResourceService &rs, const String &resource_name)
   refresh(rs, change_list);
 }
 
+//-----------------------------------------------------------------------------
+//
+// Asynchronous loading
+//
+//-----------------------------------------------------------------------------
+
+ImageResourcePtr ResourceService::get_image_async(const String &name)
+{
+  String resource_name = make_resource_name(RESOURCE_IMAGE_TAG, name);
+  ResourcePtr found = find_resource(resource_name);
+
+  if (found != nullptr) {
+    return std::static_pointer_cast<ImageResource>(found);
+  }
+
+  String filename = ImageLoader::get_image_filename(name);
+  ImageResourcePtr resource = std::make_shared<ImageResource>();
+  resource->set_name(resource_name);
+  resource->depend_on_file(filename);
+  resource->set_loader(&my_loaders->image);
+  resource->set_state(ResourceState::LOADING);
+
+  sptr<uptr<Image>> image = std::make_shared<uptr<Image>>();
+  sptr<AsyncRequest> request = std::make_shared<AsyncRequest>();
+  request->resource = resource;
+  request->decode = [filename, image]() -> bool {
+    *image = Image::create_from_file(filename.c_str());
+    return *image != nullptr;
+  };
+  request->finish = [resource, image]() -> bool {
+    resource->set_data(std::move(*image));
+    return true;
+  };
+
+  add_resource(resource);
+  submit(request);
+  return resource;
+}
+
+TextureResourcePtr ResourceService::get_texture_async(const String &name)
+{
+  String resource_name = make_resource_name(RESOURCE_TEXTURE_TAG, name);
+  ResourcePtr found = find_resource(resource_name);
+
+  if (found != nullptr) {
+    return std::static_pointer_cast<TextureResource>(found);
+  }
+
+  ImageResourcePtr image = get_image_async(name);
+  TextureResourcePtr resource = std::make_shared<TextureResource>();
+  resource->set_name(resource_name);
+  resource->depend_on_resource(image);
+  resource->set_loader(&my_loaders->texture);
+  resource->set_state(ResourceState::LOADING);
+
+  VideoService &vs = video_service();
+  sptr<AsyncRequest> request = std::make_shared<AsyncRequest>();
+  request->resource = resource;
+  request->dependency = image;
+  request->finish = [resource, image, &vs]() -> bool {
+    uptr<Texture> texture(new Texture(vs));
+    texture->init_from_image(image->image());
+    resource->set_data(std::move(texture));
+    return true;
+  };
+
+  add_resource(resource);
+  submit(request);
+  return resource;
+}
+
+ModelResourcePtr ResourceService::get_model_async(const String &name, i32 priority)
+{
+  String resource_name = make_resource_name(RESOURCE_MODEL_TAG, name);
+  ResourcePtr found = find_resource(resource_name);
+
+  if (found != nullptr) {
+    return std::static_pointer_cast<ModelResource>(found);
+  }
+
+  String filename = ModelLoader::get_model_filename(name);
+  ModelResourcePtr resource = std::make_shared<ModelResource>();
+  my_loaders->model.init_resource(*resource, name);
+  resource->set_state(ResourceState::LOADING);
+
+  sptr<uptr<Model>> model = std::make_shared<uptr<Model>>(new Model());
+  sptr<AsyncRequest> request = std::make_shared<AsyncRequest>();
+  request->resource = resource;
+  request->priority = priority;
+  request->decode = [filename, model]() -> bool {
+    return load_model(filename, **model);
+  };
+  request->finish = [resource, model]() -> bool {
+    resource->set_data(std::move(*model));
+    return true;
+  };
+
+  add_resource(resource);
+  submit(request);
+  return resource;
+}
+
+MeshResourcePtr ResourceService::get_mesh_async(const String &name, i32 priority)
+{
+  String resource_name = make_resource_name(RESOURCE_MESH_TAG, name);
+  ResourcePtr found = find_resource(resource_name);
+
+  if (found != nullptr) {
+    return std::static_pointer_cast<MeshResource>(found);
+  }
+
+  ModelResourcePtr model = get_model_async(name, priority);
+  MeshResourcePtr resource = std::make_shared<MeshResource>();
+  resource->set_name(resource_name);
+  resource->depend_on_resource(model);
+  resource->set_loader(&my_loaders->mesh);
+  resource->set_state(ResourceState::LOADING);
+
+  sptr<AsyncRequest> request = std::make_shared<AsyncRequest>();
+  request->resource = resource;
+  request->dependency = model;
+  request->priority = priority;
+  request->finish = [this, resource, model]() -> bool {
+    uptr<Mesh> mesh(new Mesh());
+    MeshLoader::load_mesh_from_model(*this, model->model(), *mesh);
+    resource->set_data(std::move(mesh));
+    return true;
+  };
+
+  add_resource(resource);
+  submit(request);
+  return resource;
+}
+
+SoundResourcePtr ResourceService::get_sound_async(const String &name)
+{
+  String resource_name = make_resource_name(RESOURCE_SOUND_TAG, name);
+  ResourcePtr found = find_resource(resource_name);
+
+  if (found != nullptr) {
+    return std::static_pointer_cast<SoundResource>(found);
+  }
+
+  String filename = SoundLoader::sound_filename(name);
+  ResampleQuality quality = Config::instance().linear_resampling ? ResampleQuality::LINEAR
+    : ResampleQuality::SINC;
+  SoundResourcePtr resource = std::make_shared<SoundResource>();
+  resource->set_name(resource_name);
+  resource->depend_on_file(filename);
+  resource->set_loader(&my_loaders->sound);
+  resource->set_state(ResourceState::LOADING);
+
+  sptr<uptr<Sound>> sound = std::make_shared<uptr<Sound>>();
+  sptr<AsyncRequest> request = std::make_shared<AsyncRequest>();
+  request->resource = resource;
+  request->decode = [filename, quality, sound]() -> bool {
+    *sound = Sound::create_from_file(filename.c_str(), quality);
+    return *sound != nullptr;
+  };
+  request->finish = [resource, sound]() -> bool {
+    resource->set_data(std::move(*sound));
+    return true;
+  };
+
+  add_resource(resource);
+  submit(request);
+  return resource;
+}
+
+bool ResourceService::wait_for(const ResourcePtr &resource)
+{
+  assert(resource != nullptr);
+
+  if (resource->state() != ResourceState::LOADING) {
+    return resource->is_ready();
+  }
+
+  auto found = std::find_if(my_requests.begin(), my_requests.end(),
+    [&resource](const sptr<AsyncRequest> &request) { return request->resource == resource; });
+
+  assert(found != my_requests.end() && "Loading resource without request");
+  sptr<AsyncRequest> request = *found;
+
+  if (request->dependency != nullptr) {
+    wait_for(request->dependency);
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(my_async_mutex);
+    // don't wait behind other pending requests
+    request->priority = I32_MAX;
+    my_decoded.wait(lock, [&request] { return request->decoded; });
+  }
+
+  try_finish(*request);
+  utils::erase_remove(my_requests, request);
+  return resource->is_ready();
+}
+
+void ResourceService::submit(const sptr<AsyncRequest> &request)
+{
+  my_requests.push_back(request);
+
+  if (!request->decode) {
+    request->decoded = true;
+    request->success = true;
+    return;
+  }
+
+  if (my_workers == nullptr) {
+    my_workers.reset(new ThreadPool());
+    log_debug(DEBUG_RESOURCES, "Starting %u resource loading threads", my_workers->worker_count());
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(my_async_mutex);
+    my_pending.push_back(request);
+  }
+
+  // each job decodes one request, not necessarily this one
+  my_workers->push([this]() { decode_next(); });
+}
+
+void ResourceService::decode_next()
+{
+  sptr<AsyncRequest> request;
+
+  {
+    std::lock_guard<std::mutex> lock(my_async_mutex);
+
+    // requests were dropped (shutdown)
+    if (my_pending.empty()) {
+      return;
+    }
+
+    // first of the highest priority requests, so equal priorities keep the submit order
+    auto next = std::max_element(my_pending.begin(), my_pending.end(),
+      [](const sptr<AsyncRequest> &a, const sptr<AsyncRequest> &b) {
+        return a->priority < b->priority;
+      });
+    request = *next;
+    my_pending.erase(next);
+  }
+
+  bool success = request->decode();
+
+  {
+    std::lock_guard<std::mutex> lock(my_async_mutex);
+    request->decoded = true;
+    request->success = success;
+  }
+
+  my_decoded.notify_all();
+}
+
+void ResourceService::set_load_priority(const ResourcePtr &resource, i32 priority)
+{
+  assert(resource != nullptr);
+
+  if (resource->state() != ResourceState::LOADING) {
+    return;
+  }
+
+  auto found = std::find_if(my_requests.begin(), my_requests.end(),
+    [&resource](const sptr<AsyncRequest> &request) { return request->resource == resource; });
+
+  if (found == my_requests.end()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(my_async_mutex);
+    (*found)->priority = priority;
+  }
+
+  if ((*found)->dependency != nullptr) {
+    set_load_priority((*found)->dependency, priority);
+  }
+}
+
+void ResourceService::poll_async(i64 budget)
+{
+  i64 start = micro_time();
+  auto i = my_requests.begin();
+  // requests are in submit order, dependency is always before dependent request
+  while (i != my_requests.end() && micro_time() - start < budget) {
+    if (try_finish(**i)) {
+      i = my_requests.erase(i);
+    } else {
+      ++i;
+    }
+  }
+}
+
+bool ResourceService::try_finish(AsyncRequest &request)
+{
+  {
+    std::lock_guard<std::mutex> lock(my_async_mutex);
+
+    if (!request.decoded) {
+      return false;
+    }
+  }
+
+  Resource &resource = *request.resource;
+
+  if (request.dependency != nullptr) {
+    if (request.dependency->state() == ResourceState::LOADING) {
+      return false;
+    }
+
+    if (request.dependency->state() == ResourceState::FAILED) {
+      request.success = false;
+    }
+  }
+
+  if (request.success && request.finish()) {
+    log_debug(DEBUG_RESOURCES, "Resource \"%s\" loaded asynchronously", resource.name().c_str());
+    resource.set_state(ResourceState::READY);
+  } else {
+    log_error("Can't load resource \"%s\"", resource.name().c_str());
+    resource.set_state(ResourceState::FAILED);
+  }
+
+  return true;
+}
+
 }
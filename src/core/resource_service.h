@@ -1,12 +1,15 @@
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
 #include "corefwd.h"
 #include "resources.h"
+#include "resource_index.h"
 #include "file_watch.h"
 
 namespace atom {
 
-typedef std::vector<ResourcePtr> ResourceArray;
+struct AsyncRequest;
 
 /**
  * Tato trieda reprezentuje inteligentnu spravu zdrojov (textura, obrazok, zvuk, hudba, ...).
@@ -52,6 +55,41 @@ public:
 
   MusicResourcePtr get_music(const String &name);
 
+  /**
+   * Asynchronous variants of get_* methods. File reading and decoding runs on
+   * worker threads, GL upload is done in poll() on the main thread.
+   * Returned resource is in ResourceState::LOADING state until it is finished
+   * (see Resource::is_ready, wait_for).
+   *
+   * Workers decode requests with higher @p priority first, requests with the
+   * same priority in submit order.
+   */
+  ImageResourcePtr get_image_async(const String &name);
+
+  TextureResourcePtr get_texture_async(const String &name);
+
+  ModelResourcePtr get_model_async(const String &name, i32 priority = 0);
+
+  MeshResourcePtr get_mesh_async(const String &name, i32 priority = 0);
+
+  /**
+   * Vorbis decoding and conversion to the mixer format run on a worker.
+   */
+  SoundResourcePtr get_sound_async(const String &name);
+
+  /**
+   * Change priority of asynchronously loaded resource (and the resource it
+   * depends on), no effect when the resource isn't waiting for a worker.
+   */
+  void set_load_priority(const ResourcePtr &resource, i32 priority);
+
+  /**
+   * Block until asynchronously loaded resource is finished.
+   *
+   * @return true when the resource is ready, false when loading failed
+   */
+  bool wait_for(const ResourcePtr &resource);
+
   ResourcePtr find_resource(const String &resource_name);
 
   void add_resource(const ResourcePtr &resource);
@@ -60,12 +98,36 @@ private:
   void refresh(ResourceService &rs, const StringArray &change_list);
   void refresh(ResourceService &rs, const String &resource_name);
 
+  void submit(const sptr<AsyncRequest> &request);
+
+  /**
+   * Decode the pending request with the highest priority (worker thread).
+   */
+  void decode_next();
+
+  /**
+   * Finish decoded requests on the main thread, stop when the time budget
+   * (microseconds) is exhausted.
+   */
+  void poll_async(i64 budget);
+
+  /**
+   * @return true when the request has been finished (successfully or not)
+   */
+  bool try_finish(AsyncRequest &request);
+
 private:
   // private members
   Core                  &my_core;
   uptr<ResourceLoaders>  my_loaders;
-  ResourceArray          my_resources;
+  ResourceIndex          my_resources;
   FileWatch              my_file_watch;
+  // asynchronous loading
+  uptr<ThreadPool>                  my_workers;
+  std::vector<sptr<AsyncRequest>>   my_requests;    ///< in submit order
+  std::vector<sptr<AsyncRequest>>   my_pending;     ///< waiting for worker, guarded by my_async_mutex
+  std::mutex                        my_async_mutex;
+  std::condition_variable           my_decoded;
 };
 
 }
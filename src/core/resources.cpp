@@ -7,6 +7,7 @@
 #include "sound.h"
 #include "music.h"
 #include "mesh.h"
+#include "video_buffer.h"
 #include "model.h"
 
 namespace atom {
@@ -18,6 +19,7 @@ String make_resource_name(const String &tag, const String &name)
 
 Resource::Resource()
   : my_loader(nullptr)
+  , my_state(ResourceState::READY)
 {
 }
 
@@ -66,10 +68,20 @@ ImageResource::~ImageResource()
 {
 }
 
+u32 ImageResource::memory_size() const
+{
+  return data() != nullptr ? data()->get_size() : 0;
+}
+
 TextureResource::~TextureResource()
 {
 }
 
+u32 TextureResource::memory_size() const
+{
+  return data() != nullptr ? data()->size() : 0;
+}
+
 TechniqueResource::~TechniqueResource()
 {
 }
@@ -82,6 +94,29 @@ MeshResource::~MeshResource()
 {
 }
 
+u32 MeshResource::memory_size() const
+{
+  const Mesh *mesh = data();
+
+  if (mesh == nullptr)
+    return 0;
+
+  // vertex & index buffers (VBO/IBO) in the video memory
+  const VideoBuffer *buffers[] = {
+    mesh->vertex.get(), mesh->normal.get(), mesh->color.get(), mesh->uv.get(),
+    mesh->surface.get(), mesh->bone_weight.get(), mesh->bone_index.get(),
+    mesh->vertices.get()
+  };
+  u32 size = 0;
+
+  for (const VideoBuffer *buffer : buffers) {
+    if (buffer != nullptr)
+      size += buffer->size();
+  }
+
+  return size;
+}
+
 BitmapFontResource::~BitmapFontResource()
 {
 }
@@ -98,4 +133,17 @@ ModelResource::~ModelResource()
 {
 }
 
+u32 ModelResource::memory_size() const
+{
+  u32 size = 0;
+
+  if (data() != nullptr) {
+    for (const uptr<DataStream> &stream : data()->arrays()) {
+      size += stream->data.size();
+    }
+  }
+
+  return size;
+}
+
 }
@@ -14,6 +14,12 @@ String make_resource_name(const String &tag, const String &name);
 
 class Loader;
 
+enum class ResourceState {
+  READY,    ///< resource data are available
+  LOADING,  ///< asynchronous load is in progress, data are not available yet
+  FAILED    ///< asynchronous load failed
+};
+
 class Resource : public NonCopyable {
 public:
   Resource();
@@ -51,10 +57,34 @@ public:
 
   void set_loader(Loader *loader);
 
+  ResourceState state() const
+  {
+    return my_state;
+  }
+
+  bool is_ready() const
+  {
+    return my_state == ResourceState::READY;
+  }
+
+  void set_state(ResourceState state)
+  {
+    my_state = state;
+  }
+
+  /**
+   * Estimated memory used by resource data (bytes), used by resource cache.
+   */
+  virtual u32 memory_size() const
+  {
+    return 0;
+  }
+
 private:
   Loader *my_loader;
   String my_name;
   StringArray my_sources;
+  ResourceState my_state;   ///< modified only from the main thread
 };
 
 template<typename T>
@@ -96,6 +126,8 @@ class ImageResource : public StandardResource<Image> {
 public:
   ~ImageResource();
 
+  u32 memory_size() const override;
+
   const Image& image() const
   {
     return *data();
@@ -115,6 +147,8 @@ class TextureResource : public StandardResource<Texture> {
 public:
   ~TextureResource();
 
+  u32 memory_size() const override;
+
   const Texture& texture() const
   {
     return *data();
@@ -180,6 +214,8 @@ class ModelResource : public StandardResource<Model> {
 public:
   ~ModelResource();
 
+  u32 memory_size() const override;
+
   const Model& model() const
   {
     return *data();
@@ -196,6 +232,8 @@ class MeshResource : public StandardResource<Mesh> {
 public:
   ~MeshResource();
 
+  u32 memory_size() const override;
+
   const Mesh& mesh() const
   {
     return *data();
@@ -7,6 +7,53 @@
 
 namespace atom {
 
+const u32 STATE_BUFFER_COUNT = 3;   ///< previous, current and the written one
+
+/**
+ * Bullet reads kinematic poses through the motion state. Simulated poses are
+ * read from the body after each fixed step (store_state), Bullet's own
+ * interpolation isn't used.
+ */
+class RigidBodyComponent::MotionState : public btMotionState {
+public:
+  btTransform    transform;      ///< physics thread
+  btTransform    target;         ///< kinematic pose set by the main thread
+  RigidBodyState states[STATE_BUFFER_COUNT];
+
+  explicit MotionState(const btTransform &initial)
+    : transform(initial)
+    , target(initial)
+  {
+    // empty
+  }
+
+  void getWorldTransform(btTransform &world_transform) const override
+  {
+    world_transform = transform;
+  }
+
+  void setWorldTransform(const btTransform &world_transform) override
+  {
+    transform = world_transform;
+  }
+};
+
+namespace {
+
+RigidBodyState to_state(const btTransform &transform)
+{
+  btQuaternion q = transform.getRotation();
+  return RigidBodyState{to_vec3(transform.getOrigin()), Quatf(q.w(), q.x(), q.y(), q.z())};
+}
+
+}
+
+RigidBodyState interpolate_state(const RigidBodyState &a, const RigidBodyState &b, f32 alpha)
+{
+  return RigidBodyState{a.position + (b.position - a.position) * alpha,
+    nlerp(a.rotation, b.rotation, alpha)};
+}
+
 META_CLASS(RigidBodyComponent,
   FIELD(my_body_type, "body_type"),
   FIELD(my_mass, "mass")
@@ -31,7 +78,7 @@ void RigidBodyComponent::activate()
   btTransform transform;
   const Mat4f &entity_transform = entity().transform();
   transform.setFromOpenGLMatrix(&entity_transform[0][0]);
-  my_motion_state.reset(new btDefaultMotionState(transform));
+  my_motion_state.reset(new MotionState(transform));
   my_rigid_body.reset(new btRigidBody(my_mass, my_motion_state.get(), shape));
 
   switch (my_body_type) {
@@ -52,17 +99,58 @@ void RigidBodyComponent::activate()
 
   PhysicsProcessor &pp = world().processors().physics;
   pp.register_rigid_body(this);
-//  btMotionState *motion_state = my_rigid_body->getMotionState();
-//  motion_state->setWorldTransform(transform);
 }
 
 void RigidBodyComponent::deactivate()
 {
+  if (my_rigid_body == nullptr) {
+    return;
+  }
+
   world().processors().physics.unregister_rigid_body(this);
   my_rigid_body.reset();
   my_motion_state.reset();
 }
 
+void RigidBodyComponent::store_state(u32 buffer)
+{
+  assert(buffer < STATE_BUFFER_COUNT);
+  my_motion_state->states[buffer] = to_state(my_rigid_body->getWorldTransform());
+}
+
+void RigidBodyComponent::reset_states()
+{
+  RigidBodyState state = to_state(my_rigid_body->getWorldTransform());
+
+  for (RigidBodyState &s : my_motion_state->states) {
+    s = state;
+  }
+}
+
+void RigidBodyComponent::update_entity(u32 previous, u32 current, f32 alpha)
+{
+  switch (my_body_type) {
+    case RigidBodyType::DYNAMIC:
+      entity().set_transform(interpolate_state(my_motion_state->states[previous],
+        my_motion_state->states[current], alpha).transform());
+      break;
+
+    case RigidBodyType::KINEMATIC:
+      my_motion_state->target.setFromOpenGLMatrix(&entity().transform()[0][0]);
+      break;
+
+    case RigidBodyType::STATIC:
+      break;
+  }
+}
+
+void RigidBodyComponent::apply_kinematic_target()
+{
+  if (my_body_type == RigidBodyType::KINEMATIC) {
+    my_motion_state->transform = my_motion_state->target;
+  }
+}
+
 RigidBodyComponent::RigidBodyComponent()
   : NullComponent(ComponentType::RIGID_BODY)
   , my_mass(1.0f)
@@ -4,7 +4,6 @@
 
 // Bullet forward declaration
 class btRigidBody;
-struct btDefaultMotionState;
 
 namespace atom {
 
@@ -17,9 +16,35 @@ enum class RigidBodyType : u32 {
 TYPE_OF(RigidBodyType, U32)
 MAP_COMPONENT_TYPE(RigidBodyComponent, RIGID_BODY)
 
+/**
+ * Pose of the body after one fixed physics step.
+ */
+struct RigidBodyState {
+  Vec3f position;
+  Quatf rotation;
+
+  Mat4f transform() const
+  {
+    return Mat4f::translation(position) * rotation.rotation_matrix();
+  }
+};
+
+/**
+ * Linear interpolation of the position and nlerp of the rotation.
+ */
+RigidBodyState interpolate_state(const RigidBodyState &a, const RigidBodyState &b, f32 alpha);
+
+/**
+ * Physics body of the entity. The body is simulated on the physics thread
+ * (PhysicsProcessor), it may be accessed only after PhysicsProcessor::sync.
+ * Entity transform of dynamic body is interpolated between the last two
+ * published states, kinematic body follows the entity transform.
+ */
 class RigidBodyComponent : public NullComponent {
+  class MotionState;
+
   uptr<btRigidBody> my_rigid_body;
-  uptr<btDefaultMotionState> my_motion_state;
+  uptr<MotionState> my_motion_state;
   f32               my_mass;
   RigidBodyType     my_body_type;
 
@@ -36,6 +61,11 @@ public:
     my_body_type = type;
   }
 
+  RigidBodyType body_type() const
+  {
+    return my_body_type;
+  }
+
   void set_mass(f32 mass)
   {
     my_mass = mass;
@@ -46,6 +76,28 @@ public:
     return my_rigid_body.get();
   }
 
+  /**
+   * Store the simulated pose to the snapshot buffer, physics thread only.
+   */
+  void store_state(u32 buffer);
+
+  /**
+   * Set all snapshot buffers to the simulated pose (new body).
+   */
+  void reset_states();
+
+  /**
+   * Interpolate the entity transform between two snapshot buffers (dynamic
+   * body) or pass the entity transform to the next step (kinematic body).
+   * Called by PhysicsProcessor while the buffers aren't written.
+   */
+  void update_entity(u32 previous, u32 current, f32 alpha);
+
+  /**
+   * Kinematic pose for the following steps, physics thread only.
+   */
+  void apply_kinematic_target();
+
   META_SUB_CLASS(NullComponent);
 };
 
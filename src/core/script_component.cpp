@@ -11,13 +11,11 @@ void ScriptComponent::init()
 
 void ScriptComponent::activate()
 {
-  processors().script.register_script(this);
   on_activate();
 }
 
 void ScriptComponent::deactivate()
 {
-  processors().script.unregister_script(this);
   on_deactivate();
 }
 
@@ -2,6 +2,7 @@
 #include <cassert>
 #include <algorithm>
 #include "script_component.h"
+#include "world.h"
 
 namespace atom {
 
@@ -11,19 +12,6 @@ ScriptProcessor::ScriptProcessor(World &world)
 {
 }
 
-void ScriptProcessor::register_script(ScriptComponent *component)
-{
-  assert(component != nullptr);
-  my_scripts.push_back(component);
-}
-
-void ScriptProcessor::unregister_script(ScriptComponent *component)
-{
-  assert(component != nullptr);
-  my_scripts.erase(std::remove(my_scripts.begin(), my_scripts.end(), component),
-    my_scripts.end());
-}
-
 void ScriptProcessor::activate()
 {
   my_is_started = true;
@@ -35,7 +23,7 @@ void ScriptProcessor::poll()
     return;
   }
 
-  for (ScriptComponent *script : my_scripts) {
+  for (ScriptComponent *script : world().components<ScriptComponent>()) {
     script->update();
   }
 }
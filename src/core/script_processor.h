@@ -7,15 +7,11 @@
 namespace atom {
 
 class ScriptProcessor : public NullProcessor {
-  bool                           my_is_started;
-  std::vector<ScriptComponent *> my_scripts;
+  bool my_is_started;
 
 public:
   explicit ScriptProcessor(World &world);
 
-  void register_script(ScriptComponent *component);
-  void unregister_script(ScriptComponent *component);
-
   void activate() override;
 
   void poll() override;
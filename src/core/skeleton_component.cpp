@@ -5,12 +5,14 @@
 #include "model.h"
 #include "resource_service.h"
 #include "resources.h"
+#include <algorithm>
 
 namespace atom {
 
 SkeletonComponent::SkeletonComponent()
   : NullComponent(ComponentType::SKELETON)
   , my_model(this)
+  , my_resolved(nullptr)
 {
   // empty
 }
@@ -22,34 +24,69 @@ Slice<Mat4f> SkeletonComponent::get_transforms() const
 
 void SkeletonComponent::recalculate_skeleton()
 {
-  int i = 0;
-  for (Bone &bone : my_bones) {
-    my_transforms[i] = calculate_bone_matrix(bone);
-    ++i;
-  }
+  resolve_bones();
+  update_bone_transforms(my_bones, my_order, my_dirty, my_transforms);
 }
 
 Bone* SkeletonComponent::find_bone(const String &name)
 {
-  for (Bone &bone : my_bones) {
-    if (bone.name == name) {
-      return &bone;
+  resolve_bones();
+
+  for (u32 i = 0; i < my_bones.size(); ++i) {
+    if (my_bones[i].name == name) {
+      my_dirty[i] = 1;
+      return &my_bones[i];
     }
   }
 
   return nullptr;
 }
 
-void SkeletonComponent::activate()
+u32 SkeletonComponent::bone_count()
+{
+  resolve_bones();
+  return my_bones.size();
+}
+
+void SkeletonComponent::set_pose(const Quatf *rotations, u32 count)
 {
-  ModelResourcePtr resource  = my_model->get_model();
+  resolve_bones();
+  assert(count <= my_bones.size());
 
-  if (resource == nullptr) {
+  for (u32 i = 0; i < count; ++i) {
+    if (my_bones[i].transform != rotations[i]) {
+      my_bones[i].transform = rotations[i];
+      my_dirty[i] = 1;
+    }
+  }
+}
+
+void SkeletonComponent::activate()
+{
+  if (my_model->get_model_handle() == nullptr) {
     log_warning("Can't find model for skeleton");
     return;
   }
 
+  my_resolved = nullptr;
+  resolve_bones();
+}
+
+void SkeletonComponent::resolve_bones()
+{
+  if (my_model.is_null()) {
+    return;
+  }
+
+  ModelResourcePtr resource = my_model->get_model();
+
+  // model is loading (or already resolved)
+  if (resource == nullptr || &resource->model() == my_resolved) {
+    return;
+  }
+
   const Model &model = resource->model();
+  my_resolved = &model;
 
   i32 count = model.bones.size();
   log_info("Found %i bones", count);
@@ -69,6 +106,10 @@ void SkeletonComponent::activate()
     b.parent = bone.parent;
     my_bones.push_back(b);
   }
+
+  sort_bones(my_bones, my_order);
+  my_dirty.assign(count, 1);
+  recalculate_skeleton();
 }
 
 void SkeletonComponent::deactivate()
@@ -76,10 +117,76 @@ void SkeletonComponent::deactivate()
 
 }
 
-Mat4f SkeletonComponent::calculate_bone_matrix(const Bone &bone) const
+void sort_bones(const std::vector<Bone> &bones, std::vector<u32> &order)
+{
+  const u32 count = bones.size();
+  std::vector<u32> depth(count, U32_MAX);
+
+  for (u32 i = 0; i < count; ++i) {
+    // walk up to the first bone with known depth
+    u32 d = 0;
+    i32 b = i;
+
+    while (b >= 0 && static_cast<u32>(b) < count && depth[b] == U32_MAX && d <= count) {
+      b = bones[b].parent;
+      ++d;
+    }
+
+    u32 base = b >= 0 && static_cast<u32>(b) < count && depth[b] != U32_MAX ? depth[b] + 1 : 0;
+    // assign depths on the way down
+    b = i;
+
+    while (b >= 0 && static_cast<u32>(b) < count && depth[b] == U32_MAX && d > 0) {
+      --d;
+      depth[b] = base + d;
+      b = bones[b].parent;
+    }
+  }
+
+  order.resize(count);
+
+  for (u32 i = 0; i < count; ++i) {
+    order[i] = i;
+  }
+
+  std::stable_sort(order.begin(), order.end(),
+    [&depth](u32 a, u32 b) { return depth[a] < depth[b]; });
+}
+
+Mat4f bone_local_matrix(const Bone &bone)
+{
+  // translation(head) * rotation * translation(-head)
+  Mat4f m = bone.transform.rotation_matrix();
+  const Vec3f &h = bone.local_head;
+
+  for (u32 r = 0; r < 3; ++r) {
+    m(r, 3) = h[r] - (m(r, 0) * h[0] + m(r, 1) * h[1] + m(r, 2) * h[2]);
+  }
+
+  return m;
+}
+
+void update_bone_transforms(const std::vector<Bone> &bones, const std::vector<u32> &order,
+  std::vector<u8> &dirty, std::vector<Mat4f> &transforms)
 {
-  Mat4f m = Mat4f::translation(bone.local_head) * bone.transform.rotation_matrix() * Mat4f::translation(-bone.local_head);
-  return bone.parent < 0 ? m : calculate_bone_matrix(my_bones[bone.parent]) * m;
+  assert(bones.size() == order.size() && bones.size() == dirty.size());
+  transforms.resize(bones.size());
+
+  for (u32 i : order) {
+    i32 parent = bones[i].parent;
+    bool has_parent = parent >= 0 && static_cast<u32>(parent) < bones.size();
+    // changed parent moves the whole subtree
+    if (has_parent && dirty[parent]) {
+      dirty[i] = 1;
+    }
+
+    if (dirty[i]) {
+      transforms[i] = has_parent ? transforms[parent] * bone_local_matrix(bones[i])
+                                 : bone_local_matrix(bones[i]);
+    }
+  }
+
+  dirty.assign(dirty.size(), 0);
 }
 
 }
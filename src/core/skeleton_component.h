@@ -14,27 +14,73 @@ struct Bone {
   Quatf  transform;
 };
 
+/**
+ * Order bones so that each parent precedes its children (bones with invalid
+ * parent index are treated as roots).
+ */
+void sort_bones(const std::vector<Bone> &bones, std::vector<u32> &order);
+
+/**
+ * Rotation of the bone around its head.
+ */
+Mat4f bone_local_matrix(const Bone &bone);
+
+/**
+ * Recompute transforms of dirty bones and their descendants, each transform
+ * is computed once from the already updated parent transform. Dirty flags
+ * are cleared.
+ *
+ * @param order bones sorted by sort_bones
+ */
+void update_bone_transforms(const std::vector<Bone> &bones, const std::vector<u32> &order,
+  std::vector<u8> &dirty, std::vector<Mat4f> &transforms);
+
 
 class SkeletonComponent : public NullComponent {
   Slot<ModelComponent> my_model;
   std::vector<Bone>    my_bones;
   std::vector<Mat4f>   my_transforms;
+  std::vector<u32>     my_order;   ///< parents before children
+  std::vector<u8>      my_dirty;   ///< bone transform has changed
+  const Model         *my_resolved; ///< model of my_bones
 
 public:
   SkeletonComponent();
 
   Slice<Mat4f> get_transforms() const;
 
+  /**
+   * Update transforms of bones changed since the last call.
+   */
   void recalculate_skeleton();
 
+  /**
+   * Returned bone is marked as changed (caller is expected to modify its
+   * transform), see recalculate_skeleton.
+   */
   Bone* find_bone(const String &name);
 
+  /**
+   * Zero while the model is loading.
+   */
+  u32 bone_count();
+
+  /**
+   * Set rotation of each bone (bones are indexed as in the model skeleton),
+   * only changed bones are updated by recalculate_skeleton.
+   */
+  void set_pose(const Quatf *rotations, u32 count);
+
 private:
+  /**
+   * Build bones from the model once it is loaded (the model is loaded
+   * asynchronously), called by the methods modifying the skeleton.
+   */
+  void resolve_bones();
+
   void activate() override;
 
   void deactivate() override;
-
-  Mat4f calculate_bone_matrix(const Bone &bone) const;
 };
 
 MAP_COMPONENT_TYPE(SkeletonComponent, SKELETON)
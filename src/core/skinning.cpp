@@ -0,0 +1,347 @@
+#include "skinning.h"
+#include <cmath>
+
+#if defined(ATOM_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(ATOM_AVX2)
+#include <immintrin.h>
+#endif
+
+namespace atom {
+
+static_assert(sizeof(Mat4f) == 16 * sizeof(f32), "Kernels expect packed column-major matrix");
+
+namespace {
+
+inline Vec3f normalize_or_zero(f32 x, f32 y, f32 z)
+{
+  f32 length = std::sqrt(x * x + y * y + z * z);
+  return length > 0 ? Vec3f(x / length, y / length, z / length) : Vec3f(0, 0, 0);
+}
+
+/**
+ * Skin vertices from @p first to the end, tail of the SIMD kernels.
+ */
+void skin_scalar(const SkinningInput &input, u32 first, Vec3f *positions, Vec3f *normals)
+{
+  for (u32 i = first; i < input.count; ++i) {
+    u32 bi = input.bone_indices[i];
+    const Vec4f &weights = input.bone_weights[i];
+    // blended affine part (3 rows x 4 columns)
+    f32 m[4][3] = {};
+
+    for (u32 j = 0; j < 4; ++j, bi >>= 8) {
+      const Mat4f &bone = input.bones[bi & 0xFF];
+      f32 w = weights[j];
+
+      for (u32 c = 0; c < 4; ++c) {
+        m[c][0] += w * bone.data[c][0];
+        m[c][1] += w * bone.data[c][1];
+        m[c][2] += w * bone.data[c][2];
+      }
+    }
+
+    const Vec3f &p = input.positions[i];
+    positions[i] = Vec3f(
+      m[0][0] * p[0] + m[1][0] * p[1] + m[2][0] * p[2] + m[3][0],
+      m[0][1] * p[0] + m[1][1] * p[1] + m[2][1] * p[2] + m[3][1],
+      m[0][2] * p[0] + m[1][2] * p[1] + m[2][2] * p[2] + m[3][2]);
+
+    if (normals != nullptr) {
+      const Vec3f &n = input.normals[i];
+      normals[i] = normalize_or_zero(
+        m[0][0] * n[0] + m[1][0] * n[1] + m[2][0] * n[2],
+        m[0][1] * n[0] + m[1][1] * n[1] + m[2][1] * n[2],
+        m[0][2] * n[0] + m[1][2] * n[1] + m[2][2] * n[2]);
+    }
+  }
+}
+
+#if defined(ATOM_SSE)
+
+/// x, y, z, 0 without reading past the vertex
+inline __m128 load_vec3(const Vec3f &v)
+{
+  return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(&v[0])),
+    _mm_load_ss(&v[2]));
+}
+
+inline void store_vec3(Vec3f &dst, __m128 v)
+{
+  _mm_storel_pi(reinterpret_cast<__m64 *>(&dst[0]), v);
+  _mm_store_ss(&dst[2], _mm_movehl_ps(v, v));
+}
+
+/**
+ * Vertices are processed in SoA layout, each register holds one component of
+ * 4 vertices. Bone columns and vertex data are transposed after the load and
+ * the results before the store.
+ */
+void skin_sse(const SkinningInput &input, Vec3f *positions, Vec3f *normals)
+{
+  const u32 batch_end = input.count & ~3u;
+  const __m128 zero = _mm_setzero_ps();
+
+  for (u32 i = 0; i < batch_end; i += 4) {
+    const u32 *bi = &input.bone_indices[i];
+    // w[j] is the weight of j-th bone of each vertex
+    __m128 w[4] = {
+      _mm_loadu_ps(&input.bone_weights[i][0]), _mm_loadu_ps(&input.bone_weights[i + 1][0]),
+      _mm_loadu_ps(&input.bone_weights[i + 2][0]), _mm_loadu_ps(&input.bone_weights[i + 3][0])
+    };
+    _MM_TRANSPOSE4_PS(w[0], w[1], w[2], w[3]);
+
+    // m[c][r] is row r of column c of the blended matrix of each vertex
+    __m128 m[4][3];
+
+    for (u32 c = 0; c < 4; ++c) {
+      m[c][0] = m[c][1] = m[c][2] = zero;
+    }
+
+    for (u32 j = 0; j < 4; ++j) {
+      const u32 shift = 8 * j;
+      const f32 *b0 = &input.bones[(bi[0] >> shift) & 0xFF].data[0][0];
+      const f32 *b1 = &input.bones[(bi[1] >> shift) & 0xFF].data[0][0];
+      const f32 *b2 = &input.bones[(bi[2] >> shift) & 0xFF].data[0][0];
+      const f32 *b3 = &input.bones[(bi[3] >> shift) & 0xFF].data[0][0];
+
+      for (u32 c = 0; c < 4; ++c) {
+        __m128 r0 = _mm_loadu_ps(b0 + 4 * c);
+        __m128 r1 = _mm_loadu_ps(b1 + 4 * c);
+        __m128 r2 = _mm_loadu_ps(b2 + 4 * c);
+        __m128 r3 = _mm_loadu_ps(b3 + 4 * c);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        m[c][0] = _mm_add_ps(m[c][0], _mm_mul_ps(r0, w[j]));
+        m[c][1] = _mm_add_ps(m[c][1], _mm_mul_ps(r1, w[j]));
+        m[c][2] = _mm_add_ps(m[c][2], _mm_mul_ps(r2, w[j]));
+      }
+    }
+
+    __m128 x = load_vec3(input.positions[i]);
+    __m128 y = load_vec3(input.positions[i + 1]);
+    __m128 z = load_vec3(input.positions[i + 2]);
+    __m128 t = load_vec3(input.positions[i + 3]);
+    _MM_TRANSPOSE4_PS(x, y, z, t);
+
+    __m128 r[4];
+
+    for (u32 k = 0; k < 3; ++k) {
+      r[k] = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(m[0][k], x), _mm_mul_ps(m[1][k], y)),
+        _mm_add_ps(_mm_mul_ps(m[2][k], z), m[3][k]));
+    }
+
+    r[3] = zero;
+    _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+
+    for (u32 k = 0; k < 4; ++k) {
+      store_vec3(positions[i + k], r[k]);
+    }
+
+    if (normals != nullptr) {
+      x = load_vec3(input.normals[i]);
+      y = load_vec3(input.normals[i + 1]);
+      z = load_vec3(input.normals[i + 2]);
+      t = load_vec3(input.normals[i + 3]);
+      _MM_TRANSPOSE4_PS(x, y, z, t);
+
+      for (u32 k = 0; k < 3; ++k) {
+        r[k] = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(m[0][k], x), _mm_mul_ps(m[1][k], y)), _mm_mul_ps(m[2][k], z));
+      }
+
+      // normalize, zero length gives zero vector as normalize_or_zero
+      __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r[0], r[0]),
+        _mm_mul_ps(r[1], r[1])), _mm_mul_ps(r[2], r[2])));
+      __m128 nonzero = _mm_cmpgt_ps(length, zero);
+
+      for (u32 k = 0; k < 3; ++k) {
+        r[k] = _mm_and_ps(nonzero, _mm_div_ps(r[k], length));
+      }
+
+      r[3] = zero;
+      _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+
+      for (u32 k = 0; k < 4; ++k) {
+        store_vec3(normals[i + k], r[k]);
+      }
+    }
+  }
+
+  skin_scalar(input, batch_end, positions, normals);
+}
+
+#endif
+
+#if defined(ATOM_AVX2)
+
+/**
+ * Transpose 4x4 blocks in both 128 bit halves, each half holds 4 vertices.
+ */
+ATOM_TARGET_AVX2
+inline void transpose4_avx(__m256 &r0, __m256 &r1, __m256 &r2, __m256 &r3)
+{
+  __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+  __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+  __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+  r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+  r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+/// @p low to the lower half, @p high to the upper one
+ATOM_TARGET_AVX2
+inline __m256 combine(__m128 low, __m128 high)
+{
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+
+/**
+ * Load x, y, z of vertices first..first + 7 (SoA).
+ */
+ATOM_TARGET_AVX2
+inline void load_vertices_avx(const Vec3f *v, __m256 &x, __m256 &y, __m256 &z)
+{
+  __m256 t;
+  x = combine(load_vec3(v[0]), load_vec3(v[4]));
+  y = combine(load_vec3(v[1]), load_vec3(v[5]));
+  z = combine(load_vec3(v[2]), load_vec3(v[6]));
+  t = combine(load_vec3(v[3]), load_vec3(v[7]));
+  transpose4_avx(x, y, z, t);
+}
+
+ATOM_TARGET_AVX2
+inline void store_vertices_avx(Vec3f *v, __m256 x, __m256 y, __m256 z)
+{
+  __m256 t = _mm256_setzero_ps();
+  transpose4_avx(x, y, z, t);
+  store_vec3(v[0], _mm256_castps256_ps128(x));
+  store_vec3(v[1], _mm256_castps256_ps128(y));
+  store_vec3(v[2], _mm256_castps256_ps128(z));
+  store_vec3(v[3], _mm256_castps256_ps128(t));
+  store_vec3(v[4], _mm256_extractf128_ps(x, 1));
+  store_vec3(v[5], _mm256_extractf128_ps(y, 1));
+  store_vec3(v[6], _mm256_extractf128_ps(z, 1));
+  store_vec3(v[7], _mm256_extractf128_ps(t, 1));
+}
+
+/**
+ * SoA layout as skin_sse with 8 vertices per iteration, the lower half of
+ * each register holds vertices 0-3, the upper half vertices 4-7.
+ */
+ATOM_TARGET_AVX2
+void skin_avx2(const SkinningInput &input, Vec3f *positions, Vec3f *normals)
+{
+  const u32 batch_end = input.count & ~7u;
+
+  for (u32 i = 0; i < batch_end; i += 8) {
+    const u32 *bi = &input.bone_indices[i];
+    const Vec4f *weights = &input.bone_weights[i];
+    __m256 w[4];
+
+    for (u32 k = 0; k < 4; ++k) {
+      w[k] = combine(_mm_loadu_ps(&weights[k][0]), _mm_loadu_ps(&weights[k + 4][0]));
+    }
+
+    transpose4_avx(w[0], w[1], w[2], w[3]);
+
+    __m256 m[4][3];
+
+    for (u32 c = 0; c < 4; ++c) {
+      m[c][0] = m[c][1] = m[c][2] = _mm256_setzero_ps();
+    }
+
+    for (u32 j = 0; j < 4; ++j) {
+      const u32 shift = 8 * j;
+      const f32 *b[8];
+
+      for (u32 k = 0; k < 8; ++k) {
+        b[k] = &input.bones[(bi[k] >> shift) & 0xFF].data[0][0];
+      }
+
+      for (u32 c = 0; c < 4; ++c) {
+        __m256 r0 = combine(_mm_loadu_ps(b[0] + 4 * c), _mm_loadu_ps(b[4] + 4 * c));
+        __m256 r1 = combine(_mm_loadu_ps(b[1] + 4 * c), _mm_loadu_ps(b[5] + 4 * c));
+        __m256 r2 = combine(_mm_loadu_ps(b[2] + 4 * c), _mm_loadu_ps(b[6] + 4 * c));
+        __m256 r3 = combine(_mm_loadu_ps(b[3] + 4 * c), _mm_loadu_ps(b[7] + 4 * c));
+        transpose4_avx(r0, r1, r2, r3);
+        m[c][0] = _mm256_fmadd_ps(r0, w[j], m[c][0]);
+        m[c][1] = _mm256_fmadd_ps(r1, w[j], m[c][1]);
+        m[c][2] = _mm256_fmadd_ps(r2, w[j], m[c][2]);
+      }
+    }
+
+    __m256 x, y, z;
+    __m256 r[3];
+    load_vertices_avx(&input.positions[i], x, y, z);
+
+    for (u32 k = 0; k < 3; ++k) {
+      r[k] = _mm256_fmadd_ps(m[0][k], x,
+        _mm256_fmadd_ps(m[1][k], y, _mm256_fmadd_ps(m[2][k], z, m[3][k])));
+    }
+
+    store_vertices_avx(&positions[i], r[0], r[1], r[2]);
+
+    if (normals != nullptr) {
+      load_vertices_avx(&input.normals[i], x, y, z);
+
+      for (u32 k = 0; k < 3; ++k) {
+        r[k] = _mm256_fmadd_ps(m[0][k], x, _mm256_fmadd_ps(m[1][k], y, _mm256_mul_ps(m[2][k], z)));
+      }
+
+      __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(r[0], r[0],
+        _mm256_fmadd_ps(r[1], r[1], _mm256_mul_ps(r[2], r[2]))));
+      __m256 nonzero = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_GT_OQ);
+
+      for (u32 k = 0; k < 3; ++k) {
+        r[k] = _mm256_and_ps(nonzero, _mm256_div_ps(r[k], length));
+      }
+
+      store_vertices_avx(&normals[i], r[0], r[1], r[2]);
+    }
+  }
+
+  skin_scalar(input, batch_end, positions, normals);
+}
+
+#endif
+
+}
+
+void skin_vertices(const SkinningInput &input, Vec3f *positions, Vec3f *normals)
+{
+  skin_vertices(input, positions, normals, simd_level());
+}
+
+void skin_vertices(const SkinningInput &input, Vec3f *positions, Vec3f *normals,
+  SimdLevel level)
+{
+  assert(positions != nullptr);
+  assert(has_simd(level) && "Unsupported SIMD level");
+
+  if (input.normals == nullptr) {
+    normals = nullptr;
+  }
+
+  switch (level) {
+#if defined(ATOM_AVX2)
+    case SimdLevel::AVX2:
+      skin_avx2(input, positions, normals);
+      return;
+#endif
+#if defined(ATOM_SSE)
+    case SimdLevel::SSE:
+      skin_sse(input, positions, normals);
+      return;
+#endif
+    default:
+      skin_scalar(input, 0, positions, normals);
+      return;
+  }
+}
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "foundation.h"
+#include "cpu.h"
+
+namespace atom {
+
+/**
+ * Input of the skinning kernel. Each vertex is influenced by up to 4 bones,
+ * bone indices are packed to one u32 (8 bits per bone, the first bone in the
+ * lowest byte). Bone matrices have to be affine.
+ */
+struct SkinningInput {
+  const Vec3f *positions;
+  const Vec3f *normals;       ///< may be nullptr, then normals are not skinned
+  const u32   *bone_indices;
+  const Vec4f *bone_weights;
+  u32          count;         ///< vertex count
+  const Mat4f *bones;
+  u32          bone_count;
+};
+
+/**
+ * Blend bone matrices of each vertex by its weights and transform the vertex
+ * (and normal) once by the blended matrix. Uses the best SIMD kernel for the
+ * current CPU (see simd_level).
+ *
+ * @param[out] positions preallocated array of SkinningInput::count vertices
+ * @param[out] normals preallocated array or nullptr, normals are normalized
+ */
+void skin_vertices(const SkinningInput &input, Vec3f *positions, Vec3f *normals = nullptr);
+
+/**
+ * Skinning with explicit kernel, @p level must be supported by the CPU.
+ */
+void skin_vertices(const SkinningInput &input, Vec3f *positions, Vec3f *normals,
+  SimdLevel level);
+
+}
@@ -0,0 +1,160 @@
+#include "skinning_feedback.h"
+#include "geometry_component.h"
+#include "video_buffer.h"
+#include "technique.h"
+#include "uniforms.h"
+#include "model.h"
+#include "log.h"
+
+namespace atom {
+
+/// fence wait timeout (ns)
+const GLuint64 SKINNING_FENCE_TIMEOUT = 1000000000;
+
+void read_skinning_feedback(const Slice<Vec3f> &feedback, bool normals, GeometryCache &cache)
+{
+  u32 count = feedback.size() / 2;
+  cache.vertices.resize(count);
+  cache.normals.resize(normals ? count : 0);
+
+  for (u32 i = 0; i < count; ++i) {
+    cache.vertices[i] = feedback[i * 2];
+  }
+
+  for (u32 i = 0; i < cache.normals.size(); ++i) {
+    cache.normals[i] = feedback[i * 2 + 1];
+  }
+}
+
+SkinningFeedback::SkinningFeedback(VideoService &vs)
+  : my_vs(vs)
+  , my_technique(Technique::create("skin_feedback",
+      std::vector<String>{ "skinned_position", "skinned_normal" }))
+  , my_frame(0)
+{
+  if (my_technique == nullptr) {
+    log_error("GPU skinning isn't available, can't create \"skin_feedback\" technique");
+  }
+
+  for (GLsync &fence : my_fences) {
+    fence = nullptr;
+  }
+}
+
+SkinningFeedback::~SkinningFeedback()
+{
+  for (GLsync fence : my_fences) {
+    if (fence != nullptr) {
+      glDeleteSync(fence);
+    }
+  }
+}
+
+void SkinningFeedback::begin_frame()
+{
+  ++my_frame;
+  GLsync &fence = my_fences[slot()];
+
+  if (fence == nullptr) {
+    return;
+  }
+
+  GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, SKINNING_FENCE_TIMEOUT);
+
+  if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+    log_warning("Skinning feedback of frame %u is still in progress", my_frame - SKINNING_FEEDBACK_FRAMES);
+  }
+
+  glDeleteSync(fence);
+  fence = nullptr;
+}
+
+bool SkinningFeedback::init_target(Target &target, const Model &model)
+{
+  VertexLayout layout;
+  std::vector<u8> data;
+
+  target.model = &model;
+  target.vertex_array.reset();
+
+  for (bool &has_output : target.has_output) {
+    has_output = false;
+  }
+
+  if (!interleave_model_vertices(model, layout, data) ||
+      layout.find(BONE_INDEX_ATTRIBUTE) == nullptr) {
+    log_error("Dynamic GeometryComponent with invalid model");
+    return false;
+  }
+
+  target.count = data.size() / layout.stride();
+  target.vertices.reset(new VideoBuffer(my_vs, VideoBufferUsage::STATIC_DRAW));
+  target.vertices->set_bytes(data.data(), data.size());
+  target.vertex_array.reset(new VertexArray(my_vs, *target.vertices, layout, nullptr));
+
+  for (uptr<VideoBuffer> &output : target.outputs) {
+    output.reset(new VideoBuffer(my_vs, VideoBufferUsage::DYNAMIC_DRAW));
+    output->allocate(target.count * 2 * sizeof(Vec3f));
+  }
+
+  return true;
+}
+
+void SkinningFeedback::skin(const void *owner, const Model &model, i32 bone_offset,
+  bool normals, GeometryCache &cache)
+{
+  if (my_technique == nullptr) {
+    return;
+  }
+
+  auto found = my_targets.find(owner);
+
+  if (found == my_targets.end()) {
+    found = my_targets.insert(std::make_pair(owner, Target())).first;
+    init_target(found->second, model);
+  } else if (found->second.model != &model) {
+    // component was replaced or its model has changed
+    init_target(found->second, model);
+  }
+
+  Target &target = found->second;
+  target.frame = my_frame;
+
+  if (target.vertex_array == nullptr) {
+    return;
+  }
+
+  VideoBuffer &output = *target.outputs[slot()];
+
+  // fence of the frame which wrote the output has passed (begin_frame)
+  if (target.has_output[slot()]) {
+    my_readback.resize(target.count * 2);
+    output.get_bytes(my_readback.data(), output.size());
+    read_skinning_feedback(Slice<Vec3f>(my_readback.data(), my_readback.size()), normals, cache);
+  }
+
+  my_vs.get_uniforms().bone_offset = bone_offset;
+  my_vs.draw_feedback(*my_technique, *target.vertex_array, target.count, output);
+  target.has_output[slot()] = true;
+}
+
+void SkinningFeedback::end_frame()
+{
+  for (auto it = my_targets.begin(); it != my_targets.end(); ) {
+    if (it->second.frame != my_frame) {
+      it = my_targets.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  GLsync &fence = my_fences[slot()];
+
+  if (fence != nullptr) {
+    glDeleteSync(fence);
+  }
+
+  fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+}
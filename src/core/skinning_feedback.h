@@ -0,0 +1,86 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "noncopyable.h"
+#include "foundation.h"
+#include "gl_utils.h"
+#include "vertex_array.h"
+
+namespace atom {
+
+/// output buffers of each target, result is read back this many frames after the draw
+const u32 SKINNING_FEEDBACK_FRAMES = 2;
+
+/**
+ * Copy transform feedback output (interleaved position & normal of each
+ * vertex) to the geometry cache.
+ */
+void read_skinning_feedback(const Slice<Vec3f> &feedback, bool normals, GeometryCache &cache);
+
+/**
+ * GPU skinning of dynamic GeometryComponent caches. Vertices are skinned by
+ * the "skin_feedback" shader with the frame bone palette and captured by
+ * transform feedback. Each frame writes the next output buffer of the ring
+ * and reads back the one written SKINNING_FEEDBACK_FRAMES frames ago, its
+ * fence has already passed, so the read doesn't stall on the draw.
+ */
+class SkinningFeedback : NonCopyable {
+  struct Target {
+    const Model       *model;
+    uptr<VideoBuffer>  vertices;      ///< interleaved model vertices
+    uptr<VertexArray>  vertex_array;
+    uptr<VideoBuffer>  outputs[SKINNING_FEEDBACK_FRAMES];  ///< skinned position & normal of each vertex
+    bool               has_output[SKINNING_FEEDBACK_FRAMES];
+    u32                count;
+    u32                frame;         ///< last frame the target was skinned
+  };
+
+  VideoService   &my_vs;
+  uptr<Technique> my_technique;
+  std::unordered_map<const void *, Target> my_targets;  ///< by GeometryComponent
+  std::vector<Vec3f> my_readback;
+  GLsync          my_fences[SKINNING_FEEDBACK_FRAMES];
+  u32             my_frame;
+
+  u32 slot() const
+  {
+    return my_frame % SKINNING_FEEDBACK_FRAMES;
+  }
+
+  bool init_target(Target &target, const Model &model);
+
+public:
+  explicit SkinningFeedback(VideoService &vs);
+  ~SkinningFeedback();
+
+  /**
+   * @return false when the feedback shader isn't available
+   */
+  bool is_valid() const
+  {
+    return my_technique != nullptr;
+  }
+
+  /**
+   * Switch to the next output buffers, waits when GPU still writes them.
+   */
+  void begin_frame();
+
+  /**
+   * Copy result of the older frame to @p cache and skin the model with
+   * bones at @p bone_offset of the uploaded palette.
+   *
+   * @param owner identity of the geometry component
+   */
+  void skin(const void *owner, const Model &model, i32 bone_offset, bool normals,
+    GeometryCache &cache);
+
+  /**
+   * Release buffers of components that weren't skinned in this frame and
+   * fence the draws.
+   */
+  void end_frame();
+};
+
+}
@@ -66,11 +66,6 @@ public:
     return my_count * sizeof(T);
   }
 
-  T& operator[](u32 index)
-  {
-    return my_data[index];
-  }
-
   const T& operator[](u32 index) const
   {
     return my_data[index];
@@ -2,18 +2,20 @@
 
 #include <vorbis/vorbisfile.h>
 #include <string.h>
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <memory>
 #include "constants.h"
 #include "utils.h"
 #include "log.h"
+#include "config.h"
 
 namespace atom {
 
 const int LOAD_SOUND_BUFFER_SIZE = 8192; ///< velkost pomocneho buffru pri vytvarani Sound
 
-uptr<Sound> Sound::create_from_file(
-  const char *filename)
+uptr<Sound> Sound::create_from_file(const char *filename, ResampleQuality quality)
 {
   assert(filename != nullptr);
   OggVorbis_File vorbis_file;
@@ -64,16 +66,38 @@ uptr<Sound> Sound::create_from_file(
     error("Can't create Sound from file \"%s\"", filename);
   }
 
+  if (sample_rate != AUDIO_FREQUENCY) {
+    log_debug(DEBUG_AUDIO, "Resampling \"%s\" from %i Hz", filename, sample_rate);
+  }
+
+  return create_from_samples(reinterpret_cast<const i16 *>(buffer.get()),
+    bytes_total / sizeof(i16), sample_rate, channel_count, quality);
+}
+
+uptr<Sound> Sound::create_from_samples(const i16 *samples, u32 count, int sample_rate,
+  int channel_count, ResampleQuality quality)
+{
+  assert(samples != nullptr || count == 0);
+
+  if (channel_count != 1 && channel_count != 2) {
+    log_error("Only 1 and 2 channel sounds are supported");
+    return nullptr;
+  }
+
+  if (sample_rate <= 0) {
+    log_error("Invalid sound sample rate %i", sample_rate);
+    return nullptr;
+  }
+
   uptr<Sound> sound(new Sound());
-  sound->my_sample_rate = sample_rate;
-  sound->my_channel_count = channel_count;
-  sound->my_samples_size = bytes_total;
-  sound->my_samples = std::move(buffer);
+  sound->my_sample_rate = AUDIO_FREQUENCY;
+  sound->my_channel_count = AUDIO_CHANNELS;
+  sound->my_samples = convert_audio(samples, count, channel_count, sample_rate, quality);
   return sound;
 }
 
 Sound::Sound() :
-    my_sample_rate(-1), my_channel_count(-1), my_position(0), my_samples_size(0), my_samples(nullptr)
+    my_sample_rate(-1), my_channel_count(-1), my_position(0)
 {
 }
 
@@ -86,20 +110,26 @@ int Sound::read_old(void *buffer, int start, int size)
 {
   assert(buffer != nullptr);
   assert(start >= -1);
+  int samples_size = get_size();
 
   if (start == AudioBuffer::CURRENT_POSITION) {
     start = my_position;
-  } else if (start >= my_samples_size) {
+  } else if (start >= samples_size) {
 //    error("Sound buffer overflow");
     return 0;
   }
 
-  int end = min(start + size, my_samples_size);
+  int end = min(start + size, samples_size);
   int bytes = end - start;
+  i16 *output = static_cast<i16 *>(buffer);
 
-  memcpy(buffer, &my_samples[start], bytes);
+  // samples are kept in the mixer format, convert them back
+  for (int i = start / AUDIO_SAMPLE_SIZE; i < end / int(AUDIO_SAMPLE_SIZE); ++i) {
+    f32 v = std::min(std::max(my_samples[i], f32(I16_MIN)), f32(I16_MAX));
+    *output++ = static_cast<i16>(std::lrint(v));
+  }
 
-  my_position += bytes;
+  my_position = start + bytes;
 
   return bytes;
 }
@@ -116,7 +146,7 @@ int Sound::get_channel_count()
 
 int Sound::get_size()
 {
-  return my_samples_size;
+  return my_samples.size() * AUDIO_SAMPLE_SIZE;
 }
 
 }
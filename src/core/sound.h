@@ -1,25 +1,55 @@
 #pragma once
 
+#include <vector>
 #include "platform.h"
 #include "ptr.h"
 #include "audio_buffer.h"
+#include "audio_resampler.h"
 
 namespace atom {
 
+/**
+ * Sound decoded whole to memory. Samples are converted to the mixer format
+ * (stereo floats in 16bit range, AUDIO_FREQUENCY) when the sound is created,
+ * so the mixer doesn't convert or resample them. AudioBuffer interface reads
+ * them as 16bit stereo.
+ */
 class Sound : public AudioBuffer {
-  int        my_sample_rate; ///< vzorkovacia frekvencia
-  int        my_channel_count; ///< pocet kanalov
-  int        my_position; ///< pozicia za posledne precitanym bytom, na pociatku 0
-  int        my_samples_size; ///< velkost dat (samplov) v bytoch
-  uptr<u8[]> my_samples; ///< dekodovane audio data (samples)
+  int              my_sample_rate; ///< vzorkovacia frekvencia
+  int              my_channel_count; ///< pocet kanalov
+  int              my_position; ///< pozicia za posledne precitanym bytom, na pociatku 0
+  std::vector<f32> my_samples; ///< dekodovane audio data (samples), interleaved stereo
 
 public: // public methods
-  static uptr<Sound> create_from_file(
-    const char *filename);
+  static uptr<Sound> create_from_file(const char *filename,
+    ResampleQuality quality = ResampleQuality::SINC);
 
   ~Sound();
 
+  /**
+   * Create sound from interleaved 16bit samples (generated sounds, tests).
+   */
+  static uptr<Sound> create_from_samples(const i16 *samples, u32 count, int sample_rate,
+    int channel_count, ResampleQuality quality = ResampleQuality::SINC);
+
   int read_old(void *buffer, int pos, int size);
+
+  /**
+   * Interleaved stereo samples in the mixer format.
+   */
+  const f32* samples() const
+  {
+    return my_samples.data();
+  }
+
+  /**
+   * Sample count of all channels.
+   */
+  u32 sample_count() const
+  {
+    return my_samples.size();
+  }
+
   int get_sample_rate();
   int get_channel_count();
   int get_size();
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <vector>
+#include "noncopyable.h"
+#include "platform.h"
+
+namespace atom {
+
+/**
+ * Bounded wait-free queue for one producer and one consumer thread (game
+ * thread to audio callback). Neither side blocks nor allocates, full queue
+ * rejects the item. Popped slot is moved out, so it doesn't keep resources.
+ */
+template<typename T>
+class SpscQueue : NonCopyable {
+  std::vector<T>   my_items;
+  u32              my_mask;
+  std::atomic<u32> my_head;   ///< next popped item, written by consumer
+  u8               my_padding[64];  ///< head and tail don't share a cache line
+  std::atomic<u32> my_tail;   ///< next pushed item, written by producer
+
+public:
+  /**
+   * @param capacity power of two
+   */
+  explicit SpscQueue(u32 capacity)
+    : my_items(capacity)
+    , my_mask(capacity - 1)
+    , my_head(0)
+    , my_tail(0)
+  {
+    assert(capacity > 0 && (capacity & my_mask) == 0);
+  }
+
+  /**
+   * Producer thread only.
+   *
+   * @return false when the queue is full, @p item isn't moved
+   */
+  bool push(T &&item)
+  {
+    u32 tail = my_tail.load(std::memory_order_relaxed);
+
+    if (tail - my_head.load(std::memory_order_acquire) > my_mask) {
+      return false;
+    }
+
+    my_items[tail & my_mask] = std::move(item);
+    my_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Consumer thread only.
+   *
+   * @return false when the queue is empty
+   */
+  bool pop(T &item)
+  {
+    u32 head = my_head.load(std::memory_order_relaxed);
+
+    if (head == my_tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    item = std::move(my_items[head & my_mask]);
+    my_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  u32 capacity() const
+  {
+    return my_mask + 1;
+  }
+};
+
+}
@@ -0,0 +1,119 @@
+#include "stream_buffer.h"
+#include <cstring>
+
+namespace atom {
+
+/// fence wait timeout (ns)
+const GLuint64 STREAM_FENCE_TIMEOUT = 1000000000;
+
+StreamRing::StreamRing(u32 region_size)
+  : my_region_size(region_size)
+  , my_region(0)
+  , my_used(0)
+{
+  // empty
+}
+
+u32 StreamRing::allocate(u32 size, u32 alignment)
+{
+  assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  u32 start = (my_used + alignment - 1) & ~(alignment - 1);
+
+  if (size == 0 || start > my_region_size || size > my_region_size - start) {
+    return U32_MAX;
+  }
+
+  my_used = start + size;
+  return my_region * my_region_size + start;
+}
+
+u32 StreamRing::next_region()
+{
+  my_region = (my_region + 1) % STREAM_BUFFER_FRAMES;
+  my_used = 0;
+  return my_region;
+}
+
+StreamBuffer::StreamBuffer(VideoService &vs, u32 region_size)
+  : my_vs(vs)
+  , my_buffer(vs, VideoBufferUsage::DYNAMIC_DRAW)
+  , my_ring(region_size)
+{
+  my_buffer.allocate(my_ring.capacity());
+
+  for (GLsync &fence : my_fences) {
+    fence = nullptr;
+  }
+}
+
+StreamBuffer::~StreamBuffer()
+{
+  for (GLsync fence : my_fences) {
+    if (fence != nullptr) {
+      glDeleteSync(fence);
+    }
+  }
+}
+
+void StreamBuffer::begin_frame()
+{
+  u32 region = my_ring.next_region();
+  GLsync &fence = my_fences[region];
+
+  if (fence == nullptr) {
+    return;
+  }
+
+  GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, STREAM_FENCE_TIMEOUT);
+
+  if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+    log_warning("Stream buffer region %u is still used by GPU", region);
+  }
+
+  glDeleteSync(fence);
+  fence = nullptr;
+}
+
+void StreamBuffer::end_frame()
+{
+  GLsync &fence = my_fences[my_ring.region()];
+
+  if (fence != nullptr) {
+    glDeleteSync(fence);
+  }
+
+  fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+StreamRange StreamBuffer::write(const void *data, u32 size, u32 alignment)
+{
+  if (size == 0) {
+    return StreamRange();
+  }
+
+  assert(data != nullptr);
+  u32 offset = my_ring.allocate(size, alignment);
+
+  if (offset == U32_MAX) {
+    log_warning("Stream buffer is full, %u bytes dropped", size);
+    return StreamRange();
+  }
+
+  // region is protected by its fence, driver doesn't have to synchronize
+  my_vs.bind_array_buffer(my_buffer);
+  void *target = glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+  if (target == nullptr) {
+    log_error("Can't map stream buffer");
+    my_vs.unbind_array_buffer();
+    return StreamRange();
+  }
+
+  memcpy(target, data, size);
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+  my_vs.unbind_array_buffer();
+  return StreamRange(&my_buffer, offset, size);
+}
+
+}
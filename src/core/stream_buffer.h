@@ -0,0 +1,130 @@
+#pragma once
+
+#include "noncopyable.h"
+#include "gl_utils.h"
+#include "video_buffer.h"
+
+namespace atom {
+
+/// regions of the stream buffer, GPU reads one while CPU writes another
+const u32 STREAM_BUFFER_FRAMES = 3;
+
+/**
+ * Part of the stream buffer written in the current frame, valid until the
+ * region is reused STREAM_BUFFER_FRAMES frames later.
+ */
+struct StreamRange {
+  VideoBuffer *buffer;  ///< nullptr when the data didn't fit
+  u32          offset;  ///< in bytes
+  u32          size;
+
+  StreamRange()
+    : buffer(nullptr)
+    , offset(0)
+    , size(0)
+  {
+    // empty
+  }
+
+  StreamRange(VideoBuffer *buffer, u32 offset, u32 size)
+    : buffer(buffer)
+    , offset(offset)
+    , size(size)
+  {
+    // empty
+  }
+};
+
+/**
+ * Linear allocator over STREAM_BUFFER_FRAMES equal regions, allocation of
+ * each frame stays in one region (StreamBuffer bookkeeping without OpenGL).
+ */
+class StreamRing {
+  u32 my_region_size;
+  u32 my_region;      ///< region of the current frame
+  u32 my_used;        ///< bytes used in the current region
+
+public:
+  explicit StreamRing(u32 region_size);
+
+  /**
+   * @param alignment power of two
+   * @return offset from the buffer start or U32_MAX when the region is full
+   */
+  u32 allocate(u32 size, u32 alignment);
+
+  /**
+   * Move to the next region and drop its old allocations.
+   *
+   * @return index of the new region
+   */
+  u32 next_region();
+
+  u32 region() const
+  {
+    return my_region;
+  }
+
+  u32 region_size() const
+  {
+    return my_region_size;
+  }
+
+  u32 used() const
+  {
+    return my_used;
+  }
+
+  u32 capacity() const
+  {
+    return my_region_size * STREAM_BUFFER_FRAMES;
+  }
+};
+
+/**
+ * Vertex data rewritten every frame (debug lines, CPU skinning) share one
+ * buffer allocated once. Region of the frame is mapped unsynchronized, GPU
+ * fence of the frame which used the region last time protects data still in
+ * flight, so writes don't reallocate the buffer nor stall on implicit sync.
+ */
+class StreamBuffer : NonCopyable {
+  VideoService &my_vs;
+  VideoBuffer   my_buffer;
+  StreamRing    my_ring;
+  GLsync        my_fences[STREAM_BUFFER_FRAMES];
+
+public:
+  StreamBuffer(VideoService &vs, u32 region_size);
+
+  ~StreamBuffer();
+
+  /**
+   * Switch to the next region, waits when GPU still reads it.
+   */
+  void begin_frame();
+
+  /**
+   * Fence commands using the current region, call after the last draw.
+   */
+  void end_frame();
+
+  /**
+   * Copy data to the current region.
+   *
+   * @return range of the data, empty when the region is full or @p size is 0
+   */
+  StreamRange write(const void *data, u32 size, u32 alignment = 16);
+
+  template<typename T>
+  StreamRange write(const Slice<T> &data)
+  {
+    return write(data.data(), data.raw_size());
+  }
+
+  VideoBuffer& buffer()
+  {
+    return my_buffer;
+  }
+};
+
+}
@@ -1,14 +1,17 @@
 #include "technique.h"
 #include <string.h>
 #include "mat_array.h"
+#include "uniforms.h"
 #include "utils.h"
 #include "gl_utils.h"
 #include "shader.h"
 #include "constants.h"
+#include "video_service.h"
 
 namespace atom {
 
 Technique::Technique()
+  : my_blocks(0)
 {
   my_gl_program = glCreateProgram();
 }
@@ -18,7 +21,7 @@ Technique::~Technique()
   glDeleteProgram(my_gl_program);
 }
 
-uptr<Technique> Technique::create(const String &name)
+uptr<Technique> Technique::create(const String &name, const std::vector<String> &feedback)
 {
   Shader pixel_shader(ShaderType::PIXEL);
   Shader vertex_shader(ShaderType::VERTEX);
@@ -44,7 +47,7 @@ uptr<Technique> Technique::create(const String &name)
   const Shader *shaders[3] = { &vertex_shader, &pixel_shader, &geometry_shader };
 
   uptr<Technique> program(new Technique());
-  if (!program->link(shaders, geometry_shader.is_compiled() ? 3 : 2)) {
+  if (!program->link(shaders, geometry_shader.is_compiled() ? 3 : 2, feedback)) {
     log_warning("Can't link program \"%s\"", name.c_str());
     return nullptr;
   }
@@ -65,7 +68,7 @@ bool Technique::link(const Shader &a, const Shader &b, const Shader &c)
   return link(shaders, 3);
 }
 
-bool Technique::link(const Shader *shaders[], int count)
+bool Technique::link(const Shader *shaders[], int count, const std::vector<String> &feedback)
 {
   // check that all shaders are compiled
   for (int i = 0; i < count; ++i) {
@@ -78,6 +81,18 @@ bool Technique::link(const Shader *shaders[], int count)
     glAttachShader(my_gl_program, shaders[i]->gl_shader());
   }
 
+  // captured outputs must be declared before linking
+  if (!feedback.empty()) {
+    std::vector<const char *> varyings;
+
+    for (const String &name : feedback) {
+      varyings.push_back(name.c_str());
+    }
+
+    glTransformFeedbackVaryings(my_gl_program, varyings.size(), varyings.data(),
+      GL_INTERLEAVED_ATTRIBS);
+  }
+
   glLinkProgram(my_gl_program);
 
   for (int i = 0; i < count; ++i) {
@@ -131,20 +146,57 @@ void Technique::locate_uniforms()
 {
   GL_ERROR_GUARD;
   my_uniforms.clear();
+  my_blocks = 0;
 
-
+  const MetaClass &meta = *Uniforms::static_meta_class();
   GLint count = 0;
   glGetProgramiv(my_gl_program, GL_ACTIVE_UNIFORMS, &count);
 
 
   for (int i = 0; i < count; ++i) {
+    GLuint index = i;
+    GLint block = -1;
+    glGetActiveUniformsiv(my_gl_program, 1, &index, GL_UNIFORM_BLOCK_INDEX, &block);
+
+    // block members are uploaded by VideoService
+    if (block >= 0) {
+      continue;
+    }
+
     ShaderUniform u;
 
     if (get_shader_uniform_info(my_gl_program, i, u)) {
 //      info("Adding uniform %s", u.name.c_str());
+      // field lookup by name is done only once
+      u.field = meta.find_field(u.name.c_str());
+
+      // sampler bindings are fixed, only the bone palette is used now
+      if (u.type == Type::SAMPLER_BUFFER && u.name == BONE_PALETTE_UNIFORM) {
+        glProgramUniform1i(my_gl_program, u.gl_location, BONE_PALETTE_UNIT);
+      }
+
       my_uniforms.push_back(u);
     }
   }
+
+  for (u32 i = 0; i < UNIFORM_BLOCK_COUNT; ++i) {
+    GLuint index = glGetUniformBlockIndex(my_gl_program, UNIFORM_BLOCK_NAMES[i]);
+
+    if (index == GL_INVALID_INDEX) {
+      continue;
+    }
+
+    GLint size = 0;
+    glGetActiveUniformBlockiv(my_gl_program, index, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+
+    if (static_cast<u32>(size) != uniform_block_size(i)) {
+      log_warning("Uniform block \"%s\" has invalid size %i", UNIFORM_BLOCK_NAMES[i], size);
+      continue;
+    }
+
+    glUniformBlockBinding(my_gl_program, index, i);
+    my_blocks |= 1 << i;
+  }
 }
 
 void set_uniform(const MetaField &meta_field, const void *data, GLint gl_location)
@@ -181,8 +233,11 @@ void set_uniform(const MetaField &meta_field, const void *data, GLint gl_locatio
     }
 
     case Type::MAT4F_ARRAY: {
-      const Mat4fArray &m = field_ref<Mat4fArray>(meta_field, data);
-      glUniformMatrix4fv(gl_location, m.size(), false, reinterpret_cast<const GLfloat *>(m.data()));
+      const Mat4fSlice &m = field_ref<Mat4fSlice>(meta_field, data);
+
+      if (!m.is_empty()) {
+        glUniformMatrix4fv(gl_location, m.size(), false, reinterpret_cast<const GLfloat *>(m.data()));
+      }
       break;
     }
 
@@ -192,15 +247,50 @@ void set_uniform(const MetaField &meta_field, const void *data, GLint gl_locatio
   }
 }
 
-void Technique::pull(const MetaObject &properties)
+static u32 uniform_value_size(Type type)
 {
-  for (const ShaderUniform &u : my_uniforms) {
-    const MetaField *meta_field = properties.meta_class.find_field(u.name.c_str());
-    if (meta_field != nullptr) {
-//      info("Pulling uniform %s", u.name.c_str());
-      set_uniform(*meta_field, properties.data, u.gl_location);
+  switch (type) {
+    case Type::VEC2F:
+      return sizeof(Vec2f);
+    case Type::VEC3F:
+      return sizeof(Vec3f);
+    case Type::VEC4F:
+      return sizeof(Vec4f);
+    case Type::MAT4F:
+      return sizeof(Mat4f);
+    default:
+      return 0; // arrays aren't cached
+  }
+}
+
+u32 Technique::pull(const Uniforms &uniforms)
+{
+  u32 count = 0;
+
+  for (ShaderUniform &u : my_uniforms) {
+    if (u.field == nullptr) {
+      continue;
     }
+
+    u32 size = uniform_value_size(u.field->type);
+
+    if (size > 0) {
+      const u8 *value = &field_ref<u8>(*u.field, &uniforms);
+
+      if (u.has_value && memcmp(u.value, value, size) == 0) {
+        continue;
+      }
+
+      memcpy(u.value, value, size);
+      u.has_value = true;
+    }
+
+//    info("Pulling uniform %s", u.name.c_str());
+    set_uniform(*u.field, &uniforms, u.gl_location);
+    ++count;
   }
+
+  return count;
 }
 
 Type Technique::get_type_from_gl_type(GLenum type, GLint size)
@@ -230,6 +320,9 @@ Type Technique::get_type_from_gl_type(GLenum type, GLint size)
     case GL_SAMPLER_2D:
       return Type::SAMPLER_2D;
 
+    case GL_SAMPLER_BUFFER:
+      return Type::SAMPLER_BUFFER;
+
     default:
       return Type::UNKNOWN;
   }
@@ -269,6 +362,8 @@ bool Technique::get_shader_uniform_info(GLuint gl_program, GLuint index,
   uniform.type = uniform_type;
   uniform.name = name;
   uniform.gl_location = location;
+  uniform.field = nullptr;
+  uniform.has_value = false;
   return true;
 }
 
@@ -5,10 +5,20 @@
 
 namespace atom {
 
+/// largest cached uniform value (Mat4f)
+const u32 UNIFORM_CACHE_SIZE = 64;
+
+/**
+ * Uniform outside of the uniform blocks (uniforms.h), it is pulled from
+ * the Uniforms field with the same name.
+ */
 struct ShaderUniform {
-  Type   type;
-  String name;
-  GLint  gl_location;
+  Type             type;
+  String           name;
+  GLint            gl_location;
+  const MetaField *field;        ///< Uniforms field resolved by locate_uniforms (nullptr not found)
+  u8               value[UNIFORM_CACHE_SIZE];  ///< last uploaded value
+  bool             has_value;
 };
 
 typedef std::vector<ShaderUniform> ShaderUniforms;
@@ -16,28 +26,52 @@ typedef std::vector<ShaderUniform> ShaderUniforms;
 class Technique : NonCopyable {
   GLuint         my_gl_program;
   ShaderUniforms my_uniforms;
+  u32            my_blocks;       ///< bit mask of used uniform blocks
 
 public:
   Technique();
   ~Technique();
 
-  static uptr<Technique> create(const String &name);
+  /**
+   * Load and link shaders "name.vs", "name.ps" and optional "name.gs".
+   *
+   * @param feedback vertex shader outputs captured by transform feedback
+   *                 (interleaved into one buffer)
+   */
+  static uptr<Technique> create(const String &name,
+    const std::vector<String> &feedback = std::vector<String>());
 
   /**
    * Link shader programs. Then you should locate and map uniform.
    */
   bool link(const Shader &a, const Shader &b);
   bool link(const Shader &a, const Shader &b, const Shader &c);
-  bool link(const Shader *shaders[], int count);
+  bool link(const Shader *shaders[], int count,
+    const std::vector<String> &feedback = std::vector<String>());
 
   void set_param(const char *name, const Vec3f &v) const;
   void set_param(const char *name, const Mat4f &m) const;
 
   GLuint gl_program() const;
 
+  /**
+   * Find uniforms and map them to Uniforms fields, bind uniform blocks to
+   * their binding points.
+   */
   void locate_uniforms();
 
-  void pull(const MetaObject &properties);
+  bool uses_block(u32 block) const
+  {
+    return (my_blocks & (1 << block)) != 0;
+  }
+
+  /**
+   * Upload uniforms outside of the blocks, unchanged values aren't uploaded
+   * again.
+   *
+   * @return number of uploaded uniforms
+   */
+  u32 pull(const Uniforms &uniforms);
 
   static Type get_type_from_gl_type(GLenum type, GLint size);
 
@@ -0,0 +1,100 @@
+#include "terrain.h"
+#include <algorithm>
+#include <cmath>
+
+namespace atom {
+
+u64 terrain_tile_key(i32 x, i32 y)
+{
+  return (u64(u32(x)) << 32) | u32(y);
+}
+
+String terrain_tile_name(const String &prefix, i32 x, i32 y)
+{
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "_%i_%i", x, y);
+  return prefix + buffer;
+}
+
+void terrain_tiles_in_radius(const Vec2f &center, f32 tile_size, f32 radius,
+  std::vector<TerrainTile> &tiles)
+{
+  assert(tile_size > 0);
+  tiles.clear();
+
+  if (radius < 0) {
+    return;
+  }
+
+  i32 x0 = static_cast<i32>(std::floor((center.x - radius) / tile_size));
+  i32 x1 = static_cast<i32>(std::floor((center.x + radius) / tile_size));
+  i32 y0 = static_cast<i32>(std::floor((center.y - radius) / tile_size));
+  i32 y1 = static_cast<i32>(std::floor((center.y + radius) / tile_size));
+
+  for (i32 y = y0; y <= y1; ++y) {
+    for (i32 x = x0; x <= x1; ++x) {
+      // distance to the nearest point of the tile rectangle
+      f32 dx = std::max(std::max(x * tile_size - center.x, center.x - (x + 1) * tile_size), 0.0f);
+      f32 dy = std::max(std::max(y * tile_size - center.y, center.y - (y + 1) * tile_size), 0.0f);
+      f32 distance = std::sqrt(dx * dx + dy * dy);
+
+      if (distance <= radius) {
+        tiles.push_back(TerrainTile{x, y, distance});
+      }
+    }
+  }
+
+  std::stable_sort(tiles.begin(), tiles.end(),
+    [](const TerrainTile &a, const TerrainTile &b) { return a.distance < b.distance; });
+}
+
+TileCache::TileCache(u32 capacity)
+  : my_capacity(capacity)
+{
+}
+
+void TileCache::set_capacity(u32 capacity)
+{
+  my_capacity = capacity;
+}
+
+void TileCache::use(u64 key, u32 frame)
+{
+  my_used[key] = frame;
+}
+
+void TileCache::remove(u64 key)
+{
+  my_used.erase(key);
+}
+
+void TileCache::clear()
+{
+  my_used.clear();
+}
+
+void TileCache::evict(u32 frame, std::vector<u64> &evicted)
+{
+  if (my_used.size() <= my_capacity) {
+    return;
+  }
+
+  std::vector<std::pair<u32, u64>> unused;
+
+  for (const auto &item : my_used) {
+    if (item.second != frame) {
+      unused.push_back(std::make_pair(item.second, item.first));
+    }
+  }
+
+  // oldest first, ties by key so the result doesn't depend on the hash order
+  std::sort(unused.begin(), unused.end());
+  u32 count = std::min<u32>(my_used.size() - my_capacity, unused.size());
+
+  for (u32 i = 0; i < count; ++i) {
+    my_used.erase(unused[i].second);
+    evicted.push_back(unused[i].second);
+  }
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "foundation.h"
+
+namespace atom {
+
+/**
+ * Tile of the terrain grid, tile (x, y) covers <x, x + 1) * tile_size and
+ * <y, y + 1) * tile_size in the terrain space.
+ */
+struct TerrainTile {
+  i32 x;
+  i32 y;
+  f32 distance;   ///< from the viewer to the tile rectangle (xy plane)
+};
+
+u64 terrain_tile_key(i32 x, i32 y);
+
+/**
+ * Resource name of the tile model, "<prefix>_<x>_<y>".
+ */
+String terrain_tile_name(const String &prefix, i32 x, i32 y);
+
+/**
+ * Tiles closer than @p radius to @p center, sorted from the nearest one.
+ */
+void terrain_tiles_in_radius(const Vec2f &center, f32 tile_size, f32 radius,
+  std::vector<TerrainTile> &tiles);
+
+/**
+ * Bounded set of loaded tiles, least recently used tiles are released when
+ * the cache is full. Tiles used in the current frame are never released, so
+ * the cache grows over its capacity when they don't fit.
+ */
+class TileCache {
+  std::unordered_map<u64, u32> my_used;    ///< last frame each cached tile was used
+  u32                          my_capacity;
+
+public:
+  explicit TileCache(u32 capacity);
+
+  void set_capacity(u32 capacity);
+
+  u32 capacity() const
+  {
+    return my_capacity;
+  }
+
+  u32 size() const
+  {
+    return my_used.size();
+  }
+
+  bool contains(u64 key) const
+  {
+    return my_used.find(key) != my_used.end();
+  }
+
+  /**
+   * Add tile to the cache or mark the cached tile as used in @p frame.
+   */
+  void use(u64 key, u32 frame);
+
+  void remove(u64 key);
+
+  void clear();
+
+  /**
+   * Remove the least recently used tiles not used in @p frame until the
+   * cache fits its capacity.
+   *
+   * @param[out] evicted keys of removed tiles (appended)
+   */
+  void evict(u32 frame, std::vector<u64> &evicted);
+};
+
+}
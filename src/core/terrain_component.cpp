@@ -0,0 +1,205 @@
+#include "terrain_component.h"
+#include <algorithm>
+#include "collider_component.h"
+#include "config.h"
+#include "core.h"
+#include "entity.h"
+#include "geometry_component.h"
+#include "material_component.h"
+#include "mesh.h"
+#include "mesh_component.h"
+#include "model_component.h"
+#include "render_component.h"
+#include "resource_service.h"
+#include "rigid_body_component.h"
+#include "world.h"
+
+namespace atom {
+
+namespace {
+
+/// tiles which left the range while loading are decoded after everything else
+const i32 UNWANTED_TILE_PRIORITY = I32_MIN / 2;
+
+}
+
+META_CLASS(TerrainComponent,
+  FIELD(my_tile_size, "tile_size"),
+  FIELD(my_radius, "radius"),
+  FIELD(my_categories, "categories"),
+  FIELD(my_colliders, "colliders")
+)
+
+TerrainComponent::TerrainComponent()
+  : NullComponent(ComponentType::TERRAIN)
+  , my_tile_size(64)
+  , my_radius(256)
+  , my_categories(U32_MAX)
+  , my_colliders(true)
+  , my_cache(DEFAULT_TERRAIN_TILE_CACHE)
+{
+  META_INIT();
+}
+
+TerrainComponent::~TerrainComponent()
+{
+  // empty
+}
+
+void TerrainComponent::activate()
+{
+  my_cache.set_capacity(std::max(Config::instance().terrain_tile_cache, 1));
+}
+
+void TerrainComponent::deactivate()
+{
+  for (auto &item : my_tile_map) {
+    despawn_tile(item.second);
+  }
+
+  my_tile_map.clear();
+  my_cache.clear();
+  my_material_resource.reset();
+}
+
+void TerrainComponent::set_tile_size(f32 size)
+{
+  assert(size > 0);
+  my_tile_size = size;
+}
+
+u32 TerrainComponent::resident_count() const
+{
+  return std::count_if(my_tile_map.begin(), my_tile_map.end(),
+    [](const std::pair<const u64, Tile> &item) { return item.second.entity != nullptr; });
+}
+
+void TerrainComponent::update(const Vec3f &viewer, u32 frame)
+{
+  if (my_tiles.empty()) {
+    return;
+  }
+
+  ResourceService &rs = core().resource_service();
+  Vec3f local = transform_point(entity().transform().inverted(), viewer);
+  // resident tiles are kept a bit farther than new ones are requested, so
+  // tiles on the edge don't toggle when the viewer moves back and forth
+  f32 keep_radius = my_radius + my_tile_size * TERRAIN_UNLOAD_MARGIN;
+  terrain_tiles_in_radius(Vec2f(local.x, local.y), my_tile_size, keep_radius, my_wanted);
+
+  for (u32 i = 0; i < my_wanted.size(); ++i) {
+    const TerrainTile &wanted = my_wanted[i];
+    u64 key = terrain_tile_key(wanted.x, wanted.y);
+    auto found = my_tile_map.find(key);
+    // nearer tiles are decoded first
+    i32 priority = -static_cast<i32>(i);
+
+    if (found == my_tile_map.end()) {
+      if (wanted.distance > my_radius) {
+        continue;
+      }
+
+      String name = terrain_tile_name(my_tiles, wanted.x, wanted.y);
+      Tile tile{wanted.x, wanted.y, TileState::LOADING, frame,
+        rs.get_model_async(name, priority), rs.get_mesh_async(name, priority), nullptr};
+      found = my_tile_map.emplace(key, std::move(tile)).first;
+    }
+
+    Tile &tile = found->second;
+    tile.frame = frame;
+    my_cache.use(key, frame);
+
+    if (tile.state == TileState::LOADING) {
+      if (tile.mesh->state() == ResourceState::FAILED ||
+          tile.model->state() == ResourceState::FAILED) {
+        log_error("Can't load terrain tile \"%s\"",
+          terrain_tile_name(my_tiles, tile.x, tile.y).c_str());
+        tile.state = TileState::FAILED;
+      } else if (tile.mesh->is_ready() && tile.model->is_ready()) {
+        tile.state = TileState::RESIDENT;
+      } else {
+        rs.set_load_priority(tile.mesh, priority);
+      }
+    }
+
+    if (tile.state == TileState::RESIDENT && tile.entity == nullptr) {
+      spawn_tile(tile);
+    }
+  }
+
+  // tiles out of range
+  for (auto &item : my_tile_map) {
+    Tile &tile = item.second;
+
+    if (tile.frame == frame) {
+      continue;
+    }
+
+    despawn_tile(tile);
+
+    if (tile.state == TileState::LOADING) {
+      rs.set_load_priority(tile.mesh, UNWANTED_TILE_PRIORITY);
+    }
+  }
+
+  my_evicted.clear();
+  my_cache.evict(frame, my_evicted);
+
+  for (u64 key : my_evicted) {
+    auto found = my_tile_map.find(key);
+    despawn_tile(found->second);
+    // ResourceService releases unused data within its own cache budget
+    my_tile_map.erase(found);
+  }
+}
+
+void TerrainComponent::spawn_tile(Tile &tile)
+{
+  ResourceService &rs = core().resource_service();
+
+  if (my_material_resource == nullptr && !my_material.empty()) {
+    my_material_resource = rs.get_material(my_material);
+  }
+
+  sptr<Entity> tile_entity(new Entity(world(), core()));
+  tile_entity->set_transform(entity().transform() *
+    Mat4f::translation(tile.x * my_tile_size, tile.y * my_tile_size, 0));
+
+  const BoundingBox &bounds = tile.mesh->mesh().bounds;
+
+  if (!bounds.is_null()) {
+    tile_entity->set_bounding_box(bounds);
+  }
+
+  ModelComponent *model = tile_entity->add_component<ModelComponent>();
+  model->set_model(tile.model);
+  MaterialComponent *material = tile_entity->add_component<MaterialComponent>();
+  material->set_material(my_material_resource);
+  MeshComponent *mesh = tile_entity->add_component<MeshComponent>();
+  mesh->set_mode(MeshComponentMode::MANUAL);
+  mesh->set_mesh(tile.mesh);
+  tile_entity->add_component<RenderComponent>();
+  GeometryComponent *geometry = tile_entity->add_component<GeometryComponent>();
+  geometry->set_categories(my_categories);
+
+  if (my_colliders) {
+    // collider shape has to exist before the rigid body is activated
+    tile_entity->add_component<MeshColliderComponent>();
+    RigidBodyComponent *rigid_body = tile_entity->add_component<RigidBodyComponent>();
+    rigid_body->set_body_type(RigidBodyType::STATIC);
+    rigid_body->set_mass(0);
+  }
+
+  tile_entity->activate();
+  tile.entity = tile_entity;
+}
+
+void TerrainComponent::despawn_tile(Tile &tile)
+{
+  if (tile.entity != nullptr) {
+    tile.entity->deactivate();
+    tile.entity.reset();
+  }
+}
+
+}
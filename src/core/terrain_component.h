@@ -0,0 +1,113 @@
+#pragma once
+
+#include <unordered_map>
+#include "component.h"
+#include "terrain.h"
+
+namespace atom {
+
+/**
+ * Terrain paged in tiles around the viewer. Tile (x, y) is the model
+ * "<tiles>_<x>_<y>" placed at (x * tile_size, y * tile_size, 0) in the entity
+ * space. Tiles within the radius are loaded asynchronously, the nearest ones
+ * first. Loaded tiles get own entity with render, geometry and (optionally)
+ * static mesh collider, so ray queries and physics see only resident tiles.
+ * Tiles out of the radius keep their data in TileCache (Config::terrain_tile_cache
+ * tiles), least recently used ones are released when the cache is full.
+ *
+ * Tile entities are owned by the component, they aren't in the World entity
+ * list (not saved, not found by id).
+ */
+class TerrainComponent : public NullComponent {
+  enum class TileState {
+    LOADING,
+    RESIDENT,   ///< data are loaded, entity exists while the tile is in range
+    FAILED
+  };
+
+  struct Tile {
+    i32              x;
+    i32              y;
+    TileState        state;
+    u32              frame;     ///< last frame the tile was in range
+    ModelResourcePtr model;
+    MeshResourcePtr  mesh;
+    sptr<Entity>     entity;
+  };
+
+  String                          my_tiles;       ///< tile model name prefix
+  String                          my_material;
+  f32                             my_tile_size;
+  f32                             my_radius;      ///< tiles closer to the viewer are loaded
+  u32                             my_categories;  ///< GeometryComponent categories of tiles
+  bool                            my_colliders;   ///< create static mesh colliders
+  MaterialResourcePtr             my_material_resource;
+  std::unordered_map<u64, Tile>   my_tile_map;
+  TileCache                       my_cache;
+  std::vector<TerrainTile>        my_wanted;      ///< tiles in range of the current frame
+  std::vector<u64>                my_evicted;
+
+  void activate() override;
+
+  void deactivate() override;
+
+  void spawn_tile(Tile &tile);
+
+  void despawn_tile(Tile &tile);
+
+public:
+  TerrainComponent();
+  ~TerrainComponent();
+
+  void set_tiles(const String &prefix)
+  {
+    my_tiles = prefix;
+  }
+
+  void set_material(const String &material)
+  {
+    my_material = material;
+  }
+
+  void set_tile_size(f32 size);
+
+  void set_radius(f32 radius)
+  {
+    my_radius = radius;
+  }
+
+  void set_categories(u32 mask)
+  {
+    my_categories = mask;
+  }
+
+  void set_colliders(bool enable)
+  {
+    my_colliders = enable;
+  }
+
+  /**
+   * Number of tiles with spawned entity.
+   */
+  u32 resident_count() const;
+
+  /**
+   * Number of tiles loaded or loading (bounded by the tile cache).
+   */
+  u32 cached_count() const
+  {
+    return my_tile_map.size();
+  }
+
+  /**
+   * Request, spawn and release tiles around @p viewer (world space), called
+   * by TerrainProcessor.
+   */
+  void update(const Vec3f &viewer, u32 frame);
+
+  META_SUB_CLASS(NullComponent);
+};
+
+MAP_COMPONENT_TYPE(TerrainComponent, TERRAIN)
+
+}
@@ -0,0 +1,37 @@
+#include "terrain_processor.h"
+#include "terrain_component.h"
+#include "world.h"
+
+namespace atom {
+
+TerrainProcessor::TerrainProcessor(World &world)
+  : NullProcessor(world)
+  , my_frame(0)
+{
+
+}
+
+TerrainProcessor::~TerrainProcessor()
+{
+
+}
+
+void TerrainProcessor::poll()
+{
+  const ComponentRange<TerrainComponent> components = world().components<TerrainComponent>();
+
+  if (components.size() == 0) {
+    return;
+  }
+
+  // camera position is the translation of the inverted view matrix
+  Mat4f inverted_view = world().camera().view.inverted();
+  Vec3f viewer(inverted_view(0, 3), inverted_view(1, 3), inverted_view(2, 3));
+  ++my_frame;
+
+  for (TerrainComponent *component : components) {
+    component->update(viewer, my_frame);
+  }
+}
+
+}
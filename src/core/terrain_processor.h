@@ -0,0 +1,22 @@
+#pragma once
+
+#include "processor.h"
+
+namespace atom {
+
+/**
+ * Stream tiles of all TerrainComponents around the world camera. Tile
+ * entities are created and removed here, so it runs serially with the other
+ * processors.
+ */
+class TerrainProcessor : public NullProcessor {
+  u32 my_frame;
+
+public:
+  explicit TerrainProcessor(World &world);
+  ~TerrainProcessor();
+
+  void poll() override;
+};
+
+}
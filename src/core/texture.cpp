@@ -50,8 +50,22 @@ void Texture::init_from_image(const Image &image)
   set_data(image.format(), my_width, my_height, image.pixels());
 }
 
+void Texture::init_as_buffer(PixelFormat format, const VideoBuffer &buffer)
+{
+  GL_ERROR_GUARD;
+
+  my_type = TextureType::BUFFER;
+  my_format = format;
+  my_width = buffer.size() / pixel_data_size(format, 1, 1);
+  my_height = 1;
+
+  my_vs.bind_texture(0, *this);
+  glTexBuffer(GL_TEXTURE_BUFFER, pixel_format_to_gl_format(format), buffer.gl_buffer());
+}
+
 Texture::~Texture()
 {
+  my_vs.release_texture(*this);
   // glDeleteTextures ignoruje 0, takze nieje potrebne testovat tuto variantu
   glDeleteTextures(1, &my_gl_texture);
 }
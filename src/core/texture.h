@@ -28,6 +28,12 @@ public:
 
   void init_from_image(const Image &image);
 
+  /**
+   * Inicializuj texturu ako pohlad na data bufferu (TextureType::BUFFER),
+   * buffer musi existovat pocas zivota textury.
+   */
+  void init_as_buffer(PixelFormat format, const VideoBuffer &buffer);
+
   /**
    * Destruktor, uvolni texturu z pamate OpenGL.
    */
@@ -0,0 +1,76 @@
+#include "thread_pool.h"
+
+namespace atom {
+
+ThreadPool::ThreadPool(u32 count)
+  : my_running(0)
+  , my_quit(false)
+{
+  if (count == 0) {
+    u32 hardware = std::thread::hardware_concurrency();
+    count = hardware > 1 ? hardware - 1 : 1;
+  }
+
+  for (u32 i = 0; i < count; ++i) {
+    my_workers.push_back(std::thread(&ThreadPool::run, this));
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(my_mutex);
+    my_quit = true;
+  }
+
+  my_job_ready.notify_all();
+
+  for (std::thread &worker : my_workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::push(const Job &job)
+{
+  {
+    std::lock_guard<std::mutex> lock(my_mutex);
+    my_jobs.push_back(job);
+  }
+
+  my_job_ready.notify_one();
+}
+
+void ThreadPool::wait()
+{
+  std::unique_lock<std::mutex> lock(my_mutex);
+  my_idle.wait(lock, [this] { return my_jobs.empty() && my_running == 0; });
+}
+
+void ThreadPool::run()
+{
+  std::unique_lock<std::mutex> lock(my_mutex);
+
+  while (true) {
+    my_job_ready.wait(lock, [this] { return my_quit || !my_jobs.empty(); });
+    // finish queued jobs before quit
+    if (my_jobs.empty()) {
+      break;
+    }
+
+    Job job = std::move(my_jobs.front());
+    my_jobs.pop_front();
+    ++my_running;
+
+    lock.unlock();
+    job();
+    lock.lock();
+
+    --my_running;
+
+    if (my_jobs.empty() && my_running == 0) {
+      my_idle.notify_all();
+    }
+  }
+}
+
+}
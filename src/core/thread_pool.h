@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "noncopyable.h"
+#include "platform.h"
+
+namespace atom {
+
+typedef std::function<void()> Job;
+
+/**
+ * Fixed number of worker threads processing jobs in FIFO order.
+ * Destructor waits until all queued jobs are finished.
+ */
+class ThreadPool : private NonCopyable {
+public:
+  /**
+   * @param count number of worker threads, 0 means number of hardware threads
+   *              minus one (the main thread), but at least one worker
+   */
+  explicit ThreadPool(u32 count = 0);
+  ~ThreadPool();
+
+  void push(const Job &job);
+
+  /**
+   * Block until the queue is empty and all workers are idle.
+   */
+  void wait();
+
+  u32 worker_count() const
+  {
+    return my_workers.size();
+  }
+
+private:
+  void run();
+
+private:
+  std::vector<std::thread> my_workers;
+  std::deque<Job>          my_jobs;
+  std::mutex               my_mutex;
+  std::condition_variable  my_job_ready;
+  std::condition_variable  my_idle;
+  u32                      my_running;  ///< number of jobs being executed
+  bool                     my_quit;
+};
+
+}
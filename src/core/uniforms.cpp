@@ -2,22 +2,52 @@
 
 namespace atom {
 
+const char *UNIFORM_BLOCK_NAMES[UNIFORM_BLOCK_COUNT] = { "Frame", "Object" };
+
+u32 uniform_block_size(u32 block)
+{
+  switch (block) {
+    case FRAME_BLOCK:
+      return sizeof(FrameBlock);
+    case OBJECT_BLOCK:
+      return sizeof(ObjectBlock);
+    default:
+      return 0;
+  }
+}
+
 META_CLASS(Uniforms,
   FIELD(color, "color"),
   FIELD(ambient_color, "ambient"),
   FIELD(sun_dir, "sun_dir"),
   FIELD(model, "model"),
   FIELD(mvp, "mvp"),
-  FIELD(bones, "bones[0]")
+  FIELD(view_projection, "view_projection")
 )
 
 Uniforms::Uniforms()
   : color(0.5, 0.5, 0.5)
   , ambient_color(1, 1, 1)
+  , bone_offset(0)
 {
   META_INIT();
+}
 
-  bones.resize(256, Mat4f());
+void Uniforms::get_frame_block(FrameBlock &block) const
+{
+  block.view = transformations.view;
+  block.projection = transformations.projection;
+  block.view_projection = view_projection;
+  block.sun_dir = Vec4f(sun_dir, 0);
+  block.ambient = Vec4f(ambient_color, 0);
+}
+
+void Uniforms::get_object_block(ObjectBlock &block) const
+{
+  block.model = model;
+  block.mvp = mvp;
+  block.color = color;
+  block.bone_offset = bone_offset;
 }
 
 }
@@ -7,6 +7,40 @@
 
 namespace atom {
 
+/**
+ * Uniform blocks shared by all techniques (std140 layout). Block is bound to
+ * the binding point with the same index, shaders declare only used blocks.
+ */
+const u32 FRAME_BLOCK = 0;          ///< "Frame" camera & light, changes once per frame
+const u32 OBJECT_BLOCK = 1;         ///< "Object" transformations & color, changes per draw
+const u32 UNIFORM_BLOCK_COUNT = 2;
+
+extern const char *UNIFORM_BLOCK_NAMES[UNIFORM_BLOCK_COUNT];
+
+/**
+ * Data size of the block in the std140 layout.
+ */
+u32 uniform_block_size(u32 block);
+
+/// vec3 members are padded to vec4 in std140
+struct FrameBlock {
+  Mat4f view;
+  Mat4f projection;
+  Mat4f view_projection;
+  Vec4f sun_dir;
+  Vec4f ambient;
+};
+
+struct ObjectBlock {
+  Mat4f model;
+  Mat4f mvp;
+  Vec3f color;
+  i32   bone_offset;    ///< scalar fills the vec3 padding
+};
+
+static_assert(sizeof(FrameBlock) == 224, "Invalid FrameBlock size");
+static_assert(sizeof(ObjectBlock) == 144, "Invalid ObjectBlock size");
+
 class Uniforms {
 public:
   Uniforms();
@@ -22,10 +56,15 @@ public:
   Vec3f eye_direction;
   Mat4f mvp;
   Mat4f model;
+  Mat4f view_projection;    ///< instanced draws, model matrix is per instance
   Vec3f sun_dir;
-  Mat4fArray bones;
+  i32   bone_offset;          ///< first bone of the drawn skeleton in the bone palette
   Transformations transformations;
 
+  void get_frame_block(FrameBlock &block) const;
+
+  void get_object_block(ObjectBlock &block) const;
+
   META_ROOT_CLASS;
 };
 
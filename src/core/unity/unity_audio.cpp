@@ -1,4 +1,7 @@
-#include "../audio_service.cpp"
+#include "../audio_mixer.cpp"
+#include "../audio_resampler.cpp"
 #include "../audio_stream.cpp"
+#include "../audio_service.cpp"
+#include "../audio_spatial.cpp"
 #include "../music.cpp"
 #include "../sound.cpp"
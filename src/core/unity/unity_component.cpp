@@ -7,4 +7,7 @@
 #include "../script_component.cpp"
 #include "../skeleton_component.cpp"
 #include "../collider_component.cpp"
+#include "../animation_component.cpp"
+#include "../terrain_component.cpp"
+#include "../audio_component.cpp"
 #include "../rigid_body_component.cpp"
@@ -1,3 +1,11 @@
 #include "../camera.cpp"
 #include "../math.cpp"
 #include "../intersect.cpp"
+#include "../bvh.cpp"
+#include "../lod.cpp"
+#include "../terrain.cpp"
+#include "../frustum.cpp"
+#include "../occlusion_buffer.cpp"
+#include "../cpu.cpp"
+#include "../skinning.cpp"
+#include "../animation.cpp"
@@ -1,6 +1,10 @@
 #include "../processor.cpp"
 #include "../render_processor.cpp"
+#include "../fixed_timestep.cpp"
 #include "../physics_processor.cpp"
 #include "../script_processor.cpp"
 #include "../geometry_processor.cpp"
 #include "../debug_processor.cpp"
+#include "../animation_processor.cpp"
+#include "../terrain_processor.cpp"
+#include "../audio_processor.cpp"
@@ -2,8 +2,12 @@
 #include "../file_watch.cpp"
 #include "../core.cpp"
 #include "../performance_counters.cpp"
+#include "../thread_pool.cpp"
+#include "../job_system.cpp"
+#include "../resource_index.cpp"
 #include "../resource_service.cpp"
 #include "../input_service.cpp"
 #include "../resources.cpp"
 #include "../loaders.cpp"
+#include "../mapped_file.cpp"
 #include "../model_loader.cpp"
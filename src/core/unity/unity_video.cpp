@@ -7,10 +7,16 @@
 #include "../renderbuffer.cpp"
 #include "../texture.cpp"
 #include "../video_buffer.cpp"
+#include "../stream_buffer.cpp"
+#include "../vertex_array.cpp"
 #include "../video_service.cpp"
+#include "../render_queue.cpp"
+#include "../bone_palette.cpp"
+#include "../skinning_feedback.cpp"
 #include "../texture_sampler.cpp"
 #include "../gbuffer.cpp"
 #include "../model.cpp"
+#include "../mesh_simplify.cpp"
 #include "../shader.cpp"
 #include "../technique.cpp"
 #include "../uniforms.cpp"
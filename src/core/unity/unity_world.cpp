@@ -1,2 +1,4 @@
 #include "../entity.cpp"
 #include "../world.cpp"
+#include "../component_pool.cpp"
+#include "../component_storage.cpp"
@@ -0,0 +1,197 @@
+#include "vertex_array.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "video_buffer.h"
+#include "model.h"
+#include "constants.h"
+#include "log.h"
+
+namespace atom {
+
+u32 vertex_format_size(VertexFormat format)
+{
+  switch (format) {
+    case VertexFormat::VEC3F:
+      return 3 * sizeof(f32);
+    case VertexFormat::SNORM_NORMAL:
+      return sizeof(u32);
+    case VertexFormat::VEC4U8:
+      return 4 * sizeof(u8);
+    case VertexFormat::UNORM16X4:
+      return 4 * sizeof(u16);
+    default:
+      return 0;
+  }
+}
+
+void VertexLayout::add(u32 location, VertexFormat format)
+{
+  assert(location < MAX_ATTRIBUTES);
+  my_attributes.push_back(VertexAttribute{location, format, my_stride});
+  my_stride += vertex_format_size(format);
+}
+
+const VertexAttribute* VertexLayout::find(u32 location) const
+{
+  for (const VertexAttribute &attribute : my_attributes) {
+    if (attribute.location == location) {
+      return &attribute;
+    }
+  }
+
+  return nullptr;
+}
+
+u32 pack_normal(const Vec3f &normal)
+{
+  u32 packed = 0;
+
+  for (u32 i = 0; i < 3; ++i) {
+    f32 v = std::min(std::max(normal[i], -1.0f), 1.0f);
+    i32 quantized = static_cast<i32>(std::lround(v * 511));
+    packed |= (static_cast<u32>(quantized) & 0x3FF) << (i * 10);
+  }
+
+  return packed;
+}
+
+Vec3f unpack_normal(u32 packed)
+{
+  Vec3f normal;
+
+  for (u32 i = 0; i < 3; ++i) {
+    // sign extension of the 10 bit value
+    i32 quantized = static_cast<i32>(packed << (22 - i * 10)) >> 22;
+    normal[i] = std::max(quantized / 511.0f, -1.0f);
+  }
+
+  return normal;
+}
+
+void pack_weights(const Vec4f &weights, u16 *packed)
+{
+  for (u32 i = 0; i < 4; ++i) {
+    f32 v = std::min(std::max(weights[i], 0.0f), 1.0f);
+    packed[i] = static_cast<u16>(std::lround(v * U16_MAX));
+  }
+}
+
+bool interleave_model_vertices(const Model &model, VertexLayout &layout, std::vector<u8> &data)
+{
+  Slice<f32> vertices = model.find_stream<f32>(MODEL_VERTEX);
+  Slice<f32> normals = model.find_stream<f32>(MODEL_NORMAL);
+  Slice<u32> bone_index = model.find_stream<u32>(MODEL_BONE_INDEX);
+  Slice<f32> bone_weight = model.find_stream<f32>(MODEL_BONE_WEIGHT);
+  u32 count = vertices.size() / 3;
+
+  layout = VertexLayout();
+  data.clear();
+
+  if (count == 0) {
+    return false;
+  }
+
+  bool has_normals = !normals.is_empty();
+  bool has_bones = !bone_index.is_empty() && !bone_weight.is_empty();
+
+  if ((has_normals && normals.size() != count * 3) ||
+      (has_bones && (bone_index.size() != count || bone_weight.size() != count * 4))) {
+    log_error("Model streams have different vertex count");
+    return false;
+  }
+
+  layout.add(POSITION_ATTRIBUTE, VertexFormat::VEC3F);
+
+  if (has_normals) {
+    layout.add(NORMAL_ATTRIBUTE, VertexFormat::SNORM_NORMAL);
+  }
+
+  if (has_bones) {
+    layout.add(BONE_INDEX_ATTRIBUTE, VertexFormat::VEC4U8);
+    layout.add(BONE_WEIGHT_ATTRIBUTE, VertexFormat::UNORM16X4);
+  }
+
+  data.resize(count * layout.stride());
+  u8 *dst = data.data();
+
+  for (u32 i = 0; i < count; ++i) {
+    memcpy(dst, &vertices[i * 3], 3 * sizeof(f32));
+    dst += 3 * sizeof(f32);
+
+    if (has_normals) {
+      u32 normal = pack_normal(Vec3f(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]));
+      memcpy(dst, &normal, sizeof(normal));
+      dst += sizeof(normal);
+    }
+
+    if (has_bones) {
+      // bone indices are already stored as 4 x u8
+      u32 index = bone_index[i];
+      memcpy(dst, &index, sizeof(index));
+      dst += sizeof(index);
+
+      u16 weights[4];
+      pack_weights(Vec4f(bone_weight[i * 4], bone_weight[i * 4 + 1], bone_weight[i * 4 + 2],
+        bone_weight[i * 4 + 3]), weights);
+      memcpy(dst, weights, sizeof(weights));
+      dst += sizeof(weights);
+    }
+  }
+
+  return true;
+}
+
+VertexArray::VertexArray(VideoService &vs, const VideoBuffer &vertices,
+  const VertexLayout &layout, const VideoBuffer *indices)
+  : my_vs(vs)
+  , my_gl_vertex_array(0)
+  , my_layout(layout)
+  , my_instances(0)
+{
+  GL_ERROR_GUARD;
+  glGenVertexArrays(1, &my_gl_vertex_array);
+  my_vs.bind_vertex_array(*this);
+  my_vs.bind_array_buffer(vertices);
+
+  GLsizei stride = my_layout.stride();
+
+  for (const VertexAttribute &attribute : my_layout.attributes()) {
+    const void *offset = reinterpret_cast<const void *>(static_cast<size_t>(attribute.offset));
+    glEnableVertexAttribArray(attribute.location);
+
+    switch (attribute.format) {
+      case VertexFormat::VEC3F:
+        glVertexAttribPointer(attribute.location, 3, GL_FLOAT, GL_FALSE, stride, offset);
+        break;
+
+      case VertexFormat::SNORM_NORMAL:
+        glVertexAttribPointer(attribute.location, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, offset);
+        break;
+
+      case VertexFormat::VEC4U8:
+        glVertexAttribIPointer(attribute.location, 4, GL_UNSIGNED_BYTE, stride, offset);
+        break;
+
+      case VertexFormat::UNORM16X4:
+        glVertexAttribPointer(attribute.location, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, offset);
+        break;
+    }
+  }
+
+  // index buffer binding is a part of the vertex array state
+  if (indices != nullptr) {
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices->gl_buffer());
+  }
+
+  my_vs.unbind_vertex_array();
+  my_vs.unbind_array_buffer();
+}
+
+VertexArray::~VertexArray()
+{
+  my_vs.release_vertex_array(*this);
+  glDeleteVertexArrays(1, &my_gl_vertex_array);
+}
+
+}
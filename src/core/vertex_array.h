@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vector>
+#include "noncopyable.h"
+#include "gl_utils.h"
+#include "video_service.h"
+
+namespace atom {
+
+enum class VertexFormat {
+  VEC3F,          ///< 3 x f32 (12 B)
+  SNORM_NORMAL,   ///< x, y, z in 10 bits signed normalized (GL_INT_2_10_10_10_REV, 4 B)
+  VEC4U8,         ///< 4 x u8 integer attribute (4 B)
+  UNORM16X4       ///< 4 x u16 normalized to <0, 1> (8 B)
+};
+
+u32 vertex_format_size(VertexFormat format);
+
+struct VertexAttribute {
+  u32          location;
+  VertexFormat format;
+  u32          offset;      ///< offset from the start of the vertex in bytes
+};
+
+/**
+ * Layout of the interleaved vertex, attributes are stored in the order of
+ * the add calls.
+ */
+class VertexLayout {
+  std::vector<VertexAttribute> my_attributes;
+  u32                          my_stride;
+
+public:
+  VertexLayout()
+    : my_stride(0)
+  {
+    // empty
+  }
+
+  void add(u32 location, VertexFormat format);
+
+  /**
+   * @return nullptr when the layout doesn't contain the location
+   */
+  const VertexAttribute* find(u32 location) const;
+
+  Slice<VertexAttribute> attributes() const
+  {
+    return Slice<VertexAttribute>(my_attributes.data(), my_attributes.size());
+  }
+
+  /**
+   * Size of one vertex in bytes.
+   */
+  u32 stride() const
+  {
+    return my_stride;
+  }
+};
+
+u32 pack_normal(const Vec3f &normal);
+
+Vec3f unpack_normal(u32 packed);
+
+void pack_weights(const Vec4f &weights, u16 *packed);
+
+/**
+ * Build the interleaved vertex buffer from model streams, layout contains
+ * POSITION_ATTRIBUTE and optionally NORMAL_ATTRIBUTE, BONE_INDEX_ATTRIBUTE and
+ * BONE_WEIGHT_ATTRIBUTE (bone streams are used only together).
+ *
+ * @return false when the model has no vertices or streams have different size
+ */
+bool interleave_model_vertices(const Model &model, VertexLayout &layout, std::vector<u8> &data);
+
+/**
+ * OpenGL vertex array object, it stores attribute layout of the vertex buffer
+ * and the index buffer, so the draw needs only one bind.
+ */
+class VertexArray : NonCopyable {
+  VideoService &my_vs;
+  GLuint        my_gl_vertex_array;
+  VertexLayout  my_layout;
+  GLuint        my_instances;   ///< instance buffer attached to INSTANCE_ATTRIBUTE (0 none)
+
+public:
+  /**
+   * Buffers must outlive the vertex array.
+   */
+  VertexArray(VideoService &vs, const VideoBuffer &vertices, const VertexLayout &layout,
+    const VideoBuffer *indices);
+
+  ~VertexArray();
+
+  GLuint gl_vertex_array() const
+  {
+    return my_gl_vertex_array;
+  }
+
+  const VertexLayout& layout() const
+  {
+    return my_layout;
+  }
+
+  GLuint instances() const
+  {
+    return my_instances;
+  }
+
+  void set_instances(GLuint gl_buffer)
+  {
+    my_instances = gl_buffer;
+  }
+};
+
+}
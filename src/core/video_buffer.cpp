@@ -23,6 +23,7 @@ VideoBuffer::VideoBuffer(VideoBuffer &&buffer)
 
 VideoBuffer::~VideoBuffer()
 {
+  my_vs.release_buffer(*this);
   glDeleteBuffers(1, &my_gl_buffer);
 }
 
@@ -37,6 +38,24 @@ void VideoBuffer::set_bytes(const void *data, u32 size)
   my_vs.unbind_array_buffer();
 }
 
+void VideoBuffer::allocate(u32 size)
+{
+  assert(size > 0);
+  my_size = size;
+  my_vs.bind_array_buffer(*this);
+  glBufferData(GL_ARRAY_BUFFER, size, nullptr, get_gl_usage(my_usage));
+  my_vs.unbind_array_buffer();
+}
+
+void VideoBuffer::get_bytes(void *data, u32 size) const
+{
+  assert(data != nullptr);
+  assert(size <= my_size);
+  my_vs.bind_array_buffer(*this);
+  glGetBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+  my_vs.unbind_array_buffer();
+}
+
 GLenum VideoBuffer::get_gl_usage(VideoBufferUsage usage)
 {
   switch (usage) {
@@ -31,6 +31,16 @@ public:
 
   void set_bytes(const void *data, u32 size);
 
+  /**
+   * Alokuj buffer bez dat (napr. vystup transform feedback).
+   */
+  void allocate(u32 size);
+
+  /**
+   * Precitaj data z OpenGL bufferu, @p size nesmie byt vacsia ako size().
+   */
+  void get_bytes(void *data, u32 size) const;
+
   /**
    * Vrat velkost dat v bytoch.
    */
@@ -7,6 +7,9 @@
 #include "framebuffer.h"
 #include "renderbuffer.h"
 #include "video_buffer.h"
+#include "stream_buffer.h"
+#include "constants.h"
+#include "vertex_array.h"
 #include "texture_sampler.h"
 #include "technique.h"
 #include "gl_utils.h"
@@ -86,6 +89,7 @@ VideoService::VideoService()
 {
   memset(&my_state, 0, sizeof(State));
   // initialize with nullptr
+  reset_stats();
 
   GL_ERROR_GUARD;
 
@@ -100,10 +104,28 @@ VideoService::VideoService()
   glCullFace(GL_BACK);
   // set FillMode::FILL
   glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+  // uniform blocks stay bound to their binding points
+  glGenBuffers(UNIFORM_BLOCK_COUNT, my_block_buffers);
+
+  for (u32 i = 0; i < UNIFORM_BLOCK_COUNT; ++i) {
+    glBindBuffer(GL_UNIFORM_BUFFER, my_block_buffers[i]);
+    glBufferData(GL_UNIFORM_BUFFER, uniform_block_size(i), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, i, my_block_buffers[i]);
+    my_has_block[i] = false;
+  }
+
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  my_stream_buffer.reset(new StreamBuffer(*this, STREAM_BUFFER_SIZE));
 }
 
 VideoService::~VideoService()
 {
+  my_stream_buffer.reset();
+  my_bone_palette.reset();
+  my_bone_buffer.reset();
+  glDeleteBuffers(UNIFORM_BLOCK_COUNT, my_block_buffers);
 }
 
 void VideoService::draw(const DrawCommand &command)
@@ -113,39 +135,115 @@ void VideoService::draw(const DrawCommand &command)
     return;
   }
 
-  for (u32 i = 0; i < MAX_ATTRIBUTES; ++i) {
-    if (command.attributes[i] != nullptr) {
-      bind_attribute(i, *command.attributes[i], command.types[i]);
-    } else {
-      unbind_attribute(i);
+  if (command.vertex_array != nullptr) {
+    // vertex array contains all mesh attributes and the index buffer
+    bind_vertex_array(*command.vertex_array);
+
+    VideoBuffer *instances = command.attributes[INSTANCE_ATTRIBUTE];
+
+    if (command.instance_count > 0 && instances != nullptr) {
+      bind_instances(*command.vertex_array, *instances);
+    }
+  } else {
+    unbind_vertex_array();
+
+    // attributes stay bound after the draw, only changed ones are rebound
+    for (u32 i = 0; i < MAX_ATTRIBUTES; ) {
+      const VideoBuffer *buffer = command.attributes[i];
+
+      if (buffer != nullptr) {
+        if (my_state.attributes[i] != buffer->gl_buffer() ||
+            my_state.attribute_types[i] != command.types[i] ||
+            my_state.attribute_offsets[i] != command.offsets[i]) {
+          bind_attribute(i, *buffer, command.types[i], command.offsets[i]);
+        }
+      } else if (my_state.attributes[i] != 0) {
+        unbind_attribute(i);
+      }
+
+      // matrix columns use the following locations
+      i += buffer != nullptr && command.types[i] == Type::MAT4F ? 4 : 1;
     }
   }
 
   bind_program(*command.program);
-  command.program->pull(meta_object(*my_uniforms));
+  update_uniform_blocks(*command.program);
+  my_stats.uniform_updates += command.program->pull(*my_uniforms);
 
   set_draw_face(command.face);
   set_depth_test(command.depth_test);
   set_fill_mode(command.fill_mode);
 
   if (command.draw == DrawType::TRIANGLES) {
-    draw_index_array(GL_TRIANGLES, *command.indices, command.indices->size() / sizeof(u32));
+    if (command.indices == nullptr) {
+      log_warning("DrawCommand is missing indices");
+      return;
+    }
+
+    u32 count = command.index_count > 0 ? command.index_count
+                                        : command.indices->size() / sizeof(u32);
+    draw_index_array(GL_TRIANGLES, *command.indices, count, command.instance_count,
+      command.first_index);
   } else if (command.draw == DrawType::LINES) {
     if (command.indices != nullptr) {
       not_tested();
       draw_index_array(GL_LINES, *command.indices, command.indices->size() / sizeof(u32));
     } else {
-      draw_arrays(GL_LINES, 0, command.attributes[0]->size() / sizeof(Vec3f));
+      u32 count = command.vertex_count > 0 ? command.vertex_count
+                                           : command.attributes[0]->size() / sizeof(Vec3f);
+      draw_arrays(GL_LINES, 0, count);
     }
   } else {
     log_warning("DrawCommand is missing primitive type");
   }
+}
 
-  for (u32 i = 0; i < MAX_ATTRIBUTES; ++i) {
-    if (command.attributes[i] != nullptr) {
-      unbind_attribute(i);
-    }
+void VideoService::update_uniform_blocks(const Technique &program)
+{
+  if (program.uses_block(FRAME_BLOCK)) {
+    FrameBlock block;
+    my_uniforms->get_frame_block(block);
+    upload_block(FRAME_BLOCK, &block, sizeof(block), &my_frame_block);
+  }
+
+  if (program.uses_block(OBJECT_BLOCK)) {
+    ObjectBlock block;
+    my_uniforms->get_object_block(block);
+    upload_block(OBJECT_BLOCK, &block, sizeof(block), &my_object_block);
+  }
+}
+
+void VideoService::upload_block(u32 block, const void *data, u32 size, void *cache)
+{
+  if (my_has_block[block] && memcmp(cache, data, size) == 0) {
+    return;
+  }
+
+  memcpy(cache, data, size);
+  my_has_block[block] = true;
+
+  glBindBuffer(GL_UNIFORM_BUFFER, my_block_buffers[block]);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+  ++my_stats.uniform_updates;
+}
+
+void VideoService::set_bone_palette(const Slice<Mat4f> &bones)
+{
+  if (bones.size() == 0) {
+    return;
   }
+
+  if (my_bone_palette == nullptr) {
+    my_bone_buffer.reset(new VideoBuffer(*this, VideoBufferUsage::DYNAMIC_DRAW));
+    my_bone_buffer->set_data(bones);
+    my_bone_palette.reset(new Texture(*this));
+    my_bone_palette->init_as_buffer(PixelFormat::RGBA32F, *my_bone_buffer);
+  } else {
+    // texture keeps referencing the buffer, new storage is allocated
+    my_bone_buffer->set_data(bones);
+  }
+
+  bind_texture(BONE_PALETTE_UNIT, *my_bone_palette);
 }
 
 void VideoService::bind_program(Technique &program)
@@ -158,6 +256,7 @@ void VideoService::bind_program(Technique &program)
 
   my_state.program = &program;
   glUseProgram(program.gl_program());
+  ++my_stats.program_switches;
 }
 
 void VideoService::unbind_program()
@@ -171,8 +270,14 @@ void VideoService::bind_texture(u32 index, const Texture &texture)
 {
   assert(index < TEXTURE_UNIT_COUNT);
   GL_ERROR_GUARD;
-  // texture_unit zacina hodnotou 0, preto ho treba skonvertovat na GL_TEXTURE0..i
-  glActiveTexture(GL_TEXTURE0 + index);
+
+  set_texture_unit(index);
+
+  if (my_state.textures[index] == &texture) {
+    return;
+  }
+
+  ++my_stats.texture_binds;
 
   TextureType type = texture.type();
   if (type == TextureType::BUFFER)
@@ -194,8 +299,7 @@ void VideoService::unbind_texture(u32 index)
   const Texture *texture = my_state.textures[index];
 
   if (texture != nullptr) {
-    // texture_unit zacina hodnotou 0, preto ho treba skonvertovat na GL_TEXTURE0..i
-    glActiveTexture(GL_TEXTURE0 + index);
+    set_texture_unit(index);
     TextureType type = texture->type();
     if (type == TextureType::BUFFER) {
       glBindTexture(GL_TEXTURE_BUFFER, 0);
@@ -230,32 +334,63 @@ void VideoService::unbind_sampler(u32 index)
   glBindSampler(index, 0);
 }
 
-void VideoService::bind_attribute(u32 index, const VideoBuffer &buffer, Type type)
+void VideoService::bind_attribute(u32 index, const VideoBuffer &buffer, Type type, u32 offset)
 {
-  glEnableVertexAttribArray(index);
+  unbind_vertex_array();
+
+  bool per_instance = type == Type::MAT4F;
+  u32 locations = per_instance ? 4 : 1;
+  assert(index + locations <= MAX_ATTRIBUTES);
+
+  for (u32 i = index; i < index + locations; ++i) {
+    if (my_state.attributes[i] == 0) {
+      glEnableVertexAttribArray(i);
+    }
+
+    // divisor is a state of the location, it survives glDisableVertexAttribArray
+    if ((my_state.attribute_types[i] == Type::MAT4F) != per_instance) {
+      glVertexAttribDivisor(i, per_instance ? 1 : 0);
+    }
+
+    my_state.attributes[i] = buffer.gl_buffer();
+    my_state.attribute_types[i] = type;
+    my_state.attribute_offsets[i] = offset;
+  }
+
+  const void *start = reinterpret_cast<const void *>(size_t(offset));
+
   bind_array_buffer(buffer);
+  ++my_stats.buffer_binds;
 
   switch (type) {
     case Type::VEC2F:
-      glVertexAttribPointer(index, 2, GL_FLOAT, GL_FALSE, 0, 0);
+      glVertexAttribPointer(index, 2, GL_FLOAT, GL_FALSE, 0, start);
       break;
 
     case Type::VEC3F:
-      glVertexAttribPointer(index, 3, GL_FLOAT, GL_FALSE, 0, 0);
+      glVertexAttribPointer(index, 3, GL_FLOAT, GL_FALSE, 0, start);
       break;
 
     case Type::VEC4F:
-      glVertexAttribPointer(index, 4, GL_FLOAT, GL_FALSE, 0, 0);
+      glVertexAttribPointer(index, 4, GL_FLOAT, GL_FALSE, 0, start);
       break;
 
     case Type::U32:
       // glVertexAttribPointer is intended for float attributes
       // glVertexAttribIPointer is intended for integer attributes
-      glVertexAttribIPointer(index, 1, GL_UNSIGNED_INT, 0, 0);
+      glVertexAttribIPointer(index, 1, GL_UNSIGNED_INT, 0, start);
       break;
 
     case Type::VEC4U8:
-      glVertexAttribIPointer(index, 4, GL_UNSIGNED_BYTE, 0, 0);
+      glVertexAttribIPointer(index, 4, GL_UNSIGNED_BYTE, 0, start);
+      break;
+
+    case Type::MAT4F:
+      // one column per location
+      for (u32 i = 0; i < 4; ++i) {
+        glVertexAttribPointer(index + i, 4, GL_FLOAT, GL_FALSE, sizeof(Mat4f),
+          reinterpret_cast<const void *>(offset + i * sizeof(Vec4f)));
+      }
       break;
 
     default:
@@ -268,7 +403,52 @@ void VideoService::bind_attribute(u32 index, const VideoBuffer &buffer, Type typ
 
 void VideoService::unbind_attribute(u32 index)
 {
+  assert(index < MAX_ATTRIBUTES);
+  unbind_vertex_array();
   glDisableVertexAttribArray(index);
+  my_state.attributes[index] = 0;
+}
+
+void VideoService::bind_vertex_array(const VertexArray &vertex_array)
+{
+  if (my_state.vertex_array == vertex_array.gl_vertex_array()) {
+    return;
+  }
+
+  glBindVertexArray(vertex_array.gl_vertex_array());
+  my_state.vertex_array = vertex_array.gl_vertex_array();
+  ++my_stats.buffer_binds;
+}
+
+void VideoService::unbind_vertex_array()
+{
+  if (my_state.vertex_array != 0) {
+    glBindVertexArray(0);
+    my_state.vertex_array = 0;
+  }
+}
+
+void VideoService::bind_instances(VertexArray &vertex_array, const VideoBuffer &buffer)
+{
+  assert(my_state.vertex_array == vertex_array.gl_vertex_array());
+
+  if (vertex_array.instances() == buffer.gl_buffer()) {
+    return;
+  }
+
+  bind_array_buffer(buffer);
+
+  for (u32 i = 0; i < 4; ++i) {
+    u32 location = INSTANCE_ATTRIBUTE + i;
+    glEnableVertexAttribArray(location);
+    glVertexAttribDivisor(location, 1);
+    glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(Mat4f),
+      reinterpret_cast<const void *>(i * sizeof(Vec4f)));
+  }
+
+  unbind_array_buffer();
+  vertex_array.set_instances(buffer.gl_buffer());
+  ++my_stats.buffer_binds;
 }
 
 void VideoService::bind_array_buffer(const VideoBuffer &buffer)
@@ -404,21 +584,27 @@ void VideoService::disable_blending()
 
 void VideoService::enable_depth_test()
 {
-  glEnable(GL_DEPTH_TEST);
+  set_depth_test(true);
 }
 
 void VideoService::disable_depth_test()
 {
-  glDisable(GL_DEPTH_TEST);
+  set_depth_test(false);
 }
 
 void VideoService::set_depth_test(bool enable)
 {
+  if (enable == my_state.depth_test) {
+    return;
+  }
+
   if (enable) {
     glEnable(GL_DEPTH_TEST);
   } else {
     glDisable(GL_DEPTH_TEST);
   }
+
+  my_state.depth_test = enable;
 }
 
 void set_viewport(int x, int y, int width, int height)
@@ -430,15 +616,51 @@ void VideoService::draw_arrays(GLenum mode, GLint first, GLsizei count)
 {
   /// @todo assert that at least one array is active
   glDrawArrays(mode, first, count);
+  ++my_stats.draws;
 }
 
-void VideoService::draw_index_array(GLenum gl_mode, const VideoBuffer &buffer, u32 count)
+void VideoService::draw_feedback(Technique &program, VertexArray &vertex_array, u32 count,
+  VideoBuffer &output)
 {
   GL_ERROR_GUARD;
 
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.gl_buffer());
-  glDrawElements(gl_mode, count, GL_UNSIGNED_INT, nullptr);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  bind_vertex_array(vertex_array);
+  bind_program(program);
+  update_uniform_blocks(program);
+  my_stats.uniform_updates += program.pull(*my_uniforms);
+
+  glEnable(GL_RASTERIZER_DISCARD);
+  glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, output.gl_buffer());
+  glBeginTransformFeedback(GL_POINTS);
+  glDrawArrays(GL_POINTS, 0, count);
+  glEndTransformFeedback();
+  glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+  glDisable(GL_RASTERIZER_DISCARD);
+  ++my_stats.draws;
+}
+
+void VideoService::draw_index_array(GLenum gl_mode, const VideoBuffer &buffer, u32 count,
+  u32 instance_count, u32 first)
+{
+  GL_ERROR_GUARD;
+
+  // index buffer stays bound for the next draw, vertex array has its own
+  if (my_state.vertex_array == 0 && my_state.index_buffer != buffer.gl_buffer()) {
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.gl_buffer());
+    my_state.index_buffer = buffer.gl_buffer();
+    ++my_stats.buffer_binds;
+  }
+
+  const void *offset = reinterpret_cast<const void *>(size_t(first) * sizeof(u32));
+
+  if (instance_count > 0) {
+    glDrawElementsInstanced(gl_mode, count, GL_UNSIGNED_INT, offset, instance_count);
+    my_stats.instances += instance_count;
+  } else {
+    glDrawElements(gl_mode, count, GL_UNSIGNED_INT, offset);
+  }
+
+  ++my_stats.draws;
 }
 
 Uniforms& VideoService::get_uniforms()
@@ -503,6 +725,69 @@ void VideoService::set_fill_mode(FillMode mode)
   my_state.fill_mode = mode;
 }
 
+void VideoService::release_buffer(const VideoBuffer &buffer)
+{
+  GLuint gl_buffer = buffer.gl_buffer();
+
+  if (gl_buffer == 0) {
+    return;
+  }
+
+  // cached bindings belong to the default vertex array
+  unbind_vertex_array();
+
+  for (u32 i = 0; i < MAX_ATTRIBUTES; ++i) {
+    if (my_state.attributes[i] == gl_buffer) {
+      unbind_attribute(i);
+    }
+  }
+
+  if (my_state.index_buffer == gl_buffer) {
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    my_state.index_buffer = 0;
+  }
+}
+
+void VideoService::release_vertex_array(const VertexArray &vertex_array)
+{
+  if (my_state.vertex_array == vertex_array.gl_vertex_array()) {
+    unbind_vertex_array();
+  }
+}
+
+void VideoService::release_texture(const Texture &texture)
+{
+  for (u32 i = 0; i < TEXTURE_UNIT_COUNT; ++i) {
+    if (my_state.textures[i] == &texture) {
+      unbind_texture(i);
+    }
+  }
+}
+
+void VideoService::set_texture_unit(u32 index)
+{
+  if (my_state.texture_unit != index) {
+    // texture_unit zacina hodnotou 0, preto ho treba skonvertovat na GL_TEXTURE0..i
+    glActiveTexture(GL_TEXTURE0 + index);
+    my_state.texture_unit = index;
+  }
+}
+
+void VideoService::begin_frame()
+{
+  my_stream_buffer->begin_frame();
+}
+
+void VideoService::end_frame()
+{
+  my_stream_buffer->end_frame();
+}
+
+void VideoService::reset_stats()
+{
+  memset(&my_stats, 0, sizeof(my_stats));
+}
+
 AttributeBinder::AttributeBinder(VideoService &vs, int index, const VideoBuffer &buffer, Type type)
   : my_vs(vs)
   , my_index(index)
@@ -2,12 +2,20 @@
 
 #include "gl_utils.h"
 #include "utils.h"
+#include "uniforms.h"
 
 namespace atom {
 
-class Uniforms;
+const u32 MAX_ATTRIBUTES = 16;
 
-const u32 MAX_ATTRIBUTES = 8;
+// vertex attribute locations used by shaders
+const u32 POSITION_ATTRIBUTE = 0;
+const u32 NORMAL_ATTRIBUTE = 1;
+const u32 COLOR_ATTRIBUTE = 2;
+/// first location of the per-instance model matrix (Type::MAT4F, 4 locations)
+const u32 INSTANCE_ATTRIBUTE = 4;
+const u32 BONE_INDEX_ATTRIBUTE = 8;
+const u32 BONE_WEIGHT_ATTRIBUTE = 9;
 
 enum class DrawType {
   NONE,
@@ -27,11 +35,24 @@ enum class FillMode {
   POINT
 };
 
+/**
+ * Attribute of Type::MAT4F occupies 4 consecutive locations and advances once
+ * per instance (glVertexAttribDivisor), it is used with instance_count > 0.
+ *
+ * Vertex array replaces attributes and indices, only the instance attribute
+ * is used together with it.
+ */
 struct DrawCommand {
   VideoBuffer *attributes[MAX_ATTRIBUTES];
   Type         types[MAX_ATTRIBUTES];
+  u32          offsets[MAX_ATTRIBUTES];   ///< attribute data start in the buffer (bytes)
   VideoBuffer *indices;
+  VertexArray *vertex_array;
   Technique   *program;
+  u32          instance_count;  ///< 0 non instanced draw
+  u32          first_index;     ///< first drawn index (level of detail)
+  u32          index_count;     ///< 0 draw all indices
+  u32          vertex_count;    ///< non indexed draw, 0 draw whole attributes[0]
   DrawType     draw;
   DrawFace     face;
   FillMode     fill_mode;
@@ -39,7 +60,12 @@ struct DrawCommand {
 
   DrawCommand()
     : indices(nullptr)
+    , vertex_array(nullptr)
     , program(nullptr)
+    , instance_count(0)
+    , first_index(0)
+    , index_count(0)
+    , vertex_count(0)
     , draw(DrawType::NONE)
     , face(DrawFace::FRONT)
     , fill_mode(FillMode::FILL)
@@ -48,6 +74,7 @@ struct DrawCommand {
     for (u32 i = 0; i < MAX_ATTRIBUTES; ++i) {
       attributes[i] = nullptr;
       types[i] = Type::UNKNOWN;
+      offsets[i] = 0;
     }
     // empty
   }
@@ -67,6 +94,9 @@ inline GLenum framebuffer_target_to_gl(FramebufferTarget target)
 
 const u32 TEXTURE_UNIT_COUNT = 8;
 const u32 TEXTURE_SAMPLER_COUNT = 8;
+/// texture unit of the bone palette, sampler "bone_palette" is set to it at link time
+const u32 BONE_PALETTE_UNIT = TEXTURE_UNIT_COUNT - 1;
+const char BONE_PALETTE_UNIFORM[] = "bone_palette";
 
 enum class BlendOperation : GLenum {
   NO_BLENDING = 0,
@@ -83,6 +113,21 @@ public:
   ~AttributeBinder();
 };
 
+/**
+ * Number of draw calls and state changes since the last reset_stats.
+ */
+struct VideoStats {
+  u32 draws;
+  u32 instances;          ///< objects drawn by instanced draws
+  u32 program_switches;
+  u32 buffer_binds;       ///< vertex array, vertex attribute & index buffer binds
+  u32 texture_binds;
+  u32 uniform_updates;    ///< uniforms & uniform block uploads
+  u32 visible;            ///< objects which passed the frustum culling
+  u32 culled;             ///< objects rejected by the frustum culling
+  u32 occluded;           ///< objects in the frustum hidden by occluders
+};
+
 class VideoService : private NonCopyable {
 public:
   VideoService();
@@ -110,10 +155,21 @@ public:
 
   void unbind_sampler(u32 index);
 
-  void bind_attribute(u32 index, const VideoBuffer &buffer, Type type);
+  /**
+   * @param offset start of the attribute data in @p buffer (bytes)
+   */
+  void bind_attribute(u32 index, const VideoBuffer &buffer, Type type, u32 offset = 0);
 
   void unbind_attribute(u32 index);
 
+  void bind_vertex_array(const VertexArray &vertex_array);
+
+  /**
+   * Bind default vertex array, required before changing attributes with
+   * bind_attribute/unbind_attribute.
+   */
+  void unbind_vertex_array();
+
 //  void bind_texture_buffer(TextureBuffer &texture_buffer);
 
 //  void unbind_texture_buffer();
@@ -168,7 +224,22 @@ public:
 
   void draw_arrays(GLenum mode, GLint first, GLsizei count);
 
-  void draw_index_array(GLenum gl_mode, const VideoBuffer &buffer, u32 count);
+  /**
+   * Run the vertex shader over @p count vertices of the vertex array with
+   * disabled rasterization, outputs are captured by transform feedback.
+   *
+   * @param program technique linked with feedback varyings
+   * @param output receives interleaved varyings of all vertices
+   */
+  void draw_feedback(Technique &program, VertexArray &vertex_array, u32 count,
+    VideoBuffer &output);
+
+  /**
+   * @param instance_count 0 draws without instancing (glDrawElements)
+   * @param first first index in @p buffer
+   */
+  void draw_index_array(GLenum gl_mode, const VideoBuffer &buffer, u32 count,
+    u32 instance_count = 0, u32 first = 0);
 
   Uniforms& get_uniforms();
 
@@ -176,8 +247,71 @@ public:
 
   void set_fill_mode(FillMode mode);
 
+  /**
+   * Forget cached bindings of the buffer (called before the buffer is deleted).
+   */
+  void release_buffer(const VideoBuffer &buffer);
+
+  /**
+   * Unbind the texture from all units (called before the texture is deleted).
+   */
+  void release_texture(const Texture &texture);
+
+  /**
+   * Upload bone matrices of all skeletons drawn in the frame (BonePalette) and
+   * bind them to BONE_PALETTE_UNIT as RGBA32F texture buffer (4 texels per matrix).
+   */
+  void set_bone_palette(const Slice<Mat4f> &bones);
+
+  /**
+   * Unbind the vertex array (called before the vertex array is deleted).
+   */
+  void release_vertex_array(const VertexArray &vertex_array);
+
+  /**
+   * Per frame vertex data, ranges written in the frame stay valid until the
+   * frame is drawn.
+   */
+  StreamBuffer& stream_buffer()
+  {
+    return *my_stream_buffer;
+  }
+
+  /**
+   * Start writing stream buffer data of the new frame.
+   */
+  void begin_frame();
+
+  /**
+   * Call after the last draw of the frame.
+   */
+  void end_frame();
+
+  const VideoStats& stats() const
+  {
+    return my_stats;
+  }
+
+  void reset_stats();
+
+  /**
+   * Count result of the frustum & occlusion culling (RenderProcessor).
+   */
+  void add_culling_stats(u32 visible, u32 culled, u32 occluded)
+  {
+    my_stats.visible += visible;
+    my_stats.culled += culled;
+    my_stats.occluded += occluded;
+  }
+
   struct State {
     Technique            *program;
+    GLuint                vertex_array;   ///< 0 default vertex array, attributes describe its state
+    GLuint                attributes[MAX_ATTRIBUTES];   ///< buffer of enabled attribute (0 disabled)
+    Type                  attribute_types[MAX_ATTRIBUTES];  ///< MAT4F locations have divisor 1
+    u32                   attribute_offsets[MAX_ATTRIBUTES];
+    GLuint                index_buffer;
+    u32                   texture_unit;   ///< active texture unit
     const Texture        *textures[TEXTURE_UNIT_COUNT];
     const TextureSampler *samplers[TEXTURE_SAMPLER_COUNT];
     Renderbuffer         *renderbuffer;
@@ -185,11 +319,37 @@ public:
     Framebuffer          *write_framebuffer;
     FillMode              fill_mode;
     DrawFace              draw_face;
+    bool                  depth_test;
   };
 
 private:
+  void set_texture_unit(u32 index);
+
+  /**
+   * Attach instance matrices to the bound vertex array.
+   */
+  void bind_instances(VertexArray &vertex_array, const VideoBuffer &buffer);
+
+  /**
+   * Upload blocks used by the program, unchanged blocks are skipped.
+   */
+  void update_uniform_blocks(const Technique &program);
+
+  /**
+   * @param cache last uploaded data, unchanged block isn't uploaded
+   */
+  void upload_block(u32 block, const void *data, u32 size, void *cache);
+
   State          my_state;
+  VideoStats     my_stats;
   uptr<Uniforms> my_uniforms;
+  GLuint         my_block_buffers[UNIFORM_BLOCK_COUNT];
+  FrameBlock     my_frame_block;    ///< uploaded block data
+  ObjectBlock    my_object_block;
+  bool           my_has_block[UNIFORM_BLOCK_COUNT];  ///< block cache is valid
+  uptr<VideoBuffer> my_bone_buffer;
+  uptr<Texture>     my_bone_palette;  ///< texture buffer view of my_bone_buffer
+  uptr<StreamBuffer> my_stream_buffer;
 };
 
 
@@ -7,7 +7,12 @@
 #include "script_processor.h"
 #include "geometry_processor.h"
 #include "debug_processor.h"
+#include "animation_processor.h"
+#include "terrain_processor.h"
+#include "audio_processor.h"
 #include "utils.h"
+#include "core.h"
+#include "job_system.h"
 
 namespace atom {
 
@@ -104,10 +109,17 @@ void World::deactivate()
 
 void World::tick()
 {
-  my_processors.physics->poll();
-  my_processors.geometry->poll();
-  my_processors.script->poll();
-  my_processors.debug->poll();
+  Processor *processors[] = {
+    my_processors.terrain.get(),
+    my_processors.physics.get(),
+    my_processors.animation.get(),
+    my_processors.geometry.get(),
+    my_processors.script.get(),
+    my_processors.audio.get(),
+    my_processors.debug.get()
+  };
+
+  poll_processors(processors, sizeof(processors) / sizeof(processors[0]));
 
   if (my_is_live) {
     ++my_tick;
@@ -159,6 +171,60 @@ void World::unregister_processor(Processor *processor)
   utils::erase_remove(my_processor_table, processor);
 }
 
+ComponentHandle World::register_component(Component *component)
+{
+  assert(component != nullptr);
+  return my_components[static_cast<u32>(component->type())].add(component);
+}
+
+void World::unregister_component(Component *component)
+{
+  assert(component != nullptr);
+  my_components[static_cast<u32>(component->type())].remove(component->handle());
+}
+
+const ComponentPool& World::component_pool(ComponentType type) const
+{
+  assert(static_cast<u32>(type) < COMPONENT_TYPE_COUNT);
+  return my_components[static_cast<u32>(type)];
+}
+
+void World::poll_processors(Processor **processors, u32 count)
+{
+  std::vector<ProcessorAccess> access;
+
+  for (u32 i = 0; i < count; ++i) {
+    access.push_back(processors[i]->access());
+  }
+
+  std::vector<u32> levels;
+  u32 level_count = schedule_processors(access, levels);
+  JobSystem &jobs = my_core.job_system();
+
+  // processors of one level run in parallel, levels keep the poll order
+  for (u32 level = 0; level < level_count; ++level) {
+    JobCounter counter;
+    Processor *local = nullptr;
+
+    // the last processor of the level is polled by this thread (in the
+    // deterministic mode jobs run immediately, so poll order is kept)
+    for (u32 i = 0; i < count; ++i) {
+      if (levels[i] != level) {
+        continue;
+      }
+
+      if (local != nullptr) {
+        jobs.run([local] { local->poll(); }, counter);
+      }
+
+      local = processors[i];
+    }
+
+    local->poll();
+    jobs.wait(counter);
+  }
+}
+
 void World::init_processors()
 {
   my_processors.video.reset(new RenderProcessor(*this));
@@ -166,10 +232,14 @@ void World::init_processors()
   my_processors.script.reset(new ScriptProcessor(*this));
   my_processors.geometry.reset(new GeometryProcessor(*this));
   my_processors.debug.reset(new DebugProcessor(*this));
+  my_processors.animation.reset(new AnimationProcessor(*this));
+  my_processors.terrain.reset(new TerrainProcessor(*this));
+  my_processors.audio.reset(new AudioProcessor(*this));
 
   my_processors_ref.reset(new WorldProcessorsRef(*my_processors.video,
     *my_processors.physics, *my_processors.script, *my_processors.geometry,
-    *my_processors.debug));
+    *my_processors.debug, *my_processors.animation, *my_processors.terrain,
+    *my_processors.audio));
 }
 
 void World::init()
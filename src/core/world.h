@@ -22,6 +22,9 @@ struct WorldProcessors {
   uptr<ScriptProcessor>   script;
   uptr<GeometryProcessor> geometry;
   uptr<DebugProcessor>    debug;
+  uptr<AnimationProcessor> animation;
+  uptr<TerrainProcessor>  terrain;
+  uptr<AudioProcessor>    audio;
 };
 
 /// referencie na processory, umoznuju pohodlny pristup pomocou jednej metody processors()
@@ -31,14 +34,21 @@ struct WorldProcessorsRef {
   ScriptProcessor   &script;
   GeometryProcessor &geometry;
   DebugProcessor    &debug;
+  AnimationProcessor &animation;
+  TerrainProcessor  &terrain;
+  AudioProcessor    &audio;
 
   WorldProcessorsRef(RenderProcessor &vp, PhysicsProcessor &pp,
-    ScriptProcessor &sp, GeometryProcessor &gp, DebugProcessor &dp)
+    ScriptProcessor &sp, GeometryProcessor &gp, DebugProcessor &dp,
+    AnimationProcessor &ap, TerrainProcessor &tp, AudioProcessor &aup)
     : video(vp)
     , physics(pp)
     , script(sp)
     , geometry(gp)
     , debug(dp)
+    , animation(ap)
+    , terrain(tp)
+    , audio(aup)
   {
     // empty
   }
@@ -62,6 +72,7 @@ class World {
   WorldProcessors           my_processors;
   uptr<WorldProcessorsRef>  my_processors_ref;
   std::vector<sptr<Entity>> my_entities;
+  ComponentPool             my_components[COMPONENT_TYPE_COUNT];  ///< attached components by type
 
 public:
   static sptr<World> create(Core &core);
@@ -114,12 +125,45 @@ public:
 
   void unregister_processor(Processor *processor);
 
+  /**
+   * Add component to the pool of its type (called from Component::attach).
+   */
+  ComponentHandle register_component(Component *component);
+
+  void unregister_component(Component *component);
+
+  const ComponentPool& component_pool(ComponentType type) const;
+
+  /**
+   * Packed array of all attached components of type T.
+   */
+  template<typename T>
+  ComponentRange<T> components() const
+  {
+    return component_pool(component_type_of<T>()).template view<T>();
+  }
+
+  /**
+   * @return component or nullptr when the handle is no longer valid
+   */
+  template<typename T>
+  T* get_component(ComponentHandle handle) const
+  {
+    return static_cast<T *>(component_pool(component_type_of<T>()).get(handle));
+  }
+
 private:
   /**
    * Inicializuj jednotlive procesory (a inicializuj referencie na ne).
    */
   void init_processors();
 
+  /**
+   * Poll processors, independent processors (see Processor::access) are
+   * polled in parallel.
+   */
+  void poll_processors(Processor **processors, u32 count);
+
   void init();
 
   void terminate();
@@ -11,6 +11,7 @@
 #include <core/input_service.h>
 #include <core/audio_service.h>
 #include <core/resource_service.h>
+#include <core/video_service.h>
 #include <core/json_utils.h>
 #include <core/debug_processor.h>
 #include "editor/ui_editor_window.h"
@@ -305,6 +306,10 @@ void EditorWindow::update_world()
   app.core().update();
   app.core().input_service().poll();
 
+  // stream buffer data are written in tick and used in GameView::paintGL
+  my_game_view->makeCurrent();
+  app.core().video_service().begin_frame();
+
   switch (my_mode) {
     case EditorWindowMode::EDIT:
       app.world()->tick();
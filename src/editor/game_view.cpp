@@ -227,6 +227,7 @@ void GameView::paintGL()
 
   core.video_service().unbind_write_framebuffer();
   my_world->processors().video.get_gbuffer().blit();
+  core.video_service().end_frame();
 }
 
 void GameView::resizeGL(int w, int h)
@@ -12,6 +12,8 @@
 #include <core/rigid_body_component.h>
 #include <core/geometry_component.h>
 #include <core/model_component.h>
+#include <core/terrain_component.h>
+#include <core/audio_component.h>
 #include <core/model.h>
 #include <core/mesh.h>
 #include "game_frame.h"
@@ -31,11 +33,17 @@ class SkeletonBodyScript : public ScriptComponent {
   std::vector<Vec3f>      my_last_vertices;
   MeshResourcePtr         my_mesh_resource;
   bool                    my_is_initialized;
-  VideoBuffer            *my_mesh_vertices;
 
   void on_update() override
   {
-    const Model &model = my_model->get_model()->model();
+    ModelResourcePtr resource = my_model->get_model();
+
+    // model is loading
+    if (resource == nullptr) {
+      return;
+    }
+
+    const Model &model = resource->model();
 
     Slice<f32> vertex_stream = model.find_stream<f32>(MODEL_VERTEX);
     Slice<f32> bweight_stream = model.find_stream<f32>(MODEL_BONE_WEIGHT);
@@ -47,14 +55,11 @@ class SkeletonBodyScript : public ScriptComponent {
       Mesh *mesh = my_mesh_resource->data();
 
       uptr<VideoBuffer> mesh_indices(new VideoBuffer(core().video_service(), VideoBufferUsage::STATIC_DRAW));
-      uptr<VideoBuffer> mesh_vertices(new VideoBuffer(core().video_service(), VideoBufferUsage::DYNAMIC_DRAW));
 
       mesh_indices->set_data(index_stream);
 
-      mesh->vertex = std::move(mesh_vertices);
+      // skinned vertices are written to the stream buffer every frame
       mesh->surface = std::move(mesh_indices);
-      my_mesh_vertices = mesh->vertex.get();
-      my_mesh_vertices->set_data(vertex_stream);
       my_mesh->set_mesh(my_mesh_resource);
       my_render->set_enabled(true);
     }
@@ -96,9 +101,10 @@ class SkeletonBodyScript : public ScriptComponent {
       const Vec3f v2 = (m2 * v * weight[2]).xyz();
       const Vec3f v3 = (m3 * v * weight[3]).xyz();
       my_vertices.push_back(v0 + v1 + v2 + v3);
-
-      my_mesh_vertices->set_data(to_slice(my_vertices));
     }
+
+    my_mesh_resource->data()->stream_vertex =
+      core().video_service().stream_buffer().write(to_slice(my_vertices));
   }
 
 public:
@@ -108,7 +114,6 @@ public:
     , my_mesh(this)
     , my_render(this)
     , my_is_initialized(false)
-    , my_mesh_vertices(nullptr)
   {
     my_mesh_resource.reset(new MeshResource());
     my_mesh_resource->set_data(uptr<Mesh>(new Mesh()));
@@ -122,6 +127,11 @@ class AnimalScript : public ScriptComponent {
 
   void on_update() override
   {
+    // model is loading
+    if (my_skeleton->bone_count() == 0) {
+      return;
+    }
+
     ++my_tick;
     f32 angle1 = my_tick / 10.0f;
     f32 angle2 = sin(angle1) / 30;
@@ -161,20 +171,14 @@ uptr<Entity> create_test_object(World &world, Core &core)
 {
   uptr<Entity> entity(new Entity(world, core));
   // suzanne
-  uptr<ModelComponent> model(new ModelComponent());
-  model->set_model(core.resource_service().get_model("animal"));
-  uptr<MaterialComponent> material(new MaterialComponent());
+  ModelComponent *model = entity->add_component<ModelComponent>();
+  model->set_model(core.resource_service().get_model_async("animal"));
+  MaterialComponent *material = entity->add_component<MaterialComponent>();
   material->set_material(core.resource_service().get_material("animal"));
-  uptr<MeshComponent> mesh(new MeshComponent());
-  uptr<SkeletonComponent> skeleton(new SkeletonComponent());
-  uptr<RenderComponent> render(new RenderComponent());
-  uptr<ScriptComponent> script(new AnimalScript());
-  entity->add_component(std::move(model));
-  entity->add_component(std::move(material));
-  entity->add_component(std::move(mesh));
-  entity->add_component(std::move(skeleton));
-  entity->add_component(std::move(render));
-  entity->add_component(std::move(script));
+  entity->add_component<MeshComponent>();
+  entity->add_component<SkeletonComponent>();
+  entity->add_component<RenderComponent>();
+  entity->add_component<AnimalScript>();
   return entity;
 }
 
@@ -182,69 +186,49 @@ uptr<Entity> create_test_object(World &world, Core &core)
 uptr<Entity> create_monster(World &world, Core &core)
 {
   uptr<Entity> entity(new Entity(world, core));
-  uptr<ModelComponent> model(new ModelComponent());
-  model->set_model(core.resource_service().get_model("monster"));
-  uptr<MaterialComponent> material(new MaterialComponent());
+  entity->set_bounding_box(BoundingBox(-20, 20, -20, 20, 0, 20));
+  ModelComponent *model = entity->add_component<ModelComponent>();
+  model->set_model(core.resource_service().get_model_async("monster"));
+  MaterialComponent *material = entity->add_component<MaterialComponent>();
   material->set_material(core.resource_service().get_material("flat"));
-  uptr<MeshComponent> mesh(new MeshComponent());
-  uptr<SkeletonComponent> skeleton(new SkeletonComponent());
-  uptr<GeometryComponent> geometry(new GeometryComponent());
+  entity->add_component<MeshComponent>();
+  entity->add_component<SkeletonComponent>();
+  GeometryComponent *geometry = entity->add_component<GeometryComponent>();
   geometry->set_dynamic(true);
   geometry->set_categories(CollisionMask::ENEMY);
-  uptr<RenderComponent> render(new RenderComponent());
-  uptr<ScriptComponent> script(new MonsterScript());
-  entity->set_bounding_box(BoundingBox(-20, 20, -20, 20, 0, 20));
-  entity->add_component(std::move(model));
-  entity->add_component(std::move(material));
-  entity->add_component(std::move(mesh));
-  entity->add_component(std::move(skeleton));
-  entity->add_component(std::move(geometry));
-  entity->add_component(std::move(script));
-  entity->add_component(std::move(render));
+  entity->add_component<MonsterScript>();
+  entity->add_component<RenderComponent>();
   return entity;
 }
 
 uptr<Entity> create_track(World &world, Core &core)
 {
   uptr<Entity> entity(new Entity(world, core));
-  uptr<ModelComponent> model(new ModelComponent());
-  model->set_model(core.resource_service().get_model("track"));
-  uptr<MaterialComponent> material(new MaterialComponent());
-  material->set_material(core.resource_service().get_material("road"));
-  uptr<MeshComponent> mesh(new MeshComponent());
-  uptr<SkeletonComponent> skeleton(new SkeletonComponent());
-  uptr<GeometryComponent> geometry(new GeometryComponent());
-  uptr<RenderComponent> render(new RenderComponent());
   entity->set_bounding_box(BoundingBox(-20, 20, -20, 20, 0, 20));
-  entity->add_component(std::move(model));
-  entity->add_component(std::move(material));
-  entity->add_component(std::move(mesh));
-  entity->add_component(std::move(geometry));
-  entity->add_component(std::move(render));
+  ModelComponent *model = entity->add_component<ModelComponent>();
+  model->set_model(core.resource_service().get_model_async("track"));
+  MaterialComponent *material = entity->add_component<MaterialComponent>();
+  material->set_material(core.resource_service().get_material("road"));
+  entity->add_component<MeshComponent>();
+  entity->add_component<GeometryComponent>();
+  entity->add_component<RenderComponent>();
   return entity;
 }
 
 uptr<Entity> create_manual_monster(World &world, Core &core)
 {
   uptr<Entity> entity(new Entity(world, core));
-  uptr<ModelComponent> model(new ModelComponent());
-  model->set_model(core.resource_service().get_model("monster"));
-  uptr<MaterialComponent> material(new MaterialComponent());
+  ModelComponent *model = entity->add_component<ModelComponent>();
+  model->set_model(core.resource_service().get_model_async("monster"));
+  MaterialComponent *material = entity->add_component<MaterialComponent>();
   material->set_material(core.resource_service().get_material("manual"));
-  uptr<MeshComponent> mesh(new MeshComponent());
+  MeshComponent *mesh = entity->add_component<MeshComponent>();
   mesh->set_mode(MeshComponentMode::MANUAL);
-  uptr<SkeletonComponent> skeleton(new SkeletonComponent());
-  uptr<RenderComponent> render(new RenderComponent());
+  entity->add_component<SkeletonComponent>();
+  entity->add_component<SkeletonBodyScript>();
+  entity->add_component<MonsterScript>();
+  RenderComponent *render = entity->add_component<RenderComponent>();
   render->set_enabled(false);
-  uptr<ScriptComponent> skeleton_script(new MonsterScript());
-  uptr<SkeletonBodyScript> script(new SkeletonBodyScript());
-  entity->add_component(std::move(model));
-  entity->add_component(std::move(material));
-  entity->add_component(std::move(mesh));
-  entity->add_component(std::move(skeleton));
-  entity->add_component(std::move(script));
-  entity->add_component(std::move(skeleton_script));
-  entity->add_component(std::move(render));
   return entity;
 }
 
@@ -252,24 +236,36 @@ uptr<Entity> create_manual_monster(World &world, Core &core)
 uptr<Entity> create_ground(World &world, Core &core)
 {
   uptr<Entity> entity(new Entity(world, core));
-  uptr<PlaneColliderComponent> collider(new PlaneColliderComponent());
+  PlaneColliderComponent *collider = entity->add_component<PlaneColliderComponent>();
   collider->set_plane(Vec3f(0, 0, 1), 0);
-  uptr<RigidBodyComponent> rigid_body(new RigidBodyComponent());
+  RigidBodyComponent *rigid_body = entity->add_component<RigidBodyComponent>();
   rigid_body->set_body_type(RigidBodyType::STATIC);
   rigid_body->set_mass(0);
-  entity->add_component(std::move(collider));
-  entity->add_component(std::move(rigid_body));
   return entity;
 }
 
 uptr<Entity> create_box(World &world, Core &core)
 {
   uptr<Entity> entity(new Entity(world, core));
-  uptr<BoxColliderComponent> collider(new BoxColliderComponent());
+  BoxColliderComponent *collider = entity->add_component<BoxColliderComponent>();
   collider->set_size(Vec3f(1, 1, 1));
-  uptr<RigidBodyComponent> rigid_body(new RigidBodyComponent());
-  entity->add_component(std::move(collider));
-  entity->add_component(std::move(rigid_body));
+  entity->add_component<RigidBodyComponent>();
+  return entity;
+}
+
+/**
+ * Static wall, its model hides objects behind it (occlusion culling).
+ */
+uptr<Entity> create_wall(World &world, Core &core)
+{
+  uptr<Entity> entity(new Entity(world, core));
+  ModelComponent *model = entity->add_component<ModelComponent>();
+  model->set_model(core.resource_service().get_model_async("cube"));
+  MaterialComponent *material = entity->add_component<MaterialComponent>();
+  material->set_material(core.resource_service().get_material("flat"));
+  entity->add_component<MeshComponent>();
+  RenderComponent *render = entity->add_component<RenderComponent>();
+  render->set_occluder(true);
   return entity;
 }
 
@@ -277,54 +273,67 @@ uptr<Entity> create_suzanne(World &world, Core &core)
 {
   uptr<Entity> entity(new Entity(world, core));
   // suzanne
-  uptr<ModelComponent> model(new ModelComponent());
-  model->set_model(core.resource_service().get_model("suzzane"));
-  uptr<MaterialComponent> material(new MaterialComponent());
+  ModelComponent *model = entity->add_component<ModelComponent>();
+  model->set_model(core.resource_service().get_model_async("suzzane"));
+  MaterialComponent *material = entity->add_component<MaterialComponent>();
   material->set_material(core.resource_service().get_material("flat"));
-  uptr<MeshComponent> mesh(new MeshComponent());
-  uptr<RenderComponent> render(new RenderComponent());
-  entity->add_component(std::move(model));
-  entity->add_component(std::move(material));
-  entity->add_component(std::move(mesh));
-  entity->add_component(std::move(render));
+  entity->add_component<MeshComponent>();
+  entity->add_component<RenderComponent>();
   return entity;
 }
 
 uptr<Entity> create_flat_terrain(World &world, Core &core)
 {
   uptr<Entity> entity(new Entity(world, core));
-  uptr<ModelComponent> model(new ModelComponent());
-  model->set_model(core.resource_service().get_model("quad_terrain"));
-  uptr<MaterialComponent> material(new MaterialComponent());
+  ModelComponent *model = entity->add_component<ModelComponent>();
+  model->set_model(core.resource_service().get_model_async("quad_terrain"));
+  MaterialComponent *material = entity->add_component<MaterialComponent>();
   material->set_material(core.resource_service().get_material("terrain"));
-  uptr<MeshComponent> mesh(new MeshComponent());
-  uptr<RenderComponent> render(new RenderComponent());
-  uptr<GeometryComponent> geometry(new GeometryComponent());
+  entity->add_component<MeshComponent>();
+  entity->add_component<RenderComponent>();
+  GeometryComponent *geometry = entity->add_component<GeometryComponent>();
   geometry->set_categories(CollisionMask::WORLD);
-  entity->add_component(std::move(model));
-  entity->add_component(std::move(material));
-  entity->add_component(std::move(mesh));
-  entity->add_component(std::move(render));
-  entity->add_component(std::move(geometry));
   return entity;
 }
 
 uptr<Entity> create_bumpy_terrain(World &world, Core &core)
 {
   uptr<Entity> entity(new Entity(world, core));
-  uptr<ModelComponent> model(new ModelComponent());
-  model->set_model(core.resource_service().get_model("bumpy_terrain"));
-  uptr<MaterialComponent> material(new MaterialComponent());
+  ModelComponent *model = entity->add_component<ModelComponent>();
+  model->set_model(core.resource_service().get_model_async("bumpy_terrain"));
+  MaterialComponent *material = entity->add_component<MaterialComponent>();
   material->set_material(core.resource_service().get_material("terrain"));
-  uptr<MeshComponent> mesh(new MeshComponent());
-  uptr<RenderComponent> render(new RenderComponent());
-  uptr<GeometryComponent> geometry(new GeometryComponent());
+  entity->add_component<MeshComponent>();
+  entity->add_component<RenderComponent>();
+  GeometryComponent *geometry = entity->add_component<GeometryComponent>();
   geometry->set_categories(CollisionMask::WORLD);
-  entity->add_component(std::move(model));
-  entity->add_component(std::move(material));
-  entity->add_component(std::move(mesh));
-  entity->add_component(std::move(render));
-  entity->add_component(std::move(geometry));
+  return entity;
+}
+
+/**
+ * Terrain paged around the camera from tiles "terrain_tile_<x>_<y>".
+ */
+uptr<Entity> create_streamed_terrain(World &world, Core &core)
+{
+  uptr<Entity> entity(new Entity(world, core));
+  TerrainComponent *terrain = entity->add_component<TerrainComponent>();
+  terrain->set_tiles("terrain_tile");
+  terrain->set_material("terrain");
+  terrain->set_categories(CollisionMask::WORLD);
+  return entity;
+}
+
+/**
+ * Looping positional sound, audible up to 30 units.
+ */
+uptr<Entity> create_sound_source(World &world, Core &core)
+{
+  uptr<Entity> entity(new Entity(world, core));
+  AudioComponent *audio = entity->add_component<AudioComponent>();
+  audio->set_sound("falling_platform");
+  audio->set_distance(2, 30);
+  audio->set_rolloff(AudioRolloff::LINEAR);
+  audio->set_repeat(true);
   return entity;
 }
 
@@ -335,8 +344,11 @@ const EntityDefinition entity_creators[] = {
   { "ManualMonster", create_manual_monster },
   { "Ground", create_ground },
   { "Box", create_box },
+  { "Wall", create_wall },
   { "FlatTerrain", create_flat_terrain },
   { "BumpyTerrain", create_bumpy_terrain },
+  { "StreamedTerrain", create_streamed_terrain },
+  { "SoundSource", create_sound_source },
   { "Player", create_player },
   { "Track", create_track },
   { nullptr, nullptr }
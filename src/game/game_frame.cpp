@@ -60,6 +60,9 @@ bool load_level_from_file(const String &filename, Core &core, World &world)
   const rapidjson::Value &entities = doc["entities"];
 
   u32 count = entities.Size();
+  // entities are created first (models are loaded asynchronously) and added to
+  // the world later, so the model decoding overlaps
+  std::vector<sptr<Entity>> created;
 
   for (uint i = 0; i < count; ++i) {
     const rapidjson::Value &obj = entities[i];
@@ -102,6 +105,10 @@ bool load_level_from_file(const String &filename, Core &core, World &world)
       }
     }
 
+    created.push_back(entity);
+  }
+
+  for (const sptr<Entity> &entity : created) {
     world.add_entity(entity);
   }
 
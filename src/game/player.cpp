@@ -201,17 +201,13 @@ META_CLASS(PlayerScript,
 uptr<Entity> create_player(World &world, Core &core)
 {
   uptr<Entity> entity(new Entity(world, core));
-  uptr<ModelComponent> model(new ModelComponent());
-  model->set_model(core.resource_service().get_model("monkey_rider"));
-  entity->add_component(std::move(model));
-  uptr<MaterialComponent> material(new MaterialComponent());
+  ModelComponent *model = entity->add_component<ModelComponent>();
+  model->set_model(core.resource_service().get_model_async("monkey_rider"));
+  MaterialComponent *material = entity->add_component<MaterialComponent>();
   material->set_material(core.resource_service().get_material("player"));
-  entity->add_component(std::move(material));
-  entity->add_component(uptr<Component>(new MeshComponent()));
-  entity->add_component(uptr<Component>(new RenderComponent()));
-
-  uptr<PlayerScript> script(new PlayerScript());
-  entity->add_component(std::move(script));
+  entity->add_component<MeshComponent>();
+  entity->add_component<RenderComponent>();
+  entity->add_component<PlayerScript>();
   return entity;
 }
 
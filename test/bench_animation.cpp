@@ -0,0 +1,96 @@
+#include <core/animation.h>
+#include <core/skeleton_component.h>
+#include <core/constants.h>
+#include <core/log.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+
+namespace atom {
+
+/**
+ * Compressed clip size and pose evaluation time of 100 characters (two
+ * blended layers, bone transforms).
+ */
+TEST(AnimationBenchmark, ClipsAndPoses)
+{
+  const u32 BONE_COUNT = 64;
+  const u32 FRAME_COUNT = 120;
+  const u32 CHARACTER_COUNT = 100;
+  const u32 ROUNDS = 100;
+
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<f32> phase(0, 6);
+  std::vector<RawAnimationClip> raw(2);
+  const char *names[] = { "walk", "wave" };
+
+  for (u32 c = 0; c < raw.size(); ++c) {
+    raw[c].name = names[c];
+    raw[c].fps = 30;
+    raw[c].frame_count = FRAME_COUNT;
+
+    for (u32 b = 0; b < BONE_COUNT; ++b) {
+      RawAnimationTrack track;
+      track.bone = b;
+      f32 p = phase(gen);
+
+      for (u32 f = 0; f < FRAME_COUNT; ++f) {
+        track.frames.push_back(Quatf::from_axis_angle(Vec3f(1, 0, 0), 0.5f * std::sin(p + f * 0.05f))
+          * Quatf::from_axis_angle(Vec3f(0, 0, 1), 0.3f * std::cos(p + f * 0.03f)));
+      }
+
+      raw[c].tracks.push_back(std::move(track));
+    }
+  }
+
+  std::vector<u8> data;
+  ASSERT_TRUE(compress_animations(raw, ANIMATION_KEY_TOLERANCE, data));
+  std::vector<AnimationClip> clips;
+  ASSERT_TRUE(parse_animations(Slice<u8>(data.data(), data.size()), BONE_COUNT, clips));
+
+  for (const AnimationClip &clip : clips) {
+    log_info("Animation clip \"%s\": %u bones, %u frames, raw %u B, compressed %u B (%u keys)",
+      clip.name().c_str(), BONE_COUNT, FRAME_COUNT,
+      static_cast<u32>(BONE_COUNT * FRAME_COUNT * sizeof(Quatf)), clip.memory_size(),
+      clip.key_count());
+  }
+
+  // chain skeleton
+  std::vector<Bone> bones(BONE_COUNT);
+
+  for (u32 i = 0; i < BONE_COUNT; ++i) {
+    bones[i].parent = static_cast<i32>(i) - 1;
+    bones[i].local_head = Vec3f(0, 0, i * 0.1f);
+  }
+
+  std::vector<u32> order;
+  sort_bones(bones, order);
+  std::vector<u8> dirty(BONE_COUNT, 1);
+  std::vector<Mat4f> transforms;
+  std::vector<Quatf> pose(BONE_COUNT);
+
+  typedef std::chrono::high_resolution_clock Clock;
+  Clock::time_point start = Clock::now();
+
+  for (u32 r = 0; r < ROUNDS; ++r) {
+    for (u32 c = 0; c < CHARACTER_COUNT; ++c) {
+      f32 time = (r + c) / 30.0f;
+      pose.assign(BONE_COUNT, Quatf());
+      clips[0].sample(time, true, 1, pose.data(), BONE_COUNT);
+      clips[1].sample(time, true, 0.5f, pose.data(), BONE_COUNT);
+
+      for (u32 b = 0; b < BONE_COUNT; ++b) {
+        bones[b].transform = pose[b];
+      }
+
+      dirty.assign(BONE_COUNT, 1);
+      update_bone_transforms(bones, order, dirty, transforms);
+    }
+  }
+
+  f64 seconds = std::chrono::duration_cast<std::chrono::duration<f64>>(Clock::now() - start).count();
+  log_info("Animation of %u characters (%u bones, 2 layers): %.3f ms per frame",
+    CHARACTER_COUNT, BONE_COUNT, seconds * 1000 / ROUNDS);
+}
+
+}
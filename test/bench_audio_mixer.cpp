@@ -0,0 +1,80 @@
+#include <core/audio_mixer.h>
+#include <core/constants.h>
+#include <core/resources.h>
+#include <core/sound.h>
+#include <core/log.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace atom {
+
+/**
+ * Play 32 looping tracks into device sized buffers without an audio device,
+ * AUDIO_MAX_VOICES loudest ones are mixed, the rest are virtual.
+ */
+TEST(AudioMixerBenchmark, Tracks)
+{
+  const u32 TRACK_COUNT = 32;
+  const u32 VOICE_COUNT = std::min(TRACK_COUNT, AUDIO_MAX_VOICES);
+  const u32 BUFFERS = 200;
+  const u32 BUFFER_SIZE = AUDIO_SAMPLES * AUDIO_CHANNELS;
+
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> sample(-8000, 8000);
+  std::vector<i16> data(AUDIO_FREQUENCY * AUDIO_CHANNELS);
+
+  for (i16 &s : data) {
+    s = static_cast<i16>(sample(gen));
+  }
+
+  SoundResourcePtr sound(new SoundResource());
+  sound->set_data(Sound::create_from_samples(data.data(), data.size(), AUDIO_FREQUENCY,
+    AUDIO_CHANNELS));
+
+  typedef std::chrono::high_resolution_clock Clock;
+  const SimdLevel levels[] = { SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2 };
+  std::vector<i16> output(BUFFER_SIZE);
+  std::vector<i16> expected;
+
+  for (SimdLevel level : levels) {
+    if (!has_simd(level)) {
+      continue;
+    }
+
+    AudioMixer mixer(level);
+
+    for (u32 i = 0; i < TRACK_COUNT; ++i) {
+      AudioCommand command;
+      command.type = AudioCommandType::PLAY;
+      command.id = i;
+      command.sound = sound;
+      command.repeat = true;
+      command.volume = 1.0f / TRACK_COUNT * (i % 4 + 1);
+      ASSERT_TRUE(mixer.push(std::move(command)));
+    }
+
+    Clock::time_point start = Clock::now();
+
+    for (u32 i = 0; i < BUFFERS; ++i) {
+      mixer.mix(output.data(), BUFFER_SIZE);
+    }
+
+    f64 us = std::chrono::duration_cast<std::chrono::duration<f64>>(Clock::now() - start).count()
+      * 1000000 / BUFFERS;
+    log_info("Mixing %u voices (%u virtual tracks): %s %.1f us per %u samples", VOICE_COUNT,
+      TRACK_COUNT - VOICE_COUNT, simd_level_name(level), us, BUFFER_SIZE);
+
+    EXPECT_EQ(TRACK_COUNT, mixer.track_count());
+    EXPECT_EQ(VOICE_COUNT, mixer.voice_count());
+
+    if (expected.empty()) {
+      expected = output;
+    }
+
+    EXPECT_EQ(expected, output);
+  }
+}
+
+}
@@ -0,0 +1,214 @@
+#include <core/component_pool.h>
+#include <core/component.h>
+#include <core/log.h>
+#include <gtest/gtest.h>
+#include <chrono>
+
+namespace atom {
+
+namespace {
+
+template<ComponentType TYPE>
+class BenchComponent : public NullComponent {
+public:
+  BenchComponent()
+    : NullComponent(TYPE)
+    , value(1)
+  {}
+
+  u32 value;
+};
+
+typedef BenchComponent<ComponentType::RENDER> BenchRender;
+typedef BenchComponent<ComponentType::SCRIPT> BenchScript;
+typedef BenchComponent<ComponentType::GEOMETRY> BenchGeometry;
+
+/**
+ * Components of the processed types, both layouts are created entity by
+ * entity like the game creates them.
+ */
+struct Layout {
+  std::vector<Component *> render;
+  std::vector<Component *> script;
+  std::vector<Component *> geometry;
+  std::vector<Component *> other;
+};
+
+/**
+ * Baseline layout, each component is allocated on the heap and processors
+ * keep vectors of pointers to them.
+ */
+template<typename T>
+Component* create_heap(std::vector<Component *> &components)
+{
+  components.push_back(new T());
+  return components.back();
+}
+
+/**
+ * Current layout, component is stored by value in the storage of its class
+ * (see Entity::add_component).
+ */
+template<typename T>
+Component* create_stored(std::vector<Component *> &components)
+{
+  components.push_back(new (component_storage<T>().allocate()) T());
+  return components.back();
+}
+
+template<typename T>
+void destroy_stored(Component *component)
+{
+  component->~Component();
+  component_storage<T>().deallocate(component);
+}
+
+template<typename T>
+u32 sum_values(const std::vector<Component *> &components)
+{
+  u32 sum = 0;
+
+  for (Component *component : components) {
+    sum += static_cast<T *>(component)->value;
+  }
+
+  return sum;
+}
+
+template<typename T>
+u32 sum_values(const ComponentPool &pool)
+{
+  u32 sum = 0;
+
+  for (T *component : pool.view<T>()) {
+    sum += component->value;
+  }
+
+  return sum;
+}
+
+template<typename Create>
+void create_entities(u32 entity_count, Layout &layout)
+{
+  for (u32 e = 0; e < entity_count; ++e) {
+    Create::template create<BenchComponent<ComponentType::MODEL>>(layout.other);
+    Create::template create<BenchComponent<ComponentType::MATERIAL>>(layout.other);
+    Create::template create<BenchComponent<ComponentType::MESH>>(layout.other);
+    Create::template create<BenchComponent<ComponentType::SKELETON>>(layout.other);
+    Create::template create<BenchGeometry>(layout.geometry);
+    Create::template create<BenchRender>(layout.render);
+    // every other entity has script
+    if ((e & 1) == 0) {
+      Create::template create<BenchScript>(layout.script);
+    }
+  }
+}
+
+struct CreateHeap {
+  template<typename T>
+  static void create(std::vector<Component *> &components)
+  {
+    create_heap<T>(components);
+  }
+};
+
+struct CreateStored {
+  template<typename T>
+  static void create(std::vector<Component *> &components)
+  {
+    create_stored<T>(components);
+  }
+};
+
+void bench_iteration(u32 entity_count)
+{
+  Layout heap;
+  Layout stored;
+  create_entities<CreateHeap>(entity_count, heap);
+  create_entities<CreateStored>(entity_count, stored);
+
+  ComponentPool render_pool;
+  ComponentPool script_pool;
+  ComponentPool geometry_pool;
+
+  for (Component *component : stored.render) {
+    render_pool.add(component);
+  }
+
+  for (Component *component : stored.script) {
+    script_pool.add(component);
+  }
+
+  for (Component *component : stored.geometry) {
+    geometry_pool.add(component);
+  }
+
+  typedef std::chrono::high_resolution_clock Clock;
+  u32 heap_sum = 0;
+  u32 pool_sum = 0;
+
+  Clock::time_point start = Clock::now();
+
+  heap_sum += sum_values<BenchRender>(heap.render);
+  heap_sum += sum_values<BenchScript>(heap.script);
+  heap_sum += sum_values<BenchGeometry>(heap.geometry);
+
+  Clock::time_point iterated = Clock::now();
+
+  pool_sum += sum_values<BenchRender>(render_pool);
+  pool_sum += sum_values<BenchScript>(script_pool);
+  pool_sum += sum_values<BenchGeometry>(geometry_pool);
+
+  Clock::time_point pooled = Clock::now();
+
+  ASSERT_EQ(heap_sum, pool_sum);
+
+  auto us = [](Clock::time_point a, Clock::time_point b)
+  { return (long)std::chrono::duration_cast<std::chrono::microseconds>(b - a).count(); };
+
+  log_info("Render/script/geometry iteration, %u entities: heap pointer vectors %ldus, "
+    "component pool %ldus", entity_count, us(start, iterated), us(iterated, pooled));
+
+  for (Component *component : heap.render) delete component;
+  for (Component *component : heap.script) delete component;
+  for (Component *component : heap.geometry) delete component;
+  for (Component *component : heap.other) delete component;
+
+  render_pool.clear();
+  script_pool.clear();
+  geometry_pool.clear();
+
+  for (Component *component : stored.render) {
+    destroy_stored<BenchRender>(component);
+  }
+
+  for (Component *component : stored.script) {
+    destroy_stored<BenchScript>(component);
+  }
+
+  for (Component *component : stored.geometry) {
+    destroy_stored<BenchGeometry>(component);
+  }
+
+  // storage of each class is released through its own type
+  u32 i = 0;
+
+  for (Component *component : stored.other) {
+    switch (i++ % 4) {
+      case 0: destroy_stored<BenchComponent<ComponentType::MODEL>>(component); break;
+      case 1: destroy_stored<BenchComponent<ComponentType::MATERIAL>>(component); break;
+      case 2: destroy_stored<BenchComponent<ComponentType::MESH>>(component); break;
+      default: destroy_stored<BenchComponent<ComponentType::SKELETON>>(component); break;
+    }
+  }
+}
+
+}
+
+TEST(ComponentBenchmark, Iteration)
+{
+  bench_iteration(10000);
+  bench_iteration(100000);
+}
+
+}
@@ -0,0 +1,98 @@
+#include <core/frustum.h>
+#include <core/mesh_tree.h>
+#include <core/log.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+
+namespace atom {
+
+/**
+ * Frustum culling of 100k boxes: scalar loop over all boxes, SIMD kernels
+ * over all boxes and hierarchical culling (MeshTree).
+ */
+TEST(CullingBenchmark, Boxes)
+{
+  const u32 BOX_COUNT = 100000;
+  const u32 ROUNDS = 20;
+
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<f32> coord(-500, 500);
+  std::uniform_real_distribution<f32> size(0.5f, 3);
+  std::vector<BoundingBox> boxes;
+  BoxArray array;
+  array.resize(BOX_COUNT);
+
+  for (u32 i = 0; i < BOX_COUNT; ++i) {
+    Vec3f c(coord(gen), coord(gen), coord(gen) * 0.1f);
+    f32 s = size(gen);
+    boxes.push_back(BoundingBox(c.x - s, c.x + s, c.y - s, c.y + s, c.z - s, c.z + s));
+    array.set(i, boxes.back());
+  }
+
+  MeshTree tree;
+  tree.build(Slice<BoundingBox>(boxes.data(), boxes.size()));
+
+  // camera turning around in the middle of the scene
+  std::vector<Frustum> frustums;
+  Mat4f projection = Mat4f::perspective(PI / 3, 16.0f / 9, 1, 300);
+
+  for (u32 r = 0; r < ROUNDS; ++r) {
+    frustums.push_back(extract_frustum(projection * Mat4f::rotation_x(-PI2)
+      * Mat4f::rotation_z(r * 2 * PI / ROUNDS)));
+  }
+
+  typedef std::chrono::high_resolution_clock Clock;
+  auto ms_per_frame = [](Clock::time_point a, Clock::time_point b)
+  {
+    return std::chrono::duration_cast<std::chrono::duration<f64>>(b - a).count() * 1000 / ROUNDS;
+  };
+
+  // scalar test of each box
+  u32 expected = 0;
+  Clock::time_point start = Clock::now();
+
+  for (const Frustum &frustum : frustums) {
+    for (const BoundingBox &box : boxes) {
+      expected += classify_box(frustum, box) != Containment::OUTSIDE ? 1 : 0;
+    }
+  }
+
+  log_info("Culling %u boxes: classify_box loop %.3f ms, %u visible per frame",
+    BOX_COUNT, ms_per_frame(start, Clock::now()), expected / ROUNDS);
+
+  const SimdLevel levels[] = { SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2 };
+  std::vector<u32> visible(BOX_COUNT);
+
+  for (SimdLevel level : levels) {
+    if (!has_simd(level)) {
+      continue;
+    }
+
+    u32 total = 0;
+    start = Clock::now();
+
+    for (const Frustum &frustum : frustums) {
+      total += cull_boxes(frustum, array, 0, BOX_COUNT, visible.data(), level);
+    }
+
+    Clock::time_point flat = Clock::now();
+    u32 tree_total = 0;
+    std::vector<u32> tree_visible;
+
+    for (const Frustum &frustum : frustums) {
+      tree_visible.clear();
+      tree.cull(frustum, tree_visible, level);
+      tree_total += tree_visible.size();
+    }
+
+    log_info("Culling %u boxes: %s all boxes %.3f ms, hierarchy %.3f ms",
+      BOX_COUNT, simd_level_name(level), ms_per_frame(start, flat),
+      ms_per_frame(flat, Clock::now()));
+
+    EXPECT_EQ(expected, total);
+    EXPECT_EQ(expected, tree_total);
+  }
+}
+
+}
@@ -0,0 +1,85 @@
+#include <core/bvh.h>
+#include <core/intersect.h>
+#include <core/log.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+
+namespace atom {
+
+/**
+ * Ray queries against terrain like grid mesh, compare brute force intersection
+ * with BVH accelerated one.
+ */
+TEST(IntersectBenchmark, TerrainMesh)
+{
+  const u32 SIZE = 100;
+  const u32 RAY_COUNT = 500;
+  std::vector<Vec3f> vertices;
+  std::vector<u32> indices;
+
+  for (u32 y = 0; y <= SIZE; ++y) {
+    for (u32 x = 0; x <= SIZE; ++x) {
+      f32 z = 2.0f * std::sin(x * 0.1f) * std::cos(y * 0.1f);
+      vertices.push_back(Vec3f(x, y, z));
+    }
+  }
+
+  for (u32 y = 0; y < SIZE; ++y) {
+    for (u32 x = 0; x < SIZE; ++x) {
+      u32 i = y * (SIZE + 1) + x;
+      indices.push_back(i);
+      indices.push_back(i + 1);
+      indices.push_back(i + SIZE + 2);
+      indices.push_back(i);
+      indices.push_back(i + SIZE + 2);
+      indices.push_back(i + SIZE + 1);
+    }
+  }
+
+  Slice<Vec3f> v(vertices.data(), vertices.size());
+  Slice<u32> i(indices.data(), indices.size());
+
+  std::vector<Ray> rays;
+
+  for (u32 r = 0; r < RAY_COUNT; ++r) {
+    f32 x = (r * 37 % SIZE) + 0.3f;
+    f32 y = (r * 71 % SIZE) + 0.6f;
+    rays.push_back(Ray(Vec3f(x, y, 10), Vec3f(0.1f, 0.05f, -1).normalized()));
+  }
+
+  typedef std::chrono::high_resolution_clock Clock;
+
+  Clock::time_point start = Clock::now();
+  Bvh bvh;
+  build_mesh_bvh(v, i, bvh);
+  Clock::time_point built = Clock::now();
+
+  std::vector<f32> expected(RAY_COUNT);
+  std::vector<f32> result(RAY_COUNT);
+  u32 index;
+
+  for (u32 r = 0; r < RAY_COUNT; ++r) {
+    expected[r] = intersect_mesh(rays[r], v, i, index);
+  }
+
+  Clock::time_point brute = Clock::now();
+
+  for (u32 r = 0; r < RAY_COUNT; ++r) {
+    result[r] = intersect_mesh(rays[r], bvh, v, i, index);
+  }
+
+  Clock::time_point accelerated = Clock::now();
+
+  for (u32 r = 0; r < RAY_COUNT; ++r) {
+    ASSERT_FLOAT_EQ(expected[r], result[r]);
+  }
+
+  auto us = [](Clock::time_point a, Clock::time_point b)
+  { return (long)std::chrono::duration_cast<std::chrono::microseconds>(b - a).count(); };
+
+  log_info("Intersect %u triangles, %u rays: build %ldus, brute force %ldus, bvh %ldus",
+    indices.size() / 3, RAY_COUNT, us(start, built), us(built, brute), us(brute, accelerated));
+}
+
+}
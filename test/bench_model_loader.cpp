@@ -0,0 +1,53 @@
+#include <core/model_loader.h>
+#include <core/constants.h>
+#include <core/utils.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+
+namespace atom {
+
+/**
+ * Compare JSON (.m3d) and binary (.m3b) load time of the shipped meshes.
+ * Meshes are searched relative to the working directory (repository root).
+ */
+TEST(ModelLoaderBenchmark, JsonVsBinary)
+{
+  const char *meshes[] = { "cube", "suzanne", "monkey_rider", "track", "compound" };
+  const char binary[] = "bench_model.m3b";
+
+  for (const char *name : meshes) {
+    String filename = String(MESH_RESOURCE_DIR) + "/" + name + "." + MESH_EXT;
+    i64 start = micro_time();
+    Model json;
+
+    if (!load_model_json(filename, json)) {
+      log_info("Mesh \"%s\" not found, skipping", filename.c_str());
+      continue;
+    }
+
+    i64 json_time = micro_time() - start;
+    ASSERT_TRUE(save_model_binary(binary, json));
+
+    start = micro_time();
+    Model mapped;
+    ASSERT_TRUE(load_model_binary(binary, mapped));
+    i64 binary_time = micro_time() - start;
+
+    ASSERT_EQ(json.arrays().size(), mapped.arrays().size());
+    ASSERT_EQ(json.bones.size(), mapped.bones.size());
+
+    for (const uptr<DataStream> &stream : json.arrays()) {
+      const DataStream *found = mapped.find_array(stream->name, stream->type);
+      ASSERT_TRUE(found != nullptr);
+      ASSERT_EQ(stream->data.size(), found->data.size());
+      ASSERT_EQ(0, memcmp(stream->data.data(), found->data.data(), found->data.size()));
+    }
+
+    log_info("Load \"%s\": json %lldus, binary %lldus", name,
+      (long long)json_time, (long long)binary_time);
+  }
+
+  std::remove(binary);
+}
+
+}
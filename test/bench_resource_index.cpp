@@ -0,0 +1,76 @@
+#include <core/resource_index.h>
+#include <core/utils.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+
+namespace atom {
+
+/**
+ * Lookup and change propagation over 10k resources, compare with linear scan
+ * of the resource array (previous ResourceService implementation).
+ */
+TEST(ResourceIndexBenchmark, TenThousandResources)
+{
+  const u32 COUNT = 10000;
+  const u32 LOOKUPS = 2000;
+  ResourceIndex index;
+
+  for (u32 i = 0; i < COUNT; ++i) {
+    ResourcePtr resource = std::make_shared<Resource>();
+    resource->set_name("texture:synthetic" + to_string(i));
+    resource->depend_on_file("data/image/synthetic" + to_string(i / 4) + ".png");
+    index.add(resource);
+  }
+
+  const ResourceArray &resources = index.resources();
+  StringArray names;
+
+  for (u32 i = 0; i < LOOKUPS; ++i) {
+    names.push_back("texture:synthetic" + to_string(i * 7919 % COUNT));
+  }
+
+  i64 start = micro_time();
+  u32 found_linear = 0;
+
+  for (const String &name : names) {
+    auto found = std::find_if(resources.begin(), resources.end(),
+      [&name](const ResourcePtr &resource) { return resource->name() == name; });
+    found_linear += found != resources.end();
+  }
+
+  i64 linear_time = micro_time() - start;
+  start = micro_time();
+  u32 found_hashed = 0;
+
+  for (const String &name : names) {
+    found_hashed += index.find(name) != nullptr;
+  }
+
+  i64 hashed_time = micro_time() - start;
+  ASSERT_EQ(LOOKUPS, found_linear);
+  ASSERT_EQ(LOOKUPS, found_hashed);
+
+  // one file change, find affected resources
+  String change = "file:data/image/synthetic1234.png";
+  start = micro_time();
+  u32 affected_scan = 0;
+
+  for (const ResourcePtr &resource : resources) {
+    const StringArray &sources = resource->sources();
+    affected_scan += std::find(sources.begin(), sources.end(), change) != sources.end();
+  }
+
+  i64 scan_time = micro_time() - start;
+  start = micro_time();
+  u32 affected_graph = index.dependents(change).size();
+  i64 graph_time = micro_time() - start;
+  ASSERT_EQ(4u, affected_scan);
+  ASSERT_EQ(4u, affected_graph);
+
+  log_info("%u resources, %u lookups: linear %lldus, hash %lldus; "
+    "change propagation: scan %lldus, graph %lldus", COUNT, LOOKUPS,
+    (long long)linear_time, (long long)hashed_time, (long long)scan_time,
+    (long long)graph_time);
+}
+
+}
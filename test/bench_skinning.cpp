@@ -0,0 +1,103 @@
+#include <core/skinning.h>
+#include <core/log.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+
+namespace atom {
+
+/**
+ * Skinning throughput of the former loop and of all supported kernels.
+ */
+TEST(SkinningBenchmark, Throughput)
+{
+  const u32 VERTEX_COUNT = 100000;
+  const u32 BONE_COUNT = 64;
+  const u32 ROUNDS = 10;
+
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<f32> coord(-1, 1);
+  std::uniform_int_distribution<u32> bone(0, BONE_COUNT - 1);
+
+  std::vector<Mat4f> bones;
+  std::vector<Vec3f> vertices;
+  std::vector<Vec3f> normals;
+  std::vector<u32> indices;
+  std::vector<Vec4f> weights;
+
+  for (u32 i = 0; i < BONE_COUNT; ++i) {
+    bones.push_back(Mat4f::translation(Vec3f(coord(gen), coord(gen), coord(gen))) * Mat4f::rotation_z(coord(gen)));
+  }
+
+  for (u32 i = 0; i < VERTEX_COUNT; ++i) {
+    vertices.push_back(Vec3f(coord(gen), coord(gen), coord(gen)));
+    normals.push_back(Vec3f(0, 0, 1));
+    indices.push_back(bone(gen) | bone(gen) << 8 | bone(gen) << 16 | bone(gen) << 24);
+    weights.push_back(Vec4f(0.4f, 0.3f, 0.2f, 0.1f));
+  }
+
+  SkinningInput input;
+  input.positions = vertices.data();
+  input.normals = normals.data();
+  input.bone_indices = indices.data();
+  input.bone_weights = weights.data();
+  input.count = VERTEX_COUNT;
+  input.bones = bones.data();
+  input.bone_count = BONE_COUNT;
+
+  typedef std::chrono::high_resolution_clock Clock;
+  auto vertices_per_second = [](Clock::time_point a, Clock::time_point b)
+  {
+    f64 seconds = std::chrono::duration_cast<std::chrono::duration<f64>>(b - a).count();
+    return seconds > 0 ? VERTEX_COUNT * ROUNDS / seconds / 1e6 : 0.0;
+  };
+
+  // former implementation
+  std::vector<Vec3f> result;
+  Clock::time_point start = Clock::now();
+
+  for (u32 r = 0; r < ROUNDS; ++r) {
+    result.clear();
+
+    for (u32 i = 0; i < VERTEX_COUNT; ++i) {
+      u32 bi = indices[i];
+      Vec3f v(0, 0, 0);
+
+      for (u32 j = 0; j < 4; ++j, bi >>= 8) {
+        v += transform_point(bones[bi & 0xFF], vertices[i]) * weights[i][j];
+      }
+      result.push_back(v);
+    }
+  }
+
+  log_info("Skinning %u vertices: transform_point loop %.1f Mvertices/s",
+    VERTEX_COUNT, vertices_per_second(start, Clock::now()));
+
+  const SimdLevel levels[] = { SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2 };
+  std::vector<Vec3f> positions(VERTEX_COUNT);
+  std::vector<Vec3f> skinned_normals(VERTEX_COUNT);
+
+  for (SimdLevel level : levels) {
+    if (!has_simd(level)) {
+      continue;
+    }
+
+    start = Clock::now();
+    for (u32 r = 0; r < ROUNDS; ++r) {
+      skin_vertices(input, positions.data(), nullptr, level);
+    }
+    Clock::time_point skinned = Clock::now();
+
+    for (u32 r = 0; r < ROUNDS; ++r) {
+      skin_vertices(input, positions.data(), skinned_normals.data(), level);
+    }
+
+    log_info("Skinning %u vertices: %s %.1f Mvertices/s, with normals %.1f Mvertices/s",
+      VERTEX_COUNT, simd_level_name(level), vertices_per_second(start, skinned),
+      vertices_per_second(skinned, Clock::now()));
+
+    ASSERT_NEAR(result.back()[0], positions.back()[0], 1e-4f);
+  }
+}
+
+}
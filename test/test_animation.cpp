@@ -0,0 +1,128 @@
+#include <core/animation.h>
+#include <core/model_loader.h>
+#include <core/constants.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+
+namespace atom {
+
+namespace {
+
+f32 max_error(const Quatf &a, const Quatf &b)
+{
+  f32 s = dot_product(a, b) < 0 ? -1 : 1;
+  return std::max(std::max(std::abs(a.w - s * b.w), std::abs(a.x - s * b.x)),
+                  std::max(std::abs(a.y - s * b.y), std::abs(a.z - s * b.z)));
+}
+
+/// swing around z axis (not linear, can't be reduced to two keys)
+std::vector<Quatf> wave_track(u32 frames)
+{
+  std::vector<Quatf> track;
+
+  for (u32 i = 0; i < frames; ++i) {
+    track.push_back(Quatf::from_axis_angle(Vec3f(0, 0, 1), std::sin(i * 0.03f)));
+  }
+
+  return track;
+}
+
+}
+
+TEST(Animation, QuantizeRotation)
+{
+  Quatf q = Quatf::from_axis_angle(Vec3f(1, 2, 3).normalized(), 2.5f);
+  // negative w is stored as the same rotation
+  Quatf negated(-q.w, -q.x, -q.y, -q.z);
+  EXPECT_LT(max_error(q, dequantize_rotation(quantize_rotation(7, q))), 1e-4f);
+  EXPECT_LT(max_error(q, dequantize_rotation(quantize_rotation(7, negated))), 1e-4f);
+  EXPECT_EQ(7, quantize_rotation(7, q).frame);
+}
+
+TEST(Animation, CompressTrack)
+{
+  std::vector<AnimationKey> keys;
+
+  std::vector<Quatf> constant(100, Quatf::from_axis_angle(Vec3f(0, 1, 0), 0.5f));
+  compress_track(constant, ANIMATION_KEY_TOLERANCE, keys);
+  EXPECT_EQ(1u, keys.size());
+
+  std::vector<Quatf> wave = wave_track(100);
+  compress_track(wave, ANIMATION_KEY_TOLERANCE, keys);
+  EXPECT_GT(keys.size(), 2u);
+  EXPECT_LT(keys.size(), wave.size() / 2);
+  EXPECT_EQ(0, keys.front().frame);
+  EXPECT_EQ(99, keys.back().frame);
+}
+
+TEST(Animation, SampleCompressedClip)
+{
+  RawAnimationClip raw;
+  raw.name = "wave";
+  raw.fps = 30;
+  raw.frame_count = 100;
+  raw.tracks.push_back(RawAnimationTrack{1, wave_track(100)});
+
+  std::vector<u8> data;
+  ASSERT_TRUE(compress_animations(std::vector<RawAnimationClip>(1, raw),
+    ANIMATION_KEY_TOLERANCE, data));
+
+  std::vector<AnimationClip> clips;
+  ASSERT_TRUE(parse_animations(Slice<u8>(data.data(), data.size()), 2, clips));
+  ASSERT_EQ(1u, clips.size());
+
+  const AnimationClip &clip = clips[0];
+  EXPECT_EQ("wave", clip.name());
+  EXPECT_FLOAT_EQ(99 / 30.0f, clip.duration());
+  EXPECT_LT(clip.memory_size(), 100 * sizeof(Quatf));
+
+  for (u32 i = 0; i < 100; ++i) {
+    Quatf pose[2];
+    clip.sample(i / 30.0f, false, 1, pose, 2);
+    // bone without track is unchanged
+    EXPECT_EQ(Quatf(), pose[0]);
+    EXPECT_LT(max_error(raw.tracks[0].frames[i], pose[1]), 2 * ANIMATION_KEY_TOLERANCE);
+  }
+
+  // blending by weight
+  Quatf pose[2];
+  clip.sample(10 / 30.0f, false, 0.5f, pose, 2);
+  EXPECT_LT(max_error(nlerp(Quatf(), raw.tracks[0].frames[10], 0.5f), pose[1]), 1e-3f);
+
+  // tracks of unknown bones are rejected
+  EXPECT_FALSE(parse_animations(Slice<u8>(data.data(), data.size()), 1, clips));
+}
+
+TEST(Animation, BinaryModel)
+{
+  RawAnimationClip raw;
+  raw.name = "wave";
+  raw.fps = 24;
+  raw.frame_count = 50;
+  raw.tracks.push_back(RawAnimationTrack{0, wave_track(50)});
+
+  Model model;
+  model.bones.resize(1);
+  model.bones[0].name = "root";
+  model.bones[0].parent = -1;
+
+  std::vector<u8> data;
+  ASSERT_TRUE(compress_animations(std::vector<RawAnimationClip>(1, raw),
+    ANIMATION_KEY_TOLERANCE, data));
+  model.add_array(MODEL_ANIMATION, Type::U32, std::move(data));
+
+  const char filename[] = "test_animation.m3b";
+  ASSERT_TRUE(save_model_binary(filename, model));
+
+  Model loaded;
+  ASSERT_TRUE(load_model(filename, loaded));
+  std::remove(filename);
+
+  ASSERT_EQ(1u, loaded.animations.size());
+  ASSERT_EQ(0u, loaded.find_animation("wave"));
+  ASSERT_EQ(U32_MAX, loaded.find_animation("walk"));
+  EXPECT_EQ(50u, loaded.animations[0].frame_count());
+  EXPECT_FLOAT_EQ(24, loaded.animations[0].fps());
+}
+
+}
@@ -0,0 +1,171 @@
+#include <core/audio_mixer.h>
+#include <core/constants.h>
+#include <core/resources.h>
+#include <core/sound.h>
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace atom {
+
+namespace {
+
+SoundResourcePtr make_sound(const std::vector<i16> &samples)
+{
+  SoundResourcePtr sound(new SoundResource());
+  sound->set_data(Sound::create_from_samples(samples.data(), samples.size(), AUDIO_FREQUENCY,
+    AUDIO_CHANNELS));
+  return sound;
+}
+
+AudioCommand play_command(u32 id, const SoundResourcePtr &sound, bool repeat, f32 volume = 1)
+{
+  AudioCommand command;
+  command.type = AudioCommandType::PLAY;
+  command.id = id;
+  command.sound = sound;
+  command.repeat = repeat;
+  command.volume = volume;
+  return command;
+}
+
+}
+
+TEST(SpscQueue, Bounded)
+{
+  SpscQueue<u32> queue(4);
+  u32 value;
+  EXPECT_FALSE(queue.pop(value));
+
+  for (u32 i = 0; i < 4; ++i) {
+    u32 item = i;
+    EXPECT_TRUE(queue.push(std::move(item)));
+  }
+
+  u32 extra = 4;
+  EXPECT_FALSE(queue.push(std::move(extra)));
+
+  for (u32 i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(i, value);
+  }
+
+  EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(SpscQueue, TwoThreads)
+{
+  const u32 COUNT = 10000;
+  SpscQueue<u32> queue(64);
+  u64 sum = 0;
+
+  std::thread consumer([&queue, &sum]()
+  {
+    u32 value;
+    u32 expected = 0;
+
+    while (expected < COUNT) {
+      if (queue.pop(value)) {
+        EXPECT_EQ(expected, value);
+        sum += value;
+        ++expected;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (u32 i = 0; i < COUNT; ) {
+    u32 item = i;
+
+    if (queue.push(std::move(item))) {
+      ++i;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  consumer.join();
+  EXPECT_EQ(u64(COUNT) * (COUNT - 1) / 2, sum);
+}
+
+TEST(AudioMixer, KernelsMatchScalar)
+{
+  const u32 COUNT = 103;  // odd tail for every kernel
+  std::vector<f32> samples(COUNT);
+
+  for (u32 i = 0; i < COUNT; ++i) {
+    samples[i] = static_cast<i16>((i * 7919) % 65536 - 32768);
+  }
+
+  samples[1] = I16_MAX;
+  samples[2] = 4;
+
+  const SimdLevel levels[] = { SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2 };
+  std::vector<i16> expected;
+
+  for (SimdLevel level : levels) {
+    if (!has_simd(level)) {
+      continue;
+    }
+
+    // two loud tracks saturate
+    std::vector<f32> accumulator(COUNT, 0.0f);
+    mix_accumulate(accumulator.data(), samples.data(), COUNT, 1.5f, level);
+    mix_accumulate(accumulator.data(), samples.data(), COUNT, 0.25f, level);
+
+    std::vector<i16> output(COUNT);
+    mix_convert(output.data(), accumulator.data(), COUNT, level);
+
+    if (expected.empty()) {
+      expected = output;
+    }
+
+    EXPECT_EQ(expected, output) << simd_level_name(level);
+  }
+
+  EXPECT_EQ(I16_MIN, expected[0]);
+  EXPECT_EQ(I16_MAX, expected[1]);
+  EXPECT_EQ(7, expected[2]);
+}
+
+TEST(AudioMixer, Tracks)
+{
+  AudioMixer mixer;
+  SoundResourcePtr a = make_sound(std::vector<i16>(6, 100));
+  SoundResourcePtr b = make_sound(std::vector<i16>(4, 10));
+  std::vector<i16> output(8);
+
+  EXPECT_TRUE(mixer.push(play_command(1, a, false)));
+  EXPECT_TRUE(mixer.push(play_command(2, b, true, 2)));
+  mixer.mix(output.data(), output.size());
+
+  // a ends after 6 samples, b repeats
+  EXPECT_EQ(120, output[0]);
+  EXPECT_EQ(120, output[5]);
+  EXPECT_EQ(20, output[6]);
+  EXPECT_EQ(1u, mixer.track_count());
+
+  AudioCommand volume;
+  volume.type = AudioCommandType::VOLUME;
+  volume.id = 2;
+  volume.volume = 0.5f;
+  EXPECT_TRUE(mixer.push(std::move(volume)));
+  mixer.mix(output.data(), 2);
+  EXPECT_EQ(5, output[0]);
+
+  AudioCommand stop;
+  stop.type = AudioCommandType::STOP;
+  stop.id = 2;
+  EXPECT_TRUE(mixer.push(std::move(stop)));
+  mixer.mix(output.data(), output.size());
+  EXPECT_EQ(0u, mixer.track_count());
+  EXPECT_EQ(0, output[0]);
+
+  // sounds are released by the game thread
+  EXPECT_FALSE(a.unique());
+  mixer.collect();
+  EXPECT_TRUE(a.unique());
+  EXPECT_TRUE(b.unique());
+}
+
+}
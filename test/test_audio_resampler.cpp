@@ -0,0 +1,209 @@
+#include <core/audio_resampler.h>
+#include <core/audio_stream.h>
+#include <core/constants.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+namespace atom {
+
+namespace {
+
+/**
+ * Stereo sine, both channels are the same.
+ */
+std::vector<i16> make_sine(u32 frames, f64 frequency, u32 rate, f64 amplitude)
+{
+  std::vector<i16> samples;
+
+  for (u32 i = 0; i < frames; ++i) {
+    i16 s = static_cast<i16>(std::lrint(amplitude * std::sin(2 * PI * frequency * i / rate)));
+    samples.push_back(s);
+    samples.push_back(s);
+  }
+
+  return samples;
+}
+
+/**
+ * Max difference from the ideal sine at AUDIO_FREQUENCY, edges are skipped.
+ */
+f64 sine_error(const std::vector<f32> &samples, f64 frequency, f64 amplitude)
+{
+  f64 error = 0;
+
+  for (u32 i = RESAMPLE_TAPS; i + RESAMPLE_TAPS < samples.size() / 2; ++i) {
+    f64 expected = amplitude * std::sin(2 * PI * frequency * i / AUDIO_FREQUENCY);
+    error = std::max(error, std::abs(samples[2 * i] - expected));
+    error = std::max(error, std::abs(samples[2 * i + 1] - expected));
+  }
+
+  return error;
+}
+
+/**
+ * 16bit buffer with any sample rate (Sound is always converted).
+ */
+class TestBuffer : public AudioBuffer {
+  std::vector<i16> my_samples;
+  int              my_rate;
+  int              my_channels;
+
+public:
+  TestBuffer(const std::vector<i16> &samples, int rate, int channels)
+    : my_samples(samples)
+    , my_rate(rate)
+    , my_channels(channels)
+  {
+    // empty
+  }
+
+  int read_old(void *buffer, int start, int size) override
+  {
+    int end = std::min<int>(start + size, get_size());
+
+    if (start >= end) {
+      return 0;
+    }
+
+    memcpy(buffer, reinterpret_cast<const u8 *>(my_samples.data()) + start, end - start);
+    return end - start;
+  }
+
+  int get_sample_rate() override
+  {
+    return my_rate;
+  }
+
+  int get_channel_count() override
+  {
+    return my_channels;
+  }
+
+  int get_size() override
+  {
+    return my_samples.size() * sizeof(i16);
+  }
+};
+
+}
+
+TEST(AudioResampler, Passthrough)
+{
+  std::vector<i16> samples = make_sine(100, 1000, AUDIO_FREQUENCY, 1000);
+  std::vector<f32> result = convert_audio(samples.data(), samples.size(), 2, AUDIO_FREQUENCY,
+    ResampleQuality::SINC);
+  ASSERT_EQ(samples.size(), result.size());
+
+  for (u32 i = 0; i < samples.size(); ++i) {
+    ASSERT_EQ(samples[i], result[i]);
+  }
+
+  AudioResampler resampler(AUDIO_FREQUENCY, AUDIO_FREQUENCY, ResampleQuality::SINC);
+  EXPECT_TRUE(resampler.is_passthrough());
+}
+
+TEST(AudioResampler, MonoToStereo)
+{
+  std::vector<i16> mono = { 1, -2, 3 };
+  std::vector<f32> result = convert_audio(mono.data(), mono.size(), 1, AUDIO_FREQUENCY,
+    ResampleQuality::SINC);
+  std::vector<f32> expected = { 1, 1, -2, -2, 3, 3 };
+  EXPECT_EQ(expected, result);
+}
+
+TEST(AudioResampler, Upsample)
+{
+  const u32 RATE = 32000;
+  const f64 FREQUENCY = 3000;
+  std::vector<i16> samples = make_sine(RATE / 10, FREQUENCY, RATE, 10000);
+
+  std::vector<f32> sinc = convert_audio(samples.data(), samples.size(), 2, RATE,
+    ResampleQuality::SINC);
+  std::vector<f32> linear = convert_audio(samples.data(), samples.size(), 2, RATE,
+    ResampleQuality::LINEAR);
+
+  // 0.1 s
+  EXPECT_NEAR(AUDIO_FREQUENCY / 10, sinc.size() / 2, 1);
+  EXPECT_NEAR(AUDIO_FREQUENCY / 10, linear.size() / 2, 1);
+  EXPECT_LT(sine_error(sinc, FREQUENCY, 10000), 100);
+  EXPECT_LT(sine_error(linear, FREQUENCY, 10000), 500);
+  EXPECT_LT(sine_error(sinc, FREQUENCY, 10000), sine_error(linear, FREQUENCY, 10000));
+}
+
+TEST(AudioResampler, DownsampleKeepsDC)
+{
+  std::vector<i16> samples(48000 / 10 * 2, 1000);
+  std::vector<f32> result = convert_audio(samples.data(), samples.size(), 2, 48000,
+    ResampleQuality::SINC);
+  EXPECT_NEAR(AUDIO_FREQUENCY / 10, result.size() / 2, 1);
+
+  // zeros before and after the sound ring at the edges
+  for (u32 i = RESAMPLE_TAPS; i + RESAMPLE_TAPS < result.size() / 2; ++i) {
+    ASSERT_NEAR(1000, result[2 * i], 0.5f);
+  }
+}
+
+TEST(AudioResampler, StreamingMatchesWhole)
+{
+  std::vector<i16> samples = make_sine(1000, 440, 22050, 8000);
+  std::vector<f32> input(samples.begin(), samples.end());
+  std::vector<f32> expected = convert_audio(samples.data(), samples.size(), 2, 22050,
+    ResampleQuality::SINC);
+
+  AudioResampler resampler(22050, AUDIO_FREQUENCY, ResampleQuality::SINC);
+  std::vector<f32> output(expected.size() + 100);
+  u32 done = 0;
+  u32 pushed = 0;
+
+  // pieces of different sizes, output pulled in small chunks
+  for (u32 piece = 1; pushed < 1000; piece = piece * 3 % 97 + 1) {
+    u32 frames = std::min(piece, 1000 - pushed);
+    resampler.push(&input[pushed * 2], frames);
+    pushed += frames;
+    done += resampler.pull(&output[done * 2], 7);
+    done += resampler.pull(&output[done * 2], 1000);
+  }
+
+  resampler.flush();
+  done += resampler.pull(&output[done * 2], output.size() / 2 - done);
+  ASSERT_EQ(expected.size() / 2, done);
+
+  for (u32 i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected[i], output[i]) << i;
+  }
+}
+
+TEST(AudioResampler, Stream)
+{
+  // mono ramp at half rate, linear interpolation doubles it exactly
+  std::vector<i16> ramp;
+
+  for (u32 i = 0; i < 3000; ++i) {
+    ramp.push_back(static_cast<i16>(i));
+  }
+
+  AudioStream stream(uptr<AudioBuffer>(new TestBuffer(ramp, AUDIO_FREQUENCY / 2, 1)), false,
+    ResampleQuality::LINEAR);
+  EXPECT_EQ(3000u, stream.frame_count());
+
+  std::vector<f32> output(1000);
+  u32 frame = 0;
+
+  while (!stream.is_stream_finished()) {
+    while (stream.update()) {
+    }
+
+    u32 count = stream.read(output.data(), output.size());
+
+    for (u32 i = 0; i < count; i += 2, ++frame) {
+      // the last frame fades to the silence after the stream
+      f32 expected = frame < 5999 ? frame * 0.5f : 1499.5f;
+      ASSERT_FLOAT_EQ(expected, output[i]);
+      ASSERT_FLOAT_EQ(expected, output[i + 1]);
+    }
+  }
+
+  EXPECT_EQ(6000u, frame);
+}
+
+}
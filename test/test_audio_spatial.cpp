@@ -0,0 +1,178 @@
+#include <core/audio_mixer.h>
+#include <core/audio_spatial.h>
+#include <core/constants.h>
+#include <core/resources.h>
+#include <core/sound.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+namespace atom {
+
+namespace {
+
+SoundResourcePtr make_sound(u32 frames, i16 value)
+{
+  std::vector<i16> samples(frames * AUDIO_CHANNELS, value);
+  SoundResourcePtr sound(new SoundResource());
+  sound->set_data(Sound::create_from_samples(samples.data(), samples.size(), AUDIO_FREQUENCY,
+    AUDIO_CHANNELS));
+  return sound;
+}
+
+AudioCommand spatial_command(u32 id, const SoundResourcePtr &sound, const Vec3f &position,
+  bool repeat)
+{
+  AudioCommand command;
+  command.type = AudioCommandType::PLAY;
+  command.id = id;
+  command.sound = sound;
+  command.repeat = repeat;
+  command.spatial = true;
+  command.emitter.position = position;
+  return command;
+}
+
+}
+
+TEST(AudioSpatial, Attenuation)
+{
+  AudioEmitter emitter;
+  emitter.min_distance = 2;
+  emitter.max_distance = 10;
+
+  EXPECT_FLOAT_EQ(1, audio_attenuation(emitter, 0));
+  EXPECT_FLOAT_EQ(1, audio_attenuation(emitter, 2));
+  EXPECT_FLOAT_EQ(0.5f, audio_attenuation(emitter, 4));
+  EXPECT_FLOAT_EQ(0, audio_attenuation(emitter, 10));
+  EXPECT_FLOAT_EQ(0, audio_attenuation(emitter, 100));
+
+  emitter.rolloff = AudioRolloff::LINEAR;
+  EXPECT_FLOAT_EQ(1, audio_attenuation(emitter, 2));
+  EXPECT_FLOAT_EQ(0.5f, audio_attenuation(emitter, 6));
+  EXPECT_FLOAT_EQ(0, audio_attenuation(emitter, 10));
+}
+
+TEST(AudioSpatial, Panning)
+{
+  AudioListener listener;
+  AudioEmitter emitter;
+
+  emitter.position = Vec3f(1, 0, 0);
+  AudioGain right = spatialize(listener, emitter, 1);
+  EXPECT_NEAR(0, right.left, 1e-5f);
+  EXPECT_NEAR(1, right.right, 1e-5f);
+
+  emitter.position = Vec3f(-1, 0, 0);
+  AudioGain left = spatialize(listener, emitter, 1);
+  EXPECT_NEAR(1, left.left, 1e-5f);
+  EXPECT_NEAR(0, left.right, 1e-5f);
+
+  // constant power in front of the listener
+  emitter.position = Vec3f(0, 1, 0);
+  AudioGain front = spatialize(listener, emitter, 0.5f);
+  EXPECT_NEAR(front.left, front.right, 1e-5f);
+  EXPECT_NEAR(0.25f, front.left * front.left + front.right * front.right, 1e-5f);
+  EXPECT_FLOAT_EQ(1, front.pitch);
+}
+
+TEST(AudioSpatial, Doppler)
+{
+  AudioListener listener;
+  AudioEmitter emitter;
+  emitter.position = Vec3f(0, 10, 0);
+
+  emitter.velocity = Vec3f(0, -SPEED_OF_SOUND / 4, 0);
+  EXPECT_NEAR(4.0f / 3, spatialize(listener, emitter, 1).pitch, 1e-4f);
+
+  emitter.velocity = Vec3f(0, SPEED_OF_SOUND / 4, 0);
+  EXPECT_LT(spatialize(listener, emitter, 1).pitch, 1);
+
+  // listener moving towards the source
+  emitter.velocity = Vec3f();
+  listener.velocity = Vec3f(0, SPEED_OF_SOUND / 2, 0);
+  EXPECT_NEAR(1.5f, spatialize(listener, emitter, 1).pitch, 1e-4f);
+
+  // supersonic source is clamped
+  listener.velocity = Vec3f();
+  emitter.velocity = Vec3f(0, -2 * SPEED_OF_SOUND, 0);
+  EXPECT_FLOAT_EQ(AUDIO_MAX_PITCH, spatialize(listener, emitter, 1).pitch);
+
+  // inaudible shift of slowly moving source is not resampled
+  emitter.velocity = Vec3f(0, -1, 0);
+  EXPECT_EQ(1.0f, spatialize(listener, emitter, 1).pitch);
+}
+
+TEST(AudioSpatial, Virtualization)
+{
+  AudioMixer mixer(SimdLevel::SCALAR);
+  SoundResourcePtr silent = make_sound(4096, 0);
+  // the quietest one, short and not repeated
+  SoundResourcePtr quiet = make_sound(100, 1000);
+
+  for (u32 i = 0; i < AUDIO_MAX_VOICES; ++i) {
+    mixer.push(spatial_command(i + 1, silent, Vec3f(0, 1, 0), true));
+  }
+
+  mixer.push(spatial_command(100, quiet, Vec3f(0, 50, 0), false));
+
+  std::vector<i16> output(256 * AUDIO_CHANNELS, 1);
+  mixer.mix(output.data(), 64 * AUDIO_CHANNELS);
+  EXPECT_EQ(AUDIO_MAX_VOICES + 1, mixer.track_count());
+  EXPECT_EQ(AUDIO_MAX_VOICES, mixer.voice_count());
+
+  // virtual track isn't heard but its position advances, so it ends in time
+  mixer.mix(output.data(), output.size());
+  EXPECT_EQ(AUDIO_MAX_VOICES, mixer.track_count());
+
+  for (i16 sample : output) {
+    EXPECT_EQ(0, sample);
+  }
+
+  // source out of range is virtual even with a free voice
+  AudioCommand stop;
+  stop.type = AudioCommandType::STOP;
+  stop.id = 1;
+  mixer.push(std::move(stop));
+  mixer.push(spatial_command(101, quiet, Vec3f(0, 500, 0), true));
+  mixer.mix(output.data(), output.size());
+  EXPECT_EQ(AUDIO_MAX_VOICES, mixer.track_count());
+  EXPECT_EQ(AUDIO_MAX_VOICES - 1, mixer.voice_count());
+}
+
+TEST(AudioSpatial, PitchShift)
+{
+  AudioMixer mixer(SimdLevel::SCALAR);
+  SoundResourcePtr sound = make_sound(100, 1000);
+  AudioCommand command = spatial_command(1, sound, Vec3f(0, 0.5f, 0), false);
+  // approaching at the half of the speed of sound doubles the pitch
+  command.emitter.velocity = Vec3f(0, -SPEED_OF_SOUND / 2, 0);
+  mixer.push(std::move(command));
+
+  std::vector<i16> output(60 * AUDIO_CHANNELS);
+  mixer.mix(output.data(), output.size());
+  EXPECT_EQ(0u, mixer.track_count());
+
+  i16 expected = static_cast<i16>(std::lround(1000 * std::sqrt(0.5f)));
+  EXPECT_NEAR(expected, output[0], 1);
+  EXPECT_NEAR(expected, output[49 * AUDIO_CHANNELS + 1], 1);
+  EXPECT_EQ(0, output[50 * AUDIO_CHANNELS]);
+}
+
+TEST(AudioSpatial, Listener)
+{
+  AudioMixer mixer(SimdLevel::SCALAR);
+  mixer.push(spatial_command(1, make_sound(100, 1000), Vec3f(0, 0, 1), true));
+
+  // listener turned, the source is on its right
+  AudioCommand command;
+  command.type = AudioCommandType::LISTENER;
+  command.listener.right = Vec3f(0, 0, 1);
+  mixer.push(std::move(command));
+
+  std::vector<i16> output(16 * AUDIO_CHANNELS);
+  mixer.mix(output.data(), output.size());
+  EXPECT_EQ(0, output[0]);
+  EXPECT_EQ(1000, output[1]);
+}
+
+}
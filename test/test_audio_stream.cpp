@@ -0,0 +1,168 @@
+#include <core/audio_stream.h>
+#include <core/audio_mixer.h>
+#include <core/sound.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace atom {
+
+namespace {
+
+/**
+ * Stereo ramp, both samples of frame i are i.
+ */
+uptr<AudioBuffer> make_ramp(u32 frames, u32 channels = 2)
+{
+  std::vector<i16> samples;
+
+  for (u32 i = 0; i < frames; ++i) {
+    samples.insert(samples.end(), channels, static_cast<i16>(i));
+  }
+
+  return uptr<AudioBuffer>(Sound::create_from_samples(samples.data(), samples.size(),
+    AUDIO_FREQUENCY, channels).release());
+}
+
+void decode_all(AudioStream &stream)
+{
+  while (stream.update()) {
+  }
+}
+
+}
+
+TEST(AudioStream, Blocks)
+{
+  const u32 FRAMES = AUDIO_BUFFER_SIZE * 3;   // longer than all blocks
+  AudioStream stream(make_ramp(FRAMES), false);
+  EXPECT_EQ(FRAMES, stream.frame_count());
+
+  std::vector<f32> output(1000);
+  u32 frame = 0;
+
+  while (!stream.is_stream_finished()) {
+    decode_all(stream);
+    u32 count = stream.read(output.data(), output.size());
+
+    for (u32 i = 0; i < count; i += 2, ++frame) {
+      ASSERT_EQ(static_cast<i16>(frame), output[i]);
+      ASSERT_EQ(static_cast<i16>(frame), output[i + 1]);
+    }
+  }
+
+  EXPECT_EQ(FRAMES, frame);
+  EXPECT_FALSE(stream.update());
+}
+
+TEST(AudioStream, Underrun)
+{
+  AudioStream stream(make_ramp(100), false);
+  std::vector<f32> output(50);
+  // nothing decoded yet
+  EXPECT_EQ(0u, stream.read(output.data(), output.size()));
+
+  decode_all(stream);
+  EXPECT_EQ(50u, stream.read(output.data(), output.size()));
+  EXPECT_FALSE(stream.is_stream_finished());
+  EXPECT_EQ(50u, stream.read(output.data(), output.size()));
+  EXPECT_EQ(50u, stream.read(output.data(), output.size()));
+  EXPECT_EQ(50u, stream.read(output.data(), output.size()));
+  // 200 samples in total
+  EXPECT_EQ(0u, stream.read(output.data(), output.size()));
+  EXPECT_TRUE(stream.is_stream_finished());
+}
+
+TEST(AudioStream, MonoToStereo)
+{
+  AudioStream stream(make_ramp(10, 1), false);
+  decode_all(stream);
+
+  std::vector<f32> output(40);
+  ASSERT_EQ(20u, stream.read(output.data(), output.size()));
+  EXPECT_EQ(9, output[18]);
+  EXPECT_EQ(9, output[19]);
+  EXPECT_TRUE(stream.is_stream_finished());
+}
+
+TEST(AudioStream, SeekDropsDecodedBlocks)
+{
+  AudioStream stream(make_ramp(1000), false);
+  decode_all(stream);
+
+  std::vector<f32> output(20);
+  stream.read(output.data(), 4);
+  stream.seek(700);
+  // blocks of the old position are skipped until the decoder catches up
+  EXPECT_EQ(0u, stream.read(output.data(), output.size()));
+
+  decode_all(stream);
+  ASSERT_EQ(20u, stream.read(output.data(), output.size()));
+  EXPECT_EQ(700, output[0]);
+  EXPECT_EQ(709, output[18]);
+}
+
+TEST(AudioStream, LoopPoints)
+{
+  AudioStream stream(make_ramp(100), true);
+  stream.set_loop_points(10, 20);
+  stream.seek(15);
+  decode_all(stream);
+
+  std::vector<f32> output(30);
+  ASSERT_EQ(30u, stream.read(output.data(), output.size()));
+  // 15..19, 10..19
+  EXPECT_EQ(15, output[0]);
+  EXPECT_EQ(19, output[8]);
+  EXPECT_EQ(10, output[10]);
+  EXPECT_EQ(19, output[28]);
+  EXPECT_FALSE(stream.is_stream_finished());
+}
+
+TEST(AudioStream, Mixer)
+{
+  AudioStreamPtr stream = std::make_shared<AudioStream>(make_ramp(8), false);
+  decode_all(*stream);
+
+  AudioMixer mixer;
+  AudioCommand command;
+  command.type = AudioCommandType::PLAY;
+  command.id = 1;
+  command.stream = stream;
+  EXPECT_TRUE(mixer.push(std::move(command)));
+
+  std::vector<i16> output(20);
+  mixer.mix(output.data(), output.size());
+  EXPECT_EQ(7, output[14]);
+  EXPECT_EQ(0, output[16]);
+  EXPECT_EQ(0u, mixer.track_count());
+
+  mixer.collect();
+  EXPECT_TRUE(stream.unique());
+}
+
+TEST(AudioDecoder, DecodesOnThread)
+{
+  AudioDecoder decoder;
+  AudioStreamPtr stream = std::make_shared<AudioStream>(make_ramp(100), false);
+  decoder.add(stream);
+
+  std::vector<f32> output(200);
+  u32 count = 0;
+
+  // add doesn't decode, the first block comes from the thread
+  for (u32 i = 0; i < 1000 && count == 0; ++i) {
+    count = stream->read(output.data(), output.size());
+
+    if (count == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  ASSERT_EQ(200u, count);
+  EXPECT_EQ(0, output[0]);
+  EXPECT_EQ(99, output[198]);
+  EXPECT_TRUE(stream->is_stream_finished());
+}
+
+}
@@ -0,0 +1,30 @@
+#include <core/bone_palette.h>
+#include <gtest/gtest.h>
+
+namespace atom {
+
+TEST(BonePalette, SharedOffsets)
+{
+  std::vector<Mat4f> a(3, Mat4f::translation(1, 0, 0));
+  std::vector<Mat4f> b(2, Mat4f::translation(0, 2, 0));
+  int skeleton_a, skeleton_b;
+
+  BonePalette palette;
+  EXPECT_EQ(0, palette.add(&skeleton_a, Slice<Mat4f>(a.data(), a.size())));
+  EXPECT_EQ(3, palette.add(&skeleton_b, Slice<Mat4f>(b.data(), b.size())));
+  // skeleton drawn several times is stored once
+  EXPECT_EQ(0, palette.add(&skeleton_a, Slice<Mat4f>(a.data(), a.size())));
+  EXPECT_EQ(3, palette.find(&skeleton_b));
+  EXPECT_EQ(-1, palette.find(&palette));
+
+  Slice<Mat4f> bones = palette.bones();
+  ASSERT_EQ(5u, bones.size());
+  EXPECT_EQ(1, bones[2](0, 3));
+  EXPECT_EQ(2, bones[3](1, 3));
+
+  palette.clear();
+  EXPECT_EQ(0u, palette.bones().size());
+  EXPECT_EQ(-1, palette.find(&skeleton_a));
+}
+
+}
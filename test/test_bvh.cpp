@@ -0,0 +1,138 @@
+#include <core/bvh.h>
+#include <core/intersect.h>
+#include <gtest/gtest.h>
+
+namespace atom {
+
+static f32 intersect_boxes(const Bvh &bvh, const std::vector<BoundingBox> &boxes,
+  const Ray &ray, u32 &index)
+{
+  return bvh.intersect_ray(ray, [&](u32 primitive, f32 tmax) -> f32 {
+    f32 t = intersect_bounding_box(ray, boxes[primitive]);
+
+    if (t >= 0 && t < tmax) {
+      index = primitive;
+    }
+
+    return t;
+  });
+}
+
+TEST(Bvh, EmptyMiss)
+{
+  Bvh bvh;
+  ASSERT_TRUE(bvh.is_empty());
+  ASSERT_TRUE(bvh.bounds().is_null());
+
+  u32 index = U32_MAX;
+  std::vector<BoundingBox> boxes;
+  ASSERT_LT(intersect_boxes(bvh, boxes, Ray(Vec3f(0, 0, 0), Vec3f(1, 0, 0)), index), 0);
+}
+
+TEST(Bvh, BuildAndRefit)
+{
+  std::vector<BoundingBox> boxes;
+
+  for (u32 i = 0; i < 100; ++i) {
+    f32 x = 3.0f * i;
+    boxes.push_back(BoundingBox(x, x + 1, 0, 1, 0, 1));
+  }
+
+  Bvh bvh;
+  bvh.build(Slice<BoundingBox>(boxes.data(), boxes.size()));
+  ASSERT_FALSE(bvh.is_empty());
+  ASSERT_EQ(100u, bvh.primitive_count());
+  ASSERT_FLOAT_EQ(0.0f, bvh.bounds().xmin);
+  ASSERT_FLOAT_EQ(298.0f, bvh.bounds().xmax);
+
+  // ray along x axis hits the first box
+  u32 index = U32_MAX;
+  Ray ray(Vec3f(-10, 0.5f, 0.5f), Vec3f(1, 0, 0));
+  ASSERT_FLOAT_EQ(10.0f, intersect_boxes(bvh, boxes, ray, index));
+  ASSERT_EQ(0u, index);
+
+  // ray along y axis hits only box 50
+  Ray ray_y(Vec3f(150.5f, -10, 0.5f), Vec3f(0, 1, 0));
+  ASSERT_FLOAT_EQ(10.0f, intersect_boxes(bvh, boxes, ray_y, index));
+  ASSERT_EQ(50u, index);
+
+  // move box 50 away, the ray must miss after refit
+  boxes[50] = BoundingBox(150, 151, 0, 1, 10, 11);
+  bvh.refit(Slice<BoundingBox>(boxes.data(), boxes.size()));
+  ASSERT_LT(intersect_boxes(bvh, boxes, ray_y, index), 0);
+  ASSERT_FLOAT_EQ(11.0f, bvh.bounds().zmax);
+}
+
+TEST(Bvh, RayOnSlabPlane)
+{
+  std::vector<BoundingBox> boxes;
+
+  for (u32 i = 0; i < 20; ++i) {
+    f32 x = 3.0f * i;
+    boxes.push_back(BoundingBox(x, x + 1, 0, 1, 0, 1));
+  }
+
+  Bvh bvh;
+  bvh.build(Slice<BoundingBox>(boxes.data(), boxes.size()));
+
+  // zero y and z direction, origin lies on the ymin and zmax planes
+  Ray ray(Vec3f(-10, 0, 1), Vec3f(1, 0, 0));
+  u32 visited = 0;
+  bvh.intersect_ray(ray, [&visited](u32 primitive, f32 tmax) -> f32 {
+    ++visited;
+    return -1;
+  });
+  EXPECT_EQ(20u, visited);
+
+  // parallel ray outside of the slab misses everything
+  visited = 0;
+  bvh.intersect_ray(Ray(Vec3f(-10, 1.5f, 0.5f), Vec3f(1, 0, 0)),
+    [&visited](u32 primitive, f32 tmax) -> f32 {
+      ++visited;
+      return -1;
+    });
+  EXPECT_EQ(0u, visited);
+}
+
+TEST(Bvh, MeshMatchesBruteForce)
+{
+  // unit cube
+  std::vector<Vec3f> vertices = {
+    Vec3f(-1, -1, -1), Vec3f(1, -1, -1), Vec3f(1, 1, -1), Vec3f(-1, 1, -1),
+    Vec3f(-1, -1,  1), Vec3f(1, -1,  1), Vec3f(1, 1,  1), Vec3f(-1, 1,  1)
+  };
+  std::vector<u32> indices = {
+    0, 2, 1, 0, 3, 2,  4, 5, 6, 4, 6, 7,  0, 1, 5, 0, 5, 4,
+    2, 3, 7, 2, 7, 6,  1, 2, 6, 1, 6, 5,  0, 4, 7, 0, 7, 3
+  };
+  Slice<Vec3f> v(vertices.data(), vertices.size());
+  Slice<u32> i(indices.data(), indices.size());
+
+  Bvh bvh;
+  build_mesh_bvh(v, i, bvh);
+  ASSERT_EQ(12u, bvh.primitive_count());
+
+  const Ray rays[] = {
+    Ray(Vec3f(-5, 0.1f, 0.2f), Vec3f(1, 0, 0)),
+    Ray(Vec3f(0.3f, 5, -0.2f), Vec3f(0, -1, 0)),
+    Ray(Vec3f(0.1f, 0.3f, 0.1f), Vec3f(0, 0, 1)),
+    Ray(Vec3f(-5, -5, -5), Vec3f(1, 1.1f, 0.9f).normalized()),
+    Ray(Vec3f(-5, 5, 0), Vec3f(1, 0, 0))
+  };
+
+  for (const Ray &ray : rays) {
+    u32 expected_index = U32_MAX;
+    u32 index = U32_MAX;
+    f32 expected = intersect_mesh(ray, v, i, expected_index);
+    f32 t = intersect_mesh(ray, bvh, v, i, index);
+
+    if (expected < 0) {
+      ASSERT_LT(t, 0);
+    } else {
+      ASSERT_FLOAT_EQ(expected, t);
+      ASSERT_EQ(expected_index, index);
+    }
+  }
+}
+
+}
@@ -0,0 +1,89 @@
+#include <core/component_pool.h>
+#include <core/component.h>
+#include <gtest/gtest.h>
+#include <new>
+
+namespace atom {
+
+namespace {
+
+class TestComponent : public NullComponent {
+public:
+  explicit TestComponent(u32 value)
+    : NullComponent(ComponentType::SCRIPT)
+    , value(value)
+  {}
+
+  u32 value;
+};
+
+}
+
+TEST(ComponentPool, AddRemove)
+{
+  ComponentPool pool;
+  TestComponent a(1), b(2), c(3);
+
+  ComponentHandle ha = pool.add(&a);
+  ComponentHandle hb = pool.add(&b);
+  ComponentHandle hc = pool.add(&c);
+  ASSERT_EQ(3u, pool.size());
+  ASSERT_EQ(&b, pool.get(hb));
+
+  u32 revision = pool.revision();
+  pool.remove(ha);
+  ASSERT_NE(revision, pool.revision());
+  ASSERT_EQ(2u, pool.size());
+  ASSERT_TRUE(pool.get(ha) == nullptr);
+  // remaining handles are still valid after the packed array was reordered
+  ASSERT_EQ(&b, pool.get(hb));
+  ASSERT_EQ(&c, pool.get(hc));
+
+  u32 sum = 0;
+  for (TestComponent *component : pool.view<TestComponent>()) {
+    sum += component->value;
+  }
+  ASSERT_EQ(5u, sum);
+
+  // slot is reused, but the old handle stays invalid
+  ComponentHandle hd = pool.add(&a);
+  ASSERT_EQ(ha.index, hd.index);
+  ASSERT_TRUE(pool.get(ha) == nullptr);
+  ASSERT_EQ(&a, pool.get(hd));
+
+  pool.clear();
+  ASSERT_EQ(0u, pool.size());
+  ASSERT_TRUE(pool.get(hb) == nullptr);
+  ASSERT_TRUE(pool.get(ComponentHandle()) == nullptr);
+}
+
+TEST(ComponentStorage, AllocateReuse)
+{
+  ComponentStorage storage(sizeof(TestComponent), alignof(TestComponent));
+  ASSERT_EQ(0u, storage.element_size() % alignof(TestComponent));
+
+  u8 *a = static_cast<u8 *>(storage.allocate());
+  u8 *b = static_cast<u8 *>(storage.allocate());
+  u8 *c = static_cast<u8 *>(storage.allocate());
+  ASSERT_EQ(3u, storage.size());
+  // components of one class are contiguous
+  ASSERT_EQ(a + storage.element_size(), b);
+  ASSERT_EQ(b + storage.element_size(), c);
+
+  TestComponent *component = new (b) TestComponent(7);
+  ASSERT_EQ(7u, component->value);
+  component->~TestComponent();
+  storage.deallocate(b);
+  ASSERT_EQ(2u, storage.size());
+
+  // place of the destroyed component is reused
+  ASSERT_EQ(b, storage.allocate());
+  ASSERT_EQ(3u, storage.size());
+
+  storage.deallocate(a);
+  storage.deallocate(b);
+  storage.deallocate(c);
+  ASSERT_EQ(0u, storage.size());
+}
+
+}
@@ -0,0 +1,68 @@
+#include <core/fixed_timestep.h>
+#include <core/rigid_body_component.h>
+#include <gtest/gtest.h>
+
+namespace atom {
+
+TEST(FixedTimestep, Accumulates)
+{
+  FixedTimestep timestep(0.25, 10);
+
+  EXPECT_EQ(0u, timestep.advance(0.1));
+  EXPECT_FLOAT_EQ(0.4f, timestep.alpha());
+  EXPECT_EQ(1u, timestep.advance(0.2));
+  EXPECT_FLOAT_EQ(0.2f, timestep.alpha());
+  EXPECT_EQ(4u, timestep.advance(1));
+  EXPECT_FLOAT_EQ(0.2f, timestep.alpha());
+  EXPECT_EQ(0u, timestep.advance(-1));
+
+  timestep.reset();
+  EXPECT_FLOAT_EQ(0, timestep.alpha());
+}
+
+TEST(FixedTimestep, FrameRateIndependent)
+{
+  // the same simulated time for any frame rate
+  const u32 rates[] = { 24, 30, 60, 144 };
+
+  for (u32 rate : rates) {
+    FixedTimestep timestep(1.0 / 60, 10);
+    u32 steps = 0;
+
+    for (u32 i = 0; i < rate * 2; ++i) {
+      steps += timestep.advance(1.0 / rate);
+    }
+
+    EXPECT_NEAR(120, steps, 1) << rate;
+  }
+}
+
+TEST(FixedTimestep, MaxSteps)
+{
+  FixedTimestep timestep(0.1, 3);
+  EXPECT_EQ(3u, timestep.advance(10));
+  // the rest of the long frame is dropped
+  EXPECT_FLOAT_EQ(0, timestep.alpha());
+  EXPECT_EQ(1u, timestep.advance(0.15));
+}
+
+TEST(RigidBodyState, Interpolate)
+{
+  RigidBodyState a{Vec3f(0, 0, 0), Quatf::from_axis_angle(Vec3f(0, 0, 1), 0)};
+  RigidBodyState b{Vec3f(2, 4, 0), Quatf::from_axis_angle(Vec3f(0, 0, 1), PI / 2)};
+
+  RigidBodyState half = interpolate_state(a, b, 0.5f);
+  EXPECT_FLOAT_EQ(1, half.position.x);
+  EXPECT_FLOAT_EQ(2, half.position.y);
+
+  // quarter turn halved rotates x axis by 45 degrees
+  Vec3f x = transform_vec(half.transform(), Vec3f(1, 0, 0));
+  EXPECT_NEAR(std::sqrt(0.5f), x.x, 1e-5f);
+  EXPECT_NEAR(std::sqrt(0.5f), x.y, 1e-5f);
+
+  Mat4f end = interpolate_state(a, b, 1).transform();
+  EXPECT_NEAR(2, end(0, 3), 1e-5f);
+  EXPECT_NEAR(4, end(1, 3), 1e-5f);
+}
+
+}
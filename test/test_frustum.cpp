@@ -0,0 +1,123 @@
+#include <core/frustum.h>
+#include <core/mesh_tree.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+
+namespace atom {
+
+namespace {
+
+/// camera at origin looking in -z direction, 90 degrees field of view
+Frustum test_frustum()
+{
+  return extract_frustum(Mat4f::perspective(PI / 2, 1, 1, 100));
+}
+
+BoundingBox box_at(const Vec3f &center, f32 size)
+{
+  return BoundingBox(center.x - size, center.x + size, center.y - size, center.y + size,
+    center.z - size, center.z + size);
+}
+
+std::vector<BoundingBox> random_boxes(u32 count)
+{
+  std::mt19937 gen(5);
+  std::uniform_real_distribution<f32> coord(-150, 150);
+  std::uniform_real_distribution<f32> size(0.1f, 5);
+  std::vector<BoundingBox> boxes;
+
+  for (u32 i = 0; i < count; ++i) {
+    boxes.push_back(box_at(Vec3f(coord(gen), coord(gen), coord(gen)), size(gen)));
+  }
+
+  return boxes;
+}
+
+}
+
+TEST(Frustum, ClassifyBox)
+{
+  Frustum frustum = test_frustum();
+
+  EXPECT_EQ(Containment::INSIDE, classify_box(frustum, box_at(Vec3f(0, 0, -10), 1)));
+  EXPECT_EQ(Containment::OUTSIDE, classify_box(frustum, box_at(Vec3f(0, 0, 10), 1)));
+  EXPECT_EQ(Containment::OUTSIDE, classify_box(frustum, box_at(Vec3f(0, 0, -200), 1)));
+  EXPECT_EQ(Containment::OUTSIDE, classify_box(frustum, box_at(Vec3f(30, 0, -10), 1)));
+  // near plane and side plane
+  EXPECT_EQ(Containment::INTERSECT, classify_box(frustum, box_at(Vec3f(0, 0, -1), 0.5f)));
+  EXPECT_EQ(Containment::INTERSECT, classify_box(frustum, box_at(Vec3f(10, 0, -10), 1)));
+}
+
+TEST(Frustum, CullBoxesKernels)
+{
+  Frustum frustum = test_frustum();
+  std::vector<BoundingBox> boxes = random_boxes(1001);
+  BoxArray array;
+  array.resize(boxes.size());
+
+  for (u32 i = 0; i < boxes.size(); ++i) {
+    array.set(i, boxes[i]);
+  }
+
+  // ranges which don't start and end on SIMD batch boundary
+  const u32 begin = 3;
+  const u32 end = 998;
+  std::vector<u32> expected;
+
+  for (u32 i = begin; i < end; ++i) {
+    if (classify_box(frustum, boxes[i]) != Containment::OUTSIDE) {
+      expected.push_back(i);
+    }
+  }
+
+  ASSERT_GT(expected.size(), 0u);
+
+  const SimdLevel levels[] = { SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2 };
+  std::vector<u32> visible(end - begin);
+
+  for (SimdLevel level : levels) {
+    if (!has_simd(level)) {
+      continue;
+    }
+
+    u32 count = cull_boxes(frustum, array, begin, end, visible.data(), level);
+    EXPECT_EQ(expected, std::vector<u32>(visible.begin(), visible.begin() + count))
+      << simd_level_name(level);
+  }
+}
+
+TEST(MeshTree, Cull)
+{
+  Frustum frustum = test_frustum();
+  std::vector<BoundingBox> boxes = random_boxes(2000);
+  std::vector<u32> expected;
+
+  for (u32 i = 0; i < boxes.size(); ++i) {
+    if (classify_box(frustum, boxes[i]) != Containment::OUTSIDE) {
+      expected.push_back(i);
+    }
+  }
+
+  MeshTree tree;
+  tree.build(Slice<BoundingBox>(boxes.data(), boxes.size()));
+  ASSERT_EQ(boxes.size(), tree.size());
+
+  std::vector<u32> visible;
+  tree.cull(frustum, visible);
+  std::sort(visible.begin(), visible.end());
+  EXPECT_EQ(expected, visible);
+
+  // objects moved in front of the camera
+  for (u32 i = 0; i < 10; ++i) {
+    boxes[i] = box_at(Vec3f(0, 0, -20), 1);
+  }
+
+  tree.refit(Slice<BoundingBox>(boxes.data(), boxes.size()));
+  visible.clear();
+  tree.cull(frustum, visible);
+  EXPECT_EQ(1, std::count(visible.begin(), visible.end(), 0u));
+  EXPECT_EQ(1, std::count(visible.begin(), visible.end(), 9u));
+}
+
+}
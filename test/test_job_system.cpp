@@ -0,0 +1,115 @@
+#include <core/job_system.h>
+#include <core/processor.h>
+#include <gtest/gtest.h>
+#include <atomic>
+
+namespace atom {
+
+TEST(JobSystem, NestedJobs)
+{
+  JobSystem jobs(4);
+  ASSERT_EQ(4u, jobs.worker_count());
+
+  std::atomic<u32> sum(0);
+  JobCounter counter;
+
+  for (u32 i = 0; i < 100; ++i) {
+    jobs.run([&jobs, &sum]
+    {
+      // job waits for its own jobs
+      JobCounter nested;
+      for (u32 j = 1; j <= 10; ++j) {
+        jobs.run([&sum, j] { sum += j; }, nested);
+      }
+      jobs.wait(nested);
+    }, counter);
+  }
+
+  jobs.wait(counter);
+  ASSERT_TRUE(counter.is_done());
+  ASSERT_EQ(5500u, sum.load());
+}
+
+TEST(JobSystem, ParallelFor)
+{
+  JobSystem jobs(3);
+  std::vector<u32> values(10007, 0);
+
+  jobs.parallel_for(values.size(), 64, [&values](u32 begin, u32 end)
+  {
+    for (u32 i = begin; i < end; ++i) {
+      values[i] += i;
+    }
+  });
+
+  for (u32 i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(i, values[i]);
+  }
+}
+
+TEST(JobSystem, Deterministic)
+{
+  JobSystem jobs(4, true);
+  ASSERT_TRUE(jobs.is_deterministic());
+
+  std::vector<u32> order;
+  JobCounter counter;
+
+  for (u32 i = 0; i < 10; ++i) {
+    jobs.run([&order, i] { order.push_back(i); }, counter);
+  }
+
+  jobs.parallel_for(100, 7, [&order](u32 begin, u32 end) { order.push_back(begin); });
+  jobs.wait(counter);
+
+  ASSERT_EQ(11u, order.size());
+  for (u32 i = 0; i < 10; ++i) {
+    ASSERT_EQ(i, order[i]);
+  }
+  ASSERT_EQ(0u, order[10]);
+}
+
+TEST(ProcessorSchedule, Levels)
+{
+  std::vector<ProcessorAccess> access = {
+    // physics
+    { ProcessorData::PHYSICS | ProcessorData::TRANSFORMS, ProcessorData::PHYSICS | ProcessorData::TRANSFORMS },
+    // geometry
+    { ProcessorData::SKELETONS, ProcessorData::GEOMETRY },
+    // script
+    { ProcessorData::ALL, ProcessorData::ALL },
+    // debug
+    { ProcessorData::PHYSICS, ProcessorData::DEBUG },
+    // reads geometry only
+    { ProcessorData::GEOMETRY, 0 }
+  };
+
+  std::vector<u32> levels;
+  ASSERT_EQ(3u, schedule_processors(access, levels));
+  ASSERT_EQ(0u, levels[0]);
+  ASSERT_EQ(0u, levels[1]);
+  ASSERT_EQ(1u, levels[2]);
+  ASSERT_EQ(2u, levels[3]);
+  ASSERT_EQ(2u, levels[4]);
+}
+
+TEST(ProcessorSchedule, TransformsMarkGeometry)
+{
+  const u32 physics = ProcessorData::PHYSICS | ProcessorData::TRANSFORMS;
+  std::vector<ProcessorAccess> access = {
+    // physics, moved entities mark the geometry hierarchy for refit
+    { physics, physics | ProcessorData::GEOMETRY },
+    // animation
+    { 0, ProcessorData::SKELETONS },
+    // geometry
+    { ProcessorData::SKELETONS, ProcessorData::GEOMETRY }
+  };
+
+  std::vector<u32> levels;
+  ASSERT_EQ(2u, schedule_processors(access, levels));
+  ASSERT_EQ(0u, levels[0]);
+  ASSERT_EQ(0u, levels[1]);
+  ASSERT_EQ(1u, levels[2]);
+}
+
+}
@@ -0,0 +1,158 @@
+#include <core/mesh_simplify.h>
+#include <core/model.h>
+#include <core/constants.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+namespace atom {
+
+namespace {
+
+const u32 GRID_SIZE = 17;
+
+/**
+ * Grid GRID_SIZE x GRID_SIZE vertices in xy plane with z = height(x, y).
+ */
+template<typename F>
+void make_grid(std::vector<Vec3f> &vertices, std::vector<u32> &indices, F height)
+{
+  for (u32 y = 0; y < GRID_SIZE; ++y) {
+    for (u32 x = 0; x < GRID_SIZE; ++x) {
+      vertices.push_back(Vec3f(x, y, height(f32(x), f32(y))));
+    }
+  }
+
+  for (u32 y = 0; y + 1 < GRID_SIZE; ++y) {
+    for (u32 x = 0; x + 1 < GRID_SIZE; ++x) {
+      u32 i = y * GRID_SIZE + x;
+      indices.insert(indices.end(), { i, i + 1, i + GRID_SIZE + 1 });
+      indices.insert(indices.end(), { i, i + GRID_SIZE + 1, i + GRID_SIZE });
+    }
+  }
+}
+
+bool is_border(u32 vertex)
+{
+  u32 x = vertex % GRID_SIZE, y = vertex / GRID_SIZE;
+  return x == 0 || y == 0 || x == GRID_SIZE - 1 || y == GRID_SIZE - 1;
+}
+
+}
+
+TEST(SimplifyMesh, FlatGrid)
+{
+  std::vector<Vec3f> vertices;
+  std::vector<u32> indices;
+  make_grid(vertices, indices, [](f32, f32) { return 0.0f; });
+
+  std::vector<u32> result;
+  u32 target = indices.size() / 4 / 3 * 3;
+  f32 error = simplify_mesh(Slice<Vec3f>(vertices.data(), vertices.size()),
+    Slice<u32>(indices.data(), indices.size()), target, result);
+
+  EXPECT_LE(result.size(), target);
+  EXPECT_GT(result.size(), 0u);
+  EXPECT_EQ(0u, result.size() % 3);
+  EXPECT_NEAR(0, error, 1e-3f);
+
+  std::vector<u8> used(vertices.size(), 0);
+
+  for (u32 index : result) {
+    ASSERT_LT(index, vertices.size());
+    used[index] = 1;
+  }
+
+  // open border is locked
+  for (u32 i = 0; i < vertices.size(); ++i) {
+    if (is_border(i)) {
+      EXPECT_TRUE(used[i]) << "border vertex " << i;
+    }
+  }
+
+  // no degenerated triangles
+  for (u32 i = 0; i < result.size(); i += 3) {
+    EXPECT_NE(result[i], result[i + 1]);
+    EXPECT_NE(result[i + 1], result[i + 2]);
+    EXPECT_NE(result[i], result[i + 2]);
+  }
+}
+
+TEST(SimplifyMesh, InvalidIndex)
+{
+  std::vector<Vec3f> vertices = { Vec3f(0, 0, 0), Vec3f(1, 0, 0), Vec3f(0, 1, 0) };
+  std::vector<u32> indices = { 0, 1, 3 };
+  std::vector<u32> result;
+
+  simplify_mesh(Slice<Vec3f>(vertices.data(), vertices.size()),
+    Slice<u32>(indices.data(), indices.size()), 0, result);
+  EXPECT_EQ(indices, result);
+}
+
+TEST(SelectLod, Hysteresis)
+{
+  LodLevel levels[] = { { 0, 300, 0 }, { 300, 150, 0.1f }, { 450, 75, 0.4f } };
+  Slice<LodLevel> lods(levels, 3);
+
+  EXPECT_EQ(0u, select_lod(Slice<LodLevel>(), 1, 0));
+  EXPECT_EQ(0u, select_lod(lods, 100, 2));
+  EXPECT_EQ(1u, select_lod(lods, 5, 0));
+  EXPECT_EQ(2u, select_lod(lods, 1.5f, 0));
+  // error 0.8 px is between the thresholds, level doesn't change
+  EXPECT_EQ(0u, select_lod(lods, 8, 0));
+  EXPECT_EQ(1u, select_lod(lods, 8, 1));
+  EXPECT_EQ(2u, select_lod(lods, 2, 2));
+  EXPECT_EQ(1u, select_lod(lods, 3, 2));
+  // invalid current level
+  EXPECT_EQ(2u, select_lod(lods, 0.1f, 10));
+}
+
+TEST(GenerateModelLods, CurvedGrid)
+{
+  std::vector<Vec3f> vertices;
+  std::vector<u32> indices;
+  make_grid(vertices, indices, [](f32 x, f32 y) { return std::sin(x * 0.3f) * std::cos(y * 0.2f); });
+
+  const u8 *vertex_data = reinterpret_cast<const u8 *>(vertices.data());
+  const u8 *index_data = reinterpret_cast<const u8 *>(indices.data());
+  Model model;
+  model.add_array(MODEL_VERTEX, Type::F32,
+    std::vector<u8>(vertex_data, vertex_data + vertices.size() * sizeof(Vec3f)));
+  model.add_array(MODEL_INDEX, Type::U32,
+    std::vector<u8>(index_data, index_data + indices.size() * sizeof(u32)));
+  EXPECT_EQ(0u, model.lods().size());
+
+  u32 count = generate_model_lods(model, 3);
+  ASSERT_GT(count, 0u);
+  ASSERT_LE(count, 3u);
+
+  Slice<LodLevel> lods = model.lods();
+  Slice<u32> lod_indices = model.find_stream<u32>(MODEL_LOD_INDEX);
+  ASSERT_EQ(count, lods.size());
+
+  u32 previous_count = indices.size();
+  f32 previous_error = 0;
+
+  for (const LodLevel &lod : lods) {
+    EXPECT_LT(lod.count, previous_count);
+    EXPECT_GE(lod.error, previous_error);
+    EXPECT_LT(lod.error, 1.0f);
+    EXPECT_EQ(0u, lod.count % 3);
+    ASSERT_LE(lod.first + lod.count, lod_indices.size());
+
+    for (u32 i = lod.first; i < lod.first + lod.count; ++i) {
+      EXPECT_LT(lod_indices[i], vertices.size());
+    }
+
+    previous_count = lod.count;
+    previous_error = lod.error;
+  }
+}
+
+TEST(GenerateModelLods, WithoutIndices)
+{
+  Model model;
+  EXPECT_EQ(0u, generate_model_lods(model, 3));
+  EXPECT_EQ(0u, model.lods().size());
+}
+
+}
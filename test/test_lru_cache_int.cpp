@@ -109,4 +109,31 @@ TEST_F(LRUCacheTestInt, IteratorTest)
   ASSERT_TRUE(my_cache.begin() == my_cache.end());
 }
 
+TEST_F(LRUCacheTestInt, EraseKeepsOrder)
+{
+  for (int i = 0; i < 5; ++i) {
+    my_cache.insert(i, i * 10);
+  }
+
+  ASSERT_EQ(0, my_cache.oldest().key());
+
+  // odstran najstarsi, najnovsi a prostredny prvok
+  EXPECT_TRUE(my_cache.erase(0));
+  EXPECT_TRUE(my_cache.erase(4));
+  EXPECT_TRUE(my_cache.erase(2));
+  EXPECT_FALSE(my_cache.erase(2));
+  ASSERT_EQ(2, my_cache.size());
+  EXPECT_EQ(1, my_cache.oldest().key());
+  EXPECT_EQ(10, *my_cache.oldest());
+
+  my_cache.erase(1);
+  EXPECT_EQ(3, my_cache.oldest().key());
+  my_cache.erase(3);
+  EXPECT_TRUE(my_cache.empty());
+  EXPECT_TRUE(my_cache.oldest() == my_cache.end());
+
+  my_cache.insert(7, 70);
+  EXPECT_EQ(7, my_cache.oldest().key());
+}
+
 }
@@ -0,0 +1,97 @@
+#include <core/model_loader.h>
+#include <core/constants.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+
+namespace atom {
+
+static std::vector<u8> to_bytes(const void *data, u32 size)
+{
+  const u8 *begin = static_cast<const u8 *>(data);
+  return std::vector<u8>(begin, begin + size);
+}
+
+TEST(BinaryModel, SaveAndLoad)
+{
+  const f32 vertices[] = { 0, 0, 0,  1, 0, 0,  0, 1, 0 };
+  const u32 indices[] = { 0, 1, 2 };
+  const i32 topology[] = { -1, -1, -1 };
+
+  Model model;
+  model.add_array(MODEL_VERTEX, Type::F32, to_bytes(vertices, sizeof(vertices)));
+  model.add_array(MODEL_INDEX, Type::U32, to_bytes(indices, sizeof(indices)));
+  model.add_array("topology", Type::I32, to_bytes(topology, sizeof(topology)));
+  model.bones.resize(2);
+  model.bones[0].name = "root";
+  model.bones[0].parent = -1;
+  model.bones[0].head = Vec3f(1, 2, 3);
+  model.bones[1].name = "child";
+  model.bones[1].parent = 0;
+  model.bones[1].tail = Vec3f(4, 5, 6);
+
+  const char filename[] = "test_model.m3b";
+  ASSERT_TRUE(save_model_binary(filename, model));
+
+  Model loaded;
+  ASSERT_TRUE(load_model(filename, loaded));
+  std::remove(filename);
+
+  Slice<f32> v = loaded.find_stream<f32>(MODEL_VERTEX);
+  Slice<u32> i = loaded.find_stream<u32>(MODEL_INDEX);
+  Slice<i32> t = loaded.find_stream<i32>("topology");
+  ASSERT_EQ(9u, v.size());
+  ASSERT_EQ(3u, i.size());
+  ASSERT_EQ(3u, t.size());
+  ASSERT_EQ(0, memcmp(vertices, v.data(), sizeof(vertices)));
+  ASSERT_EQ(0, memcmp(indices, i.data(), sizeof(indices)));
+  ASSERT_EQ(0, memcmp(topology, t.data(), sizeof(topology)));
+  // stream data are aligned in the mapped file
+  ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(v.data()) % MODEL_FILE_ALIGNMENT);
+
+  ASSERT_EQ(2u, loaded.bones.size());
+  ASSERT_EQ("root", loaded.bones[0].name);
+  ASSERT_EQ(-1, loaded.bones[0].parent);
+  ASSERT_FLOAT_EQ(3.0f, loaded.bones[0].head.z);
+  ASSERT_EQ("child", loaded.bones[1].name);
+  ASSERT_EQ(0, loaded.bones[1].parent);
+  ASSERT_FLOAT_EQ(5.0f, loaded.bones[1].tail.y);
+  // ray hierarchy is built for binary models too
+  ASSERT_EQ(1u, loaded.bvh.primitive_count());
+}
+
+TEST(BinaryModel, RejectInvalidFile)
+{
+  const char filename[] = "test_invalid.m3b";
+  FILE *file = fopen(filename, "wb");
+  ASSERT_TRUE(file != nullptr);
+  const char garbage[64] = "this is not a model file";
+  fwrite(garbage, 1, sizeof(garbage), file);
+  fclose(file);
+
+  Model model;
+  ASSERT_FALSE(load_model(filename, model));
+  std::remove(filename);
+}
+
+TEST(BinaryModel, RejectMissingBones)
+{
+  // the last vertex references the third bone
+  const u32 bone_indices[] = { 0x00000100, 0x00010001, 0x02000000 };
+
+  Model model;
+  model.add_array(MODEL_BONE_INDEX, Type::U32, to_bytes(bone_indices, sizeof(bone_indices)));
+  model.bones.resize(2);
+
+  const char filename[] = "test_bones.m3b";
+  ASSERT_TRUE(save_model_binary(filename, model));
+
+  Model loaded;
+  ASSERT_FALSE(load_model(filename, loaded));
+  std::remove(filename);
+
+  model.bones.resize(3);
+  ASSERT_TRUE(model.has_valid_bone_indices());
+}
+
+}
@@ -0,0 +1,86 @@
+#include <core/occlusion_buffer.h>
+#include <gtest/gtest.h>
+
+namespace atom {
+
+namespace {
+
+BoundingBox box_at(const Vec3f &center, f32 size)
+{
+  return BoundingBox(center.x - size, center.x + size, center.y - size, center.y + size,
+    center.z - size, center.z + size);
+}
+
+}
+
+TEST(OcclusionBuffer, HiddenBehindWall)
+{
+  // camera at origin looking in -z direction
+  OcclusionBuffer buffer(64, 32);
+  buffer.begin(Mat4f::perspective(PI / 2, 2, 1, 100));
+  EXPECT_TRUE(buffer.is_visible(box_at(Vec3f(0, 0, -30), 1)));
+
+  // wall 4 x 4 at distance 10
+  buffer.add_box(Mat4f::translation(0, 0, -10), BoundingBox(-2, 2, -2, 2, -0.5f, 0.5f));
+  buffer.finish();
+  ASSERT_TRUE(buffer.has_occluders());
+  EXPECT_LT(buffer.depth(0, 32, 16), 1);
+  EXPECT_EQ(1, buffer.depth(0, 0, 0));
+  // top level contains the farthest depth
+  EXPECT_EQ(1, buffer.depth(buffer.level_count() - 1, 0, 0));
+
+  EXPECT_FALSE(buffer.is_visible(box_at(Vec3f(0, 0, -30), 1)));
+  EXPECT_FALSE(buffer.is_visible(box_at(Vec3f(0.5f, -0.5f, -50), 0.5f)));
+  // in front of the wall, next to it and partially hidden
+  EXPECT_TRUE(buffer.is_visible(box_at(Vec3f(0, 0, -5), 0.5f)));
+  EXPECT_TRUE(buffer.is_visible(box_at(Vec3f(30, 0, -30), 1)));
+  EXPECT_TRUE(buffer.is_visible(box_at(Vec3f(6, 0, -30), 4)));
+  // crossing the near plane
+  EXPECT_TRUE(buffer.is_visible(box_at(Vec3f(0, 0, 0), 2)));
+}
+
+TEST(OcclusionBuffer, Triangles)
+{
+  OcclusionBuffer buffer(16, 16);
+  buffer.begin(Mat4f::perspective(PI / 2, 1, 1, 100));
+  // triangle behind the camera is skipped
+  buffer.add_triangle(Vec3f(-1, -1, 5), Vec3f(1, -1, 5), Vec3f(0, 1, 5));
+  EXPECT_FALSE(buffer.has_occluders());
+
+  // large quad
+  buffer.add_triangle(Vec3f(-20, -20, -10), Vec3f(20, -20, -10), Vec3f(20, 20, -10));
+  buffer.add_triangle(Vec3f(-20, -20, -10), Vec3f(20, 20, -10), Vec3f(-20, 20, -10));
+  buffer.finish();
+
+  for (u32 i = 0; i < buffer.level_count(); ++i) {
+    EXPECT_LT(buffer.depth(i, 0, 0), 1);
+  }
+
+  EXPECT_FALSE(buffer.is_visible(box_at(Vec3f(3, 2, -20), 1)));
+  EXPECT_TRUE(buffer.is_visible(box_at(Vec3f(3, 2, -8), 1)));
+}
+
+TEST(OcclusionBuffer, MeshWithGap)
+{
+  OcclusionBuffer buffer(64, 64);
+  buffer.begin(Mat4f::perspective(PI / 2, 1, 1, 100));
+
+  // two walls with a gap between them, their bounds would hide the gap
+  const f32 positions[] = {
+    -10, -10, 0,  -1, -10, 0,  -1, 10, 0,  -10, 10, 0,
+      1, -10, 0,  10, -10, 0,  10, 10, 0,    1, 10, 0
+  };
+  // the last triangle references missing vertex
+  const u32 indices[] = { 0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7, 0, 1, 8 };
+
+  buffer.add_mesh(Mat4f::translation(0, 0, -10), Slice<f32>(positions, 24),
+    Slice<u32>(indices, 15));
+  buffer.finish();
+  ASSERT_TRUE(buffer.has_occluders());
+
+  EXPECT_FALSE(buffer.is_visible(box_at(Vec3f(-5, 0, -30), 1)));
+  EXPECT_FALSE(buffer.is_visible(box_at(Vec3f(5, 3, -30), 1)));
+  EXPECT_TRUE(buffer.is_visible(box_at(Vec3f(0, 0, -30), 0.5f)));
+}
+
+}
@@ -0,0 +1,78 @@
+#include <core/render_queue.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+
+namespace atom {
+
+TEST(RenderQueue, RadixSortMatchesStableSort)
+{
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<u32> id(0, 5);
+  std::uniform_real_distribution<f32> depth(0, 100);
+  std::vector<RenderPacket> packets;
+
+  for (u32 i = 0; i < 5000; ++i) {
+    packets.push_back(RenderPacket{render_key(id(gen), id(gen), id(gen), depth(gen)), i});
+  }
+
+  std::vector<RenderPacket> expected = packets;
+  std::stable_sort(expected.begin(), expected.end(),
+    [](const RenderPacket &a, const RenderPacket &b) { return a.key < b.key; });
+
+  std::vector<RenderPacket> buffer(packets.size());
+  radix_sort(packets.data(), buffer.data(), packets.size());
+
+  for (u32 i = 0; i < packets.size(); ++i) {
+    ASSERT_EQ(expected[i].key, packets[i].key);
+    ASSERT_EQ(expected[i].index, packets[i].index);
+  }
+}
+
+TEST(RenderQueue, KeyOrder)
+{
+  // technique has the highest priority, then material, mesh and depth
+  EXPECT_LT(render_key(0, 9, 9, 1000), render_key(1, 0, 0, 0));
+  EXPECT_LT(render_key(1, 0, 9, 1000), render_key(1, 1, 0, 0));
+  EXPECT_LT(render_key(1, 1, 0, 1000), render_key(1, 1, 1, 0));
+  // front to back
+  EXPECT_LT(render_key(1, 1, 1, 1), render_key(1, 1, 1, 2));
+  EXPECT_LT(render_key(1, 1, 1, 500), render_key(1, 1, 1, 5000));
+  EXPECT_EQ(render_key(1, 1, 1, -5), render_key(1, 1, 1, 0));
+}
+
+TEST(RenderQueue, SortPackets)
+{
+  RenderQueue queue;
+  queue.add(render_key(2, 0, 0, 0), 0);
+  queue.add(render_key(1, 0, 0, 3), 1);
+  queue.add(render_key(1, 0, 0, 1), 2);
+  queue.sort();
+
+  Slice<RenderPacket> packets = queue.packets();
+  ASSERT_EQ(3u, packets.size());
+  EXPECT_EQ(2u, packets[0].index);
+  EXPECT_EQ(1u, packets[1].index);
+  EXPECT_EQ(0u, packets[2].index);
+}
+
+TEST(RenderQueue, StateRuns)
+{
+  RenderQueue queue;
+  queue.add(render_key(1, 2, 3, 5), 0);
+  queue.add(render_key(1, 2, 4, 1), 1);
+  queue.add(render_key(1, 2, 3, 1), 2);
+  queue.add(render_key(1, 2, 3, 9), 3);
+  queue.add(render_key(0, 2, 3, 1), 4);
+  queue.sort();
+
+  // runs differ only in depth
+  Slice<RenderPacket> packets = queue.packets();
+  EXPECT_EQ(1u, state_run(packets, 0));
+  EXPECT_EQ(3u, state_run(packets, 1));
+  EXPECT_EQ(2u, state_run(packets, 2));
+  EXPECT_EQ(1u, state_run(packets, 4));
+  EXPECT_EQ(1u, packets[4].index);
+}
+
+}
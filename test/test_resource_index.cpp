@@ -0,0 +1,166 @@
+#include <core/resource_index.h>
+#include <gtest/gtest.h>
+
+namespace atom {
+
+namespace {
+
+class SizedResource : public Resource {
+public:
+  explicit SizedResource(const String &name, u32 size)
+    : my_size(size)
+  {
+    set_name(name);
+  }
+
+  u32 memory_size() const override
+  {
+    return my_size;
+  }
+
+private:
+  u32 my_size;
+};
+
+ResourcePtr add_sized(ResourceIndex &index, const String &name, u32 size)
+{
+  ResourcePtr resource = std::make_shared<SizedResource>(name, size);
+  index.add(resource);
+  return resource;
+}
+
+}
+
+TEST(ResourceIndex, FindAndDependents)
+{
+  ResourceIndex index;
+  ResourcePtr texture = std::make_shared<Resource>();
+  texture->set_name("texture:sand");
+  texture->depend_on_file("data/image/sand.png");
+  index.add(texture);
+
+  ResourcePtr material = std::make_shared<Resource>();
+  material->set_name("material:road");
+  material->depend_on_file("data/material/road.mat");
+  material->depend_on_resource(texture);
+  index.add(material);
+
+  ASSERT_EQ(texture, index.find("texture:sand"));
+  ASSERT_EQ(material, index.find("material:road"));
+  ASSERT_TRUE(index.find("texture:missing") == nullptr);
+
+  const StringArray &image = index.dependents("file:data/image/sand.png");
+  ASSERT_EQ(2u, image.size());
+  ASSERT_EQ(1u, index.dependents("texture:sand").size());
+  ASSERT_EQ("material:road", index.dependents("texture:sand")[0]);
+  ASSERT_TRUE(index.dependents("file:unknown").empty());
+
+  // material is referenced only by the index
+  material.reset();
+  StringArray removed;
+  index.garbage_collect(removed);
+  ASSERT_EQ(1u, removed.size());
+  ASSERT_EQ("material:road", removed[0]);
+  ASSERT_TRUE(index.find("material:road") == nullptr);
+  ASSERT_EQ(texture, index.find("texture:sand"));
+  ASSERT_EQ(1u, index.dependents("file:data/image/sand.png").size());
+}
+
+TEST(ResourceIndex, CollectAfterGracePeriod)
+{
+  ResourceIndex index;
+  index.set_cache_limits(1000, 100);
+  add_sized(index, "image:a", 10);
+  ResourcePtr used = add_sized(index, "image:b", 10);
+
+  StringArray removed;
+  index.collect(0, 1000000, removed);
+  ASSERT_TRUE(removed.empty());
+  ASSERT_EQ(10u, index.released_size());
+
+  index.collect(99, 1000000, removed);
+  ASSERT_TRUE(removed.empty());
+
+  index.collect(100, 1000000, removed);
+  ASSERT_EQ(1u, removed.size());
+  ASSERT_EQ("image:a", removed[0]);
+  ASSERT_EQ(1u, index.size());
+  ASSERT_EQ(used, index.find("image:b"));
+  ASSERT_EQ(0u, index.released_size());
+}
+
+TEST(ResourceIndex, CollectOverBudget)
+{
+  ResourceIndex index;
+  index.set_cache_limits(25, 1000000);
+  add_sized(index, "image:a", 10);
+  add_sized(index, "image:b", 10);
+
+  StringArray removed;
+  index.collect(0, 1000000, removed);
+  ASSERT_TRUE(removed.empty());
+
+  // the oldest unused resource is evicted first
+  add_sized(index, "image:c", 10);
+  index.collect(1, 1000000, removed);
+  ASSERT_EQ(1u, removed.size());
+  ASSERT_EQ(20u, index.released_size());
+  ASSERT_TRUE(index.find(removed[0]) == nullptr);
+  ASSERT_TRUE(removed[0] != "image:c");
+  ASSERT_EQ(2u, index.size());
+}
+
+TEST(ResourceIndex, CollectEvictsWithinBudget)
+{
+  ResourceIndex index;
+  index.set_cache_limits(1000, 100);
+  add_sized(index, "image:a", 10);
+  add_sized(index, "image:b", 10);
+  add_sized(index, "image:c", 10);
+
+  StringArray removed;
+  index.collect(0, 0, removed);
+  ASSERT_TRUE(removed.empty());
+  ASSERT_EQ(30u, index.released_size());
+
+  // zero budget evicts one expired resource per call
+  for (u32 i = 1; i <= 3; ++i) {
+    index.collect(100, 0, removed);
+    ASSERT_EQ(i, removed.size());
+    ASSERT_EQ(3 - i, index.size());
+  }
+
+  ASSERT_EQ(0u, index.released_size());
+}
+
+TEST(ResourceIndex, CollectKeepsReferencedResource)
+{
+  ResourceIndex index;
+  index.set_cache_limits(100, 100);
+  add_sized(index, "texture:sand", 10);
+
+  ResourcePtr material = std::make_shared<Resource>();
+  material->set_name("material:road");
+  material->depend_on_file("data/material/road.mat");
+  index.add(material);
+
+  StringArray removed;
+  // texture is requested again before it is evicted
+  index.collect(0, 1000000, removed);
+  ResourcePtr texture = index.find("texture:sand");
+  ASSERT_TRUE(texture != nullptr);
+  index.collect(200, 1000000, removed);
+  ASSERT_TRUE(removed.empty());
+  ASSERT_EQ(2u, index.size());
+
+  material.reset();
+  texture.reset();
+  index.collect(300, 1000000, removed);
+  ASSERT_TRUE(removed.empty());
+  index.collect(400, 1000000, removed);
+  ASSERT_EQ(2u, removed.size());
+  ASSERT_EQ(0u, index.size());
+  ASSERT_TRUE(index.dependents("file:data/material/road.mat").empty());
+}
+
+}
@@ -0,0 +1,113 @@
+#include <core/skeleton_component.h>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace atom {
+
+namespace {
+
+Mat4f reference_bone_matrix(const std::vector<Bone> &bones, const Bone &bone)
+{
+  Mat4f m = Mat4f::translation(bone.local_head) * bone.transform.rotation_matrix()
+    * Mat4f::translation(-bone.local_head);
+  return bone.parent < 0 ? m : reference_bone_matrix(bones, bones[bone.parent]) * m;
+}
+
+// children are stored before parents to exercise the ordering
+std::vector<Bone> generate_bones(u32 count)
+{
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<f32> coord(-5, 5);
+  std::uniform_real_distribution<f32> angle(-3, 3);
+  std::vector<Bone> bones(count);
+
+  for (u32 i = 0; i < count; ++i) {
+    Bone &bone = bones[i];
+    bone.local_head = Vec3f(coord(gen), coord(gen), coord(gen));
+    bone.transform = Quatf::from_axis_angle(Vec3f(0, 0, 1), angle(gen));
+    bone.parent = i + 1 < count ? static_cast<i32>(i + 1 + gen() % (count - i - 1 > 3 ? 3 : count - i - 1)) : -1;
+  }
+
+  return bones;
+}
+
+void expect_matrix_near(const Mat4f &expected, const Mat4f &actual)
+{
+  for (u32 c = 0; c < 4; ++c) {
+    for (u32 r = 0; r < 4; ++r) {
+      EXPECT_NEAR(expected(r, c), actual(r, c), 1e-3);
+    }
+  }
+}
+
+}
+
+TEST(Skeleton, ParentsBeforeChildren)
+{
+  std::vector<Bone> bones = generate_bones(50);
+  std::vector<u32> order;
+  sort_bones(bones, order);
+
+  ASSERT_EQ(bones.size(), order.size());
+  std::vector<u32> position(bones.size());
+
+  for (u32 i = 0; i < order.size(); ++i) {
+    position[order[i]] = i;
+  }
+
+  for (u32 i = 0; i < bones.size(); ++i) {
+    if (bones[i].parent >= 0) {
+      EXPECT_LT(position[bones[i].parent], position[i]);
+    }
+  }
+}
+
+TEST(Skeleton, MatchesRecursiveEvaluation)
+{
+  std::vector<Bone> bones = generate_bones(50);
+  std::vector<u32> order;
+  std::vector<u8> dirty(bones.size(), 1);
+  std::vector<Mat4f> transforms;
+  sort_bones(bones, order);
+  update_bone_transforms(bones, order, dirty, transforms);
+
+  for (u32 i = 0; i < bones.size(); ++i) {
+    expect_matrix_near(reference_bone_matrix(bones, bones[i]), transforms[i]);
+    EXPECT_EQ(0, dirty[i]);
+  }
+}
+
+TEST(Skeleton, UpdatesOnlyDirtySubtree)
+{
+  // 0 <- 1 <- 2, 3 is a separate root
+  std::vector<Bone> bones(4);
+  bones[0].parent = -1;
+  bones[1].parent = 0;
+  bones[2].parent = 1;
+  bones[3].parent = -1;
+
+  for (Bone &bone : bones) {
+    bone.local_head = Vec3f(1, 2, 3);
+  }
+
+  std::vector<u32> order;
+  std::vector<u8> dirty(bones.size(), 1);
+  std::vector<Mat4f> transforms;
+  sort_bones(bones, order);
+  update_bone_transforms(bones, order, dirty, transforms);
+
+  // unchanged bone keeps its (marked) transform
+  Mat4f marker = Mat4f::translation(Vec3f(9, 9, 9));
+  transforms[3] = marker;
+  bones[1].transform = Quatf::from_axis_angle(Vec3f(1, 0, 0), 1);
+  dirty[1] = 1;
+  update_bone_transforms(bones, order, dirty, transforms);
+
+  expect_matrix_near(marker, transforms[3]);
+
+  for (u32 i = 0; i < 3; ++i) {
+    expect_matrix_near(reference_bone_matrix(bones, bones[i]), transforms[i]);
+  }
+}
+
+}
@@ -0,0 +1,127 @@
+#include <core/skinning.h>
+#include <core/skinning_feedback.h>
+#include <core/geometry_component.h>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace atom {
+
+namespace {
+
+struct SkinningData {
+  std::vector<Vec3f> positions;
+  std::vector<Vec3f> normals;
+  std::vector<u32>   bone_indices;
+  std::vector<Vec4f> bone_weights;
+  std::vector<Mat4f> bones;
+
+  SkinningInput input() const
+  {
+    SkinningInput input;
+    input.positions = positions.data();
+    input.normals = normals.data();
+    input.bone_indices = bone_indices.data();
+    input.bone_weights = bone_weights.data();
+    input.count = positions.size();
+    input.bones = bones.data();
+    input.bone_count = bones.size();
+    return input;
+  }
+};
+
+void generate_skinning_data(u32 vertex_count, u32 bone_count, SkinningData &data)
+{
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<f32> coord(-10, 10);
+  std::uniform_real_distribution<f32> angle(-3, 3);
+  std::uniform_real_distribution<f32> weight(0, 1);
+  std::uniform_int_distribution<u32> bone(0, bone_count - 1);
+
+  for (u32 i = 0; i < bone_count; ++i) {
+    data.bones.push_back(Mat4f::translation(Vec3f(coord(gen), coord(gen), coord(gen)))
+      * Mat4f::rotation_z(angle(gen)) * Mat4f::rotation_x(angle(gen)));
+  }
+
+  for (u32 i = 0; i < vertex_count; ++i) {
+    data.positions.push_back(Vec3f(coord(gen), coord(gen), coord(gen)));
+    data.normals.push_back(Vec3f(coord(gen), coord(gen), coord(gen)).normalized());
+    data.bone_indices.push_back(bone(gen) | bone(gen) << 8 | bone(gen) << 16 | bone(gen) << 24);
+    Vec4f w(weight(gen), weight(gen), weight(gen), weight(gen));
+    data.bone_weights.push_back(w / (w[0] + w[1] + w[2] + w[3]));
+  }
+}
+
+}
+
+/**
+ * Compare all supported kernels with the former per bone transform_point loop.
+ */
+TEST(Skinning, Accuracy)
+{
+  SkinningData data;
+  generate_skinning_data(1001, 60, data);
+  SkinningInput input = data.input();
+
+  const SimdLevel levels[] = { SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2 };
+
+  for (SimdLevel level : levels) {
+    if (!has_simd(level)) {
+      continue;
+    }
+
+    std::vector<Vec3f> positions(input.count);
+    std::vector<Vec3f> normals(input.count);
+    skin_vertices(input, positions.data(), normals.data(), level);
+
+    for (u32 i = 0; i < input.count; ++i) {
+      u32 bi = data.bone_indices[i];
+      Vec3f expected(0, 0, 0);
+      Vec3f expected_normal(0, 0, 0);
+
+      for (u32 j = 0; j < 4; ++j, bi >>= 8) {
+        const Mat4f &bone = data.bones[bi & 0xFF];
+        expected += transform_point(bone, data.positions[i]) * data.bone_weights[i][j];
+        expected_normal += transform_vec(bone, data.normals[i]) * data.bone_weights[i][j];
+      }
+
+      expected_normal = expected_normal.normalized();
+
+      for (u32 k = 0; k < 3; ++k) {
+        ASSERT_NEAR(expected[k], positions[i][k], 1e-4f) << simd_level_name(level);
+        ASSERT_NEAR(expected_normal[k], normals[i][k], 1e-4f) << simd_level_name(level);
+      }
+    }
+  }
+}
+
+/**
+ * GPU skinning output (position & normal pairs) fills the same cache as CPU.
+ */
+TEST(Skinning, ReadFeedback)
+{
+  std::vector<Vec3f> feedback = {
+    Vec3f(1, 2, 3), Vec3f(0, 0, 1),
+    Vec3f(4, 5, 6), Vec3f(0, 1, 0),
+    Vec3f(7, 8, 9), Vec3f(1, 0, 0)
+  };
+  Slice<Vec3f> slice(feedback.data(), feedback.size());
+  GeometryCache cache;
+
+  read_skinning_feedback(slice, true, cache);
+  ASSERT_EQ(3u, cache.vertices.size());
+  ASSERT_EQ(3u, cache.normals.size());
+
+  for (u32 i = 0; i < 3; ++i) {
+    for (u32 k = 0; k < 3; ++k) {
+      EXPECT_EQ(feedback[i * 2][k], cache.vertices[i][k]);
+      EXPECT_EQ(feedback[i * 2 + 1][k], cache.normals[i][k]);
+    }
+  }
+
+  // normals aren't skinned, cache keeps only positions
+  read_skinning_feedback(slice, false, cache);
+  ASSERT_EQ(3u, cache.vertices.size());
+  ASSERT_TRUE(cache.normals.empty());
+}
+
+}
@@ -0,0 +1,40 @@
+#include <core/stream_buffer.h>
+#include <gtest/gtest.h>
+
+namespace atom {
+
+TEST(StreamRing, AllocateInRegion)
+{
+  StreamRing ring(256);
+  EXPECT_EQ(768u, ring.capacity());
+  EXPECT_EQ(0u, ring.allocate(12, 16));
+  // aligned start
+  EXPECT_EQ(16u, ring.allocate(100, 16));
+  EXPECT_EQ(116u, ring.used());
+  EXPECT_EQ(116u, ring.allocate(4, 4));
+  // doesn't fit to the rest of the region
+  EXPECT_EQ(U32_MAX, ring.allocate(200, 16));
+  EXPECT_EQ(U32_MAX, ring.allocate(0, 16));
+  EXPECT_EQ(128u, ring.allocate(128, 16));
+  EXPECT_EQ(U32_MAX, ring.allocate(1, 1));
+}
+
+TEST(StreamRing, RegionsWrapAround)
+{
+  StreamRing ring(256);
+  ring.allocate(64, 16);
+
+  EXPECT_EQ(1u, ring.next_region());
+  EXPECT_EQ(0u, ring.used());
+  EXPECT_EQ(256u, ring.allocate(256, 16));
+
+  EXPECT_EQ(2u, ring.next_region());
+  EXPECT_EQ(512u, ring.allocate(10, 16));
+  EXPECT_EQ(528u, ring.allocate(10, 16));
+
+  // frame after the last region reuses the first one
+  EXPECT_EQ(0u, ring.next_region());
+  EXPECT_EQ(0u, ring.allocate(256, 16));
+}
+
+}
@@ -0,0 +1,94 @@
+#include <core/terrain.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+
+namespace atom {
+
+TEST(Terrain, TileName)
+{
+  EXPECT_EQ("hills_3_-2", terrain_tile_name("hills", 3, -2));
+  EXPECT_NE(terrain_tile_key(1, -1), terrain_tile_key(-1, 1));
+  EXPECT_NE(terrain_tile_key(0, 1), terrain_tile_key(1, 0));
+}
+
+TEST(Terrain, TilesInRadius)
+{
+  std::vector<TerrainTile> tiles;
+
+  // viewer in the middle of tile (0, 0)
+  terrain_tiles_in_radius(Vec2f(5, 5), 10, 1, tiles);
+  ASSERT_EQ(1u, tiles.size());
+  EXPECT_EQ(0, tiles[0].x);
+  EXPECT_EQ(0, tiles[0].y);
+  EXPECT_EQ(0, tiles[0].distance);
+
+  // 3x3 tiles around the viewer, corners are farther than 6
+  terrain_tiles_in_radius(Vec2f(5, 5), 10, 6, tiles);
+  EXPECT_EQ(5u, tiles.size());
+  EXPECT_EQ(0, tiles[0].x);
+  EXPECT_EQ(0, tiles[0].y);
+
+  terrain_tiles_in_radius(Vec2f(5, 5), 10, 8, tiles);
+  ASSERT_EQ(9u, tiles.size());
+
+  for (u32 i = 1; i < tiles.size(); ++i) {
+    EXPECT_LE(tiles[i - 1].distance, tiles[i].distance);
+  }
+
+  EXPECT_NEAR(5, tiles[1].distance, 1e-5f);
+  EXPECT_NEAR(std::sqrt(50.0f), tiles[8].distance, 1e-5f);
+  EXPECT_TRUE(std::any_of(tiles.begin(), tiles.end(),
+    [](const TerrainTile &t) { return t.x == -1 && t.y == -1; }));
+
+  // negative coordinates
+  terrain_tiles_in_radius(Vec2f(-15, -25), 10, 0, tiles);
+  ASSERT_EQ(1u, tiles.size());
+  EXPECT_EQ(-2, tiles[0].x);
+  EXPECT_EQ(-3, tiles[0].y);
+
+  terrain_tiles_in_radius(Vec2f(0, 0), 10, -1, tiles);
+  EXPECT_TRUE(tiles.empty());
+}
+
+TEST(TileCache, EvictLeastRecentlyUsed)
+{
+  TileCache cache(3);
+  std::vector<u64> evicted;
+
+  cache.use(1, 1);
+  cache.use(2, 2);
+  cache.use(3, 3);
+  cache.evict(3, evicted);
+  EXPECT_TRUE(evicted.empty());
+
+  cache.use(1, 4);
+  cache.use(4, 4);
+  cache.evict(4, evicted);
+  ASSERT_EQ(1u, evicted.size());
+  EXPECT_EQ(2u, evicted[0]);
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_FALSE(cache.contains(2));
+  EXPECT_TRUE(cache.contains(1));
+}
+
+TEST(TileCache, KeepTilesOfCurrentFrame)
+{
+  TileCache cache(2);
+  std::vector<u64> evicted;
+
+  // all tiles are in range, cache temporarily grows
+  cache.use(1, 1);
+  cache.use(2, 1);
+  cache.use(3, 1);
+  cache.evict(1, evicted);
+  EXPECT_TRUE(evicted.empty());
+  EXPECT_EQ(3u, cache.size());
+
+  cache.use(3, 2);
+  cache.evict(2, evicted);
+  ASSERT_EQ(1u, evicted.size());
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_TRUE(cache.contains(3));
+}
+
+}
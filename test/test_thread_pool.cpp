@@ -0,0 +1,34 @@
+#include <core/thread_pool.h>
+#include <gtest/gtest.h>
+#include <atomic>
+
+namespace atom {
+
+TEST(ThreadPool, RunAllJobs)
+{
+  std::atomic<u32> sum(0);
+
+  {
+    ThreadPool pool(4);
+    ASSERT_EQ(4u, pool.worker_count());
+
+    for (u32 i = 1; i <= 1000; ++i) {
+      pool.push([&sum, i]() { sum += i; });
+    }
+
+    pool.wait();
+    ASSERT_EQ(500500u, sum.load());
+
+    pool.push([&sum]() { sum += 1; });
+  }
+  // destructor finishes queued jobs
+  ASSERT_EQ(500501u, sum.load());
+}
+
+TEST(ThreadPool, DefaultWorkerCount)
+{
+  ThreadPool pool;
+  ASSERT_GE(pool.worker_count(), 1u);
+}
+
+}
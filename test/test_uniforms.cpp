@@ -0,0 +1,49 @@
+#include <core/uniforms.h>
+#include <gtest/gtest.h>
+#include <cstddef>
+
+namespace atom {
+
+TEST(Uniforms, Std140Layout)
+{
+  // offsets of the block members declared in data/shader
+  EXPECT_EQ(0u, offsetof(FrameBlock, view));
+  EXPECT_EQ(64u, offsetof(FrameBlock, projection));
+  EXPECT_EQ(128u, offsetof(FrameBlock, view_projection));
+  EXPECT_EQ(192u, offsetof(FrameBlock, sun_dir));
+  EXPECT_EQ(208u, offsetof(FrameBlock, ambient));
+  EXPECT_EQ(0u, offsetof(ObjectBlock, model));
+  EXPECT_EQ(64u, offsetof(ObjectBlock, mvp));
+  EXPECT_EQ(128u, offsetof(ObjectBlock, color));
+  EXPECT_EQ(140u, offsetof(ObjectBlock, bone_offset));
+
+  EXPECT_EQ(sizeof(FrameBlock), uniform_block_size(FRAME_BLOCK));
+  EXPECT_EQ(sizeof(ObjectBlock), uniform_block_size(OBJECT_BLOCK));
+}
+
+TEST(Uniforms, FillBlocks)
+{
+  Uniforms u;
+  u.transformations.view = Mat4f::translation(Vec3f(1, 2, 3));
+  u.view_projection = Mat4f::translation(Vec3f(4, 5, 6));
+  u.sun_dir = Vec3f(0, 0, -1);
+  u.ambient_color = Vec3f(0.1f, 0.2f, 0.3f);
+  u.model = Mat4f::translation(Vec3f(7, 8, 9));
+  u.color = Vec3f(1, 0, 0);
+  u.bone_offset = 12;
+
+  FrameBlock frame;
+  u.get_frame_block(frame);
+  EXPECT_EQ(3, frame.view(2, 3));
+  EXPECT_EQ(6, frame.view_projection(2, 3));
+  EXPECT_EQ(Vec4f(0, 0, -1, 0), frame.sun_dir);
+  EXPECT_EQ(Vec4f(0.1f, 0.2f, 0.3f, 0), frame.ambient);
+
+  ObjectBlock object;
+  u.get_object_block(object);
+  EXPECT_EQ(9, object.model(2, 3));
+  EXPECT_EQ(Vec3f(1, 0, 0), object.color);
+  EXPECT_EQ(12, object.bone_offset);
+}
+
+}
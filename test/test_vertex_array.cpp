@@ -0,0 +1,89 @@
+#include <core/vertex_array.h>
+#include <core/model.h>
+#include <core/constants.h>
+#include <core/log.h>
+#include <gtest/gtest.h>
+#include <cstring>
+
+namespace atom {
+
+namespace {
+
+template<typename T>
+void add_stream(Model &model, const char *name, Type type, const std::vector<T> &values)
+{
+  const u8 *begin = reinterpret_cast<const u8 *>(values.data());
+  model.add_array(name, type, std::vector<u8>(begin, begin + values.size() * sizeof(T)));
+}
+
+}
+
+TEST(VertexArray, PackNormal)
+{
+  Vec3f normals[] = { Vec3f(0, 0, 1), Vec3f(-1, 0, 0), Vec3f(0.6f, -0.8f, 0) };
+
+  for (const Vec3f &n : normals) {
+    Vec3f unpacked = unpack_normal(pack_normal(n));
+
+    for (u32 i = 0; i < 3; ++i) {
+      EXPECT_NEAR(n[i], unpacked[i], 1.0f / 511);
+    }
+  }
+}
+
+TEST(VertexArray, PackWeights)
+{
+  u16 packed[4];
+  pack_weights(Vec4f(1, 0.5f, 0, 2), packed);
+  EXPECT_EQ(U16_MAX, packed[0]);
+  EXPECT_EQ(32768, packed[1]);
+  EXPECT_EQ(0, packed[2]);
+  EXPECT_EQ(U16_MAX, packed[3]);
+}
+
+TEST(VertexArray, InterleaveModel)
+{
+  Model model;
+  add_stream(model, MODEL_VERTEX, Type::F32, std::vector<f32>{ 1, 2, 3, 4, 5, 6 });
+  add_stream(model, MODEL_NORMAL, Type::F32, std::vector<f32>{ 0, 0, 1, 0, 1, 0 });
+
+  VertexLayout layout;
+  std::vector<u8> data;
+  ASSERT_TRUE(interleave_model_vertices(model, layout, data));
+  // position + packed normal, separate float streams need 24 B
+  EXPECT_EQ(16u, layout.stride());
+  EXPECT_EQ(2 * layout.stride(), data.size());
+  ASSERT_NE(nullptr, layout.find(NORMAL_ATTRIBUTE));
+  EXPECT_EQ(nullptr, layout.find(BONE_INDEX_ATTRIBUTE));
+
+  f32 position[3];
+  u32 normal;
+  memcpy(position, &data[layout.stride()], sizeof(position));
+  memcpy(&normal, &data[layout.stride() + layout.find(NORMAL_ATTRIBUTE)->offset], sizeof(normal));
+  EXPECT_EQ(4, position[0]);
+  EXPECT_EQ(6, position[2]);
+  EXPECT_NEAR(1, unpack_normal(normal).y, 1e-3f);
+
+  // skinned vertex, separate streams need 44 B
+  add_stream(model, MODEL_BONE_INDEX, Type::U32, std::vector<u32>{ 0x01020304, 0 });
+  add_stream(model, MODEL_BONE_WEIGHT, Type::F32, std::vector<f32>{ 1, 0, 0, 0, 0.5f, 0.5f, 0, 0 });
+  ASSERT_TRUE(interleave_model_vertices(model, layout, data));
+  EXPECT_EQ(28u, layout.stride());
+  EXPECT_EQ(4u, layout.attributes().size());
+
+  u32 index;
+  memcpy(&index, &data[layout.find(BONE_INDEX_ATTRIBUTE)->offset], sizeof(index));
+  EXPECT_EQ(0x01020304u, index);
+
+  log_info("Bytes per vertex: static %u -> 16, skinned %u -> %u",
+    static_cast<u32>(2 * sizeof(Vec3f)),
+    static_cast<u32>(2 * sizeof(Vec3f) + sizeof(u32) + sizeof(Vec4f)), layout.stride());
+
+  // streams with different vertex count are rejected
+  Model invalid;
+  add_stream(invalid, MODEL_VERTEX, Type::F32, std::vector<f32>{ 1, 2, 3, 4, 5, 6 });
+  add_stream(invalid, MODEL_NORMAL, Type::F32, std::vector<f32>{ 0, 0, 1 });
+  EXPECT_FALSE(interleave_model_vertices(invalid, layout, data));
+}
+
+}
@@ -34,6 +34,8 @@ default_base_dir = "~/projects/atom/data/"
 class AtomSceneSettings(bpy.types.PropertyGroup):
     base_dir = bpy.props.StringProperty(name="Data directory",
                                         default=default_base_dir)
+    binary_format = bpy.props.BoolProperty(name="Binary format (.m3b)",
+        description="Export memory mappable binary model", default=False)
 
 
 class AtomObjectSettings(bpy.types.PropertyGroup):
@@ -67,6 +69,7 @@ class AtomPluginPanel(bpy.types.Panel):
             # basic properties
             layout.prop(context.object, "name")
             layout.prop(context.scene.atom, "base_dir")
+            layout.prop(context.scene.atom, "binary_format")
             layout.prop(context.object.atom, "export_normals")
             # uv
             if export.has_texcoords(context.object.data.uv_layers):
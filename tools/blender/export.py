@@ -6,8 +6,20 @@ import os
 import json
 import collections
 import array
+import struct
 
 filename_ext = ".m3d"
+binary_filename_ext = ".m3b"
+
+# binary model format, must match ModelFile* structures in src/core/model_loader.h
+BINARY_MAGIC = b'M3DB'
+BINARY_VERSION = 1
+BINARY_ALIGNMENT = 16
+BINARY_NAME_SIZE = 32
+BINARY_HEADER = struct.Struct('<4s7I')
+BINARY_STREAM = struct.Struct('<32s8s2I')
+BINARY_BONE = struct.Struct('<32si21f2I')
+BINARY_FORMATS = { 'f32' : 'f', 'u32' : 'I', 'i32' : 'i' }
 
 
 def to_point(v):
@@ -137,6 +149,74 @@ def export_skeleton(ob, me):
     return Result(skeleton, weight, index)
 
 
+def bone_pose_rotation(ar, bone):
+    """Rotation of the bone around its head relative to the parent (world space),
+    same as Bone::transform in src/core/skeleton_component.h
+    """
+    matrix = bone.matrix_channel
+
+    if bone.parent != None:
+        matrix = bone.parent.matrix_channel.inverted() * matrix
+
+    world = ar.matrix_world.to_quaternion()
+    return world * matrix.to_quaternion() * world.inverted()
+
+
+def export_animations(ob):
+    """Sample all actions of the armature, each animated deform bone has one
+    rotation (w, x, y, z) per frame. Clips are compressed by the engine
+    (model loader/modelconv).
+    """
+    ar = ob.parent
+    scene = bpy.context.scene
+
+    if ar.animation_data == None:
+        return None
+
+    current_action = ar.animation_data.action
+    current_frame = scene.frame_current
+    animations = dict()
+
+    try:
+        for action in bpy.data.actions:
+            # bones with keyframes in the action
+            animated = set()
+
+            for fc in action.fcurves:
+                if fc.data_path.startswith('pose.bones["'):
+                    animated.add(fc.data_path.split('"')[1])
+
+            bones = [(name, bone) for name, bone in ar.pose.bones.items()
+                if name in animated and bone.bone.use_deform]
+
+            if len(bones) == 0:
+                continue
+
+            print('Exporting animation ' + action.name)
+            ar.animation_data.action = action
+            start, end = [int(f) for f in action.frame_range]
+            tracks = dict((name, []) for name, bone in bones)
+
+            for frame in range(start, end + 1):
+                scene.frame_set(frame)
+
+                for name, bone in bones:
+                    q = bone_pose_rotation(ar, bone)
+                    tracks[name].extend([q.w, q.x, q.y, q.z])
+
+            animations[action.name] = {
+                'fps' : get_fps(),
+                'frames' : end - start + 1,
+                'tracks' : tracks
+            }
+
+    finally:
+        ar.animation_data.action = current_action
+        scene.frame_set(current_frame)
+
+    return animations
+
+
 def write_topology(ob, me, topology):
     # build mapping table: edge -> triangles (1 or 2 triangles)
     i = 0
@@ -229,10 +309,67 @@ def export_mesh(ob, me, export_bones):
         arrays['bone_weight'] = weight
         arrays['bone_index'] = index
 
+        animations = export_animations(ob)
+
+        if animations:
+            mesh['animations'] = animations
+
     return mesh
 
 
-def export_object_to_file(ob, filename):
+def align(offset):
+    return (offset + BINARY_ALIGNMENT - 1) & ~(BINARY_ALIGNMENT - 1)
+
+
+def write_binary(mesh, output):
+    """Write mesh dictionary (see export_mesh) in binary memory mappable format,
+    animations are not supported (they are compressed by modelconv).
+    """
+    streams = []
+
+    for name, stream in sorted(mesh['arrays'].items()):
+        data = array.array(BINARY_FORMATS[stream['type']], stream['data']).tobytes()
+        streams.append((name, stream['type'], data))
+
+    bones = []
+
+    if 'skeleton' in mesh:
+        bones = sorted(mesh['skeleton']['bones'].items(), key=lambda b: b[1]['index'])
+
+    stream_table = BINARY_HEADER.size
+    bone_table = stream_table + len(streams) * BINARY_STREAM.size
+    offset = align(bone_table + len(bones) * BINARY_BONE.size)
+
+    stream_entries = b''
+    stream_data = b''
+
+    for name, type, data in streams:
+        if len(name) >= BINARY_NAME_SIZE:
+            raise Exception("Stream name {0} is too long".format(name))
+
+        stream_entries += BINARY_STREAM.pack(name.encode(), type.encode(), offset, len(data))
+        padding = align(len(data)) - len(data)
+        stream_data += data + b'\0' * padding
+        offset += len(data) + padding
+
+    bone_entries = b''
+
+    for name, b in bones:
+        if len(name) >= BINARY_NAME_SIZE:
+            raise Exception("Bone name {0} is too long".format(name))
+
+        values = b['head'] + b['tail'] + b['head_local'] + b['tail_local'] + b['x'] + b['y'] + b['z']
+        bone_entries += BINARY_BONE.pack(name.encode(), b.get('parent', -1), *(values + [0, 0]))
+
+    header = BINARY_HEADER.pack(BINARY_MAGIC, BINARY_VERSION, len(streams),
+        len(bones), stream_table, bone_table, offset, 0)
+    tables = header + stream_entries + bone_entries
+    output.write(tables)
+    output.write(b'\0' * (align(len(tables)) - len(tables)))
+    output.write(stream_data)
+
+
+def export_object_to_file(ob, filename, binary=False):
     """Export object data (vertices/normals/uv/vertex bones/skeleton to file.
 
     This function duplicate active object, convert it to triangles, then export
@@ -275,11 +412,19 @@ def export_object_to_file(ob, filename):
 
         mesh = export_mesh(ob, me, has_bones(ob) and ob.atom.export_bones)
 
-        with open(filename, "w+") as output:
-            # compact format
-            #data = json.dumps({ 'mesh' : mesh }, separators=(',', ':'))
-            data = json.dumps({ 'mesh' : mesh }, indent=2)
-            output.write(data)
+        # check before the previous model file is truncated
+        if binary and 'animations' in mesh:
+            raise Exception("Animations can't be written to binary model, export .m3d and convert it by modelconv")
+
+        if binary:
+            with open(filename, "wb") as output:
+                write_binary(mesh, output)
+        else:
+            with open(filename, "w+") as output:
+                # compact format
+                #data = json.dumps({ 'mesh' : mesh }, separators=(',', ':'))
+                data = json.dumps({ 'mesh' : mesh }, indent=2)
+                output.write(data)
 
         t2 = time.clock()
         print("Total time {0}s".format(t2 - t1))
@@ -305,15 +450,16 @@ class AtomExportObject(bpy.types.Operator):
     def execute(self, context):
         ob = context.active_object
         print('Object name ', ob.name)
+        binary = context.scene.atom.binary_format
         filename = os.path.expanduser(context.scene.atom.base_dir + "/mesh/"
-                 + ob.name + filename_ext)
+                 + ob.name + (binary_filename_ext if binary else filename_ext))
         print('Filename name ', filename)
         print(filename)
         if (os.path.exists(os.path.dirname(filename)) == False):
             self.report({'ERROR'}, 'Mesh directory doesn\'t exists')
             return {'CANCELLED'}
 
-        status = export_object_to_file(ob, filename)
+        status = export_object_to_file(ob, filename, binary)
 
         self.report(status[0], status[1])
         return {'FINISHED'}
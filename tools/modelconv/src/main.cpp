@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <cstdlib>
+#include <core/model_loader.h>
+#include <core/model.h>
+#include <core/mesh_simplify.h>
+#include <core/constants.h>
+
+using namespace atom;
+
+/**
+ * Convert JSON model (.m3d) to binary memory mappable model (.m3b).
+ *
+ * Usage:
+ *   modelconv [-l levels] input.m3d [output.m3b]
+ *   modelconv [-l levels] -a a.m3d b.m3d ...       (output is next to input)
+ *
+ * -l generates up to levels coarser levels of detail (simplified meshes).
+ */
+static String binary_filename(const String &filename)
+{
+  String::size_type dot = filename.rfind('.');
+  String base = dot != String::npos ? filename.substr(0, dot) : filename;
+  return base + "." + MESH_BINARY_EXT;
+}
+
+static bool convert(const String &input, const String &output, u32 lod_levels)
+{
+  Model model;
+
+  if (!load_model_json(input, model)) {
+    fprintf(stderr, "Can't load model \"%s\"\n", input.c_str());
+    return false;
+  }
+
+  u32 lod_count = lod_levels > 0 ? generate_model_lods(model, lod_levels) : 0;
+
+  if (!save_model_binary(output, model)) {
+    fprintf(stderr, "Can't save model \"%s\"\n", output.c_str());
+    return false;
+  }
+
+  printf("%s -> %s (%u lod)\n", input.c_str(), output.c_str(), lod_count);
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  int first = 1;
+  u32 lod_levels = 0;
+
+  if (argc > 2 && String(argv[1]) == "-l") {
+    lod_levels = atoi(argv[2]);
+    first = 3;
+  }
+
+  if (argc - first < 1) {
+    printf("Usage: %s [-l levels] input.m3d [output.m3b]\n", argv[0]);
+    printf("       %s [-l levels] -a input1.m3d input2.m3d ...\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  bool ok = true;
+
+  if (String(argv[first]) == "-a") {
+    for (int i = first + 1; i < argc; ++i) {
+      ok = convert(argv[i], binary_filename(argv[i]), lod_levels) && ok;
+    }
+  } else {
+    String output = argc > first + 1 ? String(argv[first + 1]) : binary_filename(argv[first]);
+    ok = convert(argv[first], output, lod_levels);
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}